@@ -0,0 +1,571 @@
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "headers/analysis_server.hpp"
+#include "headers/bitboard.hpp"
+#include "headers/platform.hpp"
+#include "headers/search.hpp"
+#include "headers/uci.hpp"
+
+namespace esochess {
+    namespace {
+        struct json_value {
+            std::string text;
+            bool is_string; // Otherwise a number, `true`, `false` or `null` as written
+        };
+
+        using json_object = std::unordered_map<std::string, json_value>;
+
+        // A flat object of string, number and literal values, which is all requests hold
+        struct json_reader {
+            std::string_view text;
+            std::size_t position;
+
+            void skip_whitespace() {
+                while (position < text.size() &&
+                       (text [position] == ' ' || text [position] == '\t' ||
+                        text [position] == '\r' || text [position] == '\n')) {
+                    position++;
+                }
+            }
+
+            bool consume(char expected) {
+                skip_whitespace();
+
+                if (position < text.size() && text [position] == expected) {
+                    position++;
+                    return true;
+                }
+
+                return false;
+            }
+
+            std::optional<std::string> read_string() {
+                if (!consume('"')) {
+                    return std::nullopt;
+                }
+
+                std::string value {};
+
+                while (position < text.size() && text [position] != '"') {
+                    char letter {text [position++]};
+
+                    if (letter == '\\') {
+                        if (position >= text.size()) {
+                            return std::nullopt;
+                        }
+
+                        switch (text [position++]) {
+                            case 'n': letter = '\n'; break;
+                            case 't': letter = '\t'; break;
+                            case 'r': letter = '\r'; break;
+                            case 'b': letter = '\b'; break;
+                            case 'f': letter = '\f'; break;
+                            case 'u': // Only ASCII is expected, anything else is replaced
+                                letter = '?';
+                                position = std::min(position + 4, text.size());
+                                break;
+                            default: letter = text [position - 1]; break; // `"`, `\` and `/`
+                        }
+                    }
+
+                    value += letter;
+                }
+
+                if (position >= text.size()) {
+                    return std::nullopt;
+                }
+
+                position++;
+
+                return value;
+            }
+
+            std::optional<json_value> read_value() {
+                skip_whitespace();
+
+                if (position < text.size() && text [position] == '"') {
+                    std::optional<std::string> value {read_string()};
+
+                    return value.has_value() ? std::optional {json_value {std::move(*value), true}}
+                                             : std::nullopt;
+                }
+
+                const std::size_t start {position};
+
+                while (position < text.size() && text [position] != ',' &&
+                       text [position] != '}' && text [position] != ' ' &&
+                       text [position] != '\t') {
+                    position++;
+                }
+
+                if (position == start) {
+                    return std::nullopt;
+                }
+
+                return json_value {std::string {text.substr(start, position - start)}, false};
+            }
+        };
+
+        std::optional<json_object> parse_json_object(std::string_view text) {
+            json_reader reader {text, 0};
+            json_object object {};
+
+            if (!reader.consume('{')) {
+                return std::nullopt;
+            }
+
+            if (!reader.consume('}')) {
+                do {
+                    std::optional<std::string> key {reader.read_string()};
+
+                    if (!key.has_value() || !reader.consume(':')) {
+                        return std::nullopt;
+                    }
+
+                    std::optional<json_value> value {reader.read_value()};
+
+                    if (!value.has_value()) {
+                        return std::nullopt;
+                    }
+
+                    object.insert_or_assign(std::move(*key), std::move(*value));
+                } while (reader.consume(','));
+
+                if (!reader.consume('}')) {
+                    return std::nullopt;
+                }
+            }
+
+            reader.skip_whitespace();
+
+            return reader.position == text.size() ? std::optional {std::move(object)}
+                                                  : std::nullopt;
+        }
+
+        // Empty when absent, an error when present but not a non negative integer
+        std::optional<std::uint64_t> number_field(const json_object& object, const std::string& key,
+                                                  bool& invalid) {
+            const auto field {object.find(key)};
+
+            if (field == object.end() || field->second.text == "null") {
+                return std::nullopt;
+            }
+
+            const std::string& text {field->second.text};
+            std::uint64_t value {};
+            const auto [end, error_code] {
+                std::from_chars(text.data(), text.data() + text.size(), value)};
+
+            if (field->second.is_string || error_code != std::errc {} ||
+                end != text.data() + text.size()) {
+                invalid = true;
+                return std::nullopt;
+            }
+
+            return value;
+        }
+
+        bool is_true(const json_object& object, const std::string& key) {
+            const auto field {object.find(key)};
+
+            return field != object.end() && !field->second.is_string &&
+                   field->second.text == "true";
+        }
+
+        std::string json_string(std::string_view text) {
+            std::string quoted {"\""};
+
+            for (const char letter: text) {
+                if (letter == '"' || letter == '\\') {
+                    quoted += '\\';
+                    quoted += letter;
+                }
+
+                else if (static_cast<unsigned char>(letter) < 0x20) {
+                    quoted += ' ';
+                }
+
+                else {
+                    quoted += letter;
+                }
+            }
+
+            return quoted + '"';
+        }
+
+        std::string error_json(std::optional<std::string_view> id, std::string_view error) {
+            return "{\"id\":" + (id.has_value() ? json_string(*id) : std::string {"null"}) +
+                   ",\"error\":" + json_string(error) + '}';
+        }
+
+        std::string score_json(int score) {
+            if (!is_mate_score(score)) {
+                return "{\"cp\":" + std::to_string(score) + '}';
+            }
+
+            const int plies_to_mate {mate_score - std::abs(score)};
+
+            return "{\"mate\":" +
+                   std::to_string(score > 0 ? (plies_to_mate + 1) / 2 : -(plies_to_mate / 2)) +
+                   '}';
+        }
+
+        std::string response_json(std::string_view id, const analysis_response& response) {
+            const search_result& result {response.result};
+            std::string json {"{\"id\":" + json_string(id) + ",\"bestmove\":"};
+
+            json += result.best_move.has_value() ? json_string(move_to_uci(*result.best_move))
+                                                 : std::string {"null"};
+            json += ",\"ponder\":";
+            json += result.ponder_move.has_value() ? json_string(move_to_uci(*result.ponder_move))
+                                                   : std::string {"null"};
+            json += ",\"score\":" + score_json(result.score) +
+                    ",\"depth\":" + std::to_string(result.depth) +
+                    ",\"nodes\":" + std::to_string(result.statistics.nodes) + ",\"pv\":[";
+
+            if (!result.lines.empty()) {
+                const std::vector<bitboard::move>& line {result.lines.front().principal_variation};
+
+                for (std::size_t index {}; index < line.size(); index++) {
+                    json += (index == 0 ? "" : ",") + json_string(move_to_uci(line.at(index)));
+                }
+            }
+
+            return json + "],\"cancelled\":" + (response.cancelled ? "true" : "false") +
+                   ",\"queue_us\":" + std::to_string(response.queued.count()) +
+                   ",\"latency_us\":" + std::to_string(response.latency.count()) + '}';
+        }
+    } // namespace
+
+    analysis_server::analysis_server(const analysis_server_options& options) :
+        _options {options}, _job_available {}, _jobs {}, _running {}, _next_ticket {0},
+        _latencies {}, _responses {0} {
+        _latencies.reserve(latency_samples);
+
+        for (std::size_t worker {}; worker < std::max<std::size_t>(options.thread_count, 1);
+             worker++) {
+            _workers.emplace_back(
+                [this, worker](std::stop_token stop_token) { work(stop_token, worker); });
+        }
+    }
+
+    analysis_server::~analysis_server() {
+        std::deque<job> abandoned {};
+
+        {
+            const std::lock_guard<std::mutex> lock {_mutex};
+
+            abandoned.swap(_jobs);
+
+            for (auto& [ticket, stop_source]: _running) {
+                stop_source.request_stop();
+            }
+        }
+
+        for (const job& cancelled_job: abandoned) {
+            const auto waited {std::chrono::duration_cast<std::chrono::microseconds>(
+                clock::now() - cancelled_job.submitted)};
+
+            cancelled_job.respond(
+                analysis_response {cancelled_job.ticket, search_result {}, true, waited, waited});
+        }
+
+        _workers.clear(); // Stops and joins them once their searches return
+    }
+
+    std::uint64_t analysis_server::submit(const bitboard& board, const search_limits& limits,
+                                          response_function respond) {
+        const std::lock_guard<std::mutex> lock {_mutex};
+        const std::uint64_t ticket {_next_ticket++};
+
+        _jobs.push_back(job {ticket, board.position_copy(), budgeted(limits),
+                             std::move(respond), clock::now()});
+        _job_available.notify_one();
+
+        return ticket;
+    }
+
+    bool analysis_server::cancel(std::uint64_t ticket) {
+        std::unique_lock<std::mutex> lock {_mutex};
+
+        const auto queued {std::ranges::find(_jobs, ticket, &job::ticket)};
+
+        if (queued != _jobs.end()) {
+            const job cancelled_job {std::move(*queued)};
+            const auto waited {std::chrono::duration_cast<std::chrono::microseconds>(
+                clock::now() - cancelled_job.submitted)};
+
+            _jobs.erase(queued);
+            lock.unlock();
+            cancelled_job.respond(
+                analysis_response {ticket, search_result {}, true, waited, waited});
+
+            return true;
+        }
+
+        const auto running {_running.find(ticket)};
+
+        if (running == _running.end()) {
+            return false;
+        }
+
+        running->second.request_stop();
+
+        return true;
+    }
+
+    latency_percentiles analysis_server::latencies() const {
+        std::vector<std::chrono::microseconds> samples {};
+        std::uint64_t responses {};
+
+        {
+            const std::lock_guard<std::mutex> lock {_mutex};
+
+            samples = _latencies;
+            responses = _responses;
+        }
+
+        if (samples.empty()) {
+            return latency_percentiles {responses, {}, {}, {}, {}};
+        }
+
+        std::ranges::sort(samples);
+
+        const auto percentile {[&samples](std::size_t permille) {
+            return samples.at(std::min(samples.size() - 1, samples.size() * permille / 1000));
+        }};
+
+        return latency_percentiles {responses, percentile(500), percentile(900), percentile(990),
+                                    samples.back()};
+    }
+
+    std::size_t analysis_server::pending() const {
+        const std::lock_guard<std::mutex> lock {_mutex};
+
+        return _jobs.size() + _running.size();
+    }
+
+    void analysis_server::work(std::stop_token stop_token, std::size_t worker) {
+        if (_options.pin_workers) {
+            pin_current_thread(worker);
+        }
+
+        search_engine engine {_options.hash_megabytes};
+        std::unique_lock<std::mutex> lock {_mutex};
+
+        while (_job_available.wait(lock, stop_token, [this]() { return !_jobs.empty(); })) {
+            const job next {std::move(_jobs.front())};
+            std::stop_source stop_source {};
+
+            _jobs.pop_front();
+            _running.emplace(next.ticket, stop_source);
+            lock.unlock();
+
+            const clock::time_point started {clock::now()};
+            search_result result {
+                engine.search(next.board, {}, next.limits, {}, stop_source.get_token())};
+            const clock::time_point finished {clock::now()};
+            const analysis_response response {
+                next.ticket, std::move(result), stop_source.stop_requested(),
+                std::chrono::duration_cast<std::chrono::microseconds>(started - next.submitted),
+                std::chrono::duration_cast<std::chrono::microseconds>(finished - next.submitted)};
+
+            lock.lock();
+            _running.erase(next.ticket);
+            record_latency(response.latency);
+            lock.unlock();
+
+            next.respond(response);
+            lock.lock();
+        }
+    }
+
+    void analysis_server::record_latency(std::chrono::microseconds latency) {
+        if (_latencies.size() < latency_samples) {
+            _latencies.push_back(latency);
+        }
+
+        else {
+            _latencies.at(_responses % latency_samples) = latency;
+        }
+
+        _responses++;
+    }
+
+    search_limits analysis_server::budgeted(search_limits limits) const {
+        if (!limits.depth.has_value() && !limits.nodes.has_value() &&
+            !limits.move_time.has_value()) {
+            limits = _options.default_limits;
+        }
+
+        limits.infinite = false;
+        limits.ponder = false;
+        limits.time_left.reset();
+
+        if (_options.max_nodes > 0) {
+            limits.nodes = std::min(limits.nodes.value_or(_options.max_nodes), _options.max_nodes);
+        }
+
+        if (_options.max_move_time.count() > 0) {
+            limits.move_time =
+                std::min(limits.move_time.value_or(_options.max_move_time), _options.max_move_time);
+        }
+
+        return limits;
+    }
+
+    analysis_session::analysis_session(analysis_server& server, line_writer write_line) :
+        _server {server}, _write_line {std::move(write_line)} {
+    }
+
+    analysis_session::~analysis_session() {
+        cancel();
+        wait();
+    }
+
+    void analysis_session::cancel() {
+        std::vector<std::uint64_t> open_tickets {};
+
+        {
+            const std::lock_guard<std::mutex> lock {_mutex};
+
+            for (const auto& [id, ticket]: _tickets) {
+                open_tickets.push_back(ticket);
+            }
+        }
+
+        for (const std::uint64_t ticket: open_tickets) {
+            _server.cancel(ticket);
+        }
+    }
+
+    void analysis_session::handle_line(std::string_view line) {
+        if (line.find_first_not_of(" \t\r") == std::string_view::npos) {
+            return;
+        }
+
+        const std::optional<json_object> request {parse_json_object(line)};
+
+        if (!request.has_value()) {
+            write(error_json(std::nullopt, "request is not a flat JSON object"));
+            return;
+        }
+
+        if (is_true(*request, "stats")) {
+            const latency_percentiles latencies {_server.latencies()};
+
+            write("{\"stats\":{\"responses\":" + std::to_string(latencies.responses) +
+                  ",\"pending\":" + std::to_string(_server.pending()) +
+                  ",\"p50_us\":" + std::to_string(latencies.p50.count()) +
+                  ",\"p90_us\":" + std::to_string(latencies.p90.count()) +
+                  ",\"p99_us\":" + std::to_string(latencies.p99.count()) +
+                  ",\"max_us\":" + std::to_string(latencies.max.count()) + "}}");
+            return;
+        }
+
+        const auto id_field {request->find("id")};
+
+        if (id_field == request->end() || !id_field->second.is_string) {
+            write(error_json(std::nullopt, "request has no string id"));
+            return;
+        }
+
+        const std::string id {id_field->second.text};
+
+        if (is_true(*request, "cancel")) {
+            std::optional<std::uint64_t> ticket {};
+
+            {
+                const std::lock_guard<std::mutex> lock {_mutex};
+                const auto open {_tickets.find(id)};
+
+                if (open != _tickets.end()) {
+                    ticket = open->second;
+                }
+            }
+
+            // The cancelled request is answered through its own response
+            if (!ticket.has_value() || !_server.cancel(*ticket)) {
+                write(error_json(id, "no open request with this id"));
+            }
+
+            return;
+        }
+
+        const auto fen_field {request->find("fen")};
+
+        if (fen_field == request->end() || !fen_field->second.is_string) {
+            write(error_json(id, "request has no fen"));
+            return;
+        }
+
+        const auto board {bitboard::from_fen(fen_field->second.text)};
+
+        if (!board.has_value()) {
+            write(error_json(id, "invalid fen: " + board.error().to_string()));
+            return;
+        }
+
+        bool invalid_limit {false};
+        const std::optional<std::uint64_t> depth {number_field(*request, "depth", invalid_limit)};
+        const std::optional<std::uint64_t> nodes {number_field(*request, "nodes", invalid_limit)};
+        const std::optional<std::uint64_t> move_time {
+            number_field(*request, "movetime", invalid_limit)};
+
+        if (invalid_limit || depth.value_or(0) > max_search_ply) {
+            write(error_json(id, "limits must be non negative integers, depth at most " +
+                                     std::to_string(max_search_ply)));
+            return;
+        }
+
+        search_limits limits {};
+
+        limits.depth = depth.transform([](std::uint64_t value) { return static_cast<int>(value); });
+        limits.nodes = nodes;
+        limits.move_time = move_time.transform(
+            [](std::uint64_t value) { return std::chrono::milliseconds {value}; });
+
+        // Held across `submit`, so that a quick response finds its id recorded
+        const std::lock_guard<std::mutex> lock {_mutex};
+
+        if (_tickets.contains(id)) {
+            write(error_json(id, "a request with this id is still open"));
+            return;
+        }
+
+        _tickets.emplace(id, _server.submit(*board, limits,
+                                            [this, id](const analysis_response& response) {
+                                                write(response_json(id, response));
+
+                                                const std::lock_guard<std::mutex> lock {_mutex};
+                                                _tickets.erase(id);
+                                                _answered.notify_all();
+                                            }));
+    }
+
+    void analysis_session::wait() {
+        std::unique_lock<std::mutex> lock {_mutex};
+
+        _answered.wait(lock, [this]() { return _tickets.empty(); });
+    }
+
+    void analysis_session::write(std::string_view line) {
+        const std::lock_guard<std::mutex> lock {_write_mutex};
+
+        _write_line(line);
+    }
+} // namespace esochess
@@ -0,0 +1,112 @@
+#include <array>
+#include <cstddef>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "headers/attacks.hpp"
+#include "headers/bitboard.hpp"
+
+namespace esochess {
+#if defined(__AVX2__)
+    namespace {
+        // Four directions side by side. Each lane shifts one way only, the other count is 64,
+        // which shifts everything out.
+        struct direction_lanes {
+            __m256i right_shifts;
+            __m256i left_shifts;
+            __m256i landing;
+        };
+
+        direction_lanes lanes_of(const std::array<bitboard::Direction, 4>& directions) {
+            std::array<long long, 4> right_shifts {};
+            std::array<long long, 4> left_shifts {};
+            std::array<long long, 4> landing {};
+
+            for (std::size_t lane {}; lane < directions.size(); lane++) {
+                const auto direction_index {static_cast<std::size_t>(directions.at(lane))};
+                const auto& [x_offset, y_offset] {
+                    attack_tables::direction_offsets.at(direction_index)};
+                const int shift {x_offset + 8 * y_offset};
+
+                right_shifts.at(lane) = shift > 0 ? shift : 64;
+                left_shifts.at(lane) = shift < 0 ? -shift : 64;
+                landing.at(lane) =
+                    static_cast<long long>(attack_tables::landing_squares.at(direction_index));
+            }
+
+            const auto load {[](const std::array<long long, 4>& values) {
+                return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values.data()));
+            }};
+
+            return direction_lanes {load(right_shifts), load(left_shifts), load(landing)};
+        }
+
+        __m256i shifted(__m256i bits, __m256i right_shifts, __m256i left_shifts) {
+            return _mm256_or_si256(_mm256_srlv_epi64(bits, right_shifts),
+                                   _mm256_sllv_epi64(bits, left_shifts));
+        }
+
+        // `fill_attacks` for the four directions of `lanes` at once
+        __m256i fill_attacks(__m256i sliders, __m256i empty, const direction_lanes& lanes) {
+            __m256i right_shifts {lanes.right_shifts};
+            __m256i left_shifts {lanes.left_shifts};
+            __m256i propagators {_mm256_and_si256(empty, lanes.landing)};
+
+            for (int distance {1}; distance < 8; distance *= 2) {
+                sliders = _mm256_or_si256(
+                    sliders,
+                    _mm256_and_si256(propagators, shifted(sliders, right_shifts, left_shifts)));
+                propagators = _mm256_and_si256(propagators,
+                                               shifted(propagators, right_shifts, left_shifts));
+                right_shifts = _mm256_add_epi64(right_shifts, right_shifts);
+                left_shifts = _mm256_add_epi64(left_shifts, left_shifts);
+            }
+
+            return _mm256_and_si256(shifted(sliders, lanes.right_shifts, lanes.left_shifts),
+                                    lanes.landing);
+        }
+
+        bitboard::bit_representation union_of_lanes(__m256i bits) {
+            const __m128i halves {_mm_or_si128(_mm256_castsi256_si128(bits),
+                                               _mm256_extracti128_si256(bits, 1))};
+
+            return static_cast<bitboard::bit_representation>(
+                _mm_cvtsi128_si64(_mm_or_si128(halves, _mm_unpackhi_epi64(halves, halves))));
+        }
+    } // namespace
+
+    bitboard::bit_representation slider_attacks(bitboard::bit_representation diagonal_sliders,
+                                                bitboard::bit_representation straight_sliders,
+                                                bitboard::bit_representation occupancy) {
+        static const direction_lanes diagonal_lanes {
+            lanes_of(bitboard::pieces::bishop_directions)};
+        static const direction_lanes straight_lanes {lanes_of(bitboard::pieces::rook_directions)};
+
+        const __m256i empty {_mm256_set1_epi64x(static_cast<long long>(~occupancy))};
+        const __m256i diagonal_attacks {fill_attacks(
+            _mm256_set1_epi64x(static_cast<long long>(diagonal_sliders)), empty, diagonal_lanes)};
+        const __m256i straight_attacks {fill_attacks(
+            _mm256_set1_epi64x(static_cast<long long>(straight_sliders)), empty, straight_lanes)};
+
+        return union_of_lanes(_mm256_or_si256(diagonal_attacks, straight_attacks));
+    }
+#else
+    bitboard::bit_representation slider_attacks(bitboard::bit_representation diagonal_sliders,
+                                                bitboard::bit_representation straight_sliders,
+                                                bitboard::bit_representation occupancy) {
+        bitboard::bit_representation attacks {0};
+
+        for (const bitboard::Direction direction: bitboard::pieces::bishop_directions) {
+            attacks |= fill_attacks(direction, diagonal_sliders, occupancy);
+        }
+
+        for (const bitboard::Direction direction: bitboard::pieces::rook_directions) {
+            attacks |= fill_attacks(direction, straight_sliders, occupancy);
+        }
+
+        return attacks;
+    }
+#endif
+} // namespace esochess
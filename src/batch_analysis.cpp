@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "headers/batch_analysis.hpp"
+#include "headers/bitboard.hpp"
+#include "headers/san.hpp"
+#include "headers/search.hpp"
+
+namespace esochess {
+    namespace {
+        // EPD centipawn evaluations give a mate in n plies as 32767 - n
+        constexpr int epd_mate_score {32767};
+
+        struct analysis_job {
+            std::size_t sequence;
+            std::string line;
+        };
+
+        struct analysed_line {
+            std::string epd;
+            std::uint64_t nodes;
+            bool valid;
+        };
+
+        std::string score_operations(int score) {
+            if (!is_mate_score(score)) {
+                return " ce " + std::to_string(score) + ';';
+            }
+
+            const int plies_to_mate {score > 0 ? mate_score - score : mate_score + score};
+            const std::string centipawns {
+                std::to_string(score > 0 ? epd_mate_score - plies_to_mate
+                                         : plies_to_mate - epd_mate_score)};
+
+            return score > 0 ? " ce " + centipawns + "; dm " +
+                                   std::to_string((plies_to_mate + 1) / 2) + ';'
+                             : " ce " + centipawns + ';';
+        }
+
+        analysed_line analyse_line(search_engine& engine, std::string_view line,
+                                   const search_limits& limits) {
+            const auto board {bitboard::from_epd(line)};
+
+            if (!board.has_value()) {
+                return analysed_line {
+                    std::string {line} + " c0 \"" + board.error().to_string() + "\";", 0, false};
+            }
+
+            engine.clear();
+
+            const search_result result {engine.search(*board, {}, limits)};
+            bitboard position {board->position_copy()};
+            std::string epd {board->to_epd()};
+
+            if (result.best_move.has_value()) {
+                epd += " bm " + move_to_san(position, *result.best_move) + ';';
+            }
+
+            epd += score_operations(result.score) + " acd " + std::to_string(result.depth) +
+                   "; acn " + std::to_string(result.statistics.nodes) + ';';
+
+            if (!result.lines.empty() && !result.lines.front().principal_variation.empty()) {
+                epd += " pv";
+
+                for (const bitboard::move& chess_move: result.lines.front().principal_variation) {
+                    epd += ' ' + move_to_san(position, chess_move);
+                    position = position.position_copy();
+                    position.make_move(chess_move);
+                }
+
+                epd += ';';
+            }
+
+            return analysed_line {epd, result.statistics.nodes, true};
+        }
+    } // namespace
+
+    batch_analysis_statistics analyse_positions(std::istream& input, std::ostream& output,
+                                                const batch_analysis_options& options) {
+        const std::size_t worker_count {std::max<std::size_t>(options.thread_count, 1)};
+        const std::size_t window {std::max(options.window, worker_count)};
+
+        std::mutex mutex {};
+        std::condition_variable job_available {};
+        std::condition_variable window_available {};
+        std::deque<analysis_job> jobs {};
+        std::vector<std::optional<std::string>> finished(window); // By sequence modulo window
+        std::size_t next_to_write {0};
+        bool input_done {false};
+        batch_analysis_statistics statistics {0, 0, 0};
+
+        // Writes every result that no earlier position is still holding back, under the lock
+        const auto write_finished {[&]() {
+            for (std::optional<std::string>* result {&finished.at(next_to_write % window)};
+                 result->has_value(); result = &finished.at(next_to_write % window)) {
+                output << **result << '\n';
+                result->reset();
+                next_to_write++;
+            }
+        }};
+
+        {
+            std::vector<std::jthread> workers;
+
+            for (std::size_t worker {}; worker < worker_count; worker++) {
+                workers.emplace_back([&]() {
+                    search_engine engine {options.hash_megabytes};
+                    std::unique_lock<std::mutex> lock {mutex};
+
+                    while (true) {
+                        job_available.wait(lock, [&]() { return !jobs.empty() || input_done; });
+
+                        if (jobs.empty()) {
+                            return;
+                        }
+
+                        const analysis_job job {std::move(jobs.front())};
+                        jobs.pop_front();
+                        lock.unlock();
+
+                        analysed_line analysed {analyse_line(engine, job.line, options.limits)};
+
+                        lock.lock();
+                        statistics.positions += analysed.valid ? 1 : 0;
+                        statistics.invalid_lines += analysed.valid ? 0 : 1;
+                        statistics.nodes += analysed.nodes;
+                        finished.at(job.sequence % window) = std::move(analysed.epd);
+                        write_finished();
+                        window_available.notify_one();
+                    }
+                });
+            }
+
+            std::string line {};
+            std::size_t sequence {0};
+
+            while (std::getline(input, line)) {
+                if (!line.empty() && line.back() == '\r') {
+                    line.pop_back();
+                }
+
+                if (line.find_first_not_of(" \t") == std::string::npos) {
+                    continue;
+                }
+
+                std::unique_lock<std::mutex> lock {mutex};
+
+                window_available.wait(lock, [&]() { return sequence - next_to_write < window; });
+                jobs.push_back(analysis_job {sequence++, std::move(line)});
+                job_available.notify_one();
+            }
+
+            {
+                const std::lock_guard<std::mutex> lock {mutex};
+                input_done = true;
+            }
+
+            job_available.notify_all();
+        }
+
+        output.flush();
+
+        return statistics;
+    }
+} // namespace esochess
@@ -0,0 +1,51 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+#include "headers/bench.hpp"
+#include "headers/bitboard.hpp"
+#include "headers/search.hpp"
+#include "headers/uci.hpp"
+
+namespace esochess {
+    bench_result run_bench(int depth, std::ostream& output, const search_parameters& parameters) {
+        using clock = std::chrono::steady_clock;
+
+        search_engine engine {uci_engine::default_hash_megabytes};
+        bench_result result {0, std::chrono::milliseconds {0}};
+        search_limits limits {};
+
+        limits.depth = depth;
+        engine.set_parameters(parameters);
+
+        for (std::size_t index {}; index < bench_positions.size(); index++) {
+            const bitboard board {bitboard::from_fen(bench_positions.at(index)).value()};
+
+            engine.clear();
+
+            const clock::time_point start {clock::now()};
+            const search_result search {engine.search(board, {}, limits)};
+            const auto time {
+                std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - start)};
+
+            output << "Position " << index + 1 << '/' << bench_positions.size() << ": "
+                   << bench_positions.at(index) << "\n  bestmove "
+                   << (search.best_move.has_value() ? move_to_uci(*search.best_move) : "0000")
+                   << " nodes " << search.statistics.nodes << " time " << time.count() << "ms\n";
+
+            result.nodes += search.statistics.nodes;
+            result.time += time;
+        }
+
+        const std::uint64_t milliseconds {
+            static_cast<std::uint64_t>(std::max<std::int64_t>(result.time.count(), 1))};
+
+        output << "\nTotal time (ms) : " << result.time.count()
+               << "\nNodes searched  : " << result.nodes
+               << "\nNodes/second    : " << result.nodes * 1000 / milliseconds << '\n';
+
+        return result;
+    }
+} // namespace esochess
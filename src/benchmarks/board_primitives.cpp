@@ -0,0 +1,380 @@
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <headers/attacks.hpp>
+#include <headers/bitboard.hpp>
+#include <headers/board_batch.hpp>
+#include <headers/move_generation.hpp>
+#include <headers/uci.hpp>
+
+namespace {
+    using clock = std::chrono::steady_clock;
+
+    constexpr std::string_view kiwipete_fen {
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1"};
+    constexpr std::string_view en_passant_fen {
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3"};
+    constexpr std::string_view promotion_fen {
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"};
+
+    constexpr std::chrono::nanoseconds minimum_sample_duration {std::chrono::milliseconds {5}};
+
+    struct benchmark_options {
+        std::size_t samples;
+        std::string filter;
+    };
+
+    struct benchmark_result { // Timings are per operation
+        std::string name;
+        std::uint64_t iterations_per_sample;
+        double min_ns;
+        double median_ns;
+        double mean_ns;
+        double max_ns;
+        double stddev_ns;
+    };
+
+    // Results are folded into a volatile so the timed operations are not optimized away
+    volatile std::uint64_t sink {};
+
+    template <typename T>
+    void keep(const T& value) {
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T>) {
+            sink = sink + static_cast<std::uint64_t>(value);
+        }
+
+        else {
+            sink = sink + static_cast<std::uint64_t>(sizeof(value));
+            asm volatile("" : : "g"(&value) : "memory");
+        }
+    }
+
+    template <typename Operation>
+    double time_iterations(Operation& operation, std::uint64_t iterations) {
+        const clock::time_point start {clock::now()};
+
+        for (std::uint64_t iteration {}; iteration < iterations; iteration++) {
+            operation();
+        }
+
+        return std::chrono::duration<double, std::nano> {clock::now() - start}.count();
+    }
+
+    // Doubles the iteration count during warm up until a sample takes long enough to time, then
+    // times `options.samples` samples of that many iterations
+    template <typename Operation>
+    std::optional<benchmark_result> run_benchmark(const benchmark_options& options,
+                                                  std::string_view name, Operation operation) {
+        if (name.find(options.filter) == std::string_view::npos) {
+            return std::nullopt;
+        }
+
+        std::uint64_t iterations {1};
+
+        while (time_iterations(operation, iterations) <
+               static_cast<double>(minimum_sample_duration.count())) {
+            iterations *= 2;
+        }
+
+        std::vector<double> sample_ns {};
+
+        for (std::size_t sample {}; sample < options.samples; sample++) {
+            sample_ns.push_back(time_iterations(operation, iterations) /
+                                static_cast<double>(iterations));
+        }
+
+        std::ranges::sort(sample_ns);
+
+        const double mean {std::accumulate(sample_ns.begin(), sample_ns.end(), 0.0) /
+                           static_cast<double>(sample_ns.size())};
+        const double variance {std::accumulate(sample_ns.begin(), sample_ns.end(), 0.0,
+                                               [mean](double sum, double value) {
+                                                   return sum + (value - mean) * (value - mean);
+                                               }) /
+                               static_cast<double>(sample_ns.size())};
+        const std::size_t middle {sample_ns.size() / 2};
+        const double median {sample_ns.size() % 2 == 1
+                                 ? sample_ns.at(middle)
+                                 : (sample_ns.at(middle - 1) + sample_ns.at(middle)) / 2};
+
+        return benchmark_result {std::string {name}, iterations,      sample_ns.front(), median,
+                                 mean,               sample_ns.back(), std::sqrt(variance)};
+    }
+
+    std::string json_escaped(std::string_view text) {
+        std::string escaped {};
+
+        for (const char letter: text) {
+            if (letter == '"' || letter == '\\') {
+                escaped += '\\';
+            }
+
+            escaped += letter;
+        }
+
+        return escaped;
+    }
+
+    void write_json(std::ostream& output, const benchmark_options& options,
+                    const std::vector<benchmark_result>& results) {
+        output << "{\n  \"benchmark\": \"board_primitives\",\n  \"samples\": " << options.samples
+               << ",\n  \"unit\": \"ns\",\n  \"results\": [\n";
+
+        for (std::size_t index {}; index < results.size(); index++) {
+            const benchmark_result& result {results.at(index)};
+
+            output << "    {\"name\": \"" << json_escaped(result.name)
+                   << "\", \"iterations_per_sample\": " << result.iterations_per_sample
+                   << ", \"min\": " << result.min_ns << ", \"median\": " << result.median_ns
+                   << ", \"mean\": " << result.mean_ns << ", \"max\": " << result.max_ns
+                   << ", \"stddev\": " << result.stddev_ns << '}'
+                   << (index + 1 < results.size() ? ",\n" : "\n");
+        }
+
+        output << "  ]\n}\n";
+    }
+
+    void write_table(std::ostream& output, const std::vector<benchmark_result>& results) {
+        output << std::left << std::setw(44) << "benchmark" << std::right << std::setw(12)
+               << "median ns" << std::setw(12) << "mean ns" << std::setw(12) << "min ns"
+               << std::setw(12) << "stddev ns" << '\n';
+
+        for (const benchmark_result& result: results) {
+            output << std::left << std::setw(44) << result.name << std::right << std::fixed
+                   << std::setprecision(1) << std::setw(12) << result.median_ns << std::setw(12)
+                   << result.mean_ns << std::setw(12) << result.min_ns << std::setw(12)
+                   << result.stddev_ns << '\n';
+        }
+    }
+
+    esochess::bitboard board_from_fen(std::string_view fen) {
+        return esochess::bitboard::from_fen(fen).value();
+    }
+
+    template <typename Move>
+    Move first_legal_move(std::string_view fen, const std::vector<Move>& (*moves_of_type)(
+                                                    const esochess::bitboard::moves_listing&)) {
+        esochess::bitboard board {board_from_fen(fen)};
+        const esochess::bitboard::moves_listing moves {board.legal_moves()};
+
+        return moves_of_type(moves).front();
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    using esochess::bitboard;
+
+    std::vector<std::string_view> arguments {argv + 1, argv + argc};
+    benchmark_options options {15, ""};
+    std::optional<std::string> json_path {};
+
+    for (std::size_t index {}; index < arguments.size(); index++) {
+        const bool has_value {index + 1 < arguments.size()};
+
+        if (arguments.at(index) == "--samples" && has_value &&
+            esochess::parse_integer(arguments.at(index + 1), 1, 1 << 20).has_value()) {
+            options.samples =
+                static_cast<std::size_t>(*esochess::parse_integer(arguments.at(++index)));
+        }
+
+        else if (arguments.at(index) == "--filter" && has_value) {
+            options.filter = arguments.at(++index);
+        }
+
+        else if (arguments.at(index) == "--json") { // `-` or no path writes to standard output
+            json_path = has_value && !arguments.at(index + 1).starts_with("--")
+                            ? std::string {arguments.at(++index)}
+                            : std::string {"-"};
+        }
+
+        else {
+            std::cerr << "Usage: " << argv [0]
+                      << " [--samples N] [--filter substring] [--json [path|-]]\n";
+            return 1;
+        }
+    }
+
+    const bitboard kiwipete {board_from_fen(kiwipete_fen)};
+    const bitboard en_passant_board {board_from_fen(en_passant_fen)};
+    const bitboard promotion_board {board_from_fen(promotion_fen)};
+
+    const bitboard::move_normal normal_move {first_legal_move<bitboard::move_normal>(
+        kiwipete_fen, [](const bitboard::moves_listing& moves) -> const auto& {
+            return moves.normal_moves;
+        })};
+    const bitboard::move_castle castle_move {first_legal_move<bitboard::move_castle>(
+        kiwipete_fen, [](const bitboard::moves_listing& moves) -> const auto& {
+            return moves.castle_moves;
+        })};
+    const bitboard::move_en_passant en_passant_move {first_legal_move<bitboard::move_en_passant>(
+        en_passant_fen, [](const bitboard::moves_listing& moves) -> const auto& {
+            return moves.en_passant_moves;
+        })};
+    const bitboard::move_promotion promotion_move {first_legal_move<bitboard::move_promotion>(
+        promotion_fen, [](const bitboard::moves_listing& moves) -> const auto& {
+            return moves.promotion_moves;
+        })};
+
+    const bitboard::bit_representation e4_bits {bitboard::cordinate {"e4"}.to_bit_representation()};
+    const bitboard::cordinate e4_cordinate {"e4"};
+    const bitboard::bit_representation occupancy {kiwipete.bitboard_bitor_accumulation(
+                                                      bitboard::Turn::White) |
+                                                  kiwipete.bitboard_bitor_accumulation(
+                                                      bitboard::Turn::Black)};
+    std::array<char, bitboard::max_fen_length> fen_buffer {};
+    std::size_t square {0};
+
+    std::vector<benchmark_result> results {};
+
+    const auto add {[&](std::string_view name, auto operation) {
+        if (std::optional<benchmark_result> result {run_benchmark(options, name, operation)}) {
+            results.push_back(std::move(*result));
+        }
+    }};
+
+    add("piece_at_square(bit_representation)", [&]() {
+        keep(kiwipete.piece_at_square(std::uint64_t {1} << (square++ % 64)).bitboard_index);
+    });
+    add("piece_at_square(cordinate)", [&]() {
+        const int index {static_cast<int>(square++ % 64)};
+        keep(kiwipete.piece_at_square(bitboard::cordinate {index % 8, index / 8}).bitboard_index);
+    });
+    add("color_at_square(bit_representation)", [&]() {
+        keep(kiwipete.color_at_square(std::uint64_t {1} << (square++ % 64)));
+    });
+    add("color_at_square(cordinate)", [&]() {
+        const int index {static_cast<int>(square++ % 64)};
+        keep(kiwipete.color_at_square(bitboard::cordinate {index % 8, index / 8}));
+    });
+
+    // Each move is made on a fresh copy, so the copy is timed on its own as a baseline
+    add("bitboard copy (make_move baseline)", [&]() { keep(kiwipete.position_copy()); });
+    add("bitboard::position copy", [&]() { keep(bitboard::position {kiwipete.as_position()}); });
+    add("make_move(move_normal)", [&]() { keep(kiwipete.position_copy().make_move(normal_move)); });
+    add("make_move(move_castle)", [&]() { keep(kiwipete.position_copy().make_move(castle_move)); });
+    add("make_move(move_en_passant)",
+        [&]() { keep(en_passant_board.position_copy().make_move(en_passant_move)); });
+    add("make_move(move_promotion)",
+        [&]() { keep(promotion_board.position_copy().make_move(promotion_move)); });
+    add("make_move(move)",
+        [&]() { keep(kiwipete.position_copy().make_move(bitboard::move {normal_move})); });
+
+    add("cordinate(string)", [&]() { keep(bitboard::cordinate {"e4"}.pos_x()); });
+    add("cordinate(bit_representation)", [&]() { keep(bitboard::cordinate {e4_bits}.pos_y()); });
+    add("cordinate::to_bit_representation", [&]() { keep(e4_cordinate.to_bit_representation()); });
+    add("cordinate::to_string", [&]() { keep(e4_cordinate.to_string().size()); });
+    add("cordinate::to_fancy_string", [&]() { keep(e4_cordinate.to_fancy_string().size()); });
+    add("cordinate_from_bit_representation",
+        [&]() { keep(bitboard::cordinate_from_bit_representation(occupancy).size()); });
+
+    add("from_fen", [&]() { keep(bitboard::from_fen(kiwipete_fen)->fullmove_number()); });
+    add("write_fen", [&]() { keep(kiwipete.write_fen(fen_buffer)); });
+    add("to_fen", [&]() { keep(kiwipete.to_fen().size()); });
+
+    add("bitboard_bitor_accumulation",
+        [&]() { keep(kiwipete.bitboard_bitor_accumulation(bitboard::Turn::White)); });
+
+    // A side's slider attacks, per square lookups against the set wise fills
+    const std::array<bitboard::bit_representation, 12> kiwipete_bitboards {kiwipete.bitboards()};
+    const bitboard::bit_representation diagonal_sliders {kiwipete_bitboards.at(2) |
+                                                         kiwipete_bitboards.at(4)};
+    const bitboard::bit_representation straight_sliders {kiwipete_bitboards.at(3) |
+                                                         kiwipete_bitboards.at(4)};
+
+    add("bishop_attacks + rook_attacks (per square)", [&]() {
+        bitboard::bit_representation attacks {0};
+
+        for (bitboard::bit_representation bits {diagonal_sliders}; bits != 0;
+             bits = esochess::without_lowest_square(bits)) {
+            attacks |= esochess::bishop_attacks(esochess::square_index(bits), occupancy);
+        }
+
+        for (bitboard::bit_representation bits {straight_sliders}; bits != 0;
+             bits = esochess::without_lowest_square(bits)) {
+            attacks |= esochess::rook_attacks(esochess::square_index(bits), occupancy);
+        }
+
+        keep(attacks);
+    });
+    add("slider_attacks (set wise)", [&]() {
+        keep(esochess::slider_attacks(diagonal_sliders, straight_sliders, occupancy));
+    });
+
+    const auto add_generator {[&](std::string_view name, const bitboard& source, auto generator) {
+        add(name, [&source, generator]() {
+            bitboard board {source.position_copy()};
+            bitboard::moves_listing moves {};
+            generator(board, moves);
+            keep(moves.normal_moves.size() + moves.castle_moves.size() +
+                 moves.en_passant_moves.size() + moves.promotion_moves.size());
+        });
+    }};
+
+    add_generator("add_pawn_moves", kiwipete, esochess::add_pawn_moves);
+    add_generator("add_pawn_en_passant_moves", en_passant_board,
+                  esochess::add_pawn_en_passant_moves);
+    add_generator("add_pawn_promotion_moves", promotion_board, esochess::add_pawn_promotion_moves);
+    add_generator("add_king_moves", kiwipete, esochess::add_king_moves);
+    add_generator("add_king_castle_moves", kiwipete, esochess::add_king_castle_moves);
+    add_generator("add_rook_bishop_queen_moves", kiwipete, esochess::add_rook_bishop_queen_moves);
+    add_generator("add_knight_moves", kiwipete, esochess::add_knight_moves);
+    add_generator("add_bishop_moves", kiwipete,
+                  [](bitboard& board, bitboard::moves_listing& moves) {
+                      esochess::add_bishop_moves(board, moves, bitboard::cordinate {"e2"});
+                  });
+    add_generator("add_rook_moves", kiwipete, [](bitboard& board, bitboard::moves_listing& moves) {
+        esochess::add_rook_moves(board, moves, bitboard::cordinate {"a1"});
+    });
+    add_generator("add_queen_moves", kiwipete, [](bitboard& board, bitboard::moves_listing& moves) {
+        esochess::add_queen_moves(board, moves, bitboard::cordinate {"f3"});
+    });
+
+    // Four boards of both colours, generated one at a time as the baseline and then as a batch
+    const std::array<bitboard, esochess::board_batch::width> batch_boards {
+        kiwipete, en_passant_board, promotion_board,
+        board_from_fen("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R b KQkq - 0 1")};
+    const esochess::board_batch batch {batch_boards};
+    std::array<std::vector<bitboard::move>, esochess::board_batch::width> batch_moves {};
+
+    add("available_moves x4 (board_batch baseline)", [&]() {
+        for (const bitboard& source: batch_boards) {
+            bitboard board {source.position_copy()};
+            keep(board.available_moves().normal_moves.size());
+        }
+    });
+    add("board_batch(span)", [&]() { keep(esochess::board_batch {batch_boards}.size()); });
+    add("board_batch::count_moves", [&]() { keep(batch.count_moves().front()); });
+    add("board_batch::generate_moves", [&]() {
+        batch.generate_moves(batch_moves);
+        keep(batch_moves.front().size());
+    });
+
+    if (!json_path.has_value()) {
+        write_table(std::cout, results);
+    }
+
+    else if (*json_path == "-") {
+        write_json(std::cout, options, results);
+    }
+
+    else {
+        std::ofstream json_file {*json_path};
+        write_json(json_file, options, results);
+        std::cout << "Wrote " << results.size() << " results to " << *json_path << '\n';
+    }
+}
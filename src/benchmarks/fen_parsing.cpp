@@ -0,0 +1,58 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string_view>
+
+#include <headers/bitboard.hpp>
+
+namespace {
+    constexpr std::array<std::string_view, 6> benchmark_positions {
+        esochess::bitboard::starting_position_fen,
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10"};
+
+    constexpr std::size_t iterations {200'000};
+} // namespace
+
+int main() {
+    using clock = std::chrono::steady_clock;
+
+    std::size_t checksum {0};
+
+    const clock::time_point parse_start {clock::now()};
+
+    for (std::size_t iteration {}; iteration < iterations; iteration++) {
+        const auto board {esochess::bitboard::from_fen(
+            benchmark_positions [iteration % benchmark_positions.size()])};
+        checksum += static_cast<std::size_t>(board->fullmove_number());
+    }
+
+    const std::chrono::duration<double> parse_duration {clock::now() - parse_start};
+
+    std::array<esochess::bitboard, benchmark_positions.size()> boards {};
+
+    for (std::size_t index {}; index < boards.size(); index++) {
+        boards.at(index) = esochess::bitboard::from_fen(benchmark_positions.at(index)).value();
+    }
+
+    std::array<char, esochess::bitboard::max_fen_length> buffer {};
+
+    const clock::time_point serialize_start {clock::now()};
+
+    for (std::size_t iteration {}; iteration < iterations; iteration++) {
+        checksum += boards [iteration % boards.size()].write_fen(buffer);
+    }
+
+    const std::chrono::duration<double> serialize_duration {clock::now() - serialize_start};
+
+    std::cout << "Parsed " << iterations << " positions in " << parse_duration.count() << "s ("
+              << static_cast<double>(iterations) / parse_duration.count() << " positions/sec)\n";
+    std::cout << "Serialized " << iterations << " positions in " << serialize_duration.count()
+              << "s (" << static_cast<double>(iterations) / serialize_duration.count()
+              << " positions/sec)\n";
+    std::cout << "Checksum: " << checksum << '\n';
+}
@@ -0,0 +1,151 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <headers/bench.hpp>
+#include <headers/bitboard.hpp>
+#include <headers/platform.hpp>
+#include <headers/search.hpp>
+#include <headers/uci.hpp>
+
+namespace {
+    using clock = std::chrono::steady_clock;
+    using PageSize = esochess::transposition_table::PageSize;
+
+    constexpr std::size_t random_accesses {20'000'000};
+
+    // Huge pages backing anonymous memory of the whole process, as the kernel reports them
+    std::string anonymous_huge_pages() {
+        std::ifstream rollup {"/proc/self/smaps_rollup"};
+
+        for (std::string line {}; std::getline(rollup, line);) {
+            if (line.starts_with("AnonHugePages:")) {
+                return line.substr(line.find_first_not_of(' ', 14));
+            }
+        }
+
+        return "unknown";
+    }
+
+    std::string_view page_size_name(PageSize page_size) {
+        return page_size == PageSize::Huge ? "huge pages" : "default pages";
+    }
+
+    // Probes and stores at random entries, which misses the TLB on nearly every access once the
+    // table is much larger than the TLB reach
+    void benchmark_random_accesses(std::size_t megabytes, PageSize page_size) {
+        const clock::time_point allocation_start {clock::now()};
+        esochess::transposition_table table {megabytes, page_size};
+        const std::chrono::duration<double> allocation_duration {clock::now() -
+                                                                 allocation_start};
+        const std::string huge_pages {anonymous_huge_pages()};
+
+        const clock::time_point clear_start {clock::now()};
+        table.clear();
+        const std::chrono::duration<double> clear_duration {clock::now() - clear_start};
+
+        std::mt19937_64 random_engine {megabytes};
+        std::uint64_t hits {0};
+        const clock::time_point access_start {clock::now()};
+
+        for (std::size_t access {}; access < random_accesses; access++) {
+            const std::uint64_t hash {random_engine()};
+
+            if (table.probe(hash).has_value()) {
+                hits++;
+            }
+
+            else {
+                table.store(hash, 0, 0, 1, esochess::transposition_table::Bound::Exact);
+            }
+        }
+
+        const std::chrono::duration<double> access_duration {clock::now() - access_start};
+
+        std::cout << megabytes << " MB, " << page_size_name(page_size)
+                  << (table.advised_huge_pages() ? " (advised)" : "") << ": allocated in "
+                  << allocation_duration.count() << "s, cleared in " << clear_duration.count()
+                  << "s, AnonHugePages " << huge_pages << ", "
+                  << static_cast<double>(random_accesses) / access_duration.count() / 1e6
+                  << "M random probes/sec (" << hits << " hits)\n";
+    }
+
+    void benchmark_search(std::size_t megabytes, PageSize page_size, int depth) {
+        esochess::search_engine engine {1};
+        esochess::search_limits limits {};
+        std::uint64_t nodes {0};
+        std::chrono::duration<double> duration {};
+
+        engine.set_hash_size(megabytes, page_size);
+        limits.depth = depth;
+
+        for (const std::string_view fen: esochess::bench_positions) {
+            const esochess::bitboard board {esochess::bitboard::from_fen(fen).value()};
+
+            engine.clear();
+
+            const clock::time_point start {clock::now()};
+            const esochess::search_result result {engine.search(board, {}, limits)};
+
+            duration += clock::now() - start;
+            nodes += result.statistics.nodes;
+        }
+
+        std::cout << megabytes << " MB, " << page_size_name(page_size) << ": " << nodes
+                  << " nodes in " << duration.count() << "s ("
+                  << static_cast<double>(nodes) / duration.count() << " nps)\n";
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::size_t> sizes {};
+    int depth {7};
+
+    for (int index {1}; index < argc; index++) {
+        const std::string_view argument {argv [index]};
+        const std::optional<std::int64_t> number {
+            argument == "--depth" && index + 1 < argc
+                ? esochess::parse_integer(argv [++index], 1, esochess::max_search_ply)
+                : esochess::parse_integer(argument, 1, 1 << 20)};
+
+        if (!number.has_value()) {
+            std::cerr << "Usage: " << argv [0] << " [MB]... [--depth N]\n";
+            return 1;
+        }
+
+        if (argument == "--depth") {
+            depth = static_cast<int>(*number);
+        }
+
+        else {
+            sizes.push_back(static_cast<std::size_t>(*number));
+        }
+    }
+
+    if (sizes.empty()) {
+        sizes = {16, 1024};
+    }
+
+    std::cout << "Transposition table random accesses\n";
+
+    for (const std::size_t megabytes: sizes) {
+        for (const PageSize page_size: {PageSize::Default, PageSize::Huge}) {
+            benchmark_random_accesses(megabytes, page_size);
+        }
+    }
+
+    std::cout << "Bench positions searched to depth " << depth << '\n';
+
+    for (const std::size_t megabytes: sizes) {
+        for (const PageSize page_size: {PageSize::Default, PageSize::Huge}) {
+            benchmark_search(megabytes, page_size, depth);
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include <headers/bitboard.hpp>
+#include <headers/packed_position.hpp>
+
+namespace {
+    constexpr std::array<std::string_view, 4> benchmark_positions {
+        esochess::bitboard::starting_position_fen,
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"};
+
+    constexpr std::size_t position_count {4'000'000};
+} // namespace
+
+int main(int argc, char** argv) {
+    using clock = std::chrono::steady_clock;
+
+    const std::string dataset_path {argc > 1 ? argv [1] : "/tmp/esochess_packed_benchmark.bin"};
+
+    std::array<esochess::packed_position, benchmark_positions.size()> packed_positions {};
+
+    for (std::size_t index {}; index < packed_positions.size(); index++) {
+        packed_positions.at(index) =
+            esochess::packed_position::from_bitboard(
+                esochess::bitboard::from_fen(benchmark_positions.at(index)).value())
+                .value();
+    }
+
+    const clock::time_point write_start {clock::now()};
+
+    {
+        auto writer {esochess::position_dataset_writer::create(dataset_path).value()};
+
+        for (std::size_t index {}; index < position_count; index++) {
+            writer.write(packed_positions [index % packed_positions.size()]);
+        }
+    }
+
+    const std::chrono::duration<double> write_duration {clock::now() - write_start};
+
+    const clock::time_point read_start {clock::now()};
+    const auto reader {esochess::position_dataset_reader::open(dataset_path).value()};
+    std::uint64_t checksum {0};
+
+    for (const esochess::packed_position& position: reader) {
+        checksum += position.to_bitboard().value().bitboards() [0];
+    }
+
+    const std::chrono::duration<double> read_duration {clock::now() - read_start};
+
+    std::cout << "Wrote " << position_count << " positions in " << write_duration.count() << "s ("
+              << static_cast<double>(position_count) / write_duration.count()
+              << " positions/sec)\n";
+    std::cout << "Read and unpacked " << reader.size() << " positions in " << read_duration.count()
+              << "s (" << static_cast<double>(reader.size()) / read_duration.count()
+              << " positions/sec)\n";
+    std::cout << "Checksum: " << checksum << '\n';
+}
@@ -0,0 +1,95 @@
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <headers/bitboard.hpp>
+#include <headers/pgn.hpp>
+#include <headers/san.hpp>
+
+namespace {
+    constexpr std::size_t game_count {2'000};
+    constexpr int max_plies_per_game {120};
+
+    // Writes random legal games and returns the xor of the hashes of every position reached
+    std::uint64_t write_random_games(const std::string& pgn_path, std::uint64_t& move_count) {
+        std::ofstream pgn_file {pgn_path};
+        std::mt19937_64 random_engine {20240601};
+        std::uint64_t hash_checksum {0};
+
+        for (std::size_t game {}; game < game_count; game++) {
+            esochess::bitboard board {esochess::bitboard::starting_position_fen};
+
+            pgn_file << "[Event \"Random game " << game + 1 << "\"]\n[Result \"*\"]\n\n";
+
+            for (int ply {}; ply < max_plies_per_game; ply++) {
+                const std::vector<esochess::bitboard::move> moves {
+                    board.legal_moves().flatten()};
+
+                if (moves.empty()) {
+                    break;
+                }
+
+                const esochess::bitboard::move chosen_move {
+                    moves.at(std::uniform_int_distribution<std::size_t> {0, moves.size() - 1}(
+                        random_engine))};
+
+                if (ply % 2 == 0) {
+                    pgn_file << ply / 2 + 1 << ". ";
+                }
+
+                pgn_file << esochess::move_to_san(board, chosen_move) << ' ';
+                board.make_move(chosen_move);
+
+                hash_checksum ^= board.hash();
+                move_count++;
+            }
+
+            pgn_file << "*\n\n";
+        }
+
+        return hash_checksum;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    using clock = std::chrono::steady_clock;
+
+    const std::string pgn_path {argc > 1 ? argv [1] : "/tmp/esochess_random_games.pgn"};
+    const std::size_t thread_count {std::max(1U, std::thread::hardware_concurrency())};
+
+    std::uint64_t generated_moves {0};
+    const std::uint64_t expected_checksum {write_random_games(pgn_path, generated_moves)};
+
+    const auto reader {esochess::pgn_reader::open(pgn_path).value()};
+
+    for (const std::size_t threads: {std::size_t {1}, thread_count}) {
+        std::vector<std::uint64_t> worker_checksums(threads);
+
+        const clock::time_point start {clock::now()};
+        const esochess::pgn_ingest_statistics statistics {
+            reader.replay(threads, [&worker_checksums](const esochess::pgn_move_visit& visit) {
+                worker_checksums [visit.worker_index] ^= visit.position_after.hash();
+            })};
+        const std::chrono::duration<double> duration {clock::now() - start};
+
+        std::uint64_t checksum {0};
+
+        for (const std::uint64_t worker_checksum: worker_checksums) {
+            checksum ^= worker_checksum;
+        }
+
+        std::cout << threads << " thread(s): " << statistics.games << " games, "
+                  << statistics.moves << '/' << generated_moves << " moves, "
+                  << statistics.unresolved_games << " unresolved games in " << duration.count()
+                  << "s (" << static_cast<double>(statistics.moves) / duration.count()
+                  << " moves/sec), hashes " << (checksum == expected_checksum ? "match" : "differ")
+                  << '\n';
+    }
+}
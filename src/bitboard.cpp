@@ -1,11 +1,14 @@
 #include <algorithm>
 #include <array>
 #include <bit>
+#include <cstddef>
+#include <cstdint>
 #include <optional>
 #include <string>
 
 #include "headers/bitboard.hpp"
 #include "headers/move_generation.hpp"
+#include "headers/profiler.hpp"
 
 namespace esochess {
     std::string bitboard::piece::to_string() const {
@@ -13,13 +16,11 @@ namespace esochess {
     }
 
     bitboard::Turn bitboard::color_at_square(const bitboard::bit_representation& bit_mask) const {
-        for (const bitboard::piece& chess_piece: pieces::all_pieces) {
-            if ((_bitboards.at(chess_piece.bitboard_index) & bit_mask) != 0) {
-                return chess_piece.turn;
-            }
+        if ((_position.colours [0] & bit_mask) != 0) {
+            return Turn::White;
         }
 
-        return Turn::None;
+        return (_position.colours [1] & bit_mask) != 0 ? Turn::Black : Turn::None;
     }
 
     bitboard::Turn bitboard::color_at_square(const bitboard::cordinate& cord) const {
@@ -27,9 +28,15 @@ namespace esochess {
     }
 
     bitboard::piece bitboard::piece_at_square(const bitboard::bit_representation& bit_mask) const {
-        for (const bitboard::piece& chess_piece: pieces::all_pieces) {
-            if ((_bitboards.at(chess_piece.bitboard_index) & bit_mask) != 0) {
-                return chess_piece;
+        const Turn turn {color_at_square(bit_mask)};
+
+        if (turn == Turn::None) {
+            return pieces::empty_piece;
+        }
+
+        for (std::size_t type_index {}; type_index < _position.piece_types.size(); type_index++) {
+            if ((_position.piece_types.at(type_index) & bit_mask) != 0) {
+                return pieces::all_pieces.at(type_index + (turn == Turn::White ? 0 : 6));
             }
         }
 
@@ -43,13 +50,13 @@ namespace esochess {
     bitboard::chess_grid bitboard::to_grid() const {
         bitboard::chess_grid grid {};
 
-        for (std::array<piece, 8> row: grid) {
+        for (std::array<piece, 8>& row: grid) {
             std::fill(row.begin(), row.end(), pieces::empty_piece);
         }
 
         for (const bitboard::piece& chess_piece: pieces::all_pieces) {
             const std::vector<bitboard::cordinate> cordinates {
-                cordinate_from_bit_representation(_bitboards.at(chess_piece.bitboard_index))};
+                cordinate_from_bit_representation(_position.pieces(chess_piece.bitboard_index))};
 
             for (const bitboard::cordinate& cordinate: cordinates) {
                 grid.at(cordinate.pos_y()).at(cordinate.pos_x()) = chess_piece;
@@ -59,34 +66,59 @@ namespace esochess {
         return grid;
     }
 
+    const bitboard::position& bitboard::as_position() const noexcept {
+        return _position;
+    }
+
+    bitboard bitboard::position_copy() const {
+        return bitboard {_position};
+    }
+
+    bitboard bitboard::after_move(const move& chess_move) const {
+        bitboard board_after_move {_position};
+        board_after_move.make_move(chess_move);
+
+        return board_after_move;
+    }
+
     std::array<bitboard::bit_representation, 12> bitboard::bitboards() const {
-        return _bitboards;
+        std::array<bit_representation, 12> bitboards {};
+
+        for (std::size_t bitboard_index {}; bitboard_index < bitboards.size(); bitboard_index++) {
+            bitboards.at(bitboard_index) = _position.pieces(bitboard_index);
+        }
+
+        return bitboards;
     }
 
     bitboard::Turn bitboard::turn() const {
-        return _turn;
+        return _position.turn;
     }
 
     std::optional<bitboard::en_passant_square> bitboard::en_passant() const {
-        return _en_passant;
+        return _position.en_passant;
     }
 
     bitboard::castle_rights_collection bitboard::castle_rights() const {
-        return _castle_rights;
+        return _position.castle_rights;
     }
 
     int bitboard::halfmove_clock() const {
-        return _halfmove_clock;
+        return _position.halfmove_clock;
     }
 
     int bitboard::fullmove_number() const {
-        return _fullmove_number;
+        return _position.fullmove_number;
     }
 
     bitboard::Turn bitboard::opposite_turn(Turn turn) {
         return (turn == Turn::White) ? Turn::Black : Turn::White;
     }
 
+    bitboard::Direction bitboard::opposite_direction(Direction direction) {
+        return static_cast<Direction>((static_cast<int>(direction) + 4) % 8);
+    }
+
     std::vector<bitboard::cordinate>
         bitboard::cordinate_from_bit_representation(bitboard::bit_representation bits) {
         std::vector<bitboard::cordinate> cordinates;
@@ -129,13 +161,13 @@ namespace esochess {
     bitboard::cordinate bitboard::en_passant_square::to_cordinate() const {
         return cordinate {
             static_cast<int>(column_index),
-            (captureable_piece_color == Turn::White) ? 5 : 2,
+            (captureable_piece_color == Turn::White) ? 2 : 5,
         };
     }
 
     bitboard& bitboard::remove_piece_at_square(const bitboard::bit_representation& bits,
                                                const piece& piece_removed) {
-        _bitboards.at(piece_removed.bitboard_index) &= ~bits;
+        _position.remove(piece_removed.bitboard_index, bits);
 
         return *this;
     }
@@ -157,7 +189,7 @@ namespace esochess {
 
     bitboard& bitboard::add_piece_at_square(const bitboard::bit_representation& bits,
                                             const bitboard::piece& piece_added) {
-        _bitboards.at(piece_added.bitboard_index) |= bits;
+        _position.add(piece_added.bitboard_index, bits);
 
         return *this;
     }
@@ -168,7 +200,7 @@ namespace esochess {
     }
 
     bitboard& bitboard::xor_piece(const bit_representation& bits, const piece& piece_modified) {
-        _bitboards.at(piece_modified.bitboard_index) ^= bits;
+        _position.toggle(piece_modified.bitboard_index, bits);
 
         return *this;
     }
@@ -186,8 +218,30 @@ namespace esochess {
         }
     }
 
+    bitboard::bitboard(const std::array<bit_representation, 12>& bitboards, Turn turn,
+                       castle_rights_collection castle_rights,
+                       std::optional<en_passant_square> en_passant, int halfmove_clock,
+                       int fullmove_number) :
+        _position {{},
+                   {},
+                   castle_rights,
+                   en_passant,
+                   turn,
+                   // Clamped to the 16 bits that `from_fen` accepts
+                   static_cast<std::uint16_t>(std::clamp(halfmove_clock, 0, 0xffff)),
+                   static_cast<std::uint16_t>(std::clamp(fullmove_number, 0, 0xffff))} {
+        for (std::size_t bitboard_index {}; bitboard_index < bitboards.size(); bitboard_index++) {
+            _position.add(bitboard_index, bitboards.at(bitboard_index));
+        }
+    }
+
+    bitboard::bitboard(const position& board_position) : _position {board_position} {
+    }
+
     bitboard::moves_listing bitboard::available_moves(bitboard::Turn turn) {
-        if (_fullmove_number == _cached_moves_listing.full_move_calculated &&
+        ESOCHESS_PROFILE_SCOPE(AvailableMoves);
+
+        if (_position.fullmove_number == _cached_moves_listing.full_move_calculated &&
             ((turn == Turn::White && _cached_moves_listing.white_pieces_moves_complete) ||
              (turn == Turn::Black && _cached_moves_listing.black_pieces_moves_complete))) {
             return turn == Turn::White
@@ -202,7 +256,7 @@ namespace esochess {
         add_rook_bishop_queen_moves(*this, moves);
         add_knight_moves(*this, moves);
 
-        _cached_moves_listing.full_move_calculated = _fullmove_number;
+        _cached_moves_listing.full_move_calculated = _position.fullmove_number;
 
         if (turn == Turn::White) {
             _cached_moves_listing.white_pieces = moves;
@@ -217,10 +271,24 @@ namespace esochess {
         return moves;
     }
 
+    bitboard::moves_listing bitboard::available_moves() {
+        return available_moves(_position.turn);
+    }
+
     bitboard::cached_moves_listing_t& bitboard::cached_moves_listing() {
         return _cached_moves_listing;
     }
 
+    bool bitboard::cached_moves_listing_t::operator==(
+        const cached_moves_listing_t&) const noexcept {
+        return true;
+    }
+
+    bool bitboard::cached_moves_listing_t::operator!=(
+        const cached_moves_listing_t&) const noexcept {
+        return false;
+    }
+
     std::optional<bitboard::bit_representation>
         bitboard::controlled_squares(bitboard::Turn turn) const {
         if ((turn == Turn::White && _cached_moves_listing.white_pieces_bits_complete) ||
@@ -235,26 +303,11 @@ namespace esochess {
     }
 
     bitboard::bit_representation bitboard::bitboard_bitor_accumulation(Turn turn) const {
-        bit_representation accumulation {0};
-
-        if (turn == Turn::White) {
-            for (const auto& piece: pieces::white_pieces) {
-                accumulation |= _bitboards.at(piece.bitboard_index);
-            }
-        }
-
-        if (turn == Turn::Black) {
-            for (const auto& piece: pieces::black_pieces) {
-                accumulation |= _bitboards.at(piece.bitboard_index);
-            }
+        switch (turn) {
+            case Turn::White: return _position.colours [0];
+            case Turn::Black: return _position.colours [1];
+            case Turn::All: return _position.occupancy();
+            default: return 0;
         }
-
-        if (turn == Turn::All) {
-            for (const auto& piece: pieces::all_pieces) {
-                accumulation |= _bitboards.at(piece.bitboard_index);
-            }
-        }
-
-        return accumulation;
     }
 } // namespace esochess
@@ -1,151 +1,412 @@
-#include <algorithm>
 #include <array>
-#include <sstream>
+#include <bit>
+#include <charconv>
+#include <cstdint>
+#include <expected>
+#include <span>
 #include <string>
+#include <string_view>
+#include <utility>
 
 #include "headers/bitboard.hpp"
 
 namespace esochess {
-    bitboard::bitboard(const std::string& fen_position) {
-        std::string fen_board;
-        std::string fen_turn;
-        std::string fen_castle_rights;
-        std::string fen_en_passant;
-        std::string fen_halfmove_clock;
-        std::string fen_fullmove_number;
-
-        std::stringstream {fen_position} >> fen_board >> fen_turn >> fen_castle_rights >>
-            fen_en_passant >> fen_halfmove_clock >> fen_fullmove_number;
-
-        std::string rank;
+    namespace {
+        constexpr std::array<std::int8_t, 128> bitboard_index_from_symbol {[]() {
+            std::array<std::int8_t, 128> indices {};
+            indices.fill(-1);
+
+            for (const bitboard::piece& chess_piece: bitboard::pieces::all_pieces) {
+                indices.at(static_cast<std::size_t>(chess_piece.symbol)) =
+                    static_cast<std::int8_t>(chess_piece.bitboard_index);
+            }
+
+            return indices;
+        }()};
+
+        constexpr bool is_fen_whitespace(char letter) {
+            return letter == ' ' || letter == '\t' || letter == '\r' || letter == '\n';
+        }
+
+        struct fen_reader {
+            std::string_view fen_position;
+            std::size_t position;
+
+            [[nodiscard]] bool at_end() const {
+                return position >= fen_position.size();
+            }
+
+            [[nodiscard]] char peek() const {
+                return fen_position [position];
+            }
+
+            void skip_whitespace() {
+                while (!at_end() && is_fen_whitespace(peek())) {
+                    position++;
+                }
+            }
+
+            std::string_view next_field() {
+                skip_whitespace();
+
+                const std::size_t field_start {position};
+
+                while (!at_end() && !is_fen_whitespace(peek())) {
+                    position++;
+                }
+
+                return fen_position.substr(field_start, position - field_start);
+            }
+        };
+
+        // Where the board, side to move, castle rights and en passant fields end
+        std::size_t end_of_position_fields(std::string_view fen_position) {
+            fen_reader reader {fen_position, 0};
+
+            for (int field {}; field < 4; field++) {
+                static_cast<void>(reader.next_field());
+            }
+
+            return reader.position;
+        }
+
+        // Counters past the 16 bits of `bitboard::position` are rejected
+        bool parse_counter(std::string_view field, std::uint16_t& counter) {
+            const char* const field_end {field.data() + field.size()};
+            const auto [parse_end, error_code] {std::from_chars(field.data(), field_end, counter)};
+
+            return error_code == std::errc {} && parse_end == field_end;
+        }
+
+        char* write_counter(char* output, std::uint16_t counter) {
+            return std::to_chars(output, output + 5, counter).ptr;
+        }
+    } // namespace
+
+    std::string bitboard::fen_error::to_string() const {
+        static constexpr std::array<const char*, 9> descriptions {
+            "unexpected end of position",     "invalid piece symbol",
+            "invalid board layout",           "invalid side to move",
+            "invalid castle rights",          "invalid en passant square",
+            "invalid halfmove clock",         "invalid fullmove number",
+            "trailing characters after position"};
+
+        return std::string {descriptions.at(static_cast<std::size_t>(error_type))} +
+               " at character " + std::to_string(position);
+    }
+
+    bitboard::bitboard(const std::string& fen_position) :
+        bitboard {from_fen(fen_position).value()} {
+    }
+
+    std::expected<bitboard, bitboard::fen_error>
+        bitboard::from_fen(std::string_view fen_position) noexcept {
+        bitboard board {};
+        fen_reader reader {fen_position, 0};
+
+        reader.skip_whitespace();
+
+        if (reader.at_end()) {
+            return std::unexpected {fen_error {FenErrorType::UnexpectedEnd, reader.position}};
+        }
+
         int row {7};
+        int column {0};
 
-        std::istringstream fen_position_stream {fen_position};
+        for (; !reader.at_end() && !is_fen_whitespace(reader.peek()); reader.position++) {
+            const char letter {reader.peek()};
 
-        while (std::getline(fen_position_stream, rank, '/') && row >= 0) {
-            int column {0};
+            if (letter == '/') {
+                if (column != 8 || row == 0) {
+                    return std::unexpected {
+                        fen_error {FenErrorType::InvalidBoardLayout, reader.position}};
+                }
 
-            for (const char letter: rank) {
-                if (std::isdigit(letter) != 0) {
-                    const int value {letter - '0'};
-                    column += value;
+                row--;
+                column = 0;
+            }
+
+            else if (letter >= '1' && letter <= '8') {
+                column += letter - '0';
+
+                if (column > 8) {
+                    return std::unexpected {
+                        fen_error {FenErrorType::InvalidBoardLayout, reader.position}};
                 }
+            }
 
-                else {
-                    const piece corresponding_piece {*std::find_if(
-                        bitboard::pieces::all_pieces.begin(), bitboard::pieces::all_pieces.end(),
-                        [letter](bitboard::piece maybe_piece) {
-                            return maybe_piece.symbol == letter;
-                        })};
+            else {
+                const std::int8_t bitboard_index {
+                    (static_cast<unsigned char>(letter) < bitboard_index_from_symbol.size())
+                        ? bitboard_index_from_symbol [static_cast<unsigned char>(letter)]
+                        : std::int8_t {-1}};
 
-                    const bitboard::bit_representation bit_position {
-                        cordinate {column, row}
-                         .to_bit_representation()
-                    };
+                if (bitboard_index < 0) {
+                    return std::unexpected {
+                        fen_error {FenErrorType::InvalidPiece, reader.position}};
+                }
 
-                    _bitboards.at(corresponding_piece.bitboard_index) |= bit_position;
-                    column++;
+                if (column >= 8) {
+                    return std::unexpected {
+                        fen_error {FenErrorType::InvalidBoardLayout, reader.position}};
                 }
+
+                board._position.add(static_cast<std::size_t>(bitboard_index),
+                                    cordinate {column, row}.to_bit_representation());
+                column++;
             }
+        }
 
-            row--;
+        if (row != 0 || column != 8) {
+            return std::unexpected {fen_error {FenErrorType::InvalidBoardLayout, reader.position}};
+        }
+
+        reader.skip_whitespace();
+
+        const std::size_t turn_position {reader.position};
+        const std::string_view fen_turn {reader.next_field()};
+
+        if (fen_turn.empty()) {
+            return std::unexpected {fen_error {FenErrorType::UnexpectedEnd, reader.position}};
         }
 
         if (fen_turn == "w") {
-            _turn = Turn::White;
+            board._position.turn = Turn::White;
         }
+
+        else if (fen_turn == "b") {
+            board._position.turn = Turn::Black;
+        }
+
         else {
-            _turn = Turn::Black;
+            return std::unexpected {fen_error {FenErrorType::InvalidTurn, turn_position}};
         }
 
-        if (fen_castle_rights.contains('K')) {
-            _castle_rights.white_king_side = true;
+        reader.skip_whitespace();
+
+        const std::size_t castle_rights_position {reader.position};
+        const std::string_view fen_castle_rights {reader.next_field()};
+
+        if (fen_castle_rights.empty()) {
+            return std::unexpected {fen_error {FenErrorType::UnexpectedEnd, reader.position}};
         }
-        if (fen_castle_rights.contains('Q')) {
-            _castle_rights.white_queen_side = true;
+
+        if (fen_castle_rights != "-") {
+            for (std::size_t index {}; index < fen_castle_rights.size(); index++) {
+                bool* castle_right {nullptr};
+
+                switch (fen_castle_rights [index]) {
+                    case 'K': castle_right = &board._position.castle_rights.white_king_side; break;
+                    case 'Q': castle_right = &board._position.castle_rights.white_queen_side; break;
+                    case 'k': castle_right = &board._position.castle_rights.black_king_side; break;
+                    case 'q': castle_right = &board._position.castle_rights.black_queen_side; break;
+                    default: break;
+                }
+
+                if (castle_right == nullptr || *castle_right) {
+                    return std::unexpected {fen_error {FenErrorType::InvalidCastleRights,
+                                                       castle_rights_position + index}};
+                }
+
+                *castle_right = true;
+            }
         }
-        if (fen_castle_rights.contains('k')) {
-            _castle_rights.black_king_side = true;
+
+        reader.skip_whitespace();
+
+        const std::size_t en_passant_position {reader.position};
+        const std::string_view fen_en_passant {reader.next_field()};
+
+        if (fen_en_passant.empty()) {
+            return std::unexpected {fen_error {FenErrorType::UnexpectedEnd, reader.position}};
         }
-        if (fen_castle_rights.contains('q')) {
-            _castle_rights.black_queen_side = true;
+
+        if (fen_en_passant != "-") {
+            if (fen_en_passant.size() != 2 || fen_en_passant [0] < 'a' ||
+                fen_en_passant [0] > 'h' ||
+                (fen_en_passant [1] != '3' && fen_en_passant [1] != '6')) {
+                return std::unexpected {
+                    fen_error {FenErrorType::InvalidEnPassant, en_passant_position}};
+            }
+
+            board._position.en_passant =
+                en_passant_square {static_cast<std::uint8_t>(fen_en_passant [0] - 'a'),
+                                   (fen_en_passant [1] == '3') ? Turn::White : Turn::Black};
         }
 
-        if (fen_en_passant == "-") {
-            _en_passant = {};
+        // The move counters are optional so that EPD style positions are accepted
+        board._position.halfmove_clock = 0;
+        board._position.fullmove_number = 1;
+
+        reader.skip_whitespace();
+
+        if (!reader.at_end()) {
+            const std::size_t halfmove_clock_position {reader.position};
+
+            if (!parse_counter(reader.next_field(), board._position.halfmove_clock)) {
+                return std::unexpected {
+                    fen_error {FenErrorType::InvalidHalfmoveClock, halfmove_clock_position}};
+            }
+
+            reader.skip_whitespace();
+
+            const std::size_t fullmove_number_position {reader.position};
+
+            if (!reader.at_end() &&
+                !parse_counter(reader.next_field(), board._position.fullmove_number)) {
+                return std::unexpected {
+                    fen_error {FenErrorType::InvalidFullmoveNumber, fullmove_number_position}};
+            }
+
+            reader.skip_whitespace();
+
+            if (!reader.at_end()) {
+                return std::unexpected {
+                    fen_error {FenErrorType::TrailingCharacters, reader.position}};
+            }
         }
 
-        else {
-            const int en_passant_cordinate_x {fen_en_passant [0] - 'a'};
-            const int en_passant_cordinate_y {fen_en_passant [1] - '1'};
+        return board;
+    }
+
+    std::expected<bitboard, bitboard::fen_error>
+        bitboard::from_epd(std::string_view epd_line) noexcept {
+        auto board {from_fen(epd_line)};
 
-            _en_passant =
-                en_passant_square {static_cast<std::uint8_t>(en_passant_cordinate_x),
-                                   (en_passant_cordinate_y == 3) ? Turn::White : Turn::Black};
+        if (!board.has_value()) {
+            board = from_fen(epd_line.substr(0, end_of_position_fields(epd_line)));
         }
 
-        _halfmove_clock = std::atoi(fen_halfmove_clock.c_str());
-        _fullmove_number = std::atoi(fen_fullmove_number.c_str());
+        return board;
     }
 
-    std::string bitboard::to_fen() const {
-        const bitboard::chess_grid grid {this->to_grid()};
+    std::size_t bitboard::write_fen(std::span<char> buffer) const noexcept {
+        if (buffer.size() < max_fen_length) {
+            return 0;
+        }
+
+        std::array<char, 64> symbols_by_square {};
+
+        for (const piece& chess_piece: pieces::all_pieces) {
+            bit_representation piece_bits {_position.pieces(chess_piece.bitboard_index)};
+
+            while (piece_bits != 0) {
+                symbols_by_square [static_cast<std::size_t>(std::countl_zero(piece_bits))] =
+                    chess_piece.symbol;
+                piece_bits &= ~std::bit_floor(piece_bits);
+            }
+        }
 
-        std::string fen_position {};
+        char* output {buffer.data()};
 
-        for (std::size_t row_index {}; row_index < 8; row_index++) {
-            const std::array<piece, 8>& row {grid.at(row_index)};
+        for (int row {7}; row >= 0; row--) {
+            char empty_squares {0};
 
-            std::size_t empty_squares {0};
+            for (int column {0}; column < 8; column++) {
+                const char symbol {symbols_by_square [static_cast<std::size_t>(column + row * 8)]};
 
-            for (const piece& grid_piece: row) {
-                if (grid_piece == pieces::empty_piece) {
+                if (symbol == 0) {
                     empty_squares++;
+                    continue;
                 }
 
-                else {
-                    if (empty_squares > 0) {
-                        fen_position += std::to_string(empty_squares);
-                        empty_squares = 0;
-                    }
-
-                    fen_position += grid_piece.to_string();
+                if (empty_squares > 0) {
+                    *output++ = static_cast<char>('0' + empty_squares);
+                    empty_squares = 0;
                 }
+
+                *output++ = symbol;
             }
 
             if (empty_squares > 0) {
-                fen_position += std::to_string(empty_squares);
+                *output++ = static_cast<char>('0' + empty_squares);
             }
 
-            if (row_index != 7) {
-                fen_position += '/';
+            if (row != 0) {
+                *output++ = '/';
             }
         }
 
-        return fen_position;
+        *output++ = ' ';
+        *output++ = (_position.turn == Turn::Black) ? 'b' : 'w';
+        *output++ = ' ';
+
+        if (_position.castle_rights == castle_rights_collection {}) {
+            *output++ = '-';
+        }
+
+        else {
+            for (const auto& [has_castle_right, symbol]:
+                 {std::pair {_position.castle_rights.white_king_side, 'K'},
+                  std::pair {_position.castle_rights.white_queen_side, 'Q'},
+                  std::pair {_position.castle_rights.black_king_side, 'k'},
+                  std::pair {_position.castle_rights.black_queen_side, 'q'}}) {
+                if (has_castle_right) {
+                    *output++ = symbol;
+                }
+            }
+        }
+
+        *output++ = ' ';
+
+        if (_position.en_passant.has_value()) {
+            const cordinate en_passant_cordinate {_position.en_passant->to_cordinate()};
+
+            *output++ = static_cast<char>('a' + en_passant_cordinate.pos_x());
+            *output++ = static_cast<char>('1' + en_passant_cordinate.pos_y());
+        }
+
+        else {
+            *output++ = '-';
+        }
+
+        *output++ = ' ';
+        output = write_counter(output, _position.halfmove_clock);
+        *output++ = ' ';
+        output = write_counter(output, _position.fullmove_number);
+
+        return static_cast<std::size_t>(output - buffer.data());
+    }
+
+    std::string bitboard::to_fen() const {
+        std::array<char, max_fen_length> buffer {};
+        const std::size_t fen_length {write_fen(buffer)};
+
+        return std::string {buffer.data(), fen_length};
+    }
+
+    std::string bitboard::to_epd() const {
+        std::array<char, max_fen_length> buffer {};
+        const std::string_view fen_position {buffer.data(), write_fen(buffer)};
+
+        return std::string {fen_position.substr(0, end_of_position_fields(fen_position))};
     }
 
     std::string bitboard::to_fancy_string() const {
         const bitboard::chess_grid grid {this->to_grid()};
 
-        std::string fancy_string {};
+        std::array<char, max_fen_length> buffer {};
+        fen_reader reader {std::string_view {buffer.data(), write_fen(buffer)}, 0};
+
+        reader.next_field();
 
-        std::string fen_board;
-        std::string fen_turn;
-        std::string fen_castle_rights;
-        std::string fen_en_passant;
-        std::string fen_halfmove_clock;
-        std::string fen_fullmove_number;
+        const std::string_view fen_turn {reader.next_field()};
+        const std::string_view fen_castle_rights {reader.next_field()};
+        const std::string_view fen_en_passant {reader.next_field()};
+        const std::string_view fen_halfmove_clock {reader.next_field()};
+        const std::string_view fen_fullmove_number {reader.next_field()};
 
-        std::stringstream {this->to_fen()} >> fen_board >> fen_turn >> fen_castle_rights >>
-            fen_en_passant >> fen_halfmove_clock >> fen_fullmove_number;
+        std::string fancy_string {};
 
-        fancy_string += "Move number: " + fen_fullmove_number + " Turn: " + fen_turn +
-                        " Castle rights: " + fen_castle_rights + " En passant: " + fen_en_passant +
-                        " Halfmove clock: " + fen_halfmove_clock + "\n";
+        fancy_string.append("Move number: ").append(fen_fullmove_number);
+        fancy_string.append(" Turn: ").append(fen_turn);
+        fancy_string.append(" Castle rights: ").append(fen_castle_rights);
+        fancy_string.append(" En passant: ").append(fen_en_passant);
+        fancy_string.append(" Halfmove clock: ").append(fen_halfmove_clock);
+        fancy_string += '\n';
 
-        for (const std::array<piece, 8>& row: grid) {
-            for (const piece& grid_piece: row) {
+        for (auto row {grid.rbegin()}; row != grid.rend(); row++) {
+            for (const piece& grid_piece: *row) {
                 fancy_string += grid_piece.to_string() + " ";
             }
 
@@ -0,0 +1,466 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+#include "headers/attacks.hpp"
+#include "headers/bitboard.hpp"
+#include "headers/board_batch.hpp"
+
+namespace esochess {
+    namespace {
+        using bit_representation = bitboard::bit_representation;
+        using lane_bits = board_batch::lane_bits;
+
+        struct offset {
+            int x;
+            int y;
+        };
+
+        constexpr std::array<offset, 8> knight_offsets {
+            {{1, 2}, {2, 1}, {2, -1}, {1, -2}, {-1, -2}, {-2, -1}, {-2, 1}, {-1, 2}}
+        };
+
+        constexpr std::array<bitboard::PieceType, 4> promotion_types {
+            bitboard::PieceType::Knight, bitboard::PieceType::Bishop, bitboard::PieceType::Rook,
+            bitboard::PieceType::Queen};
+
+        constexpr bit_representation rank_bits(int rank) {
+            return bit_representation {0xff} << (56 - 8 * rank);
+        }
+
+        offset offset_of(bitboard::Direction direction) {
+            const auto& [x_offset, y_offset] {
+                attack_tables::direction_offsets.at(static_cast<std::size_t>(direction))};
+
+            return offset {x_offset, y_offset};
+        }
+
+        // Black boards are stored upside down, which swaps north and south
+        bitboard::Direction flipped(bitboard::Direction direction) {
+            const offset step {offset_of(direction)};
+
+            for (const bitboard::Direction candidate: bitboard::pieces::all_directions) {
+                if (offset_of(candidate).x == step.x && offset_of(candidate).y == -step.y) {
+                    return candidate;
+                }
+            }
+
+            return direction;
+        }
+
+        // One bitboard of every board in the batch
+        struct lanes {
+#if defined(__AVX2__)
+            __m256i bits;
+#else
+            lane_bits bits;
+#endif
+        };
+
+#if defined(__AVX2__)
+        lanes load(const lane_bits& bits) {
+            return lanes {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(bits.data()))};
+        }
+
+        lane_bits store(lanes value) {
+            lane_bits bits {};
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(bits.data()), value.bits);
+            return bits;
+        }
+
+        lanes broadcast(bit_representation bits) {
+            return lanes {_mm256_set1_epi64x(static_cast<long long>(bits))};
+        }
+
+        lanes operator&(lanes first, lanes second) {
+            return lanes {_mm256_and_si256(first.bits, second.bits)};
+        }
+
+        lanes operator|(lanes first, lanes second) {
+            return lanes {_mm256_or_si256(first.bits, second.bits)};
+        }
+
+        lanes and_not(lanes first, lanes second) { // `first & ~second`
+            return lanes {_mm256_andnot_si256(second.bits, first.bits)};
+        }
+
+        // Moves every square up by `delta` squares, dropping what leaves the board
+        lanes shifted(lanes value, int delta) {
+            return delta > 0 ? lanes {_mm256_srl_epi64(value.bits, _mm_cvtsi32_si128(delta))}
+                             : lanes {_mm256_sll_epi64(value.bits, _mm_cvtsi32_si128(-delta))};
+        }
+
+        lanes empty_lanes(lanes value) { // All ones in the lanes without a square, 0 elsewhere
+            return lanes {_mm256_cmpeq_epi64(value.bits, _mm256_setzero_si256())};
+        }
+#else
+        lanes load(const lane_bits& bits) {
+            return lanes {bits};
+        }
+
+        lane_bits store(lanes value) {
+            return value.bits;
+        }
+
+        lanes broadcast(bit_representation bits) {
+            lanes value {};
+            value.bits.fill(bits);
+            return value;
+        }
+
+        template <typename Operation>
+        lanes each_lane(lanes first, lanes second, Operation operation) {
+            lanes result {};
+
+            for (std::size_t lane {}; lane < board_batch::width; lane++) {
+                result.bits [lane] = operation(first.bits [lane], second.bits [lane]);
+            }
+
+            return result;
+        }
+
+        lanes operator&(lanes first, lanes second) {
+            return each_lane(first, second, [](auto a, auto b) { return a & b; });
+        }
+
+        lanes operator|(lanes first, lanes second) {
+            return each_lane(first, second, [](auto a, auto b) { return a | b; });
+        }
+
+        lanes and_not(lanes first, lanes second) { // `first & ~second`
+            return each_lane(first, second, [](auto a, auto b) { return a & ~b; });
+        }
+
+        // Moves every square up by `delta` squares, dropping what leaves the board
+        lanes shifted(lanes value, int delta) {
+            return each_lane(value, value, [delta](auto bits, auto) {
+                return delta > 0 ? bits >> delta : bits << -delta;
+            });
+        }
+
+        lanes empty_lanes(lanes value) { // All ones in the lanes without a square, 0 elsewhere
+            return each_lane(value, value, [](auto bits, auto) {
+                return bits == 0 ? ~bit_representation {0} : bit_representation {0};
+            });
+        }
+#endif
+
+        lanes step(lanes pieces, offset direction) {
+            return shifted(pieces, direction.x + 8 * direction.y) &
+                   broadcast(attack_tables::file_step_landing_squares.at(
+                       static_cast<std::size_t>(direction.x + 2)));
+        }
+
+        // Kogge-Stone fill, as `fill_attacks` but for every board at once: the squares `sliders`
+        // reach in one direction, up to and including the first occupied square
+        lanes slide(lanes sliders, lanes empty, bitboard::Direction direction) {
+            const offset direction_offset {offset_of(direction)};
+            const int delta {direction_offset.x + 8 * direction_offset.y};
+            const lanes landing {broadcast(
+                attack_tables::landing_squares.at(static_cast<std::size_t>(direction)))};
+            lanes propagators {empty & landing};
+
+            sliders = sliders | (propagators & shifted(sliders, delta));
+            propagators = propagators & shifted(propagators, delta);
+            sliders = sliders | (propagators & shifted(sliders, 2 * delta));
+            propagators = propagators & shifted(propagators, 2 * delta);
+            sliders = sliders | (propagators & shifted(sliders, 4 * delta));
+
+            return shifted(sliders, delta) & landing;
+        }
+
+        lanes sliders_towards(bitboard::Direction direction, const std::array<lanes, 6>& pieces) {
+            const bool diagonal {std::ranges::find(bitboard::pieces::bishop_directions,
+                                                   direction) !=
+                                 bitboard::pieces::bishop_directions.end()};
+
+            return pieces.at(bitboard::pieces::white_queen.bitboard_index) |
+                   pieces.at(diagonal ? bitboard::pieces::white_bishop.bitboard_index
+                                      : bitboard::pieces::white_rook.bitboard_index);
+        }
+    } // namespace
+
+    // Target squares of every move, as seen by white
+    struct board_batch::move_targets {
+        lane_bits single_pushes;
+        lane_bits double_pushes;
+        std::array<lane_bits, 2> pawn_captures; // Towards the north east, then the north west
+        std::array<lane_bits, 8> knight_moves;  // Indexed as `knight_offsets`
+        lane_bits king_moves;
+        std::array<lane_bits, 8> slider_moves; // Indexed by `bitboard::Direction`
+        lane_bits castles;                     // g1 and c1 for the castles that may be played
+        lane_bits occupancy;
+    };
+
+    board_batch::board_batch(std::span<const bitboard> boards) :
+        _own {}, _enemy {}, _en_passant {}, _king_side_castle {}, _queen_side_castle {}, _turns {},
+        _en_passant_squares {}, _size {std::min(boards.size(), width)} {
+        for (std::size_t lane {}; lane < _size; lane++) {
+            const bitboard& board {boards [lane]};
+            const bool black_to_move {board.turn() == bitboard::Turn::Black};
+            const std::array<bit_representation, 12> bitboards {board.bitboards()};
+            const std::size_t own_first {black_to_move ? 6U : 0U};
+            const bitboard::castle_rights_collection rights {board.castle_rights()};
+
+            const auto oriented {[black_to_move](bit_representation bits) {
+                return black_to_move ? std::byteswap(bits) : bits; // Swaps the ranks
+            }};
+
+            for (std::size_t piece {}; piece < 6; piece++) {
+                _own.at(piece) [lane] = oriented(bitboards.at(own_first + piece));
+                _enemy.at(piece) [lane] = oriented(bitboards.at(6 - own_first + piece));
+            }
+
+            _turns [lane] = board.turn();
+
+            if (board.en_passant().has_value() &&
+                board.en_passant()->captureable_piece_color != board.turn()) {
+                _en_passant_squares [lane] = board.en_passant();
+                _en_passant [lane] =
+                    oriented(board.en_passant()->to_cordinate().to_bit_representation());
+            }
+
+            _king_side_castle [lane] =
+                (black_to_move ? rights.black_king_side : rights.white_king_side) ? square_bits(6)
+                                                                                  : 0;
+            _queen_side_castle [lane] =
+                (black_to_move ? rights.black_queen_side : rights.white_queen_side)
+                    ? square_bits(2)
+                    : 0;
+        }
+    }
+
+    std::size_t board_batch::size() const noexcept {
+        return _size;
+    }
+
+    board_batch::move_targets board_batch::targets() const {
+        std::array<lanes, 6> own {};
+        std::array<lanes, 6> enemy {};
+        lanes own_pieces {broadcast(0)};
+        lanes enemy_pieces {broadcast(0)};
+
+        for (std::size_t piece {}; piece < 6; piece++) {
+            own.at(piece) = load(_own.at(piece));
+            enemy.at(piece) = load(_enemy.at(piece));
+            own_pieces = own_pieces | own.at(piece);
+            enemy_pieces = enemy_pieces | enemy.at(piece);
+        }
+
+        const lanes occupancy {own_pieces | enemy_pieces};
+        const lanes empty {and_not(broadcast(~bit_representation {0}), occupancy)};
+        const lanes pawns {own.at(bitboard::pieces::white_pawn.bitboard_index)};
+        const lanes knights {own.at(bitboard::pieces::white_knight.bitboard_index)};
+        const lanes king {own.at(bitboard::pieces::white_king.bitboard_index)};
+        const lanes pawn_targets {enemy_pieces | load(_en_passant)};
+        const lanes single_pushes {step(pawns, offset {0, 1}) & empty};
+
+        move_targets targets {};
+
+        targets.single_pushes = store(single_pushes);
+        targets.double_pushes =
+            store(step(single_pushes & broadcast(rank_bits(2)), offset {0, 1}) & empty);
+        targets.pawn_captures.at(0) = store(step(pawns, offset {1, 1}) & pawn_targets);
+        targets.pawn_captures.at(1) = store(step(pawns, offset {-1, 1}) & pawn_targets);
+        targets.occupancy = store(occupancy);
+
+        for (std::size_t index {}; index < knight_offsets.size(); index++) {
+            targets.knight_moves.at(index) =
+                store(and_not(step(knights, knight_offsets.at(index)), own_pieces));
+        }
+
+        lanes king_moves {broadcast(0)};
+
+        for (const bitboard::Direction direction: bitboard::pieces::all_directions) {
+            targets.slider_moves.at(static_cast<std::size_t>(direction)) = store(and_not(
+                slide(sliders_towards(direction, own), empty, direction), own_pieces));
+            king_moves = king_moves | step(king, offset_of(direction));
+        }
+
+        targets.king_moves = store(and_not(king_moves, own_pieces));
+
+        if (std::ranges::all_of(_king_side_castle, [](auto bits) { return bits == 0; }) &&
+            std::ranges::all_of(_queen_side_castle, [](auto bits) { return bits == 0; })) {
+            return targets;
+        }
+
+        // Castling needs the squares the enemy attacks
+        const lanes enemy_pawns {enemy.at(bitboard::pieces::white_pawn.bitboard_index)};
+        lanes attacked {step(enemy_pawns, offset {1, -1}) | step(enemy_pawns, offset {-1, -1})};
+
+        for (const offset knight_offset: knight_offsets) {
+            attacked = attacked |
+                       step(enemy.at(bitboard::pieces::white_knight.bitboard_index), knight_offset);
+        }
+
+        for (const bitboard::Direction direction: bitboard::pieces::all_directions) {
+            attacked = attacked |
+                       step(enemy.at(bitboard::pieces::white_king.bitboard_index),
+                            offset_of(direction)) |
+                       slide(sliders_towards(direction, enemy), empty, direction);
+        }
+
+        const lanes all_lanes {broadcast(~bit_representation {0})};
+        const lanes rooks {own.at(bitboard::pieces::white_rook.bitboard_index)};
+        const lanes king_at_home {
+            and_not(all_lanes, empty_lanes(king & broadcast(square_bits(4))))};
+
+        const lanes king_side {
+            load(_king_side_castle) & king_at_home &
+            and_not(all_lanes, empty_lanes(rooks & broadcast(square_bits(7)))) &
+            empty_lanes(occupancy & broadcast(square_bits(5) | square_bits(6))) &
+            empty_lanes(attacked & broadcast(square_bits(4) | square_bits(5) | square_bits(6)))};
+        const lanes queen_side {
+            load(_queen_side_castle) & king_at_home &
+            and_not(all_lanes, empty_lanes(rooks & broadcast(square_bits(0)))) &
+            empty_lanes(occupancy &
+                        broadcast(square_bits(1) | square_bits(2) | square_bits(3))) &
+            empty_lanes(attacked & broadcast(square_bits(2) | square_bits(3) | square_bits(4)))};
+
+        targets.castles = store(king_side | queen_side);
+
+        return targets;
+    }
+
+    std::array<std::size_t, board_batch::width> board_batch::count_moves() const {
+        const move_targets moves {targets()};
+        std::array<std::size_t, width> counts {};
+
+        for (std::size_t lane {}; lane < _size; lane++) {
+            const auto count_pawn_moves {[lane](const lane_bits& pawn_targets) {
+                const bit_representation promotions {pawn_targets [lane] & rank_bits(7)};
+
+                return static_cast<std::size_t>(std::popcount(pawn_targets [lane] & ~promotions) +
+                                                4 * std::popcount(promotions));
+            }};
+
+            counts [lane] = count_pawn_moves(moves.single_pushes) +
+                            count_pawn_moves(moves.pawn_captures.at(0)) +
+                            count_pawn_moves(moves.pawn_captures.at(1)) +
+                            static_cast<std::size_t>(std::popcount(moves.double_pushes [lane]) +
+                                                     std::popcount(moves.king_moves [lane]) +
+                                                     std::popcount(moves.castles [lane]));
+
+            for (std::size_t index {}; index < 8; index++) {
+                counts [lane] += static_cast<std::size_t>(
+                    std::popcount(moves.knight_moves.at(index) [lane]) +
+                    std::popcount(moves.slider_moves.at(index) [lane]));
+            }
+        }
+
+        return counts;
+    }
+
+    void board_batch::generate_moves(std::array<std::vector<bitboard::move>, width>& moves) const {
+        const move_targets targets {this->targets()};
+
+        for (std::size_t lane {}; lane < width; lane++) {
+            std::vector<bitboard::move>& lane_moves {moves.at(lane)};
+            const bool black_to_move {_turns [lane] == bitboard::Turn::Black};
+
+            lane_moves.clear();
+
+            if (lane >= _size) {
+                continue;
+            }
+
+            const auto real_bits {[black_to_move](int square) {
+                return square_bits(black_to_move ? square ^ 56 : square);
+            }};
+            const auto real_direction {[black_to_move](bitboard::Direction direction) {
+                return black_to_move ? flipped(direction) : direction;
+            }};
+
+            const auto add_pawn_moves {[&](bit_representation pawn_targets,
+                                           bitboard::Direction direction, int distance) {
+                const offset pawn_step {offset_of(direction)};
+
+                for (; pawn_targets != 0; pawn_targets = without_lowest_square(pawn_targets)) {
+                    const int end {square_index(pawn_targets)};
+                    const int start {end - distance * (pawn_step.x + 8 * pawn_step.y)};
+
+                    if (end / 8 == 7) {
+                        for (const bitboard::PieceType promotion_type: promotion_types) {
+                            lane_moves.emplace_back(bitboard::move_promotion {
+                                real_bits(start), promotion_type, real_direction(direction)});
+                        }
+                    }
+
+                    else if (pawn_step.x != 0 && square_bits(end) == _en_passant [lane]) {
+                        lane_moves.emplace_back(bitboard::move_en_passant {
+                            *_en_passant_squares [lane], real_direction(direction)});
+                    }
+
+                    else {
+                        lane_moves.emplace_back(
+                            bitboard::move_normal {real_bits(start), real_bits(end)});
+                    }
+                }
+            }};
+
+            const auto add_moves_from {[&](bit_representation move_targets, auto start_of) {
+                for (; move_targets != 0; move_targets = without_lowest_square(move_targets)) {
+                    const int end {square_index(move_targets)};
+
+                    lane_moves.emplace_back(
+                        bitboard::move_normal {real_bits(start_of(end)), real_bits(end)});
+                }
+            }};
+
+            add_pawn_moves(targets.single_pushes [lane], bitboard::Direction::North, 1);
+            add_pawn_moves(targets.double_pushes [lane], bitboard::Direction::North, 2);
+            add_pawn_moves(targets.pawn_captures.at(0) [lane], bitboard::Direction::NorthEast, 1);
+            add_pawn_moves(targets.pawn_captures.at(1) [lane], bitboard::Direction::NorthWest, 1);
+
+            for (std::size_t index {}; index < knight_offsets.size(); index++) {
+                const offset knight_offset {knight_offsets.at(index)};
+
+                add_moves_from(targets.knight_moves.at(index) [lane], [knight_offset](int end) {
+                    return end - knight_offset.x - 8 * knight_offset.y;
+                });
+            }
+
+            const int king_square {square_index(
+                _own.at(bitboard::pieces::white_king.bitboard_index) [lane])};
+
+            add_moves_from(targets.king_moves [lane], [king_square](int) { return king_square; });
+
+            // The slider behind a target is the first piece on the way back
+            for (const bitboard::Direction direction: bitboard::pieces::all_directions) {
+                const bool diagonal {std::ranges::find(bitboard::pieces::bishop_directions,
+                                                       direction) !=
+                                     bitboard::pieces::bishop_directions.end()};
+                const bit_representation sliders {
+                    _own.at(bitboard::pieces::white_queen.bitboard_index) [lane] |
+                    _own.at(diagonal ? bitboard::pieces::white_bishop.bitboard_index
+                                     : bitboard::pieces::white_rook.bitboard_index) [lane]};
+                const bitboard::Direction backwards {bitboard::opposite_direction(direction)};
+                const bit_representation occupancy {targets.occupancy [lane]};
+
+                add_moves_from(targets.slider_moves.at(static_cast<std::size_t>(direction)) [lane],
+                               [&](int end) {
+                                   return square_index(ray_attacks(backwards, end, occupancy) &
+                                                       sliders);
+                               });
+            }
+
+            if ((targets.castles [lane] & square_bits(6)) != 0) {
+                lane_moves.emplace_back(
+                    bitboard::move_castle {_turns [lane], bitboard::CastleType::KingSide});
+            }
+
+            if ((targets.castles [lane] & square_bits(2)) != 0) {
+                lane_moves.emplace_back(
+                    bitboard::move_castle {_turns [lane], bitboard::CastleType::QueenSide});
+            }
+        }
+    }
+} // namespace esochess
@@ -0,0 +1,145 @@
+#include <array>
+#include <bit>
+#include <cstddef>
+
+#include "headers/attacks.hpp"
+#include "headers/bitboard.hpp"
+#include "headers/move_generation.hpp"
+#include "headers/profiler.hpp"
+
+namespace esochess {
+    void add_quiet_check_moves(const bitboard& board, bitboard::moves_listing& moves_listing_ext) {
+        ESOCHESS_PROFILE_SCOPE(AddQuietCheckMoves);
+
+        using bit_representation = bitboard::bit_representation;
+
+        const bitboard::Turn turn {board.turn()};
+        const bitboard::Turn opponents_turn {bitboard::opposite_turn(turn)};
+        const std::size_t first_index {turn == bitboard::Turn::White
+                                           ? bitboard::pieces::white_pawn.bitboard_index
+                                           : bitboard::pieces::black_pawn.bitboard_index};
+        const bit_representation enemy_king {board.bitboards().at(
+            turn == bitboard::Turn::White ? bitboard::pieces::black_king.bitboard_index
+                                          : bitboard::pieces::white_king.bitboard_index)};
+
+        if (enemy_king == 0) {
+            return;
+        }
+
+        const int king_square {square_index(enemy_king)};
+        const bit_representation occupancy {
+            board.bitboard_bitor_accumulation(bitboard::Turn::All)};
+        const bit_representation empty {~occupancy};
+        const auto pieces_of {[&board, first_index](const bitboard::piece& white_piece) {
+            return board.bitboards().at(first_index + white_piece.bitboard_index);
+        }};
+
+        // The squares from which each kind of piece attacks the king, indexed like the bitboards
+        const bit_representation diagonal_checks {bishop_attacks(king_square, occupancy)};
+        const bit_representation straight_checks {rook_attacks(king_square, occupancy)};
+        const std::array<bit_representation, 6> checking_squares {
+            pawn_attacks(opponents_turn, king_square),
+            knight_attacks(king_square),
+            diagonal_checks,
+            straight_checks,
+            diagonal_checks | straight_checks,
+            0};
+
+        // Own pieces that are the only blocker between the king and an own slider behind them,
+        // with the ray from the king that they have to leave to uncover the check
+        std::array<bit_representation, 8> discovering_pieces {};
+        std::array<bit_representation, 8> discovered_lines {};
+
+        for (std::size_t direction_index {}; direction_index < discovering_pieces.size();
+             direction_index++) {
+            const auto direction {static_cast<bitboard::Direction>(direction_index)};
+            const bool is_diagonal {direction == bitboard::Direction::NorthEast ||
+                                    direction == bitboard::Direction::SouthEast ||
+                                    direction == bitboard::Direction::SouthWest ||
+                                    direction == bitboard::Direction::NorthWest};
+            const bit_representation blocker {ray_attacks(direction, king_square, occupancy) &
+                                              board.bitboard_bitor_accumulation(turn)};
+
+            if (blocker == 0) {
+                continue;
+            }
+
+            const bit_representation sliders {
+                pieces_of(bitboard::pieces::white_queen) |
+                pieces_of(is_diagonal ? bitboard::pieces::white_bishop
+                                      : bitboard::pieces::white_rook)};
+
+            if ((ray_attacks(direction, king_square, occupancy & ~blocker) & sliders) != 0) {
+                discovering_pieces.at(direction_index) = blocker;
+                discovered_lines.at(direction_index) =
+                    attack_tables::rays [direction_index][static_cast<std::size_t>(king_square)];
+            }
+        }
+
+        // Squares a piece on `from` can move to that uncover a check
+        const auto discovering_squares {[&](bit_representation from) {
+            for (std::size_t direction_index {}; direction_index < discovering_pieces.size();
+                 direction_index++) {
+                if (discovering_pieces.at(direction_index) == from) {
+                    return ~discovered_lines.at(direction_index);
+                }
+            }
+
+            return bit_representation {0};
+        }};
+
+        const auto add_moves {[&moves_listing_ext](int from, bit_representation targets) {
+            for (; targets != 0; targets = without_lowest_square(targets)) {
+                moves_listing_ext.normal_moves.emplace_back(square_bits(from),
+                                                            std::bit_floor(targets));
+            }
+        }};
+
+        const int forward {turn == bitboard::Turn::White ? 8 : -8};
+        const int starting_rank {turn == bitboard::Turn::White
+                                     ? bitboard::white_pawn_starting_rank
+                                     : bitboard::black_pawn_starting_rank};
+        const int last_rank_before_promotion {turn == bitboard::Turn::White ? 6 : 1};
+
+        for (bit_representation pawns {pieces_of(bitboard::pieces::white_pawn)}; pawns != 0;
+             pawns = without_lowest_square(pawns)) {
+            const int from {square_index(pawns)};
+
+            if (from / 8 == last_rank_before_promotion ||
+                (empty & square_bits(from + forward)) == 0) {
+                continue;
+            }
+
+            bit_representation pushes {square_bits(from + forward)};
+
+            if (from / 8 == starting_rank && (empty & square_bits(from + 2 * forward)) != 0) {
+                pushes |= square_bits(from + 2 * forward);
+            }
+
+            add_moves(from, pushes & (checking_squares.at(0) |
+                                      discovering_squares(std::bit_floor(pawns))));
+        }
+
+        for (const bitboard::piece& white_piece:
+             {bitboard::pieces::white_knight, bitboard::pieces::white_bishop,
+              bitboard::pieces::white_rook, bitboard::pieces::white_queen,
+              bitboard::pieces::white_king}) {
+            for (bit_representation pieces {pieces_of(white_piece)}; pieces != 0;
+                 pieces = without_lowest_square(pieces)) {
+                const int from {square_index(pieces)};
+                const bit_representation attacks {
+                    white_piece == bitboard::pieces::white_knight ? knight_attacks(from)
+                    : white_piece == bitboard::pieces::white_bishop
+                        ? bishop_attacks(from, occupancy)
+                    : white_piece == bitboard::pieces::white_rook ? rook_attacks(from, occupancy)
+                    : white_piece == bitboard::pieces::white_queen
+                        ? queen_attacks(from, occupancy)
+                        : king_attacks(from)};
+
+                add_moves(from, attacks & empty &
+                                    (checking_squares.at(white_piece.bitboard_index) |
+                                     discovering_squares(std::bit_floor(pieces))));
+            }
+        }
+    }
+} // namespace esochess
@@ -12,7 +12,7 @@ namespace esochess {
     }
 
     bitboard::cordinate::cordinate(bitboard::bit_representation bit_mask) :
-        _x {std::countr_zero(bit_mask) % 8}, _y {std::countr_zero(bit_mask / 8)} {
+        _x {std::countl_zero(bit_mask) % 8}, _y {std::countl_zero(bit_mask) / 8} {
     }
 
     int bitboard::cordinate::pos_x() const {
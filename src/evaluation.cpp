@@ -0,0 +1,199 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+
+#include "headers/attacks.hpp"
+#include "headers/bitboard.hpp"
+#include "headers/evaluation.hpp"
+
+namespace esochess {
+    namespace {
+        using square_table = std::array<int, 64>;
+
+        // Written from white's side with a8 first, so a white piece on `square` reads index
+        // `square ^ 56` and a black piece reads `square`
+        // clang-format off
+        constexpr std::array<square_table, 6> middlegame_tables {{
+            {{ // Pawn
+                   0,    0,    0,    0,    0,    0,    0,    0,
+                  50,   50,   50,   50,   50,   50,   50,   50,
+                  10,   10,   20,   30,   30,   20,   10,   10,
+                   5,    5,   10,   25,   25,   10,    5,    5,
+                   0,    0,    0,   20,   20,    0,    0,    0,
+                   5,   -5,  -10,    0,    0,  -10,   -5,    5,
+                   5,   10,   10,  -20,  -20,   10,   10,    5,
+                   0,    0,    0,    0,    0,    0,    0,    0,
+            }},
+            {{ // Knight
+                 -50,  -40,  -30,  -30,  -30,  -30,  -40,  -50,
+                 -40,  -20,    0,    0,    0,    0,  -20,  -40,
+                 -30,    0,   10,   15,   15,   10,    0,  -30,
+                 -30,    5,   15,   20,   20,   15,    5,  -30,
+                 -30,    0,   15,   20,   20,   15,    0,  -30,
+                 -30,    5,   10,   15,   15,   10,    5,  -30,
+                 -40,  -20,    0,    5,    5,    0,  -20,  -40,
+                 -50,  -40,  -30,  -30,  -30,  -30,  -40,  -50,
+            }},
+            {{ // Bishop
+                 -20,  -10,  -10,  -10,  -10,  -10,  -10,  -20,
+                 -10,    0,    0,    0,    0,    0,    0,  -10,
+                 -10,    0,    5,   10,   10,    5,    0,  -10,
+                 -10,    5,    5,   10,   10,    5,    5,  -10,
+                 -10,    0,   10,   10,   10,   10,    0,  -10,
+                 -10,   10,   10,   10,   10,   10,   10,  -10,
+                 -10,    5,    0,    0,    0,    0,    5,  -10,
+                 -20,  -10,  -10,  -10,  -10,  -10,  -10,  -20,
+            }},
+            {{ // Rook
+                   0,    0,    0,    0,    0,    0,    0,    0,
+                   5,   10,   10,   10,   10,   10,   10,    5,
+                  -5,    0,    0,    0,    0,    0,    0,   -5,
+                  -5,    0,    0,    0,    0,    0,    0,   -5,
+                  -5,    0,    0,    0,    0,    0,    0,   -5,
+                  -5,    0,    0,    0,    0,    0,    0,   -5,
+                  -5,    0,    0,    0,    0,    0,    0,   -5,
+                   0,    0,    0,    5,    5,    0,    0,    0,
+            }},
+            {{ // Queen
+                 -20,  -10,  -10,   -5,   -5,  -10,  -10,  -20,
+                 -10,    0,    0,    0,    0,    0,    0,  -10,
+                 -10,    0,    5,    5,    5,    5,    0,  -10,
+                  -5,    0,    5,    5,    5,    5,    0,   -5,
+                   0,    0,    5,    5,    5,    5,    0,   -5,
+                 -10,    5,    5,    5,    5,    5,    0,  -10,
+                 -10,    0,    5,    0,    0,    0,    0,  -10,
+                 -20,  -10,  -10,   -5,   -5,  -10,  -10,  -20,
+            }},
+            {{ // King
+                 -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+                 -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+                 -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+                 -30,  -40,  -40,  -50,  -50,  -40,  -40,  -30,
+                 -20,  -30,  -30,  -40,  -40,  -30,  -30,  -20,
+                 -10,  -20,  -20,  -20,  -20,  -20,  -20,  -10,
+                  20,   20,    0,    0,    0,    0,   20,   20,
+                  20,   30,   10,    0,    0,   10,   30,   20,
+            }},
+        }};
+
+        // Only the pawns and the king play differently once the pieces are traded
+        constexpr square_table endgame_pawn_table {
+               0,    0,    0,    0,    0,    0,    0,    0,
+              80,   80,   80,   80,   80,   80,   80,   80,
+              50,   50,   50,   50,   50,   50,   50,   50,
+              30,   30,   30,   30,   30,   30,   30,   30,
+              20,   20,   20,   20,   20,   20,   20,   20,
+              10,   10,   10,   10,   10,   10,   10,   10,
+               0,    0,    0,    0,    0,    0,    0,    0,
+               0,    0,    0,    0,    0,    0,    0,    0,
+        };
+
+        constexpr square_table endgame_king_table {
+             -50,  -40,  -30,  -20,  -20,  -30,  -40,  -50,
+             -30,  -20,  -10,    0,    0,  -10,  -20,  -30,
+             -30,  -10,   20,   30,   30,   20,  -10,  -30,
+             -30,  -10,   30,   40,   40,   30,  -10,  -30,
+             -30,  -10,   30,   40,   40,   30,  -10,  -30,
+             -30,  -10,   20,   30,   30,   20,  -10,  -30,
+             -30,  -30,    0,    0,    0,    0,  -30,  -30,
+             -50,  -30,  -30,  -30,  -30,  -30,  -30,  -50,
+        };
+        // clang-format on
+
+        constexpr std::array<int, 6> phase_weights {0, 1, 1, 2, 4, 0};
+        constexpr int full_phase {24}; // Phase of the starting position
+
+        constexpr int slider_mobility_weight {2}; // Per square the sliders of a side reach
+        constexpr int king_zone_attack_weight {6}; // Per square next to the enemy king, middlegame
+
+        // Mobility and king zone pressure of one side's sliders, from the set wise fills
+        struct slider_activity {
+            int mobility;
+            int king_zone_attacks;
+        };
+
+        slider_activity
+            slider_activity_of(const std::array<bitboard::bit_representation, 12>& bitboards,
+                               std::size_t first_index, std::size_t enemy_first_index,
+                               bitboard::bit_representation occupancy) {
+            using pieces = bitboard::pieces;
+
+            const bitboard::bit_representation own_pieces {[&]() {
+                bitboard::bit_representation bits {0};
+
+                for (std::size_t index {first_index}; index < first_index + 6; index++) {
+                    bits |= bitboards.at(index);
+                }
+
+                return bits;
+            }()};
+            const bitboard::bit_representation queens {
+                bitboards.at(first_index + pieces::white_queen.bitboard_index)};
+            const bitboard::bit_representation attacks {slider_attacks(
+                bitboards.at(first_index + pieces::white_bishop.bitboard_index) | queens,
+                bitboards.at(first_index + pieces::white_rook.bitboard_index) | queens,
+                occupancy)};
+            const bitboard::bit_representation enemy_king {
+                bitboards.at(enemy_first_index + pieces::white_king.bitboard_index)};
+            const bitboard::bit_representation king_zone {
+                enemy_king == 0 ? 0 : king_attacks(square_index(enemy_king))};
+
+            return slider_activity {std::popcount(attacks & ~own_pieces),
+                                    std::popcount(attacks & king_zone)};
+        }
+    } // namespace
+
+    int evaluate(const bitboard& board) {
+        const std::array<bitboard::bit_representation, 12> bitboards {board.bitboards()};
+
+        int middlegame {0};
+        int endgame {0};
+        int phase {0};
+
+        for (std::size_t index {}; index < bitboards.size(); index++) {
+            const std::size_t piece_index {index % 6};
+            const bool is_white {index < 6};
+            const int sign {is_white ? 1 : -1};
+
+            for (bitboard::bit_representation bits {bitboards.at(index)}; bits != 0;
+                 bits = without_lowest_square(bits)) {
+                const int square {square_index(bits)};
+                const std::size_t table_index {static_cast<std::size_t>(is_white ? square ^ 56
+                                                                                 : square)};
+                const int middlegame_square {middlegame_tables.at(piece_index).at(table_index)};
+
+                const int endgame_square {
+                    piece_index == bitboard::pieces::white_pawn.bitboard_index
+                        ? endgame_pawn_table.at(table_index)
+                    : piece_index == bitboard::pieces::white_king.bitboard_index
+                        ? endgame_king_table.at(table_index)
+                        : middlegame_square};
+
+                middlegame += sign * (piece_values.at(piece_index) + middlegame_square);
+                endgame += sign * (piece_values.at(piece_index) + endgame_square);
+                phase += phase_weights.at(piece_index);
+            }
+        }
+
+        bitboard::bit_representation occupancy {0};
+
+        for (const bitboard::bit_representation bits: bitboards) {
+            occupancy |= bits;
+        }
+
+        const slider_activity white_activity {slider_activity_of(bitboards, 0, 6, occupancy)};
+        const slider_activity black_activity {slider_activity_of(bitboards, 6, 0, occupancy)};
+        const int mobility {slider_mobility_weight *
+                            (white_activity.mobility - black_activity.mobility)};
+
+        middlegame += mobility + king_zone_attack_weight * (white_activity.king_zone_attacks -
+                                                            black_activity.king_zone_attacks);
+        endgame += mobility;
+        phase = std::min(phase, full_phase);
+
+        const int score {(middlegame * phase + endgame * (full_phase - phase)) / full_phase};
+
+        return board.turn() == bitboard::Turn::White ? score : -score;
+    }
+} // namespace esochess
@@ -0,0 +1,133 @@
+#ifndef ESOCHESS_ANALYSIS_SERVER_HPP
+#define ESOCHESS_ANALYSIS_SERVER_HPP
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "bitboard.hpp"
+#include "search.hpp"
+
+namespace esochess {
+    struct analysis_server_options {
+        std::size_t thread_count;
+        std::size_t hash_megabytes; // Of each worker's table, kept warm from request to request
+        search_limits default_limits; // For requests without a depth, node or time limit
+        std::uint64_t max_nodes;      // Budgets every request is held to, 0 for none
+        std::chrono::milliseconds max_move_time;
+        bool pin_workers; // Each to a core of its own, where there are enough
+    };
+
+    struct analysis_response {
+        std::uint64_t ticket;
+        search_result result;
+        bool cancelled;                     // Stopped by `cancel` or the server shutting down
+        std::chrono::microseconds queued;   // Waiting for a worker
+        std::chrono::microseconds latency;  // From submission to the response
+    };
+
+    struct latency_percentiles { // Over the most recent responses
+        std::uint64_t responses;        // Since the server started
+        std::chrono::microseconds p50;
+        std::chrono::microseconds p90;
+        std::chrono::microseconds p99;
+        std::chrono::microseconds max;
+    };
+
+    // Analyses positions on a fixed pool of workers in submission order. Each worker keeps its
+    // search engine, and with it the transposition table and move ordering tables, between
+    // requests. A queued or running request is cancelled by its ticket and is still answered.
+    struct analysis_server {
+        using response_function = std::function<void(const analysis_response&)>;
+
+        static constexpr std::size_t latency_samples {4096};
+
+        explicit analysis_server(const analysis_server_options& options);
+        analysis_server(const analysis_server& other) = delete;
+        ~analysis_server(); // Cancels what is left, answering it, and joins the workers
+
+        analysis_server& operator=(const analysis_server& other) = delete;
+
+        // `respond` is called once, from a worker thread, or from `cancel` for a queued request
+        std::uint64_t submit(const bitboard& board, const search_limits& limits,
+                             response_function respond);
+        bool cancel(std::uint64_t ticket); // False once the request has been answered
+
+        [[nodiscard]] latency_percentiles latencies() const;
+        [[nodiscard]] std::size_t pending() const; // Queued or running
+
+        private:
+
+        using clock = std::chrono::steady_clock;
+
+        struct job {
+            std::uint64_t ticket;
+            bitboard board;
+            search_limits limits;
+            response_function respond;
+            clock::time_point submitted;
+        };
+
+        void work(std::stop_token stop_token, std::size_t worker);
+        void record_latency(std::chrono::microseconds latency); // Under `_mutex`
+        [[nodiscard]] search_limits budgeted(search_limits limits) const;
+
+        analysis_server_options _options;
+
+        mutable std::mutex _mutex;
+        std::condition_variable_any _job_available;
+        std::deque<job> _jobs;
+        std::unordered_map<std::uint64_t, std::stop_source> _running;
+        std::uint64_t _next_ticket;
+
+        std::vector<std::chrono::microseconds> _latencies; // Ring of `latency_samples`
+        std::uint64_t _responses;
+
+        std::vector<std::jthread> _workers;
+    };
+
+    // One client of the server speaking line delimited JSON. Every line is a request object:
+    //   {"id": "a", "fen": "...", "depth": 12, "nodes": 500000, "movetime": 250}
+    //   {"id": "a", "cancel": true}
+    //   {"stats": true}
+    // and every response is one object on one line, in completion order, carrying the id with
+    // `bestmove`, `score`, `depth`, `nodes`, `pv`, `cancelled` and the latency, or an `error`.
+    struct analysis_session {
+        using line_writer = std::function<void(std::string_view)>; // Called one line at a time
+
+        analysis_session(analysis_server& server, line_writer write_line);
+        analysis_session(const analysis_session& other) = delete;
+        ~analysis_session(); // Cancels the requests still open and waits for their responses
+
+        analysis_session& operator=(const analysis_session& other) = delete;
+
+        void handle_line(std::string_view line);
+        void cancel(); // The requests still open, which are answered all the same
+        void wait();   // Until every request of the session is answered
+
+        private:
+
+        void write(std::string_view line); // Serialised, since workers answer concurrently
+
+        analysis_server& _server;
+        line_writer _write_line;
+
+        std::mutex _mutex;
+        std::mutex _write_mutex;
+        std::condition_variable _answered;
+        std::unordered_map<std::string, std::uint64_t> _tickets; // Of open requests, by id
+    };
+} // namespace esochess
+
+#endif
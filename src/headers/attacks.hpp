@@ -0,0 +1,236 @@
+#ifndef ESOCHESS_ATTACKS_HPP
+#define ESOCHESS_ATTACKS_HPP
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+
+#include "bitboard.hpp"
+
+namespace esochess {
+    // Squares are indexed from a1 (0) to h8 (63), matching `cordinate {x, y}` as `x + y * 8`. The
+    // bit of a square is `1 << (63 - square)`, so the lowest square of a mask is its leading zero
+    // count.
+    constexpr int square_index(bitboard::bit_representation bits) {
+        return std::countl_zero(bits);
+    }
+
+    constexpr bitboard::bit_representation square_bits(int square) {
+        return bitboard::bit_representation {1} << (63 - square);
+    }
+
+    constexpr bitboard::bit_representation
+        without_lowest_square(bitboard::bit_representation bits) {
+        return bits & ~std::bit_floor(bits);
+    }
+
+    namespace attack_tables {
+        using attack_table = std::array<bitboard::bit_representation, 64>;
+
+        constexpr bitboard::bit_representation offset_bits(int square, int x_offset, int y_offset) {
+            const int pos_x {square % 8 + x_offset};
+            const int pos_y {square / 8 + y_offset};
+
+            return (pos_x < 0 || pos_x >= 8 || pos_y < 0 || pos_y >= 8)
+                       ? bitboard::bit_representation {0}
+                       : square_bits(pos_x + pos_y * 8);
+        }
+
+        constexpr std::array<std::array<int, 2>, 8> direction_offsets {
+            {{0, 1}, {1, 1}, {1, 0}, {1, -1}, {0, -1}, {-1, -1}, {-1, 0}, {-1, 1}}
+        }; // Indexed by `bitboard::Direction`
+
+        inline constexpr attack_table knight {[]() {
+            attack_table table {};
+
+            for (int square {}; square < 64; square++) {
+                for (const auto& [x_offset, y_offset]: std::array<std::array<int, 2>, 8> {
+                         {{1, 2}, {1, -2}, {-1, 2}, {-1, -2}, {2, 1}, {2, -1}, {-2, 1}, {-2, -1}}
+                }) {
+                    table.at(static_cast<std::size_t>(square)) |=
+                        offset_bits(square, x_offset, y_offset);
+                }
+            }
+
+            return table;
+        }()};
+
+        inline constexpr attack_table king {[]() {
+            attack_table table {};
+
+            for (int square {}; square < 64; square++) {
+                for (const auto& [x_offset, y_offset]: direction_offsets) {
+                    table.at(static_cast<std::size_t>(square)) |=
+                        offset_bits(square, x_offset, y_offset);
+                }
+            }
+
+            return table;
+        }()};
+
+        // Squares attacked by a pawn of the given colour standing on the square
+        inline constexpr std::array<attack_table, 2> pawn {[]() {
+            std::array<attack_table, 2> tables {};
+
+            for (int square {}; square < 64; square++) {
+                tables.at(0).at(static_cast<std::size_t>(square)) =
+                    offset_bits(square, 1, 1) | offset_bits(square, -1, 1);
+                tables.at(1).at(static_cast<std::size_t>(square)) =
+                    offset_bits(square, 1, -1) | offset_bits(square, -1, -1);
+            }
+
+            return tables;
+        }()};
+
+        // Every square in a direction up to the edge of the board, indexed by `bitboard::Direction`
+        inline constexpr std::array<attack_table, 8> rays {[]() {
+            std::array<attack_table, 8> tables {};
+
+            for (std::size_t direction {}; direction < direction_offsets.size(); direction++) {
+                const auto& [x_offset, y_offset] {direction_offsets.at(direction)};
+
+                for (int square {}; square < 64; square++) {
+                    for (int steps {1}; steps < 8; steps++) {
+                        tables.at(direction).at(static_cast<std::size_t>(square)) |=
+                            offset_bits(square, x_offset * steps, y_offset * steps);
+                    }
+                }
+            }
+
+            return tables;
+        }()};
+
+        // Squares a single step in a direction can land on without wrapping around the board,
+        // indexed by `bitboard::Direction`
+        inline constexpr std::array<bitboard::bit_representation, 8> landing_squares {[]() {
+            std::array<bitboard::bit_representation, 8> masks {};
+
+            for (std::size_t direction {}; direction < direction_offsets.size(); direction++) {
+                const auto& [x_offset, y_offset] {direction_offsets.at(direction)};
+
+                for (int square {}; square < 64; square++) {
+                    masks.at(direction) |= offset_bits(square, x_offset, y_offset);
+                }
+            }
+
+            return masks;
+        }()};
+
+        // Squares a step of -2 to 2 files can land on without wrapping around the board, indexed
+        // by the file offset plus 2, for shifting knights and kings set wise
+        inline constexpr std::array<bitboard::bit_representation, 5> file_step_landing_squares {
+            []() {
+                std::array<bitboard::bit_representation, 5> masks {};
+
+                for (int x_offset {-2}; x_offset <= 2; x_offset++) {
+                    for (int square {}; square < 64; square++) {
+                        masks.at(static_cast<std::size_t>(x_offset + 2)) |=
+                            offset_bits(square, x_offset, 0);
+                    }
+                }
+
+                return masks;
+            }()};
+    } // namespace attack_tables
+
+    constexpr bitboard::bit_representation knight_attacks(int square) {
+        return attack_tables::knight [static_cast<std::size_t>(square)];
+    }
+
+    constexpr bitboard::bit_representation king_attacks(int square) {
+        return attack_tables::king [static_cast<std::size_t>(square)];
+    }
+
+    constexpr bitboard::bit_representation pawn_attacks(bitboard::Turn turn, int square) {
+        return attack_tables::pawn [turn == bitboard::Turn::White ? 0 : 1]
+                                   [static_cast<std::size_t>(square)];
+    }
+
+    // Squares in a direction up to and including the first occupied square
+    constexpr bitboard::bit_representation ray_attacks(bitboard::Direction direction, int square,
+                                                       bitboard::bit_representation occupancy) {
+        const auto direction_index {static_cast<std::size_t>(direction)};
+        const bitboard::bit_representation ray {
+            attack_tables::rays [direction_index][static_cast<std::size_t>(square)]};
+        const bitboard::bit_representation blockers {ray & occupancy};
+
+        if (blockers == 0) {
+            return ray;
+        }
+
+        // North, NorthEast, East and NorthWest walk towards higher squares
+        const bool increasing {direction == bitboard::Direction::North ||
+                               direction == bitboard::Direction::NorthEast ||
+                               direction == bitboard::Direction::East ||
+                               direction == bitboard::Direction::NorthWest};
+        const int first_blocker {increasing ? square_index(blockers)
+                                            : 63 - std::countr_zero(blockers)};
+
+        return ray &
+               ~attack_tables::rays [direction_index][static_cast<std::size_t>(first_blocker)];
+    }
+
+    constexpr bitboard::bit_representation bishop_attacks(int square,
+                                                          bitboard::bit_representation occupancy) {
+        bitboard::bit_representation attacks {0};
+
+        for (const bitboard::Direction direction: bitboard::pieces::bishop_directions) {
+            attacks |= ray_attacks(direction, square, occupancy);
+        }
+
+        return attacks;
+    }
+
+    constexpr bitboard::bit_representation rook_attacks(int square,
+                                                        bitboard::bit_representation occupancy) {
+        bitboard::bit_representation attacks {0};
+
+        for (const bitboard::Direction direction: bitboard::pieces::rook_directions) {
+            attacks |= ray_attacks(direction, square, occupancy);
+        }
+
+        return attacks;
+    }
+
+    constexpr bitboard::bit_representation queen_attacks(int square,
+                                                         bitboard::bit_representation occupancy) {
+        return bishop_attacks(square, occupancy) | rook_attacks(square, occupancy);
+    }
+
+    // Kogge-Stone occluded fill: the squares every piece of `sliders` attacks in one direction, up
+    // to and including the first occupied square, in a fixed number of shifts
+    constexpr bitboard::bit_representation fill_attacks(bitboard::Direction direction,
+                                                        bitboard::bit_representation sliders,
+                                                        bitboard::bit_representation occupancy) {
+        const auto direction_index {static_cast<std::size_t>(direction)};
+        const auto& [x_offset, y_offset] {attack_tables::direction_offsets [direction_index]};
+        const int shift {x_offset + 8 * y_offset}; // Positive towards higher squares
+        const bitboard::bit_representation landing {
+            attack_tables::landing_squares [direction_index]};
+
+        const auto step {[shift](bitboard::bit_representation bits, int distance) {
+            return shift > 0 ? bits >> (shift * distance) : bits << (-shift * distance);
+        }};
+
+        bitboard::bit_representation propagators {~occupancy & landing};
+
+        sliders |= propagators & step(sliders, 1);
+        propagators &= step(propagators, 1);
+        sliders |= propagators & step(sliders, 2);
+        propagators &= step(propagators, 2);
+        sliders |= propagators & step(sliders, 4);
+
+        return step(sliders, 1) & landing;
+    }
+
+    // The squares attacked by a whole side's sliders, filled set wise in every direction rather
+    // than looked up square by square. Four directions share an instruction when the build
+    // targets AVX2.
+    [[nodiscard]] bitboard::bit_representation
+        slider_attacks(bitboard::bit_representation diagonal_sliders,
+                       bitboard::bit_representation straight_sliders,
+                       bitboard::bit_representation occupancy);
+} // namespace esochess
+
+#endif
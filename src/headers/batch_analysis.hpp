@@ -0,0 +1,34 @@
+#ifndef ESOCHESS_BATCH_ANALYSIS_HPP
+#define ESOCHESS_BATCH_ANALYSIS_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+
+#include "search.hpp"
+
+namespace esochess {
+    struct batch_analysis_options {
+        std::size_t thread_count;
+        std::size_t hash_megabytes; // Of each worker's table, cleared before every position
+        search_limits limits;       // A depth or node limit keeps the output reproducible
+        std::size_t window; // Positions in flight: read but not yet written, at least one a thread
+    };
+
+    struct batch_analysis_statistics {
+        std::size_t positions;
+        std::size_t invalid_lines;
+        std::uint64_t nodes;
+    };
+
+    // Searches one FEN or EPD position per line of `input` on a pool of workers, each with its own
+    // search engine, and writes an EPD line per position to `output` in input order: the position
+    // followed by `bm`, `ce` (or `dm` for a mate), `acd`, `acn` and `pv`. Memory stays bounded by
+    // the window however long the input is. Invalid lines are written back with a `c0` comment.
+    batch_analysis_statistics analyse_positions(std::istream& input, std::ostream& output,
+                                                const batch_analysis_options& options);
+} // namespace esochess
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef ESOCHESS_BENCH_HPP
+#define ESOCHESS_BENCH_HPP
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+#include "search.hpp"
+
+namespace esochess {
+    inline constexpr int default_bench_depth {5};
+
+    inline constexpr std::array<std::string_view, 8> bench_positions {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 10",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 11",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+        "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10",
+        "4rrk1/pp1n3p/3q2pQ/2p1pb2/2PP4/2P3N1/P2B2PP/4RRK1 b - - 7 19",
+        "6k1/6p1/6Pp/ppp5/3pn2P/1P3K2/1PP2P2/3N4 b - - 0 1"};
+
+    struct bench_result {
+        std::uint64_t nodes; // Changes only when the search itself changes, not for speedups
+        std::chrono::milliseconds time;
+    };
+
+    // Searches every bench position to `depth` on one thread, clearing the hash in between, and
+    // reports each position and the totals to `output`
+    bench_result run_bench(int depth, std::ostream& output,
+                           const search_parameters& parameters = {});
+} // namespace esochess
+
+#endif
@@ -5,8 +5,11 @@
 #include <array>
 #include <cstddef>
 #include <cstdint>
+#include <expected>
 #include <optional>
+#include <span>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <variant>
 #include <vector>
@@ -15,7 +18,7 @@ namespace esochess {
     struct bitboard {
         using bit_representation = std::uint64_t;
 
-        enum class Turn { White, Black, None, All };
+        enum class Turn : std::uint8_t { White, Black, None, All };
         enum class PieceType { Any, AnyPromotion, Pawn, Knight, Bishop, Rook, Queen, King };
         enum class Direction { // Ordinal cordinate where `North` tends towards the 8th rank
                                // `South` tends towards the 1st rank
@@ -38,6 +41,32 @@ namespace esochess {
         static constexpr const char* const starting_position_fen {
             "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1"};
 
+        // 71 board characters, the side to move, 4 castle rights, 2 en passant characters, two 5
+        // digit counters and 5 separators
+        static constexpr std::size_t max_fen_length {93};
+
+        enum class FenErrorType {
+            UnexpectedEnd,
+            InvalidPiece,
+            InvalidBoardLayout,
+            InvalidTurn,
+            InvalidCastleRights,
+            InvalidEnPassant,
+            InvalidHalfmoveClock,
+            InvalidFullmoveNumber,
+            TrailingCharacters
+        };
+
+        struct fen_error {
+            [[nodiscard]] std::string to_string() const;
+
+            bool operator==(const fen_error& other) const noexcept = default;
+            bool operator!=(const fen_error& other) const noexcept = default;
+
+            FenErrorType error_type;
+            std::size_t position; // Offset into the parsed string where the error was found
+        };
+
         struct piece {
             [[nodiscard]] std::string to_string() const;
 
@@ -148,6 +177,47 @@ namespace esochess {
             bool operator!=(const castle_rights_collection& other) const noexcept = default;
         };
 
+        // The position alone: piece type and colour bitboards, with the state packed into small
+        // fields. Trivially copyable and within two cache lines, so copy-make and search stacks
+        // copy it cheaply; `bitboard` wraps it with the cached move listings.
+        struct position {
+            // The bitboard of one piece, indexed as `piece::bitboard_index`
+            [[nodiscard]] constexpr bit_representation
+                pieces(std::size_t bitboard_index) const noexcept {
+                return piece_types.at(bitboard_index % 6) & colours.at(bitboard_index / 6);
+            }
+
+            [[nodiscard]] constexpr bit_representation occupancy() const noexcept {
+                return colours [0] | colours [1];
+            }
+
+            constexpr void add(std::size_t bitboard_index, bit_representation bits) {
+                piece_types.at(bitboard_index % 6) |= bits;
+                colours.at(bitboard_index / 6) |= bits;
+            }
+
+            constexpr void remove(std::size_t bitboard_index, bit_representation bits) {
+                piece_types.at(bitboard_index % 6) &= ~bits;
+                colours.at(bitboard_index / 6) &= ~bits;
+            }
+
+            constexpr void toggle(std::size_t bitboard_index, bit_representation bits) {
+                piece_types.at(bitboard_index % 6) ^= bits;
+                colours.at(bitboard_index / 6) ^= bits;
+            }
+
+            bool operator==(const position& other) const noexcept = default;
+            bool operator!=(const position& other) const noexcept = default;
+
+            std::array<bit_representation, 6> piece_types; // Both colours, pawns to kings
+            std::array<bit_representation, 2> colours;    // White, then black
+            castle_rights_collection castle_rights;
+            std::optional<en_passant_square> en_passant;
+            Turn turn;
+            std::uint16_t halfmove_clock;
+            std::uint16_t fullmove_number;
+        };
+
         enum class MoveTypes { Normal, Capture, EnPassant, Castle, Promotion, PromotionCapture };
 
         struct move_normal {
@@ -193,12 +263,22 @@ namespace esochess {
             PieceType promotion_type;
         };
 
-        // using move = std::variant<move_normal, move_en_passant, move_castle, move_promotion>;
+        using move = std::variant<move_normal, move_en_passant, move_castle, move_promotion>;
 
+        // Each overload also updates the side to move, castle rights, en passant square and clocks
         bitboard& make_move(const move_normal& move);
         bitboard& make_move(const move_en_passant& move);
         bitboard& make_move(const move_castle& move);
         bitboard& make_move(const move_promotion& move);
+        bitboard& make_move(const move& chess_move);
+
+        // Passes the turn: flips the side to move and clears the en passant square, which is
+        // returned so that `unmake_null_move` can restore it
+        std::optional<en_passant_square> make_null_move();
+        bitboard& unmake_null_move(std::optional<en_passant_square> previous_en_passant);
+
+        [[nodiscard]] static bit_representation move_start(const move& chess_move);
+        [[nodiscard]] static bit_representation move_end(const move& chess_move);
 
         bitboard& remove_piece_at_square(const cordinate& cord);
         bitboard& remove_piece_at_square(const bit_representation& bits);
@@ -218,7 +298,19 @@ namespace esochess {
         bitboard(bitboard&& other) = default;
 
         explicit bitboard(const chess_grid& grid);
-        explicit bitboard(const std::string& fen_position);
+        explicit bitboard(const position& board_position); // Without cached move listings
+        bitboard(const std::array<bit_representation, 12>& bitboards, Turn turn,
+                 castle_rights_collection castle_rights,
+                 std::optional<en_passant_square> en_passant, int halfmove_clock,
+                 int fullmove_number);
+        explicit bitboard(const std::string& fen_position); // Throws on an invalid position
+
+        [[nodiscard]] static std::expected<bitboard, fen_error>
+            from_fen(std::string_view fen_position) noexcept;
+        // A FEN, or an EPD line carrying operations such as `bm Nf3;` after the four position
+        // fields instead of the move counters
+        [[nodiscard]] static std::expected<bitboard, fen_error>
+            from_epd(std::string_view epd_line) noexcept;
 
         bitboard& operator=(const bitboard& other) = default;
         bool operator==(const bitboard& other) const noexcept = default;
@@ -232,8 +324,16 @@ namespace esochess {
 
         [[nodiscard]] chess_grid to_grid() const;
         [[nodiscard]] std::string to_fen() const;
+        [[nodiscard]] std::string to_epd() const; // The four position fields, without operations
+        // Returns the amount of characters written, or 0 if `buffer` is shorter than
+        // `max_fen_length`. The output is not null terminated.
+        std::size_t write_fen(std::span<char> buffer) const noexcept;
         [[nodiscard]] std::string to_fancy_string() const;
 
+        [[nodiscard]] const position& as_position() const noexcept;
+        // Copies only the position, leaving the cached move listings behind
+        [[nodiscard]] bitboard position_copy() const;
+        [[nodiscard]] bitboard after_move(const move& chess_move) const; // On a position copy
         [[nodiscard]] std::array<bit_representation, 12> bitboards() const;
         [[nodiscard]] Turn turn() const;
         [[nodiscard]] std::optional<en_passant_square> en_passant() const;
@@ -246,6 +346,9 @@ namespace esochess {
             std::vector<move_castle> castle_moves;
             std::vector<move_en_passant> en_passant_moves;
             std::vector<move_promotion> promotion_moves;
+
+            // Normal moves first, then castling, en passant captures and promotions
+            [[nodiscard]] std::vector<move> flatten() const;
         };
 
         struct cached_moves_listing_t { // Avoid recalculating the moves listing
@@ -269,26 +372,54 @@ namespace esochess {
 
         [[nodiscard]] moves_listing available_moves(Turn turn);
         [[nodiscard]] moves_listing available_moves();
+        [[nodiscard]] moves_listing legal_moves(); // `available_moves` without moves into check
+        [[nodiscard]] std::vector<move> all_legal_moves() const; // Flattened, on a position copy
+        [[nodiscard]] bool has_legal_move() const; // Stops at the first, without making moves
+        [[nodiscard]] bool leaves_king_safe(const move& chess_move) const;
+
+        // Checks of a move from anywhere, such as a hash table, a killer slot or a book, without
+        // generating the moves of the position. A pseudo legal move follows the movement rules
+        // but may leave the king in check; castling through an attacked square is not pseudo
+        // legal. `gives_check` expects a pseudo legal move.
+        [[nodiscard]] bool is_pseudo_legal(const move& chess_move) const;
+        [[nodiscard]] bool is_legal(const move& chess_move) const;
+        [[nodiscard]] bool gives_check(const move& chess_move) const;
+
+        // The legal move from `start` to `end`, with castling given as the king's two square step.
+        // `promotion_type` is `PieceType::Any` unless a pawn reaches the last rank.
+        [[nodiscard]] std::optional<move>
+            legal_move_between(bit_representation start, bit_representation end,
+                               PieceType promotion_type = PieceType::Any) const;
+
+        [[nodiscard]] bit_representation attackers_of(bit_representation square, Turn attacker,
+                                                      bit_representation occupancy) const;
+        [[nodiscard]] bool is_square_attacked(bit_representation square, Turn attacker) const;
+        [[nodiscard]] bool is_in_check(Turn turn) const;
+        [[nodiscard]] bool is_in_check() const;
+
+        [[nodiscard]] std::uint64_t hash() const; // Zobrist hash of the position
         [[nodiscard]] std::optional<bit_representation> controlled_squares(Turn checked_turn) const;
         [[nodiscard]] bit_representation bitboard_bitor_accumulation(Turn turn) const;
         [[nodiscard]] cached_moves_listing_t& cached_moves_listing();
 
         static Turn opposite_turn(Turn turn);
         static Turn opposite_turn(const piece& piece);
+        static Direction opposite_direction(Direction direction);
         static std::vector<cordinate> cordinate_from_bit_representation(bit_representation bits);
         static bool in_bounds(const cordinate& cord);
 
         private:
 
-        std::array<bit_representation, 12> _bitboards {};
-        Turn _turn {};
-        std::optional<en_passant_square> _en_passant {};
-        castle_rights_collection _castle_rights {};
-        int _halfmove_clock {};
-        int _fullmove_number {};
+        bitboard& update_castle_rights(bit_representation squares_touched);
+        bitboard& finish_move();
+
+        position _position {};
 
         cached_moves_listing_t _cached_moves_listing;
     };
+
+    static_assert(std::is_trivially_copyable_v<bitboard::position>);
+    static_assert(sizeof(bitboard::position) <= 128); // Two cache lines
 } // namespace esochess
 
 #endif
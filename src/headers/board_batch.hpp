@@ -0,0 +1,55 @@
+#ifndef ESOCHESS_BOARD_BATCH_HPP
+#define ESOCHESS_BOARD_BATCH_HPP
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "bitboard.hpp"
+
+namespace esochess {
+    // Up to `width` positions stored structure of arrays, one bitboard of every board side by
+    // side, so that pseudo legal moves are generated set wise for all boards at once. The set
+    // operations use AVX2 when the build targets it and plain loops otherwise. Black boards are
+    // stored flipped, so every board generates as white.
+    //
+    // The moves are the pseudo legal moves of `bitboard::is_pseudo_legal`: king moves into check
+    // are included, castling through an attacked square is not.
+    struct board_batch {
+        static constexpr std::size_t width {4};
+
+        using lane_bits = std::array<bitboard::bit_representation, width>;
+
+        // Takes the first `width` boards; the lanes past them hold no pieces
+        explicit board_batch(std::span<const bitboard> boards);
+
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        [[nodiscard]] std::array<std::size_t, width> count_moves() const;
+        // Replaces the contents of `moves`, one list per board
+        void generate_moves(std::array<std::vector<bitboard::move>, width>& moves) const;
+
+        private:
+
+        struct move_targets;
+
+        [[nodiscard]] move_targets targets() const;
+
+        // Own and enemy pieces of the side to move, indexed as the white `bitboard_index`es
+        std::array<lane_bits, 6> _own;
+        std::array<lane_bits, 6> _enemy;
+
+        lane_bits _en_passant;        // The square a pawn may capture on, if any
+        lane_bits _king_side_castle;  // g1 while the right is held, 0 otherwise
+        lane_bits _queen_side_castle; // c1 while the right is held, 0 otherwise
+
+        std::array<bitboard::Turn, width> _turns;
+        std::array<std::optional<bitboard::en_passant_square>, width> _en_passant_squares;
+        std::size_t _size;
+    };
+} // namespace esochess
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef ESOCHESS_EVALUATION_HPP
+#define ESOCHESS_EVALUATION_HPP
+#pragma once
+
+#include <array>
+
+#include "bitboard.hpp"
+
+namespace esochess {
+    // Centipawn values indexed like the white bitboards, pawn to king
+    inline constexpr std::array<int, 6> piece_values {100, 320, 330, 500, 900, 0};
+
+    // Material, piece square tables and slider mobility and king zone attacks, tapered from the
+    // middlegame to the endgame as the non pawn material comes off. Scored in centipawns for the
+    // side to move.
+    [[nodiscard]] int evaluate(const bitboard& board);
+} // namespace esochess
+
+#endif
@@ -0,0 +1,38 @@
+#ifndef ESOCHESS_MAPPED_FILE_HPP
+#define ESOCHESS_MAPPED_FILE_HPP
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <string>
+#include <system_error>
+
+namespace esochess {
+    struct mapped_file { // Read only memory mapping of a whole file
+        enum class AccessPattern { Sequential, Random };
+
+        mapped_file() = default;
+        mapped_file(const mapped_file& other) = delete;
+        mapped_file(mapped_file&& other) noexcept;
+        ~mapped_file();
+
+        mapped_file& operator=(const mapped_file& other) = delete;
+        mapped_file& operator=(mapped_file&& other) noexcept;
+
+        [[nodiscard]] static std::expected<mapped_file, std::error_code>
+            open(const std::string& path, AccessPattern access_pattern = AccessPattern::Sequential);
+
+        [[nodiscard]] std::span<const std::byte> bytes() const noexcept;
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        private:
+
+        mapped_file(const std::byte* data, std::size_t size);
+
+        const std::byte* _data {};
+        std::size_t _size {};
+    };
+} // namespace esochess
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef ESOCHESS_MATE_SOLVER_HPP
+#define ESOCHESS_MATE_SOLVER_HPP
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stop_token>
+#include <vector>
+
+#include "bitboard.hpp"
+
+namespace esochess {
+    // Proof and disproof numbers keyed by position hash and the plies left to mate in
+    struct proof_table {
+        struct proof_numbers {
+            std::uint32_t proof;    // 0 once the side to mate is proven to mate in time
+            std::uint32_t disproof; // 0 once it is proven not to
+        };
+
+        explicit proof_table(std::size_t size_in_megabytes);
+
+        [[nodiscard]] std::optional<proof_numbers> find(std::uint64_t hash,
+                                                        int remaining_plies) const;
+        void store(std::uint64_t hash, int remaining_plies, proof_numbers numbers);
+
+        void resize(std::size_t size_in_megabytes);
+        void clear();
+
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        private:
+
+        struct entry {
+            std::uint64_t key;
+            int remaining_plies;
+            proof_numbers numbers;
+        };
+
+        [[nodiscard]] std::size_t index_of(std::uint64_t hash, int remaining_plies) const noexcept;
+
+        std::vector<entry> _entries;
+    };
+
+    struct mate_solver_limits {
+        int moves;                          // Mate in at most this many moves of the side to move
+        std::optional<std::uint64_t> nodes; // Gives up after this many nodes
+        std::optional<std::chrono::milliseconds> time;
+    };
+
+    struct mate_solution {
+        std::optional<int> mate_in;                      // Moves of the shortest mate, if proven
+        std::vector<bitboard::move> principal_variation; // Longest defence against it
+        bool disproven; // No mate within the limit; neither this nor a mate when interrupted
+        std::uint64_t nodes;
+        std::chrono::milliseconds time;
+    };
+
+    // Depth first proof number search for forced mates. Mates in 1, 2 and so on up to the limit
+    // are tried in turn, so the first proof is the shortest mate. Cycles on the current path count
+    // as failures to mate; the disproofs that rest on one hold for that path only and are never
+    // stored. The table is bounded, replacing entries as they collide.
+    struct mate_solver {
+        static constexpr std::size_t default_table_megabytes {16};
+
+        explicit mate_solver(std::size_t table_megabytes);
+
+        void set_table_size(std::size_t size_in_megabytes);
+        void clear();
+
+        mate_solution solve(const bitboard& root, const mate_solver_limits& limits,
+                            std::stop_token stop_token = {});
+
+        private:
+
+        struct solve_state;
+
+        struct node_result {
+            proof_table::proof_numbers numbers;
+            bool path_dependent; // Disproven only through a repetition of the current path
+        };
+
+        // Runs the search below `board` until it is proven or disproven, or the limits are hit
+        [[nodiscard]] proof_table::proof_numbers prove(solve_state& state, const bitboard& board,
+                                                       int remaining_plies);
+        node_result search_node(solve_state& state, const bitboard& board, int remaining_plies,
+                                std::uint32_t proof_threshold, std::uint32_t disproof_threshold);
+        [[nodiscard]] std::vector<bitboard::move>
+            principal_variation(solve_state& state, const bitboard& board, int remaining_plies);
+
+        proof_table _table;
+    };
+} // namespace esochess
+
+#endif
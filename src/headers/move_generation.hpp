@@ -23,6 +23,10 @@ namespace esochess {
     void add_queen_moves(bitboard& board, bitboard::moves_listing& moves_listing_ext,
                          const bitboard::cordinate& at_cordinate);
 
+    // Pseudo legal moves that capture nothing, do not promote and check the enemy king, either
+    // directly or by uncovering an attack of a piece behind them. Castling is not included.
+    void add_quiet_check_moves(const bitboard& board, bitboard::moves_listing& moves_listing_ext);
+
     void bitor_add_controlled_squares(
         std::optional<bitboard::bit_representation>& controlled_squares_bits,
         const bitboard::bit_representation& bit_mask);
@@ -0,0 +1,74 @@
+#ifndef ESOCHESS_MOVE_ORDERING_HPP
+#define ESOCHESS_MOVE_ORDERING_HPP
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "bitboard.hpp"
+
+namespace esochess {
+    inline constexpr int max_ordering_ply {128};
+
+    struct piece_square {
+        std::size_t piece_index; // Bitboard index of the piece that moved
+        int square;              // Where it moved to
+    };
+
+    struct ordering_context { // The node whose quiet moves are being ordered
+        int ply;
+        bitboard::Turn turn;
+        std::optional<piece_square> previous_move;     // The move that led to the node
+        std::optional<piece_square> own_previous_move; // The side to move's move before that
+    };
+
+    struct quiet_move {
+        std::uint16_t encoded_move; // As in `encode_move`
+        piece_square moved;
+    };
+
+    // Learnt ordering of quiet moves: butterfly history by colour, start and end square,
+    // continuation history by the previous one and two moves, two killers per ply and a
+    // countermove per previous move. Histories are bounded by `history_limit` through gravity:
+    // every update shrinks the entry in proportion to the bonus before adding the bonus.
+    struct move_ordering_tables {
+        static constexpr int history_limit {16384};
+
+        move_ordering_tables();
+
+        void clear();
+        void clear_killers(); // Killers only make sense within one search
+
+        // Orders killers first, then the countermove, then by the summed histories
+        [[nodiscard]] int quiet_score(const ordering_context& context,
+                                      const quiet_move& chess_move) const;
+
+        // Called when `best_move` caused a beta cutoff, with the quiet moves searched before it
+        void update(const ordering_context& context, const quiet_move& best_move,
+                    std::span<const quiet_move> failed_moves, int depth);
+
+        private:
+
+        static constexpr std::size_t piece_square_count {12 * 64};
+
+        [[nodiscard]] static std::size_t butterfly_index(bitboard::Turn turn,
+                                                         std::uint16_t encoded_move);
+        [[nodiscard]] static std::size_t continuation_index(const piece_square& previous,
+                                                            const piece_square& moved);
+        [[nodiscard]] static std::size_t piece_square_index(const piece_square& moved);
+
+        void update_history(const ordering_context& context, const quiet_move& chess_move,
+                            int bonus);
+
+        std::vector<std::int16_t> _butterfly;    // [colour][start][end]
+        std::vector<std::int16_t> _continuation; // [previous piece][square][piece][square]
+        std::vector<std::uint16_t> _countermoves; // [previous piece][square]
+        std::array<std::array<std::uint16_t, 2>, max_ordering_ply> _killers;
+    };
+} // namespace esochess
+
+#endif
@@ -0,0 +1,114 @@
+#ifndef ESOCHESS_PACKED_POSITION_HPP
+#define ESOCHESS_PACKED_POSITION_HPP
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <system_error>
+#include <type_traits>
+
+#include "bitboard.hpp"
+#include "mapped_file.hpp"
+#include "pgn.hpp"
+
+namespace esochess {
+    struct packed_position { // Fixed size encoding of a `bitboard`, stored as is in dataset files
+        static constexpr std::size_t max_pieces {32};
+
+        static constexpr std::uint8_t black_to_move_flag {1U << 0U};
+        static constexpr std::uint8_t white_king_side_flag {1U << 1U};
+        static constexpr std::uint8_t white_queen_side_flag {1U << 2U};
+        static constexpr std::uint8_t black_king_side_flag {1U << 3U};
+        static constexpr std::uint8_t black_queen_side_flag {1U << 4U};
+        static constexpr unsigned result_shift {5}; // Two bits of `flags` label the game result
+        static constexpr std::uint8_t result_mask {3U << result_shift};
+
+        // Empty if the position holds more than `max_pieces` pieces
+        [[nodiscard]] static std::optional<packed_position>
+            from_bitboard(const bitboard& board) noexcept;
+        // `std::errc::invalid_argument` for a corrupt encoding, such as an unknown piece code
+        [[nodiscard]] std::expected<bitboard, std::error_code> to_bitboard() const;
+
+        // `GameResult::Unknown` unless the position was labelled, as self play does
+        [[nodiscard]] GameResult result() const noexcept;
+        void set_result(GameResult game_result) noexcept;
+
+        bool operator==(const packed_position& other) const noexcept = default;
+        bool operator!=(const packed_position& other) const noexcept = default;
+
+        bitboard::bit_representation occupancy;
+        // One 4 bit `bitboard_index` per occupied square, ordered from a1 to h8, low nibble first
+        std::array<std::uint8_t, max_pieces / 2> piece_codes;
+        std::uint8_t flags;
+        std::uint8_t en_passant_file; // 0 when there is no en passant square, otherwise file + 1
+        std::uint16_t halfmove_clock;
+        std::uint16_t fullmove_number;
+        std::int16_t score; // Search score for the side to move, 0 unless labelled
+    };
+
+    static_assert(sizeof(packed_position) == 32);
+    static_assert(std::is_trivially_copyable_v<packed_position>);
+
+    struct position_dataset_header {
+        static constexpr std::array<char, 8> expected_magic {'E', 'S', 'O', 'P',
+                                                             'O', 'S', '0', '1'};
+
+        std::array<char, 8> magic;
+        std::uint64_t position_count;
+        std::array<std::uint8_t, 16> reserved;
+    };
+
+    static_assert(sizeof(position_dataset_header) == sizeof(packed_position));
+
+    struct position_dataset_writer {
+        position_dataset_writer(position_dataset_writer&& other) noexcept = default;
+        ~position_dataset_writer();
+
+        // Closes the dataset being written before taking over `other`
+        position_dataset_writer& operator=(position_dataset_writer&& other) noexcept;
+
+        [[nodiscard]] static std::expected<position_dataset_writer, std::error_code>
+            create(const std::string& path);
+
+        bool write(const packed_position& position);
+        bool write(const bitboard& board); // False if the position could not be packed
+
+        // Writes the final position count into the header, called by the destructor otherwise
+        std::error_code close();
+
+        [[nodiscard]] std::uint64_t position_count() const noexcept;
+
+        private:
+
+        explicit position_dataset_writer(std::ofstream&& stream);
+
+        std::ofstream _stream;
+        std::uint64_t _position_count {};
+    };
+
+    struct position_dataset_reader { // Zero copy view over a memory mapped dataset file
+        [[nodiscard]] static std::expected<position_dataset_reader, std::error_code>
+            open(const std::string& path);
+
+        [[nodiscard]] std::span<const packed_position> positions() const noexcept;
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        [[nodiscard]] const packed_position* begin() const noexcept;
+        [[nodiscard]] const packed_position* end() const noexcept;
+
+        private:
+
+        position_dataset_reader(mapped_file&& file, std::span<const packed_position> positions);
+
+        mapped_file _file;
+        std::span<const packed_position> _positions;
+    };
+} // namespace esochess
+
+#endif
@@ -0,0 +1,53 @@
+#ifndef ESOCHESS_PERFT_HPP
+#define ESOCHESS_PERFT_HPP
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+#include "bitboard.hpp"
+
+namespace esochess {
+    // Subtree node counts keyed by position hash and depth. Entries are written without locks and
+    // checked against their key when read, so any number of threads can share one table.
+    struct perft_table {
+        explicit perft_table(std::size_t size_in_megabytes);
+
+        [[nodiscard]] std::optional<std::uint64_t> find(std::uint64_t hash, int depth) const;
+        void store(std::uint64_t hash, int depth, std::uint64_t nodes);
+
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        private:
+
+        struct entry {
+            std::atomic<std::uint64_t> checked_key; // The hash xor `data`
+            std::atomic<std::uint64_t> data;        // Node count above the low 8 bits of depth
+        };
+
+        [[nodiscard]] std::size_t index_of(std::uint64_t hash, int depth) const noexcept;
+
+        std::vector<entry> _entries;
+    };
+
+    struct perft_divide_entry {
+        bitboard::move root_move;
+        std::uint64_t nodes;
+    };
+
+    // Counts the positions `depth` plies below `board`, taking the last ply from the size of the
+    // legal move list instead of making each move
+    [[nodiscard]] std::uint64_t perft(const bitboard& board, int depth,
+                                      perft_table* table = nullptr);
+
+    // Node counts below each root move, with the root moves shared out between `thread_count`
+    // workers
+    [[nodiscard]] std::vector<perft_divide_entry> perft_divide(const bitboard& board, int depth,
+                                                               std::size_t thread_count,
+                                                               perft_table* table = nullptr);
+} // namespace esochess
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef ESOCHESS_PGN_HPP
+#define ESOCHESS_PGN_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include "bitboard.hpp"
+#include "mapped_file.hpp"
+
+namespace esochess {
+    enum class GameResult { WhiteWin, BlackWin, Draw, Unknown };
+
+    struct pgn_move_visit {
+        std::size_t worker_index; // Lets visitors keep per thread state without locking
+        const bitboard& position_before;
+        const bitboard::move& move_played;
+        const bitboard& position_after;
+        GameResult result; // Taken from the `Result` tag
+    };
+
+    struct pgn_ingest_statistics {
+        pgn_ingest_statistics& operator+=(const pgn_ingest_statistics& other);
+
+        std::uint64_t games;
+        std::uint64_t moves;
+        std::uint64_t unresolved_games; // Games abandoned at a move that could not be resolved
+    };
+
+    using pgn_move_visitor = std::function<void(const pgn_move_visit& visit)>;
+
+    // Replays every game of `pgn_text` on a single thread
+    pgn_ingest_statistics replay_pgn_games(std::string_view pgn_text, std::size_t worker_index,
+                                           const pgn_move_visitor& visitor);
+
+    struct pgn_reader { // Replays a memory mapped PGN file with games split across worker threads
+        [[nodiscard]] static std::expected<pgn_reader, std::error_code>
+            open(const std::string& path);
+
+        // `visitor` is called concurrently from `thread_count` workers
+        pgn_ingest_statistics replay(std::size_t thread_count,
+                                     const pgn_move_visitor& visitor) const;
+
+        private:
+
+        explicit pgn_reader(mapped_file&& file);
+
+        mapped_file _file;
+    };
+} // namespace esochess
+
+#endif
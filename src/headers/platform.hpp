@@ -0,0 +1,56 @@
+#ifndef ESOCHESS_PLATFORM_HPP
+#define ESOCHESS_PLATFORM_HPP
+#pragma once
+
+#include <cstddef>
+#include <expected>
+#include <functional>
+#include <span>
+#include <system_error>
+
+namespace esochess {
+    // Zeroed anonymous memory for large tables. With `PageSize::Huge` the mapping is aligned to
+    // and advised for 2 MB transparent huge pages, falling back on normal pages where the kernel
+    // does not provide them.
+    struct huge_page_memory {
+        enum class PageSize { Default, Huge };
+
+        static constexpr std::size_t huge_page_size {2 * 1024 * 1024};
+
+        huge_page_memory() = default;
+        huge_page_memory(const huge_page_memory& other) = delete;
+        huge_page_memory(huge_page_memory&& other) noexcept;
+        ~huge_page_memory();
+
+        huge_page_memory& operator=(const huge_page_memory& other) = delete;
+        huge_page_memory& operator=(huge_page_memory&& other) noexcept;
+
+        [[nodiscard]] static std::expected<huge_page_memory, std::error_code>
+            allocate(std::size_t size, PageSize page_size = PageSize::Huge);
+
+        [[nodiscard]] std::span<std::byte> bytes() const noexcept;
+        [[nodiscard]] bool advised_huge_pages() const noexcept; // The kernel accepted the advice
+
+        private:
+
+        huge_page_memory(void* mapping, std::size_t mapping_size, std::byte* data,
+                         std::size_t size, bool advised_huge_pages);
+
+        void* _mapping {};
+        std::size_t _mapping_size {};
+        std::byte* _data {};
+        std::size_t _size {};
+        bool _advised_huge_pages {};
+    };
+
+    // Splits [0, count) into one contiguous range per thread, each at least `minimum_per_thread`
+    // long, so that small tables are handled by the calling thread alone
+    void for_each_range_in_parallel(std::size_t count, std::size_t minimum_per_thread,
+                                    const std::function<void(std::size_t, std::size_t)>& work);
+
+    // Pins the calling thread to the `core_index`th core it may run on, modulo their number.
+    // False where affinity is not supported.
+    bool pin_current_thread(std::size_t core_index);
+} // namespace esochess
+
+#endif
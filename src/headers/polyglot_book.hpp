@@ -0,0 +1,90 @@
+#ifndef ESOCHESS_POLYGLOT_BOOK_HPP
+#define ESOCHESS_POLYGLOT_BOOK_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <map>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "bitboard.hpp"
+#include "mapped_file.hpp"
+#include "pgn.hpp"
+
+namespace esochess {
+    struct polyglot_entry { // Stored as 16 big endian bytes in book files, sorted by key
+        std::uint64_t key;
+        std::uint16_t move;
+        std::uint16_t weight;
+        std::uint32_t learn;
+    };
+
+    [[nodiscard]] std::uint64_t polyglot_key(const bitboard& board);
+    [[nodiscard]] std::uint16_t polyglot_move(const bitboard::move& chess_move);
+    [[nodiscard]] std::optional<bitboard::move> move_from_polyglot_move(const bitboard& board,
+                                                                        std::uint16_t encoded_move);
+
+    struct polyglot_book {
+        static constexpr std::size_t entry_size {16};
+
+        [[nodiscard]] static std::expected<polyglot_book, std::error_code>
+            open(const std::string& path);
+
+        [[nodiscard]] std::vector<polyglot_entry> probe(std::uint64_t key) const;
+        [[nodiscard]] std::vector<polyglot_entry> probe(const bitboard& board) const;
+        // Picks a legal book move with a probability proportional to its weight
+        [[nodiscard]] std::optional<bitboard::move> pick_move(bitboard& board,
+                                                              std::mt19937_64& random_engine) const;
+
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        private:
+
+        explicit polyglot_book(mapped_file&& file);
+
+        [[nodiscard]] polyglot_entry entry_at(std::size_t index) const;
+
+        mapped_file _file;
+    };
+
+    struct polyglot_book_builder {
+        struct options {
+            int max_ply;                 // Moves played after this many plies are not recorded
+            std::uint32_t minimum_games; // Moves played in fewer games are left out of the book
+        };
+
+        explicit polyglot_book_builder(options builder_options);
+
+        pgn_ingest_statistics add_games(const pgn_reader& reader, std::size_t thread_count);
+        pgn_ingest_statistics add_games(std::string_view pgn_text);
+
+        // Writes the entries sorted by key, with weights scaled to fit in 16 bits
+        [[nodiscard]] std::error_code write(const std::string& path) const;
+
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        private:
+
+        struct move_statistics {
+            std::uint64_t score; // Two points per win and one per draw for the side that moved
+            std::uint32_t games;
+        };
+
+        using book_moves = std::map<std::pair<std::uint64_t, std::uint16_t>, move_statistics>;
+
+        void record_move(book_moves& moves, const pgn_move_visit& visit) const;
+        void merge(const book_moves& moves);
+
+        options _options;
+        book_moves _moves;
+    };
+} // namespace esochess
+
+#endif
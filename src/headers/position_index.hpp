@@ -0,0 +1,122 @@
+#ifndef ESOCHESS_POSITION_INDEX_HPP
+#define ESOCHESS_POSITION_INDEX_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <system_error>
+#include <vector>
+
+#include "mapped_file.hpp"
+
+namespace esochess {
+    // Open addressing set of 64 bit position keys, such as `bitboard::hash`, storing nothing but
+    // the keys themselves in a power of two table kept at most three quarters full
+    struct position_key_set {
+        static constexpr std::size_t initial_slots {1024};
+
+        bool insert(std::uint64_t key); // True if the key was not in the set yet
+        [[nodiscard]] bool contains(std::uint64_t key) const noexcept;
+        void clear() noexcept; // Keeps the table allocated
+
+        [[nodiscard]] bool at_capacity() const noexcept; // One more key grows the table
+        [[nodiscard]] std::size_t size() const noexcept;
+        [[nodiscard]] std::size_t memory_bytes() const noexcept;
+        [[nodiscard]] std::vector<std::uint64_t> sorted_keys() const;
+
+        private:
+
+        [[nodiscard]] std::size_t slot_of(std::uint64_t key) const noexcept;
+        void grow();
+
+        std::vector<std::uint64_t> _slots; // 0 marks an empty slot, the key 0 is kept aside
+        std::size_t _size {};
+        bool _contains_zero {};
+    };
+
+    struct position_index_options {
+        std::size_t shard_count;         // Rounded up to a power of two
+        std::size_t memory_limit_bytes;  // Over the tables of all shards, spilling beyond it
+        std::filesystem::path spill_directory;
+    };
+
+    struct position_index_statistics {
+        std::uint64_t keys;         // Distinct keys inserted, in memory and spilled alike
+        std::uint64_t spilled_keys;
+        std::size_t memory_bytes;   // Of the in memory tables
+        std::uint64_t spill_bytes;
+        std::size_t spill_runs;
+    };
+
+    // Deduplicates positions by key across many threads and more keys than fit in memory. Keys
+    // are split over shards by their high bits, each locked on its own. A shard whose table would
+    // outgrow its share of the memory limit writes its keys out as a sorted run and starts over,
+    // later keys are also looked up in the runs. Every `runs_per_merge` runs of one tier are merged
+    // into a run of the next tier, so a key is rewritten once per tier rather than at every merge.
+    struct position_index {
+        static constexpr std::size_t runs_per_merge {8};
+
+        position_index(const position_index& other) = delete;
+        position_index(position_index&& other) noexcept = default;
+        ~position_index(); // Removes the spilled runs
+
+        position_index& operator=(const position_index& other) = delete;
+        position_index& operator=(position_index&& other) = delete;
+
+        // Spilled runs go into a new directory inside `spill_directory`
+        [[nodiscard]] static std::expected<position_index, std::error_code>
+            create(const position_index_options& options);
+
+        // True the first time a key is inserted, an error if spilling to disk failed
+        [[nodiscard]] std::expected<bool, std::error_code> insert(std::uint64_t key);
+        [[nodiscard]] bool contains(std::uint64_t key) const;
+
+        // Keys of different shards can be inserted concurrently without waiting on each other
+        [[nodiscard]] std::size_t shard_of(std::uint64_t key) const noexcept;
+        [[nodiscard]] std::size_t shard_count() const noexcept;
+        [[nodiscard]] position_index_statistics statistics() const;
+
+        private:
+
+        struct spilled_run {
+            std::filesystem::path path;
+            mapped_file file;
+            std::span<const std::uint64_t> keys; // Sorted
+            std::size_t tier {};                 // Merges behind the run, 0 when spilled
+        };
+
+        struct shard {
+            mutable std::mutex mutex;
+            position_key_set keys;
+            std::vector<spilled_run> runs;
+            std::size_t runs_written {};
+        };
+
+        position_index(std::filesystem::path spill_directory, std::size_t shard_count,
+                       std::size_t shard_memory_bytes);
+
+        [[nodiscard]] static bool in_runs(const shard& keys_shard, std::uint64_t key);
+        [[nodiscard]] std::error_code spill(shard& full_shard, std::size_t shard_index);
+        [[nodiscard]] std::error_code merge_runs(shard& full_shard, std::size_t shard_index,
+                                                 std::size_t first_run);
+        [[nodiscard]] std::expected<spilled_run, std::error_code>
+            write_run(std::span<const std::uint64_t> keys, shard& full_shard,
+                      std::size_t shard_index) const;
+        [[nodiscard]] std::filesystem::path next_run_path(shard& full_shard,
+                                                          std::size_t shard_index) const;
+        [[nodiscard]] static std::expected<spilled_run, std::error_code>
+            open_run(const std::filesystem::path& path, std::size_t key_count);
+
+        std::filesystem::path _spill_directory;
+        std::vector<std::unique_ptr<shard>> _shards; // Empty once moved from
+        unsigned _shard_shift {};
+        std::size_t _shard_memory_bytes {};
+    };
+} // namespace esochess
+
+#endif
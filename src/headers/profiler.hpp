@@ -0,0 +1,105 @@
+#ifndef ESOCHESS_PROFILER_HPP
+#define ESOCHESS_PROFILER_HPP
+#pragma once
+
+// Scoped timers for the move generation and move making hot paths. They only exist when built
+// with `make LXX_FLAGS=-DESOCHESS_PROFILE` (after `make clean`); otherwise `ESOCHESS_PROFILE_SCOPE`
+// expands to nothing. Each thread counts into its own table, which is merged when the thread
+// exits, and the flat profile is written to standard error when the program exits.
+
+#ifdef ESOCHESS_PROFILE
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+
+namespace esochess::profiling {
+    enum class Section : std::size_t {
+        AvailableMoves,
+        AddPawnMoves,
+        AddPawnEnPassantMoves,
+        AddPawnPromotionMoves,
+        AddKingMoves,
+        AddKingCastleMoves,
+        AddRookBishopQueenMoves,
+        AddKnightMoves,
+        AddBishopMoves,
+        AddRookMoves,
+        AddQueenMoves,
+        AddQuietCheckMoves,
+        MakeMove,
+        MakeMoveNormal,
+        MakeMoveEnPassant,
+        MakeMoveCastle,
+        MakeMovePromotion,
+        Count
+    };
+
+    inline constexpr std::array<std::string_view, static_cast<std::size_t>(Section::Count)>
+        section_names {"available_moves",
+                       "add_pawn_moves",
+                       "add_pawn_en_passant_moves",
+                       "add_pawn_promotion_moves",
+                       "add_king_moves",
+                       "add_king_castle_moves",
+                       "add_rook_bishop_queen_moves",
+                       "add_knight_moves",
+                       "add_bishop_moves",
+                       "add_rook_moves",
+                       "add_queen_moves",
+                       "add_quiet_check_moves",
+                       "make_move(move)",
+                       "make_move(move_normal)",
+                       "make_move(move_en_passant)",
+                       "make_move(move_castle)",
+                       "make_move(move_promotion)"};
+
+    struct section_counters {
+        std::uint64_t calls;
+        std::uint64_t total_ticks; // Including the sections timed inside this one
+        std::uint64_t self_ticks;
+    };
+
+    using profile = std::array<section_counters, static_cast<std::size_t>(Section::Count)>;
+
+    [[nodiscard]] std::uint64_t read_ticks(); // Cycles from rdtsc on x86, nanoseconds elsewhere
+    [[nodiscard]] std::string_view tick_unit();
+
+    // The merged counters of the threads that have exited, plus the calling thread
+    [[nodiscard]] profile collect_profile();
+    void write_profile(std::ostream& output, const profile& counters);
+
+    struct scoped_timer {
+        explicit scoped_timer(Section section);
+        scoped_timer(const scoped_timer& other) = delete;
+        ~scoped_timer();
+
+        scoped_timer& operator=(const scoped_timer& other) = delete;
+
+        private:
+
+        Section _section;
+        std::uint64_t _start;
+        std::uint64_t _child_ticks;
+        scoped_timer* _parent;
+    };
+} // namespace esochess::profiling
+
+#define ESOCHESS_PROFILE_CONCATENATE_INNER(first, second) first##second
+#define ESOCHESS_PROFILE_CONCATENATE(first, second)                                               \
+    ESOCHESS_PROFILE_CONCATENATE_INNER(first, second)
+#define ESOCHESS_PROFILE_SCOPE(section)                                                           \
+    ::esochess::profiling::scoped_timer ESOCHESS_PROFILE_CONCATENATE(esochess_profile_timer_,     \
+                                                                     __LINE__) {                  \
+        ::esochess::profiling::Section::section                                                   \
+    }
+
+#else
+
+#define ESOCHESS_PROFILE_SCOPE(section)
+
+#endif
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef ESOCHESS_SAN_HPP
+#define ESOCHESS_SAN_HPP
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include "bitboard.hpp"
+
+namespace esochess {
+    // Resolves standard algebraic notation (`Nbd7`, `exd6`, `e8=Q+`, `O-O`) against the legal moves
+    // of `board`. Empty if the move is malformed, illegal or ambiguous.
+    [[nodiscard]] std::optional<bitboard::move> move_from_san(bitboard& board,
+                                                              std::string_view san);
+    [[nodiscard]] std::string move_to_san(bitboard& board, const bitboard::move& chess_move);
+} // namespace esochess
+
+#endif
@@ -0,0 +1,216 @@
+#ifndef ESOCHESS_SEARCH_HPP
+#define ESOCHESS_SEARCH_HPP
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <stop_token>
+#include <string>
+#include <vector>
+
+#include "bitboard.hpp"
+#include "move_ordering.hpp"
+#include "platform.hpp"
+#include "syzygy.hpp"
+
+namespace esochess {
+    inline constexpr int max_search_ply {128};
+    inline constexpr int mate_score {32000};      // Mated at the root, less one per ply
+    inline constexpr int tablebase_win_score {mate_score - 2 * max_search_ply};
+    inline constexpr int infinite_score {mate_score + 1};
+    inline constexpr std::size_t cache_line_size {64};
+
+    [[nodiscard]] constexpr bool is_mate_score(int score) {
+        return score > mate_score - max_search_ply || score < -mate_score + max_search_ply;
+    }
+
+    // Moves are stored in the transposition table as the start square, the end square shifted by
+    // 6 and the promotion piece (knight 1 to queen 4) shifted by 12
+    [[nodiscard]] std::uint16_t encode_move(const bitboard::move& chess_move);
+
+    // Entries are written without locks and checked against their key when read, like the perft
+    // table, so that the table can later be shared between search threads
+    struct transposition_table {
+        enum class Bound : std::uint8_t { Exact, Lower, Upper };
+
+        struct probe_result {
+            std::uint16_t encoded_move;
+            int score;
+            int depth;
+            Bound bound;
+        };
+
+        using PageSize = huge_page_memory::PageSize;
+
+        explicit transposition_table(std::size_t size_in_megabytes,
+                                     PageSize page_size = PageSize::Huge);
+
+        [[nodiscard]] std::optional<probe_result> probe(std::uint64_t hash) const;
+        void store(std::uint64_t hash, std::uint16_t encoded_move, int score, int depth,
+                   Bound bound);
+
+        void resize(std::size_t size_in_megabytes, PageSize page_size = PageSize::Huge);
+        void clear(); // Zeroes large tables on several threads
+        void new_search(); // Ages the entries written by earlier searches
+
+        [[nodiscard]] std::size_t size() const noexcept;
+        // Permille of a sample of entries written during the current search, as in UCI `hashfull`
+        [[nodiscard]] int hashfull() const;
+        [[nodiscard]] bool advised_huge_pages() const noexcept;
+
+        private:
+
+        struct entry {
+            std::atomic<std::uint64_t> checked_key; // The hash xor `data`
+            std::atomic<std::uint64_t> data;        // Move, score, depth, bound and generation
+        };
+
+        huge_page_memory _memory;
+        std::span<entry> _entries; // Constructed in `_memory`
+        std::uint64_t _generation;
+    };
+
+    // Counters kept by a search thread in its own cache lines and only summed when reported, so
+    // the hot path never writes to shared memory
+    struct alignas(cache_line_size) search_statistics {
+        std::uint64_t nodes; // Including the quiescence nodes
+        std::uint64_t quiescence_nodes;
+        std::uint64_t table_probes;
+        std::uint64_t table_hits;
+        std::uint64_t table_cutoffs;
+        std::uint64_t beta_cutoffs; // Main search only, stand pat cutoffs are not counted
+        std::uint64_t first_move_cutoffs;
+        std::uint64_t generated_moves;
+        std::uint64_t searched_moves;
+        std::uint64_t tablebase_hits;
+        std::uint64_t null_move_cutoffs;
+        std::uint64_t reverse_futility_cutoffs;
+        std::uint64_t futility_pruned_moves;
+        std::uint64_t late_move_pruned_moves;
+        std::uint64_t reduced_searches;
+        std::uint64_t reduced_re_searches; // Reduced searches that beat alpha and were repeated
+
+        search_statistics& operator+=(const search_statistics& other);
+
+        [[nodiscard]] std::string to_string() const; // One counter group per line
+    };
+
+    // Margins and limits of the selective search. A technique is turned off by putting its depth
+    // limit out of reach.
+    struct search_parameters {
+        int null_move_min_depth {3};
+        int null_move_base_reduction {3};
+        int null_move_depth_divisor {4}; // One more ply of reduction per this many plies of depth
+
+        // Late move reductions are log(depth) * log(move number) / divisor plus the base, both in
+        // hundredths of a ply
+        int reduction_base {75};
+        int reduction_divisor {225};
+        int reduction_min_depth {3};
+        int reduction_min_moves {3};
+
+        int reverse_futility_max_depth {6};
+        int reverse_futility_margin {80}; // Per ply of depth
+
+        int futility_max_depth {6};
+        int futility_base_margin {100};
+        int futility_depth_margin {100};
+
+        int late_move_pruning_max_depth {6};
+        int late_move_pruning_base {3}; // Quiet moves tried are limited to this plus depth squared
+    };
+
+    struct search_limits {
+        std::optional<int> depth;
+        std::optional<std::uint64_t> nodes;
+        std::optional<std::chrono::milliseconds> move_time;
+        std::optional<std::chrono::milliseconds> time_left; // Clock of the side to move
+        std::chrono::milliseconds increment;
+        std::optional<int> moves_to_go;
+        bool infinite; // Keeps the result back until stopped, even once the depth limit is reached
+        bool ponder;   // Like `infinite` until `search_engine::ponder_hit`, which starts the clock
+        std::size_t multi_pv {1}; // How many of the best root moves to find a line for
+    };
+
+    struct search_iteration { // Reported for every line after every completed depth
+        int depth;
+        std::size_t line; // 1 for the best line, as in UCI's `multipv`
+        int selective_depth;
+        int score;
+        int hashfull;
+        std::chrono::milliseconds time;
+        search_statistics statistics;
+        std::vector<bitboard::move> principal_variation;
+    };
+
+    struct search_line {
+        int score;
+        std::vector<bitboard::move> principal_variation;
+    };
+
+    struct search_result {
+        std::optional<bitboard::move> best_move; // Empty when the root has no legal moves
+        std::optional<bitboard::move> ponder_move;
+        int score;
+        int depth;
+        search_statistics statistics;
+        std::vector<search_line> lines; // Of the last completed depth, best first
+    };
+
+    // Iterative deepening principal variation search with a transposition table, history based
+    // quiet move ordering, null move pruning, late move reductions, futility and late move
+    // pruning, and a quiescence search over captures, plus quiet checks at its first ply
+    struct search_engine {
+        using report_function = std::function<void(const search_iteration&)>;
+
+        explicit search_engine(std::size_t hash_megabytes);
+
+        void set_hash_size(std::size_t size_in_megabytes,
+                           transposition_table::PageSize page_size =
+                               transposition_table::PageSize::Huge);
+        void set_tablebases(const syzygy_tablebases* tablebases);
+        void set_parameters(const search_parameters& parameters);
+        [[nodiscard]] const search_parameters& parameters() const noexcept;
+        void clear(); // Forgets everything learnt from earlier searches
+
+        // Turns the running ponder search into a normal one, timed from now. Safe to call from any
+        // thread.
+        void ponder_hit();
+
+        // `history` holds the hashes of the game positions before `root`, oldest first, and is
+        // used to find repetitions. Stops at the limits or once `stop_token` is triggered.
+        search_result search(const bitboard& root, std::span<const std::uint64_t> history,
+                             const search_limits& limits, const report_function& report = {},
+                             std::stop_token stop_token = {});
+
+        private:
+
+        struct search_state;
+
+        [[nodiscard]] int negamax(search_state& state, const bitboard& board, int alpha, int beta,
+                                  int depth, int ply,
+                                  std::vector<bitboard::move>& principal_variation);
+        [[nodiscard]] int reduction(int depth, std::size_t move_number, bool is_pv_node) const;
+        [[nodiscard]] int quiescence(search_state& state, const bitboard& board, int alpha,
+                                     int beta, int ply, bool include_checks);
+
+        [[nodiscard]] std::optional<int> probe_tablebases(const bitboard& board, int ply) const;
+
+        transposition_table _table;
+        move_ordering_tables _ordering;
+        const syzygy_tablebases* _tablebases;
+
+        search_parameters _parameters;
+        std::array<std::array<int, 64>, 64> _reductions; // In hundredths, by depth and move number
+
+        std::atomic<bool> _ponder_hit; // Cleared when a search returns
+    };
+} // namespace esochess
+
+#endif
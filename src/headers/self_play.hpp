@@ -0,0 +1,55 @@
+#ifndef ESOCHESS_SELF_PLAY_HPP
+#define ESOCHESS_SELF_PLAY_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <stop_token>
+
+#include "packed_position.hpp"
+
+namespace esochess {
+    struct self_play_options {
+        std::size_t thread_count;
+        std::uint64_t games;
+        std::uint64_t nodes;        // Node limit of every search
+        std::size_t hash_megabytes; // Of each thread's table, cleared between games
+        std::uint64_t seed;
+
+        int random_plies; // Uniformly random moves that open each game, never recorded
+        int max_plies;    // A game this long is drawn
+
+        // A side wins once the score stays at least `resign_score` for it for `resign_plies`
+        // plies in a row. A game is drawn once the score stays within `draw_score` of 0 for
+        // `draw_plies` plies in a row, from ply `draw_min_ply` on.
+        int resign_score;
+        int resign_plies;
+        int draw_score;
+        int draw_plies;
+        int draw_min_ply;
+    };
+
+    struct self_play_statistics {
+        std::uint64_t games;
+        std::uint64_t positions; // Written to the dataset
+        std::uint64_t white_wins;
+        std::uint64_t black_wins;
+        std::uint64_t draws;
+        std::uint64_t adjudicated; // Ended by the resign or draw rule rather than on the board
+        std::uint64_t nodes;
+    };
+
+    // Called with the totals so far after every game
+    using self_play_progress = std::function<void(const self_play_statistics&)>;
+
+    // Plays games of the engine against itself on `thread_count` threads and writes the quiet
+    // positions of every game, labelled with the search score and the game result, to `writer`.
+    // Positions in check and those whose best move captures or promotes are left out.
+    self_play_statistics run_self_play(const self_play_options& options,
+                                       position_dataset_writer& writer,
+                                       const self_play_progress& progress = {},
+                                       std::stop_token stop_token = {});
+} // namespace esochess
+
+#endif
@@ -0,0 +1,71 @@
+#ifndef ESOCHESS_SYZYGY_HPP
+#define ESOCHESS_SYZYGY_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "bitboard.hpp"
+
+namespace esochess {
+    // Win, draw or loss for the side to move, where the cursed win and blessed loss are drawn by
+    // the fifty move rule
+    enum class WdlScore { Loss = -2, BlessedLoss = -1, Draw = 0, CursedWin = 1, Win = 2 };
+
+    // Read only access to the Syzygy `.rtbw` and `.rtbz` files of one or more directories. Tables
+    // are memory mapped and decoded when opened, so one instance can be probed from any number of
+    // search threads at once.
+    struct syzygy_tablebases {
+        syzygy_tablebases();
+        syzygy_tablebases(const syzygy_tablebases& other) = delete;
+        syzygy_tablebases(syzygy_tablebases&& other) noexcept;
+        ~syzygy_tablebases();
+
+        syzygy_tablebases& operator=(const syzygy_tablebases& other) = delete;
+        syzygy_tablebases& operator=(syzygy_tablebases&& other) noexcept;
+
+        // `paths` lists directories separated by ':', as in the UCI `SyzygyPath` option. Missing
+        // directories and unreadable or corrupted files are skipped.
+        [[nodiscard]] static syzygy_tablebases open(std::string_view paths);
+
+        // Both probes fail when a table is missing or the position still has castle rights
+        [[nodiscard]] std::optional<WdlScore> probe_wdl(const bitboard& board) const;
+        // Plies to the next capture or pawn move that keeps the result, negative when losing and
+        // offset by 100 for cursed wins and blessed losses. Mated positions return -1.
+        [[nodiscard]] std::optional<int> probe_dtz(const bitboard& board) const;
+
+        // The legal moves that keep the best tablebase result, ranked by distance to zeroing when
+        // the DTZ tables are present
+        [[nodiscard]] std::optional<std::vector<bitboard::move>>
+            root_moves(const bitboard& board) const;
+
+        [[nodiscard]] int max_pieces() const noexcept; // Largest piece count of any table
+        [[nodiscard]] std::size_t size() const noexcept;
+
+        private:
+
+        struct pairs_data;
+        struct table_file;
+        struct table;
+
+        enum class ProbeState { Ok, Failed, ChangeSideToMove, ZeroingBestMove };
+
+        [[nodiscard]] const table* find_table(std::uint64_t material_key) const;
+
+        [[nodiscard]] int probe_table(const bitboard& board, bool probe_dtz_table, WdlScore wdl,
+                                      ProbeState& state) const;
+        [[nodiscard]] WdlScore search(const bitboard& board, bool check_zeroing_moves,
+                                      ProbeState& state) const;
+        [[nodiscard]] int probe_dtz(const bitboard& board, ProbeState& state) const;
+
+        std::vector<table> _tables;
+        std::unordered_map<std::uint64_t, std::size_t> _table_indices; // Keyed by material
+        int _max_pieces;
+    };
+} // namespace esochess
+
+#endif
@@ -0,0 +1,81 @@
+#ifndef ESOCHESS_UCI_HPP
+#define ESOCHESS_UCI_HPP
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <mutex>
+#include <optional>
+#include <ostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "bitboard.hpp"
+#include "mate_solver.hpp"
+#include "polyglot_book.hpp"
+#include "search.hpp"
+#include "syzygy.hpp"
+
+namespace esochess {
+    // Long algebraic notation as used by UCI, such as `e2e4`, `e1g1` or `e7e8q`
+    [[nodiscard]] std::string move_to_uci(const bitboard::move& chess_move);
+    [[nodiscard]] std::optional<bitboard::move> move_from_uci(const bitboard& board,
+                                                              std::string_view uci_move);
+    // The whole of `text` as a decimal integer, nothing for anything else or out of range values
+    [[nodiscard]] std::optional<std::int64_t> parse_integer(std::string_view text);
+    // Also nothing outside `minimum` to `maximum`, as command line options are checked
+    [[nodiscard]] std::optional<std::int64_t> parse_integer(std::string_view text,
+                                                            std::int64_t minimum,
+                                                            std::int64_t maximum);
+
+    // Speaks the UCI protocol. Searches run on their own thread so that `stop`, `isready` and
+    // `quit` are answered while the engine thinks.
+    struct uci_engine {
+        static constexpr std::size_t default_hash_megabytes {16};
+        static constexpr std::size_t max_multi_pv {256};
+
+        explicit uci_engine(std::ostream& output);
+        uci_engine(const uci_engine& other) = delete;
+        ~uci_engine();
+
+        uci_engine& operator=(const uci_engine& other) = delete;
+
+        void run(std::istream& input); // Reads commands until `quit` or the end of the input
+        bool handle_command(std::string_view command_line); // False once `quit` is received
+
+        private:
+
+        // Also records `statistics` for the `stats` command when given
+        void send(std::string_view line, const search_statistics* statistics = nullptr);
+
+        void set_option(std::string_view arguments);
+        void set_position(std::string_view arguments);
+        void go(std::string_view arguments);
+        void stop_search();
+
+        std::ostream& _output;
+        std::mutex _output_mutex;
+        search_statistics _statistics; // Guarded by `_output_mutex`
+
+        search_engine _engine;
+        mate_solver _mate_solver; // For `go mate`
+        bitboard _position;
+        std::vector<std::uint64_t> _history; // Hashes of the game positions before `_position`
+        std::size_t _multi_pv;
+
+        std::optional<syzygy_tablebases> _tablebases;
+        std::optional<polyglot_book> _book;
+        bool _own_book;
+        bool _pin_search_thread;
+        std::size_t _next_search_core; // Searches take the allowed cores in turn when pinned
+        std::mt19937_64 _random_engine;
+
+        std::jthread _search_thread;
+    };
+} // namespace esochess
+
+#endif
@@ -1,2 +1,31 @@
-int main() {
+#include <algorithm>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <headers/bench.hpp>
+#include <headers/search.hpp>
+#include <headers/uci.hpp>
+
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string_view {argv [1]} == "bench") { // `main bench [depth]`
+        const std::optional<std::int64_t> depth {argc > 2 ? esochess::parse_integer(argv [2])
+                                                          : std::nullopt};
+
+        if (argc > 2 && !depth.has_value()) {
+            std::cout << "info string Invalid bench depth: " << argv [2] << std::endl;
+        }
+
+        static_cast<void>(esochess::run_bench(
+            depth.has_value()
+                ? static_cast<int>(std::clamp<std::int64_t>(*depth, 1, esochess::max_search_ply))
+                : esochess::default_bench_depth,
+            std::cout));
+        return 0;
+    }
+
+    esochess::uci_engine engine {std::cout};
+    engine.run(std::cin);
 }
@@ -0,0 +1,88 @@
+#include <cerrno>
+#include <cstddef>
+#include <expected>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "headers/mapped_file.hpp"
+
+namespace esochess {
+    mapped_file::mapped_file(const std::byte* data, std::size_t size) : _data {data}, _size {size} {
+    }
+
+    mapped_file::mapped_file(mapped_file&& other) noexcept :
+        _data {std::exchange(other._data, nullptr)}, _size {std::exchange(other._size, 0)} {
+    }
+
+    mapped_file::~mapped_file() {
+        if (_data != nullptr) {
+            munmap(const_cast<std::byte*>(_data), _size);
+        }
+    }
+
+    mapped_file& mapped_file::operator=(mapped_file&& other) noexcept {
+        if (this != &other) {
+            if (_data != nullptr) {
+                munmap(const_cast<std::byte*>(_data), _size);
+            }
+
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+        }
+
+        return *this;
+    }
+
+    std::expected<mapped_file, std::error_code> mapped_file::open(const std::string& path,
+                                                                  AccessPattern access_pattern) {
+        const int file_descriptor {::open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+
+        if (file_descriptor < 0) {
+            return std::unexpected {std::error_code {errno, std::system_category()}};
+        }
+
+        struct stat file_status {};
+
+        if (fstat(file_descriptor, &file_status) != 0) {
+            const std::error_code error {errno, std::system_category()};
+            close(file_descriptor);
+            return std::unexpected {error};
+        }
+
+        const auto file_size {static_cast<std::size_t>(file_status.st_size)};
+
+        if (file_size == 0) { // mmap does not accept empty mappings
+            close(file_descriptor);
+            return mapped_file {};
+        }
+
+        void* const mapping {mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0)};
+        const int mmap_errno {errno};
+
+        close(file_descriptor);
+
+        if (mapping == MAP_FAILED) {
+            return std::unexpected {std::error_code {mmap_errno, std::system_category()}};
+        }
+
+        madvise(mapping, file_size,
+                access_pattern == AccessPattern::Sequential ? MADV_SEQUENTIAL : MADV_RANDOM);
+
+        return mapped_file {static_cast<const std::byte*>(mapping), file_size};
+    }
+
+    std::span<const std::byte> mapped_file::bytes() const noexcept {
+        return {_data, _size};
+    }
+
+    std::size_t mapped_file::size() const noexcept {
+        return _size;
+    }
+} // namespace esochess
@@ -0,0 +1,345 @@
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <stop_token>
+#include <utility>
+#include <vector>
+
+#include "headers/bitboard.hpp"
+#include "headers/mate_solver.hpp"
+
+namespace esochess {
+    namespace {
+        using clock = std::chrono::steady_clock;
+        using proof_numbers = proof_table::proof_numbers;
+
+        constexpr std::uint32_t infinite_proof {1U << 30U};
+        constexpr std::uint64_t time_check_interval {1024}; // Nodes between clock reads
+
+        constexpr proof_numbers proven {0, infinite_proof};
+        constexpr proof_numbers disproven {infinite_proof, 0};
+
+        std::uint32_t saturating_sum(std::uint32_t first, std::uint32_t second) {
+            return std::min(first + second, infinite_proof);
+        }
+
+        std::uint32_t threshold_for_child(std::uint32_t threshold, std::uint32_t node_number,
+                                          std::uint32_t child_number) {
+            const std::int64_t child_threshold {static_cast<std::int64_t>(threshold) -
+                                                node_number + child_number};
+
+            return static_cast<std::uint32_t>(
+                std::clamp<std::int64_t>(child_threshold, 0, infinite_proof));
+        }
+
+        struct child_node {
+            bitboard::move chess_move;
+            bitboard board;
+            std::uint64_t hash;
+        };
+
+        std::vector<child_node> children_of(const bitboard& board) {
+            std::vector<child_node> children {};
+
+            for (const bitboard::move& chess_move: board.all_legal_moves()) {
+                const bitboard child {board.after_move(chess_move)};
+
+                children.emplace_back(chess_move, child, child.hash());
+            }
+
+            return children;
+        }
+
+        // The side to mate moves when an odd number of plies is left
+        bool is_attacker_node(int remaining_plies) {
+            return remaining_plies % 2 == 1;
+        }
+    } // namespace
+
+    proof_table::proof_table(std::size_t size_in_megabytes) {
+        resize(size_in_megabytes);
+    }
+
+    std::size_t proof_table::index_of(std::uint64_t hash, int remaining_plies) const noexcept {
+        const std::uint64_t depth_hash {hash ^ (static_cast<std::uint64_t>(remaining_plies) *
+                                                0x9e37'79b9'7f4a'7c15)};
+
+        return static_cast<std::size_t>(depth_hash & (_entries.size() - 1));
+    }
+
+    std::optional<proof_table::proof_numbers> proof_table::find(std::uint64_t hash,
+                                                                int remaining_plies) const {
+        const entry& table_entry {_entries [index_of(hash, remaining_plies)]};
+
+        if (table_entry.key != hash || table_entry.remaining_plies != remaining_plies) {
+            return std::nullopt;
+        }
+
+        return table_entry.numbers;
+    }
+
+    void proof_table::store(std::uint64_t hash, int remaining_plies, proof_numbers numbers) {
+        _entries [index_of(hash, remaining_plies)] = entry {hash, remaining_plies, numbers};
+    }
+
+    void proof_table::resize(std::size_t size_in_megabytes) {
+        _entries = std::vector<entry>(
+            std::bit_floor(std::max<std::size_t>(size_in_megabytes * 1024 * 1024 / sizeof(entry),
+                                                 1)));
+        clear();
+    }
+
+    void proof_table::clear() {
+        // A remaining ply count of -1 never matches a lookup
+        std::ranges::fill(_entries, entry {0, -1, proof_numbers {0, 0}});
+    }
+
+    std::size_t proof_table::size() const noexcept {
+        return _entries.size();
+    }
+
+    struct mate_solver::solve_state {
+        mate_solver_limits limits;
+        std::stop_token stop_token;
+        clock::time_point start;
+
+        std::uint64_t nodes;
+        bool stopped;
+        std::vector<std::uint64_t> path; // Hashes of the positions being searched
+
+        // Counts the node and reports whether the search has to unwind
+        bool visit_node() {
+            nodes++;
+
+            if (!stopped &&
+                ((limits.nodes.has_value() && nodes >= *limits.nodes) ||
+                 (nodes % time_check_interval == 0 &&
+                  (stop_token.stop_requested() ||
+                   (limits.time.has_value() && clock::now() - start >= *limits.time))))) {
+                stopped = true;
+            }
+
+            return stopped;
+        }
+    };
+
+    mate_solver::mate_solver(std::size_t table_megabytes) : _table {table_megabytes} {
+    }
+
+    void mate_solver::set_table_size(std::size_t size_in_megabytes) {
+        _table.resize(size_in_megabytes);
+    }
+
+    void mate_solver::clear() {
+        _table.clear();
+    }
+
+    mate_solution mate_solver::solve(const bitboard& root, const mate_solver_limits& limits,
+                                     std::stop_token stop_token) {
+        solve_state state {limits, std::move(stop_token), clock::now(), 0, false, {}};
+        mate_solution solution {std::nullopt, {}, false, 0, std::chrono::milliseconds {0}};
+
+        for (int moves {1}; moves <= limits.moves && !state.stopped; moves++) {
+            const proof_numbers numbers {prove(state, root, 2 * moves - 1)};
+
+            if (!state.stopped && numbers.proof == 0) {
+                solution.mate_in = moves;
+                solution.principal_variation = principal_variation(state, root, 2 * moves - 1);
+                break;
+            }
+        }
+
+        solution.disproven = !solution.mate_in.has_value() && !state.stopped;
+        solution.nodes = state.nodes;
+        solution.time =
+            std::chrono::duration_cast<std::chrono::milliseconds>(clock::now() - state.start);
+
+        return solution;
+    }
+
+    proof_numbers mate_solver::prove(solve_state& state, const bitboard& board,
+                                     int remaining_plies) {
+        const std::optional<proof_numbers> stored {_table.find(board.hash(), remaining_plies)};
+
+        if (stored.has_value() && (stored->proof == 0 || stored->disproof == 0)) {
+            return *stored;
+        }
+
+        return search_node(state, board, remaining_plies, infinite_proof, infinite_proof).numbers;
+    }
+
+    mate_solver::node_result mate_solver::search_node(solve_state& state, const bitboard& board,
+                                                      int remaining_plies,
+                                                      std::uint32_t proof_threshold,
+                                                      std::uint32_t disproof_threshold) {
+        if (state.visit_node()) {
+            return node_result {proof_numbers {1, 1}, false};
+        }
+
+        const std::uint64_t hash {board.hash()};
+        const bool attacker_node {is_attacker_node(remaining_plies)};
+
+        // The attacker's last move has been played, only whether it mated is left to decide
+        if (remaining_plies == 0) {
+            const proof_numbers numbers {
+                board.is_in_check() && !board.has_legal_move() ? proven : disproven};
+
+            _table.store(hash, remaining_plies, numbers);
+            return node_result {numbers, false};
+        }
+
+        std::vector<child_node> children {children_of(board)};
+
+        // Only a check can mate with the last move
+        if (attacker_node && remaining_plies == 1) {
+            std::erase_if(children,
+                          [](const child_node& child) { return !child.board.is_in_check(); });
+        }
+
+        if (children.empty()) {
+            const proof_numbers numbers {
+                !attacker_node && board.is_in_check() ? proven : disproven};
+
+            _table.store(hash, remaining_plies, numbers);
+            return node_result {numbers, false};
+        }
+
+        // Disproofs through a repetition of the current path, valid during this visit only
+        std::vector<std::optional<proof_numbers>> path_dependent_numbers(children.size());
+
+        const auto numbers_of {[this, &state, &path_dependent_numbers, &children,
+                                remaining_plies](std::size_t index) {
+            if (std::ranges::find(state.path, children.at(index).hash) != state.path.end()) {
+                return disproven; // Going round in circles never mates
+            }
+
+            return path_dependent_numbers.at(index).value_or(
+                _table.find(children.at(index).hash, remaining_plies - 1)
+                    .value_or(proof_numbers {1, 1}));
+        }};
+
+        const auto depends_on_path {[&state, &path_dependent_numbers, &children](
+                                        std::size_t index) {
+            return path_dependent_numbers.at(index).has_value() ||
+                   std::ranges::find(state.path, children.at(index).hash) != state.path.end();
+        }};
+
+        proof_numbers numbers {};
+        bool path_dependent {false};
+
+        state.path.push_back(hash);
+
+        while (true) {
+            // The number that chooses the child: proof at the attacker's nodes, disproof otherwise
+            const auto choosing_number {[attacker_node](const proof_numbers& child_numbers) {
+                return attacker_node ? child_numbers.proof : child_numbers.disproof;
+            }};
+
+            std::size_t best_index {0};
+            std::uint32_t best_number {infinite_proof};
+            std::uint32_t second_number {infinite_proof};
+            std::uint32_t summed_number {0};
+            proof_numbers best_numbers {};
+
+            path_dependent = false;
+
+            for (std::size_t index {}; index < children.size(); index++) {
+                const proof_numbers child_numbers {numbers_of(index)};
+                const std::uint32_t number {choosing_number(child_numbers)};
+
+                summed_number = saturating_sum(summed_number, attacker_node
+                                                                  ? child_numbers.disproof
+                                                                  : child_numbers.proof);
+                path_dependent = path_dependent ||
+                                 (child_numbers.disproof == 0 && depends_on_path(index));
+
+                if (number < best_number) {
+                    second_number = best_number;
+                    best_number = number;
+                    best_index = index;
+                    best_numbers = child_numbers;
+                }
+
+                else if (number < second_number) {
+                    second_number = number;
+                }
+            }
+
+            numbers = attacker_node ? proof_numbers {best_number, summed_number}
+                                    : proof_numbers {summed_number, best_number};
+
+            if (numbers.proof >= proof_threshold || numbers.disproof >= disproof_threshold ||
+                state.stopped) {
+                break;
+            }
+
+            const std::uint32_t child_proof_threshold {
+                attacker_node ? std::min(proof_threshold, saturating_sum(second_number, 1))
+                              : threshold_for_child(proof_threshold, numbers.proof,
+                                                    best_numbers.proof)};
+            const std::uint32_t child_disproof_threshold {
+                attacker_node ? threshold_for_child(disproof_threshold, numbers.disproof,
+                                                    best_numbers.disproof)
+                              : std::min(disproof_threshold, saturating_sum(second_number, 1))};
+
+            const node_result child_result {search_node(state, children.at(best_index).board,
+                                                        remaining_plies - 1, child_proof_threshold,
+                                                        child_disproof_threshold)};
+
+            path_dependent_numbers.at(best_index) =
+                child_result.path_dependent ? std::optional {child_result.numbers} : std::nullopt;
+        }
+
+        state.path.pop_back();
+
+        // Only disproofs rest on the path, proofs never count a repetition as a mate
+        path_dependent = path_dependent && numbers.disproof == 0;
+
+        if (!path_dependent) {
+            _table.store(hash, remaining_plies, numbers);
+        }
+
+        return node_result {numbers, path_dependent};
+    }
+
+    std::vector<bitboard::move> mate_solver::principal_variation(solve_state& state,
+                                                                 const bitboard& board,
+                                                                 int remaining_plies) {
+        std::vector<bitboard::move> variation {};
+        bitboard position {board.position_copy()};
+
+        // The attacker plays the fastest mate, the defender the reply that delays it the longest
+        while (remaining_plies > 0 && !state.stopped) {
+            const bool attacker_node {is_attacker_node(remaining_plies)};
+            std::optional<child_node> chosen_child {};
+            int chosen_plies {attacker_node ? std::numeric_limits<int>::max() : -1};
+
+            for (const child_node& child: children_of(position)) {
+                for (int plies {attacker_node ? 0 : 1}; plies < remaining_plies; plies += 2) {
+                    if (prove(state, child.board, plies).proof == 0) {
+                        if (attacker_node ? plies < chosen_plies : plies > chosen_plies) {
+                            chosen_child = child;
+                            chosen_plies = plies;
+                        }
+
+                        break;
+                    }
+                }
+            }
+
+            if (!chosen_child.has_value()) {
+                break;
+            }
+
+            variation.push_back(chosen_child->chess_move);
+            position = chosen_child->board;
+            remaining_plies = chosen_plies;
+        }
+
+        return variation;
+    }
+} // namespace esochess
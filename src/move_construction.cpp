@@ -1,3 +1,5 @@
+#include <variant>
+
 #include "headers/bitboard.hpp"
 
 namespace esochess {
@@ -22,4 +24,51 @@ namespace esochess {
         promotion_direction {promotion_direction},
         start {bit_from}, promotion_type {promotion_type} {
     }
+
+    bitboard::bit_representation bitboard::move_start(const move& chess_move) {
+        switch (chess_move.index()) {
+            case move_normal::variant_index: return std::get<move_normal>(chess_move).start;
+
+            case move_en_passant::variant_index: {
+                const move_en_passant& en_passant_move {std::get<move_en_passant>(chess_move)};
+
+                return en_passant_move.square_taken.to_cordinate()
+                    .in_direction(opposite_direction(en_passant_move.en_passant_direction))
+                    .to_bit_representation();
+            }
+
+            case move_castle::variant_index:
+                return cordinate {4, std::get<move_castle>(chess_move).turn == Turn::White ? 0 : 7}
+                    .to_bit_representation();
+
+            default: return std::get<move_promotion>(chess_move).start;
+        }
+    }
+
+    bitboard::bit_representation bitboard::move_end(const move& chess_move) {
+        switch (chess_move.index()) {
+            case move_normal::variant_index: return std::get<move_normal>(chess_move).end;
+
+            case move_en_passant::variant_index:
+                return std::get<move_en_passant>(chess_move)
+                    .square_taken.to_cordinate()
+                    .to_bit_representation();
+
+            case move_castle::variant_index: {
+                const move_castle& castle_move {std::get<move_castle>(chess_move)};
+
+                return cordinate {castle_move.castle_type == CastleType::KingSide ? 6 : 2,
+                                  castle_move.turn == Turn::White ? 0 : 7}
+                    .to_bit_representation();
+            }
+
+            default: {
+                const move_promotion& promotion_move {std::get<move_promotion>(chess_move)};
+
+                return cordinate {promotion_move.start}
+                    .in_direction(promotion_move.promotion_direction)
+                    .to_bit_representation();
+            }
+        }
+    }
 } // namespace esochess
@@ -0,0 +1,450 @@
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdlib>
+#include <optional>
+#include <variant>
+#include <vector>
+
+#include "headers/attacks.hpp"
+#include "headers/bitboard.hpp"
+
+namespace esochess {
+    namespace {
+        bitboard::bit_representation ray(bitboard::Direction direction, int square) {
+            return attack_tables::rays [static_cast<std::size_t>(direction)]
+                                       [static_cast<std::size_t>(square)];
+        }
+
+        bool is_diagonal(bitboard::Direction direction) {
+            return std::ranges::find(bitboard::pieces::bishop_directions, direction) !=
+                   bitboard::pieces::bishop_directions.end();
+        }
+
+        // The direction from `square` towards `target`, if they share a line
+        std::optional<bitboard::Direction> direction_towards(int square,
+                                                             bitboard::bit_representation target) {
+            for (const bitboard::Direction direction: bitboard::pieces::all_directions) {
+                if ((ray(direction, square) & target) != 0) {
+                    return direction;
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        bitboard::bit_representation piece_attacks(bitboard::PieceType piece_type,
+                                                   bitboard::Turn turn, int square,
+                                                   bitboard::bit_representation occupancy) {
+            switch (piece_type) {
+                case bitboard::PieceType::Pawn: return pawn_attacks(turn, square);
+                case bitboard::PieceType::Knight: return knight_attacks(square);
+                case bitboard::PieceType::Bishop: return bishop_attacks(square, occupancy);
+                case bitboard::PieceType::Rook: return rook_attacks(square, occupancy);
+                case bitboard::PieceType::Queen: return queen_attacks(square, occupancy);
+                case bitboard::PieceType::King: return king_attacks(square);
+                default: return 0;
+            }
+        }
+    } // namespace
+
+    bitboard::moves_listing bitboard::legal_moves() {
+        moves_listing moves {available_moves()};
+
+        const auto remove_moves_into_check {[this](auto& moves_of_type) {
+            std::erase_if(moves_of_type, [this](const auto& chess_move) {
+                return !leaves_king_safe(move {chess_move});
+            });
+        }};
+
+        remove_moves_into_check(moves.normal_moves);
+        remove_moves_into_check(moves.castle_moves);
+        remove_moves_into_check(moves.en_passant_moves);
+        remove_moves_into_check(moves.promotion_moves);
+
+        return moves;
+    }
+
+    std::vector<bitboard::move> bitboard::all_legal_moves() const {
+        return position_copy().legal_moves().flatten();
+    }
+
+    bool bitboard::has_legal_move() const {
+        const moves_listing moves {position_copy().available_moves()};
+
+        const auto any_leaves_king_safe {[this](const auto& moves_of_type) {
+            return std::ranges::any_of(moves_of_type, [this](const auto& chess_move) {
+                return leaves_king_safe(move {chess_move});
+            });
+        }};
+
+        return any_leaves_king_safe(moves.normal_moves) ||
+               any_leaves_king_safe(moves.castle_moves) ||
+               any_leaves_king_safe(moves.en_passant_moves) ||
+               any_leaves_king_safe(moves.promotion_moves);
+    }
+
+    std::vector<bitboard::move> bitboard::moves_listing::flatten() const {
+        std::vector<move> all_moves {};
+
+        all_moves.reserve(normal_moves.size() + castle_moves.size() + en_passant_moves.size() +
+                          promotion_moves.size());
+        all_moves.insert(all_moves.end(), normal_moves.begin(), normal_moves.end());
+        all_moves.insert(all_moves.end(), castle_moves.begin(), castle_moves.end());
+        all_moves.insert(all_moves.end(), en_passant_moves.begin(), en_passant_moves.end());
+        all_moves.insert(all_moves.end(), promotion_moves.begin(), promotion_moves.end());
+
+        return all_moves;
+    }
+
+    bool bitboard::leaves_king_safe(const move& chess_move) const {
+        bitboard board_after_move {_position};
+
+        board_after_move.make_move(chess_move);
+
+        return !board_after_move.is_in_check(_position.turn);
+    }
+
+    bool bitboard::is_pseudo_legal(const move& chess_move) const {
+        const Turn opponent {opposite_turn(_position.turn)};
+        const bool white_to_move {_position.turn == Turn::White};
+        const bit_representation own_pieces {bitboard_bitor_accumulation(_position.turn)};
+        const bit_representation occupancy {bitboard_bitor_accumulation(Turn::All)};
+        const bit_representation own_pawns {
+            _position.pieces(white_to_move ? pieces::white_pawn.bitboard_index
+                                           : pieces::black_pawn.bitboard_index)};
+
+        switch (chess_move.index()) {
+            case move_normal::variant_index: {
+                const move_normal& normal_move {std::get<move_normal>(chess_move)};
+
+                if (std::popcount(normal_move.start) != 1 || std::popcount(normal_move.end) != 1 ||
+                    (own_pieces & normal_move.start) == 0 || (own_pieces & normal_move.end) != 0) {
+                    return false;
+                }
+
+                const PieceType piece_type {piece_at_square(normal_move.start).piece_type};
+                const int start_square {square_index(normal_move.start)};
+                const int end_square {square_index(normal_move.end)};
+
+                if (piece_type != PieceType::Pawn) {
+                    return (piece_attacks(piece_type, _position.turn, start_square, occupancy) &
+                            normal_move.end) != 0;
+                }
+
+                const int forward {white_to_move ? 8 : -8};
+                const int pawn_starting_rank {white_to_move ? white_pawn_starting_rank
+                                                            : black_pawn_starting_rank};
+
+                if (end_square / 8 == 0 || end_square / 8 == 7) {
+                    return false; // Reaching the last rank is a `move_promotion`
+                }
+
+                if (end_square == start_square + forward) {
+                    return (occupancy & normal_move.end) == 0;
+                }
+
+                if (end_square == start_square + 2 * forward) {
+                    return start_square / 8 == pawn_starting_rank &&
+                           (occupancy & (normal_move.end | square_bits(start_square + forward))) ==
+                               0;
+                }
+
+                return (pawn_attacks(_position.turn, start_square) & normal_move.end &
+                        occupancy) != 0;
+            }
+
+            case move_en_passant::variant_index: {
+                const move_en_passant& en_passant_move {std::get<move_en_passant>(chess_move)};
+                const Direction direction {en_passant_move.en_passant_direction};
+
+                if (!_position.en_passant.has_value() ||
+                    en_passant_move.square_taken != *_position.en_passant ||
+                    _position.en_passant->captureable_piece_color != opponent ||
+                    !is_diagonal(direction) ||
+                    (direction == Direction::NorthEast || direction == Direction::NorthWest) !=
+                        white_to_move) {
+                    return false;
+                }
+
+                const cordinate start {en_passant_move.square_taken.to_cordinate().in_direction(
+                    opposite_direction(direction))};
+
+                return in_bounds(start) && (own_pawns & start.to_bit_representation()) != 0;
+            }
+
+            case move_castle::variant_index: {
+                const move_castle& castle_move {std::get<move_castle>(chess_move)};
+                const bool king_side {castle_move.castle_type == CastleType::KingSide};
+                const bool has_right {
+                    white_to_move
+                        ? (king_side ? _position.castle_rights.white_king_side
+                                     : _position.castle_rights.white_queen_side)
+                        : (king_side ? _position.castle_rights.black_king_side
+                                     : _position.castle_rights.black_queen_side)};
+
+                const int king_square {white_to_move ? 4 : 60};
+                const int side {king_side ? 1 : -1};
+                const bit_representation rook_bits {
+                    square_bits(king_side ? king_square + 3 : king_square - 4)};
+                const bit_representation king_path {square_bits(king_square) |
+                                                    square_bits(king_square + side) |
+                                                    square_bits(king_square + 2 * side)};
+                const bit_representation between {
+                    ray(king_side ? Direction::East : Direction::West, king_square) &
+                    ~ray(king_side ? Direction::East : Direction::West,
+                         square_index(rook_bits)) &
+                    ~rook_bits};
+
+                if (castle_move.turn != _position.turn || !has_right ||
+                    (_position.pieces(white_to_move ? pieces::white_king.bitboard_index
+                                                    : pieces::black_king.bitboard_index) &
+                     square_bits(king_square)) == 0 ||
+                    (_position.pieces(white_to_move ? pieces::white_rook.bitboard_index
+                                                    : pieces::black_rook.bitboard_index) &
+                     rook_bits) == 0 ||
+                    (occupancy & between) != 0) {
+                    return false;
+                }
+
+                for (bit_representation squares {king_path}; squares != 0;
+                     squares = without_lowest_square(squares)) {
+                    if (attackers_of(std::bit_floor(squares), opponent, occupancy) != 0) {
+                        return false;
+                    }
+                }
+
+                return true;
+            }
+
+            default: {
+                const move_promotion& promotion_move {std::get<move_promotion>(chess_move)};
+                const Direction direction {promotion_move.promotion_direction};
+                const Direction forward {white_to_move ? Direction::North : Direction::South};
+
+                if (std::popcount(promotion_move.start) != 1 ||
+                    (own_pawns & promotion_move.start) == 0 ||
+                    square_index(promotion_move.start) / 8 != (white_to_move ? 6 : 1) ||
+                    promotion_move.promotion_type < PieceType::Knight ||
+                    promotion_move.promotion_type > PieceType::Queen) {
+                    return false;
+                }
+
+                const cordinate end {cordinate {promotion_move.start}.in_direction(direction)};
+
+                if (!in_bounds(end)) {
+                    return false;
+                }
+
+                if (direction == forward) {
+                    return (occupancy & end.to_bit_representation()) == 0;
+                }
+
+                return (pawn_attacks(_position.turn, square_index(promotion_move.start)) &
+                        end.to_bit_representation() & occupancy & ~own_pieces) != 0;
+            }
+        }
+    }
+
+    bool bitboard::is_legal(const move& chess_move) const {
+        if (!is_pseudo_legal(chess_move)) {
+            return false;
+        }
+
+        if (std::holds_alternative<move_castle>(chess_move)) {
+            return true; // The king's path was checked by `is_pseudo_legal`
+        }
+
+        if (std::holds_alternative<move_en_passant>(chess_move)) {
+            return leaves_king_safe(chess_move); // Two pieces leave the king's lines
+        }
+
+        const Turn opponent {opposite_turn(_position.turn)};
+        const bit_representation king_bits {
+            _position.pieces(_position.turn == Turn::White ? pieces::white_king.bitboard_index
+                                                           : pieces::black_king.bitboard_index)};
+        const bit_representation start {move_start(chess_move)};
+        const bit_representation end {move_end(chess_move)};
+        const bit_representation occupancy {bitboard_bitor_accumulation(Turn::All)};
+
+        if (king_bits == 0) {
+            return true;
+        }
+
+        if (start == king_bits) {
+            return attackers_of(end, opponent, occupancy & ~start) == 0;
+        }
+
+        const int king_square {square_index(king_bits)};
+        const bit_representation checkers {attackers_of(king_bits, opponent, occupancy)};
+
+        if (std::popcount(checkers) > 1) {
+            return false;
+        }
+
+        // A single check is answered by taking the checker or blocking its line
+        if (checkers != 0) {
+            const std::optional<Direction> check_direction {
+                direction_towards(king_square, checkers)};
+            const bit_representation blocking_squares {
+                check_direction.has_value()
+                    ? ray_attacks(*check_direction, king_square, occupancy) & ~checkers
+                    : 0};
+
+            if ((end & (checkers | blocking_squares)) == 0) {
+                return false;
+            }
+        }
+
+        // A pinned piece stays on the line between its king and the pinner
+        const std::optional<Direction> pin_direction {direction_towards(king_square, start)};
+
+        if (!pin_direction.has_value() ||
+            (ray_attacks(*pin_direction, king_square, occupancy) & start) == 0 ||
+            (ray(*pin_direction, king_square) & end) != 0) {
+            return true;
+        }
+
+        const std::size_t first_index {opponent == Turn::White ? pieces::white_pawn.bitboard_index
+                                                               : pieces::black_pawn.bitboard_index};
+        const bit_representation pinners {
+            _position.pieces(first_index + pieces::white_queen.bitboard_index) |
+            _position.pieces(first_index + (is_diagonal(*pin_direction)
+                                                ? pieces::white_bishop.bitboard_index
+                                                : pieces::white_rook.bitboard_index))};
+
+        return (ray_attacks(*pin_direction, king_square, occupancy & ~start) & pinners) == 0;
+    }
+
+    bool bitboard::gives_check(const move& chess_move) const {
+        const Turn opponent {opposite_turn(_position.turn)};
+        const bit_representation enemy_king {
+            _position.pieces(opponent == Turn::White ? pieces::white_king.bitboard_index
+                                                     : pieces::black_king.bitboard_index)};
+
+        if (enemy_king == 0) {
+            return false;
+        }
+
+        // Both move two pieces, and are rare enough to play out
+        if (std::holds_alternative<move_castle>(chess_move) ||
+            std::holds_alternative<move_en_passant>(chess_move)) {
+            bitboard board_after_move {_position};
+
+            board_after_move.make_move(chess_move);
+
+            return board_after_move.is_in_check(opponent);
+        }
+
+        const bit_representation start {move_start(chess_move)};
+        const bit_representation end {move_end(chess_move)};
+        const bit_representation occupancy_after_move {
+            (bitboard_bitor_accumulation(Turn::All) & ~start) | end};
+        const auto* const promotion_move {std::get_if<move_promotion>(&chess_move)};
+        const PieceType moved_type {promotion_move != nullptr
+                                        ? promotion_move->promotion_type
+                                        : piece_at_square(start).piece_type};
+
+        if ((piece_attacks(moved_type, _position.turn, square_index(end), occupancy_after_move) &
+             enemy_king) != 0) {
+            return true;
+        }
+
+        // A slider uncovered by the move
+        const int king_square {square_index(enemy_king)};
+        const std::size_t first_index {_position.turn == Turn::White
+                                           ? pieces::white_pawn.bitboard_index
+                                           : pieces::black_pawn.bitboard_index};
+        const bit_representation queens {
+            _position.pieces(first_index + pieces::white_queen.bitboard_index)};
+        const bit_representation diagonal_sliders {
+            (_position.pieces(first_index + pieces::white_bishop.bitboard_index) | queens) &
+            ~start};
+        const bit_representation straight_sliders {
+            (_position.pieces(first_index + pieces::white_rook.bitboard_index) | queens) &
+            ~start};
+
+        return (bishop_attacks(king_square, occupancy_after_move) & diagonal_sliders) != 0 ||
+               (rook_attacks(king_square, occupancy_after_move) & straight_sliders) != 0;
+    }
+
+    std::optional<bitboard::move> bitboard::legal_move_between(bit_representation start,
+                                                               bit_representation end,
+                                                               PieceType promotion_type) const {
+        if (std::popcount(start) != 1 || std::popcount(end) != 1 ||
+            color_at_square(start) != _position.turn) {
+            return std::nullopt;
+        }
+
+        const PieceType piece_type {piece_at_square(start).piece_type};
+        const cordinate start_cordinate {start};
+        const cordinate end_cordinate {end};
+        const int file_offset {end_cordinate.pos_x() - start_cordinate.pos_x()};
+        const std::optional<Direction> direction {direction_towards(square_index(start), end)};
+        move chess_move {move_normal {start, end}};
+
+        if (piece_type == PieceType::King && std::abs(file_offset) == 2 &&
+            end_cordinate.pos_y() == start_cordinate.pos_y()) {
+            chess_move = move_castle {_position.turn, file_offset > 0 ? CastleType::KingSide
+                                                             : CastleType::QueenSide};
+        }
+
+        else if (piece_type == PieceType::Pawn && direction.has_value() &&
+                 (end_cordinate.pos_y() == 0 || end_cordinate.pos_y() == 7)) {
+            chess_move = move_promotion {start, promotion_type, *direction};
+        }
+
+        else if (piece_type == PieceType::Pawn && direction.has_value() && file_offset != 0 &&
+                 _position.en_passant.has_value() &&
+                 _position.en_passant->to_cordinate().to_bit_representation() == end) {
+            chess_move = move_en_passant {*_position.en_passant, *direction};
+        }
+
+        const bool is_promotion {std::holds_alternative<move_promotion>(chess_move)};
+
+        if ((promotion_type != PieceType::Any) != is_promotion ||
+            move_start(chess_move) != start || move_end(chess_move) != end ||
+            !is_legal(chess_move)) {
+            return std::nullopt;
+        }
+
+        return chess_move;
+    }
+
+    bitboard::bit_representation bitboard::attackers_of(bit_representation square, Turn attacker,
+                                                        bit_representation occupancy) const {
+        const int square_attacked {square_index(square)};
+        const std::size_t first_index {attacker == Turn::White ? pieces::white_pawn.bitboard_index
+                                                               : pieces::black_pawn.bitboard_index};
+        const auto attacker_bits {[this, first_index](const piece& white_piece) {
+            return _position.pieces(first_index + white_piece.bitboard_index);
+        }};
+
+        const bit_representation queens {attacker_bits(pieces::white_queen)};
+
+        return (pawn_attacks(opposite_turn(attacker), square_attacked) &
+                attacker_bits(pieces::white_pawn)) |
+               (knight_attacks(square_attacked) & attacker_bits(pieces::white_knight)) |
+               (king_attacks(square_attacked) & attacker_bits(pieces::white_king)) |
+               (bishop_attacks(square_attacked, occupancy) &
+                (attacker_bits(pieces::white_bishop) | queens)) |
+               (rook_attacks(square_attacked, occupancy) &
+                (attacker_bits(pieces::white_rook) | queens));
+    }
+
+    bool bitboard::is_square_attacked(bit_representation square, Turn attacker) const {
+        return attackers_of(square, attacker, bitboard_bitor_accumulation(Turn::All)) != 0;
+    }
+
+    bool bitboard::is_in_check(Turn turn) const {
+        const bit_representation king_bits {_position.pieces(turn == Turn::White
+                                                            ? pieces::white_king.bitboard_index
+                                                            : pieces::black_king.bitboard_index)};
+
+        return king_bits != 0 && is_square_attacked(std::bit_floor(king_bits), opposite_turn(turn));
+    }
+
+    bool bitboard::is_in_check() const {
+        return is_in_check(_position.turn);
+    }
+} // namespace esochess
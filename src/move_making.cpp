@@ -1,47 +1,80 @@
+#include <optional>
+#include <variant>
+
+#include "headers/attacks.hpp"
 #include "headers/bitboard.hpp"
+#include "headers/profiler.hpp"
 
 namespace esochess {
     bitboard& bitboard::make_move(const move_normal& move) {
+        ESOCHESS_PROFILE_SCOPE(MakeMoveNormal);
+
         const piece piece_moved {piece_at_square(move.start)};
         const piece piece_at_square_moved_to {piece_at_square(move.end)};
+        const bool is_capture {piece_at_square_moved_to != pieces::empty_piece};
 
-        if (piece_at_square_moved_to != pieces::empty_piece) {
+        if (is_capture) {
             remove_piece_at_square(move.end, piece_at_square_moved_to);
         }
 
         xor_piece(move.start | move.end, piece_moved);
 
-        return *this;
+        _position.en_passant = {};
+
+        if (piece_moved.piece_type == PieceType::Pawn &&
+            (square_index(move.start) - square_index(move.end) == 16 ||
+             square_index(move.end) - square_index(move.start) == 16)) { // Double pawn push
+            _position.en_passant = en_passant_square {
+                static_cast<std::uint8_t>(square_index(move.start) % 8), piece_moved.turn};
+        }
+
+        if (is_capture || piece_moved.piece_type == PieceType::Pawn) {
+            _position.halfmove_clock = 0;
+        }
+
+        else {
+            _position.halfmove_clock++;
+        }
+
+        return update_castle_rights(move.start | move.end).finish_move();
     }
 
     bitboard& bitboard::make_move(const move_en_passant& move) {
+        ESOCHESS_PROFILE_SCOPE(MakeMoveEnPassant);
+
         const cordinate square_taken_cordinate {move.square_taken.to_cordinate()};
         const Turn opponents_turn {move.square_taken.captureable_piece_color};
         const Turn turn {opposite_turn(opponents_turn)};
         const piece piece_taken {pieces::from_type_and_turn(PieceType::Pawn, opponents_turn)};
         const piece piece_moved {pieces::from_type_and_turn(PieceType::Pawn, turn)};
 
-        const cordinate cordinate_moved_from {square_taken_cordinate.in_direction(
-            (move.en_passant_direction == Direction::NorthWest ||
-             move.en_passant_direction == Direction::SouthWest)
-                ? Direction::East
-                : Direction::West,
-            1)};
+        const cordinate cordinate_moved_from {
+            square_taken_cordinate.in_direction(opposite_direction(move.en_passant_direction))};
+        const cordinate cordinate_of_piece_taken {square_taken_cordinate.in_direction(
+            turn == Turn::White ? Direction::South : Direction::North)};
 
-        remove_piece_at_square(square_taken_cordinate, piece_taken);
+        remove_piece_at_square(cordinate_of_piece_taken, piece_taken);
 
         xor_piece(cordinate_moved_from.to_bit_representation() |
                       square_taken_cordinate.to_bit_representation(),
                   piece_moved);
 
-        return *this;
+        _position.en_passant = {};
+        _position.halfmove_clock = 0;
+
+        return finish_move();
     }
 
     bitboard& bitboard::make_move(const move_castle& move) {
+        ESOCHESS_PROFILE_SCOPE(MakeMoveCastle);
+
         if (move.turn == Turn::White) {
-            _bitboards.at(pieces::white_king.bitboard_index) =
-                move.castle_type == CastleType::KingSide ? cordinate {"g1"}.to_bit_representation()
-                                                         : cordinate {"c1"}.to_bit_representation();
+            const bit_representation king_end {move.castle_type == CastleType::KingSide
+                                                   ? cordinate {"g1"}.to_bit_representation()
+                                                   : cordinate {"c1"}.to_bit_representation()};
+
+            xor_piece(_position.pieces(pieces::white_king.bitboard_index) ^ king_end,
+                      pieces::white_king);
 
             if (move.castle_type == CastleType::KingSide) {
                 xor_piece(cordinate {"h1"}.to_bit_representation() |
@@ -54,12 +87,18 @@ namespace esochess {
                               cordinate {"d1"}.to_bit_representation(),
                           pieces::white_rook);
             }
+
+            _position.castle_rights.white_king_side = false;
+            _position.castle_rights.white_queen_side = false;
         }
 
         if (move.turn == Turn::Black) {
-            _bitboards.at(pieces::black_king.bitboard_index) =
-                move.castle_type == CastleType::KingSide ? cordinate {"g8"}.to_bit_representation()
-                                                         : cordinate {"c8"}.to_bit_representation();
+            const bit_representation king_end {move.castle_type == CastleType::KingSide
+                                                   ? cordinate {"g8"}.to_bit_representation()
+                                                   : cordinate {"c8"}.to_bit_representation()};
+
+            xor_piece(_position.pieces(pieces::black_king.bitboard_index) ^ king_end,
+                      pieces::black_king);
 
             if (move.castle_type == CastleType::KingSide) {
                 xor_piece(cordinate {"h8"}.to_bit_representation() |
@@ -72,29 +111,105 @@ namespace esochess {
                               cordinate {"d8"}.to_bit_representation(),
                           pieces::black_rook);
             }
+
+            _position.castle_rights.black_king_side = false;
+            _position.castle_rights.black_queen_side = false;
         }
 
-        return *this;
+        _position.en_passant = {};
+        _position.halfmove_clock++;
+
+        return finish_move();
     }
 
     bitboard& bitboard::make_move(const move_promotion& move) {
-        const piece piece_moved {pieces::from_type_and_turn(PieceType::Pawn, _turn)};
-        const piece piece_promoted_to {pieces::from_type_and_turn(move.promotion_type, _turn)};
+        ESOCHESS_PROFILE_SCOPE(MakeMovePromotion);
+
+        const piece piece_moved {pieces::from_type_and_turn(PieceType::Pawn, _position.turn)};
+        const piece piece_promoted_to {
+            pieces::from_type_and_turn(move.promotion_type, _position.turn)};
         const cordinate cordinate_moved_to {
             cordinate {move.start}.in_direction(move.promotion_direction, 1)};
+        const bit_representation bits_moved_to {cordinate_moved_to.to_bit_representation()};
 
         remove_piece_at_square(move.start, piece_moved);
 
-        if (move.promotion_direction == Direction::North ||
-            move.promotion_direction == Direction::South) {
-            add_piece_at_square(cordinate_moved_to, piece_promoted_to);
+        if (move.promotion_direction != Direction::North &&
+            move.promotion_direction != Direction::South) { // diagonal promotion
+            remove_piece_at_square(bits_moved_to);
+        }
+
+        add_piece_at_square(bits_moved_to, piece_promoted_to);
+
+        _position.en_passant = {};
+        _position.halfmove_clock = 0;
+
+        return update_castle_rights(bits_moved_to).finish_move();
+    }
+
+    bitboard& bitboard::make_move(const move& chess_move) {
+        ESOCHESS_PROFILE_SCOPE(MakeMove);
+
+        return std::visit([this](const auto& move_variant) -> bitboard& {
+            return make_move(move_variant);
+        }, chess_move);
+    }
+
+    std::optional<bitboard::en_passant_square> bitboard::make_null_move() {
+        const std::optional<en_passant_square> previous_en_passant {_position.en_passant};
+
+        _position.en_passant = {};
+        _position.halfmove_clock++;
+        finish_move();
+
+        return previous_en_passant;
+    }
+
+    bitboard& bitboard::unmake_null_move(std::optional<en_passant_square> previous_en_passant) {
+        _position.turn = opposite_turn(_position.turn);
+
+        if (_position.turn == Turn::Black) {
+            _position.fullmove_number--;
+        }
+
+        _position.en_passant = previous_en_passant;
+        _position.halfmove_clock--;
+        _cached_moves_listing = {};
+
+        return *this;
+    }
+
+    bitboard& bitboard::update_castle_rights(bit_representation squares_touched) {
+        static constexpr bit_representation white_king_square {square_bits(4)};
+        static constexpr bit_representation black_king_square {square_bits(60)};
+
+        if ((squares_touched & (white_king_square | square_bits(7))) != 0) {
+            _position.castle_rights.white_king_side = false;
+        }
+
+        if ((squares_touched & (white_king_square | square_bits(0))) != 0) {
+            _position.castle_rights.white_queen_side = false;
+        }
+
+        if ((squares_touched & (black_king_square | square_bits(63))) != 0) {
+            _position.castle_rights.black_king_side = false;
         }
 
-        else { // diagonal promotion
-            remove_piece_at_square(cordinate_moved_to);
-            add_piece_at_square(cordinate_moved_to, piece_promoted_to);
+        if ((squares_touched & (black_king_square | square_bits(56))) != 0) {
+            _position.castle_rights.black_queen_side = false;
         }
 
         return *this;
     }
+
+    bitboard& bitboard::finish_move() {
+        if (_position.turn == Turn::Black) {
+            _position.fullmove_number++;
+        }
+
+        _position.turn = opposite_turn(_position.turn);
+        _cached_moves_listing = {};
+
+        return *this;
+    }
 } // namespace esochess
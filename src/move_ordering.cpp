@@ -0,0 +1,127 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <span>
+
+#include "headers/bitboard.hpp"
+#include "headers/move_ordering.hpp"
+
+namespace esochess {
+    namespace {
+        constexpr int killer_score {1 << 18};
+        constexpr int countermove_score {1 << 17};
+        constexpr int maximum_bonus {1200};
+
+        void apply_gravity(std::int16_t& entry, int bonus) {
+            const int limit {move_ordering_tables::history_limit};
+            const int clamped_bonus {std::clamp(bonus, -limit, limit)};
+
+            entry = static_cast<std::int16_t>(entry + clamped_bonus -
+                                              entry * std::abs(clamped_bonus) / limit);
+        }
+    } // namespace
+
+    move_ordering_tables::move_ordering_tables() :
+        _butterfly(2 * 64 * 64), _continuation(piece_square_count * piece_square_count),
+        _countermoves(piece_square_count), _killers {} {
+    }
+
+    void move_ordering_tables::clear() {
+        std::ranges::fill(_butterfly, 0);
+        std::ranges::fill(_continuation, 0);
+        std::ranges::fill(_countermoves, 0);
+        clear_killers();
+    }
+
+    void move_ordering_tables::clear_killers() {
+        _killers = {};
+    }
+
+    std::size_t move_ordering_tables::butterfly_index(bitboard::Turn turn,
+                                                      std::uint16_t encoded_move) {
+        return (turn == bitboard::Turn::White ? 0 : 64 * 64) + (encoded_move & 0xfffU);
+    }
+
+    std::size_t move_ordering_tables::piece_square_index(const piece_square& moved) {
+        return moved.piece_index * 64 + static_cast<std::size_t>(moved.square);
+    }
+
+    std::size_t move_ordering_tables::continuation_index(const piece_square& previous,
+                                                         const piece_square& moved) {
+        return piece_square_index(previous) * piece_square_count + piece_square_index(moved);
+    }
+
+    int move_ordering_tables::quiet_score(const ordering_context& context,
+                                          const quiet_move& chess_move) const {
+        const std::array<std::uint16_t, 2>& killers {
+            _killers.at(static_cast<std::size_t>(std::min(context.ply, max_ordering_ply - 1)))};
+
+        if (chess_move.encoded_move == killers.at(0)) {
+            return killer_score + 1;
+        }
+
+        if (chess_move.encoded_move == killers.at(1)) {
+            return killer_score;
+        }
+
+        if (context.previous_move.has_value() &&
+            _countermoves.at(piece_square_index(*context.previous_move)) ==
+                chess_move.encoded_move) {
+            return countermove_score;
+        }
+
+        int score {_butterfly.at(butterfly_index(context.turn, chess_move.encoded_move))};
+
+        for (const std::optional<piece_square>& previous:
+             {context.previous_move, context.own_previous_move}) {
+            if (previous.has_value()) {
+                score += _continuation.at(continuation_index(*previous, chess_move.moved));
+            }
+        }
+
+        return score;
+    }
+
+    void move_ordering_tables::update_history(const ordering_context& context,
+                                              const quiet_move& chess_move, int bonus) {
+        apply_gravity(_butterfly.at(butterfly_index(context.turn, chess_move.encoded_move)),
+                      bonus);
+
+        for (const std::optional<piece_square>& previous:
+             {context.previous_move, context.own_previous_move}) {
+            if (previous.has_value()) {
+                apply_gravity(_continuation.at(continuation_index(*previous, chess_move.moved)),
+                              bonus);
+            }
+        }
+    }
+
+    void move_ordering_tables::update(const ordering_context& context, const quiet_move& best_move,
+                                      std::span<const quiet_move> failed_moves, int depth) {
+        const int bonus {std::min(32 * depth * depth, maximum_bonus)};
+
+        update_history(context, best_move, bonus);
+
+        for (const quiet_move& failed_move: failed_moves) {
+            update_history(context, failed_move, -bonus);
+        }
+
+        if (context.ply < max_ordering_ply) {
+            std::array<std::uint16_t, 2>& killers {
+                _killers.at(static_cast<std::size_t>(context.ply))};
+
+            if (killers.at(0) != best_move.encoded_move) {
+                killers.at(1) = killers.at(0);
+                killers.at(0) = best_move.encoded_move;
+            }
+        }
+
+        if (context.previous_move.has_value()) {
+            _countermoves.at(piece_square_index(*context.previous_move)) =
+                best_move.encoded_move;
+        }
+    }
+} // namespace esochess
@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <expected>
+#include <optional>
+#include <system_error>
+
+#include "headers/bitboard.hpp"
+#include "headers/packed_position.hpp"
+#include "headers/pgn.hpp"
+
+namespace esochess {
+    std::optional<packed_position> packed_position::from_bitboard(const bitboard& board) noexcept {
+        const std::array<bitboard::bit_representation, 12> bitboards {board.bitboards()};
+
+        packed_position position {};
+        std::array<std::uint8_t, 64> codes_by_square {};
+
+        for (std::size_t bitboard_index {}; bitboard_index < bitboards.size(); bitboard_index++) {
+            bitboard::bit_representation piece_bits {bitboards [bitboard_index]};
+            position.occupancy |= piece_bits;
+
+            while (piece_bits != 0) {
+                codes_by_square [static_cast<std::size_t>(std::countl_zero(piece_bits))] =
+                    static_cast<std::uint8_t>(bitboard_index);
+                piece_bits &= ~std::bit_floor(piece_bits);
+            }
+        }
+
+        if (std::popcount(position.occupancy) > static_cast<int>(max_pieces)) {
+            return std::nullopt;
+        }
+
+        bitboard::bit_representation occupancy {position.occupancy};
+
+        for (std::size_t piece_number {}; occupancy != 0; piece_number++) {
+            const std::uint8_t code {
+                codes_by_square [static_cast<std::size_t>(std::countl_zero(occupancy))]};
+
+            position.piece_codes [piece_number / 2] |=
+                static_cast<std::uint8_t>(code << ((piece_number % 2) * 4));
+            occupancy &= ~std::bit_floor(occupancy);
+        }
+
+        const bitboard::castle_rights_collection castle_rights {board.castle_rights()};
+
+        position.flags = static_cast<std::uint8_t>(
+            (board.turn() == bitboard::Turn::Black ? black_to_move_flag : 0) |
+            (castle_rights.white_king_side ? white_king_side_flag : 0) |
+            (castle_rights.white_queen_side ? white_queen_side_flag : 0) |
+            (castle_rights.black_king_side ? black_king_side_flag : 0) |
+            (castle_rights.black_queen_side ? black_queen_side_flag : 0));
+
+        position.en_passant_file =
+            board.en_passant()
+                .transform([](const bitboard::en_passant_square& square) {
+                    return static_cast<std::uint8_t>(square.column_index + 1);
+                })
+                .value_or(0);
+
+        position.halfmove_clock =
+            static_cast<std::uint16_t>(std::clamp(board.halfmove_clock(), 0, 0xffff));
+        position.fullmove_number =
+            static_cast<std::uint16_t>(std::clamp(board.fullmove_number(), 0, 0xffff));
+
+        return position;
+    }
+
+    std::expected<bitboard, std::error_code> packed_position::to_bitboard() const {
+        std::array<bitboard::bit_representation, 12> bitboards {};
+        bitboard::bit_representation remaining_occupancy {occupancy};
+
+        if (std::popcount(occupancy) > static_cast<int>(max_pieces) || en_passant_file > 8) {
+            return std::unexpected {std::make_error_code(std::errc::invalid_argument)};
+        }
+
+        for (std::size_t piece_number {}; remaining_occupancy != 0; piece_number++) {
+            const bitboard::bit_representation square_bits {std::bit_floor(remaining_occupancy)};
+            const std::size_t code {static_cast<std::size_t>(
+                (piece_codes [piece_number / 2] >> ((piece_number % 2) * 4)) & 0x0fU)};
+
+            if (code >= bitboards.size()) {
+                return std::unexpected {std::make_error_code(std::errc::invalid_argument)};
+            }
+
+            bitboards [code] |= square_bits;
+            remaining_occupancy &= ~square_bits;
+        }
+
+        const bitboard::Turn turn {(flags & black_to_move_flag) != 0 ? bitboard::Turn::Black
+                                                                      : bitboard::Turn::White};
+
+        std::optional<bitboard::en_passant_square> en_passant {};
+
+        if (en_passant_file != 0) {
+            en_passant = bitboard::en_passant_square {
+                static_cast<std::uint8_t>(en_passant_file - 1), bitboard::opposite_turn(turn)};
+        }
+
+        const bitboard::castle_rights_collection castle_rights {
+            (flags & white_king_side_flag) != 0, (flags & white_queen_side_flag) != 0,
+            (flags & black_king_side_flag) != 0, (flags & black_queen_side_flag) != 0};
+
+        return bitboard {bitboards,      turn,           castle_rights,
+                         en_passant,     halfmove_clock, fullmove_number};
+    }
+
+    GameResult packed_position::result() const noexcept {
+        switch ((flags & result_mask) >> result_shift) { // 0 for the positions of older files
+            case 1: return GameResult::WhiteWin;
+            case 2: return GameResult::BlackWin;
+            case 3: return GameResult::Draw;
+            default: return GameResult::Unknown;
+        }
+    }
+
+    void packed_position::set_result(GameResult game_result) noexcept {
+        unsigned code {0};
+
+        switch (game_result) {
+            case GameResult::WhiteWin: code = 1; break;
+            case GameResult::BlackWin: code = 2; break;
+            case GameResult::Draw: code = 3; break;
+            case GameResult::Unknown: code = 0; break;
+        }
+
+        flags = static_cast<std::uint8_t>((flags & ~result_mask) | (code << result_shift));
+    }
+} // namespace esochess
@@ -1,10 +1,14 @@
+#include <array>
 #include <vector>
 
 #include "headers/bitboard.hpp"
 #include "headers/move_generation.hpp"
+#include "headers/profiler.hpp"
 
 namespace esochess {
     void add_pawn_moves(bitboard& board, bitboard::moves_listing& moves_listing_ext) {
+        ESOCHESS_PROFILE_SCOPE(AddPawnMoves);
+
         using Direction = bitboard::Direction;
 
         const bitboard::Turn turn {board.turn()};
@@ -32,7 +36,7 @@ namespace esochess {
                         pawn_cordinate.in_direction(Direction::North).to_bit_representation());
 
                     if (pawn_cordinate.pos_y() == bitboard::white_pawn_starting_rank &&
-                        board.color_at_square(pawn_cordinate.in_direction(Direction::North)) ==
+                        board.color_at_square(pawn_cordinate.in_direction(Direction::North, 2)) ==
                             bitboard::Turn::None) {
                         moves_listing_ext.normal_moves.emplace_back(
                             pawn_cordinate.to_bit_representation(),
@@ -94,14 +98,14 @@ namespace esochess {
     }
 
     void add_pawn_en_passant_moves(bitboard& board, bitboard::moves_listing& moves_listing_ext) {
+        ESOCHESS_PROFILE_SCOPE(AddPawnEnPassantMoves);
+
         using Direction = bitboard::Direction;
 
         if (!board.en_passant().has_value()) { // No en passant move possible
             return;
         }
 
-        const bitboard::Turn turn {board.turn()};
-        const bitboard::Turn opposite_turn {bitboard::opposite_turn(turn)};
         const bitboard::en_passant_square en_passant_square {
             board.en_passant().value_or(bitboard::en_passant_square {})};
         const bitboard::cordinate en_passant_cordinate {en_passant_square.to_cordinate()};
@@ -109,9 +113,7 @@ namespace esochess {
         if (board.turn() == bitboard::Turn::White &&
             (bitboard::in_bounds(en_passant_cordinate.in_direction(Direction::SouthEast))) &&
             (board.piece_at_square(en_passant_cordinate.in_direction(Direction::SouthEast)) ==
-             bitboard::pieces::white_pawn) &&
-            (board.color_at_square(en_passant_cordinate.in_direction(Direction::SouthEast)) ==
-             opposite_turn)) {
+             bitboard::pieces::white_pawn)) {
             moves_listing_ext.en_passant_moves.emplace_back(en_passant_square,
                                                             bitboard::Direction::NorthWest);
         }
@@ -119,9 +121,7 @@ namespace esochess {
         if (board.turn() == bitboard::Turn::White &&
             (bitboard::in_bounds(en_passant_cordinate.in_direction(Direction::SouthWest))) &&
             (board.piece_at_square(en_passant_cordinate.in_direction(Direction::SouthWest)) ==
-             bitboard::pieces::white_pawn) &&
-            (board.color_at_square(en_passant_cordinate.in_direction(Direction::SouthWest)) ==
-             opposite_turn)) {
+             bitboard::pieces::white_pawn)) {
             moves_listing_ext.en_passant_moves.emplace_back(en_passant_square,
                                                             bitboard::Direction::NorthEast);
         }
@@ -129,9 +129,7 @@ namespace esochess {
         if (board.turn() == bitboard::Turn::Black &&
             (bitboard::in_bounds(en_passant_cordinate.in_direction(Direction::NorthEast))) &&
             (board.piece_at_square(en_passant_cordinate.in_direction(Direction::NorthEast)) ==
-             bitboard::pieces::black_pawn) &&
-            (board.color_at_square(en_passant_cordinate.in_direction(Direction::NorthEast)) ==
-             opposite_turn)) {
+             bitboard::pieces::black_pawn)) {
             moves_listing_ext.en_passant_moves.emplace_back(en_passant_square,
                                                             bitboard::Direction::SouthWest);
         }
@@ -139,15 +137,15 @@ namespace esochess {
         if (board.turn() == bitboard::Turn::Black &&
             (bitboard::in_bounds(en_passant_cordinate.in_direction(Direction::NorthWest))) &&
             (board.piece_at_square(en_passant_cordinate.in_direction(Direction::NorthWest)) ==
-             bitboard::pieces::black_pawn) &&
-            (board.color_at_square(en_passant_cordinate.in_direction(Direction::NorthWest)) ==
-             opposite_turn)) {
+             bitboard::pieces::black_pawn)) {
             moves_listing_ext.en_passant_moves.emplace_back(en_passant_square,
                                                             bitboard::Direction::SouthEast);
         }
     }
 
     void add_pawn_promotion_moves(bitboard& board, bitboard::moves_listing& moves_listing_ext) {
+        ESOCHESS_PROFILE_SCOPE(AddPawnPromotionMoves);
+
         using Direction = bitboard::Direction;
 
         static const bitboard::bit_representation seventh_rank_bits {[]() {
@@ -182,74 +180,40 @@ namespace esochess {
             return;
         }
 
-        if (turn == bitboard::Turn::White) {
-            for (const bitboard::cordinate& pawn_cordinate:
-                 bitboard::cordinate_from_bit_representation(
-                     board.bitboards().at(bitboard::pieces::white_pawn.bitboard_index) &
-                     seventh_rank_bits)) {
-                if (board.color_at_square(pawn_cordinate.in_direction(Direction::North)) ==
-                    bitboard::Turn::None) {
-                    moves_listing_ext.promotion_moves.emplace_back(
-                        pawn_cordinate.to_bit_representation(), bitboard::PieceType::AnyPromotion,
-                        bitboard::Direction::North);
+        const std::array<Direction, 3> promotion_directions {
+            turn == bitboard::Turn::White
+                ? std::array<Direction, 3> {Direction::North, Direction::NorthWest,
+                                            Direction::NorthEast}
+                : std::array<Direction, 3> {Direction::South, Direction::SouthWest,
+                                            Direction::SouthEast}};
+
+        for (const bitboard::cordinate& pawn_cordinate: bitboard::cordinate_from_bit_representation(
+                 turn == bitboard::Turn::White
+                     ? board.bitboards().at(bitboard::pieces::white_pawn.bitboard_index) &
+                           seventh_rank_bits
+                     : board.bitboards().at(bitboard::pieces::black_pawn.bitboard_index) &
+                           second_rank_bits)) {
+            for (const Direction promotion_direction: promotion_directions) {
+                const bitboard::cordinate cordinate_moved_to {
+                    pawn_cordinate.in_direction(promotion_direction)};
+                const bool is_capture {promotion_direction != promotion_directions.front()};
+
+                if (!bitboard::in_bounds(cordinate_moved_to) ||
+                    board.color_at_square(cordinate_moved_to) !=
+                        (is_capture ? opposite_turn : bitboard::Turn::None)) {
+                    continue;
                 }
 
-                if (board.color_at_square(pawn_cordinate.in_direction(Direction::NorthWest)) ==
-                    opposite_turn) {
-                    moves_listing_ext.promotion_moves.emplace_back(
-                        pawn_cordinate.to_bit_representation(), bitboard::PieceType::AnyPromotion,
-                        bitboard::Direction::NorthWest);
+                if (is_capture) {
                     add_controlled_squares_to_bitboard(
-                        board,
-                        pawn_cordinate.in_direction(Direction::NorthWest).to_bit_representation(),
-                        turn);
+                        board, cordinate_moved_to.to_bit_representation(), turn);
                 }
 
-                if (board.color_at_square(pawn_cordinate.in_direction(Direction::NorthEast)) ==
-                    opposite_turn) {
+                for (const bitboard::piece& promotion_piece:
+                     bitboard::pieces::white_pawn_promotion_pieces) {
                     moves_listing_ext.promotion_moves.emplace_back(
-                        pawn_cordinate.to_bit_representation(), bitboard::PieceType::AnyPromotion,
-                        bitboard::Direction::NorthEast);
-                    add_controlled_squares_to_bitboard(
-                        board,
-                        pawn_cordinate.in_direction(Direction::NorthEast).to_bit_representation(),
-                        turn);
-                }
-            }
-        }
-
-        if (turn == bitboard::Turn::Black) {
-            for (const bitboard::cordinate& pawn_cordinate:
-                 bitboard::cordinate_from_bit_representation(
-                     board.bitboards().at(bitboard::pieces::black_pawn.bitboard_index) &
-                     second_rank_bits)) {
-                if (board.color_at_square(pawn_cordinate.in_direction(Direction::South)) ==
-                    bitboard::Turn::None) {
-                    moves_listing_ext.promotion_moves.emplace_back(
-                        pawn_cordinate.to_bit_representation(), bitboard::PieceType::AnyPromotion,
-                        bitboard::Direction::South);
-                }
-
-                if (board.color_at_square(pawn_cordinate.in_direction(Direction::SouthWest)) ==
-                    opposite_turn) {
-                    moves_listing_ext.promotion_moves.emplace_back(
-                        pawn_cordinate.to_bit_representation(), bitboard::PieceType::AnyPromotion,
-                        bitboard::Direction::SouthWest);
-                    add_controlled_squares_to_bitboard(
-                        board,
-                        pawn_cordinate.in_direction(Direction::SouthWest).to_bit_representation(),
-                        turn);
-                }
-
-                if (board.color_at_square(pawn_cordinate.in_direction(Direction::SouthEast)) ==
-                    opposite_turn) {
-                    moves_listing_ext.promotion_moves.emplace_back(
-                        pawn_cordinate.to_bit_representation(), bitboard::PieceType::AnyPromotion,
-                        bitboard::Direction::SouthEast);
-                    add_controlled_squares_to_bitboard(
-                        board,
-                        pawn_cordinate.in_direction(Direction::SouthEast).to_bit_representation(),
-                        turn);
+                        pawn_cordinate.to_bit_representation(), promotion_piece.piece_type,
+                        promotion_direction);
                 }
             }
         }
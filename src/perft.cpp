@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <thread>
+#include <vector>
+
+#include "headers/bitboard.hpp"
+#include "headers/perft.hpp"
+
+namespace esochess {
+    namespace {
+        constexpr std::uint64_t depth_mask {0xff};
+    } // namespace
+
+    perft_table::perft_table(std::size_t size_in_megabytes) :
+        _entries(std::bit_floor(std::max<std::size_t>(size_in_megabytes * 1024 * 1024 /
+                                                          sizeof(entry),
+                                                      1))) {
+    }
+
+    std::size_t perft_table::index_of(std::uint64_t hash, int depth) const noexcept {
+        // Spreads the depths of one position over different entries
+        const std::uint64_t depth_hash {hash ^ (static_cast<std::uint64_t>(depth) *
+                                                0x9e37'79b9'7f4a'7c15)};
+
+        return static_cast<std::size_t>(depth_hash & (_entries.size() - 1));
+    }
+
+    std::optional<std::uint64_t> perft_table::find(std::uint64_t hash, int depth) const {
+        const entry& table_entry {_entries [index_of(hash, depth)]};
+        const std::uint64_t data {table_entry.data.load(std::memory_order_relaxed)};
+        const std::uint64_t checked_key {table_entry.checked_key.load(std::memory_order_relaxed)};
+
+        if ((checked_key ^ data) != hash ||
+            (data & depth_mask) != static_cast<std::uint64_t>(depth)) {
+            return std::nullopt;
+        }
+
+        return data >> 8U;
+    }
+
+    void perft_table::store(std::uint64_t hash, int depth, std::uint64_t nodes) {
+        entry& table_entry {_entries [index_of(hash, depth)]};
+        const std::uint64_t data {(nodes << 8U) | static_cast<std::uint64_t>(depth)};
+
+        table_entry.checked_key.store(hash ^ data, std::memory_order_relaxed);
+        table_entry.data.store(data, std::memory_order_relaxed);
+    }
+
+    std::size_t perft_table::size() const noexcept {
+        return _entries.size();
+    }
+
+    std::uint64_t perft(const bitboard& board, int depth, perft_table* table) {
+        if (depth <= 0) {
+            return 1;
+        }
+
+        bitboard board_copy {board.position_copy()};
+        const bitboard::moves_listing moves {board_copy.legal_moves()};
+
+        if (depth == 1) { // Bulk counting
+            return moves.normal_moves.size() + moves.castle_moves.size() +
+                   moves.en_passant_moves.size() + moves.promotion_moves.size();
+        }
+
+        const std::uint64_t hash {table != nullptr ? board.hash() : 0};
+
+        if (table != nullptr) {
+            if (const std::optional<std::uint64_t> nodes {table->find(hash, depth)}) {
+                return *nodes;
+            }
+        }
+
+        std::uint64_t nodes {0};
+
+        for (const bitboard::move& chess_move: moves.flatten()) {
+            nodes += perft(board.after_move(chess_move), depth - 1, table);
+        }
+
+        if (table != nullptr) {
+            table->store(hash, depth, nodes);
+        }
+
+        return nodes;
+    }
+
+    std::vector<perft_divide_entry> perft_divide(const bitboard& board, int depth,
+                                                 std::size_t thread_count, perft_table* table) {
+        const std::vector<bitboard::move> root_moves {board.all_legal_moves()};
+        std::vector<perft_divide_entry> entries {};
+
+        for (const bitboard::move& root_move: root_moves) {
+            entries.push_back(perft_divide_entry {root_move, depth <= 1 ? 1U : 0U});
+        }
+
+        if (depth <= 1) {
+            return entries;
+        }
+
+        std::atomic<std::size_t> next_move {0};
+
+        {
+            std::vector<std::jthread> workers;
+
+            for (std::size_t worker {}; worker < std::max<std::size_t>(thread_count, 1); worker++) {
+                workers.emplace_back([&]() {
+                    for (std::size_t index {next_move++}; index < entries.size();
+                         index = next_move++) {
+                        entries.at(index).nodes = perft(
+                            board.after_move(entries.at(index).root_move), depth - 1, table);
+                    }
+                });
+            }
+        }
+
+        return entries;
+    }
+} // namespace esochess
@@ -0,0 +1,324 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <expected>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "headers/bitboard.hpp"
+#include "headers/mapped_file.hpp"
+#include "headers/pgn.hpp"
+#include "headers/san.hpp"
+
+namespace esochess {
+    namespace {
+        bool is_pgn_whitespace(char letter) {
+            return letter == ' ' || letter == '\t' || letter == '\r' || letter == '\n';
+        }
+
+        bool is_token_delimiter(char letter) {
+            return is_pgn_whitespace(letter) || letter == '{' || letter == '}' || letter == '(' ||
+                   letter == ')' || letter == ';' || letter == '[' || letter == ']';
+        }
+
+        GameResult game_result_from_string(std::string_view result) {
+            if (result == "1-0") {
+                return GameResult::WhiteWin;
+            }
+
+            if (result == "0-1") {
+                return GameResult::BlackWin;
+            }
+
+            if (result == "1/2-1/2") {
+                return GameResult::Draw;
+            }
+
+            return GameResult::Unknown;
+        }
+
+        // A game starts at a tag line that does not follow another tag line
+        std::size_t next_game_start(std::string_view pgn_text, std::size_t from) {
+            for (std::size_t newline {pgn_text.find("\n[", from == 0 ? 0 : from - 1)};
+                 newline != std::string_view::npos;
+                 newline = pgn_text.find("\n[", newline + 1)) {
+                const std::size_t previous_text_end {
+                    pgn_text.find_last_not_of(" \t\r\n", newline)};
+
+                if (previous_text_end == std::string_view::npos) {
+                    return newline + 1;
+                }
+
+                const std::size_t previous_line_break {
+                    pgn_text.rfind('\n', previous_text_end)};
+                const std::size_t previous_line_start {
+                    pgn_text.find_first_not_of(" \t", previous_line_break == std::string_view::npos
+                                                           ? 0
+                                                           : previous_line_break + 1)};
+
+                if (pgn_text [previous_line_start] != '[') {
+                    return newline + 1;
+                }
+            }
+
+            return pgn_text.size();
+        }
+
+        struct pgn_game_replayer {
+            void start_game() {
+                board = fen_tag.has_value()
+                            ? bitboard::from_fen(*fen_tag).value_or(bitboard {})
+                            : bitboard::from_fen(bitboard::starting_position_fen).value();
+                in_movetext = true;
+            }
+
+            void finish_game() {
+                if (in_movetext || has_tags) {
+                    statistics.games++;
+                }
+
+                in_movetext = false;
+                has_tags = false;
+                abandoned = false;
+                fen_tag.reset();
+                result = GameResult::Unknown;
+            }
+
+            void read_tag(std::string_view tag_line) {
+                const std::size_t name_start {tag_line.find_first_not_of(" \t", 1)};
+                const std::size_t name_end {tag_line.find_first_of(" \t\"]", name_start)};
+                const std::size_t value_start {tag_line.find('"', name_end)};
+                const std::size_t value_end {value_start == std::string_view::npos
+                                                 ? std::string_view::npos
+                                                 : tag_line.find('"', value_start + 1)};
+
+                if (name_start == std::string_view::npos || value_end == std::string_view::npos) {
+                    return;
+                }
+
+                const std::string_view name {tag_line.substr(name_start, name_end - name_start)};
+                const std::string_view value {
+                    tag_line.substr(value_start + 1, value_end - value_start - 1)};
+
+                if (name == "FEN") {
+                    fen_tag = value;
+                }
+
+                else if (name == "Result") {
+                    result = game_result_from_string(value);
+                }
+
+                has_tags = true;
+            }
+
+            void play_san(std::string_view san) {
+                if (!in_movetext) {
+                    start_game();
+                }
+
+                if (abandoned) {
+                    return;
+                }
+
+                const std::optional<bitboard::move> move_played {move_from_san(board, san)};
+
+                if (!move_played.has_value()) {
+                    abandoned = true;
+                    statistics.unresolved_games++;
+                    return;
+                }
+
+                bitboard position_after {board.after_move(*move_played)};
+
+                visitor(pgn_move_visit {worker_index, board, *move_played, position_after, result});
+
+                board = std::move(position_after);
+                statistics.moves++;
+            }
+
+            std::size_t worker_index;
+            const pgn_move_visitor& visitor;
+
+            pgn_ingest_statistics statistics {};
+            bitboard board {};
+            std::optional<std::string_view> fen_tag {};
+            GameResult result {GameResult::Unknown};
+            bool in_movetext {false};
+            bool has_tags {false};
+            bool abandoned {false};
+        };
+    } // namespace
+
+    pgn_ingest_statistics& pgn_ingest_statistics::operator+=(const pgn_ingest_statistics& other) {
+        games += other.games;
+        moves += other.moves;
+        unresolved_games += other.unresolved_games;
+
+        return *this;
+    }
+
+    pgn_ingest_statistics replay_pgn_games(std::string_view pgn_text, std::size_t worker_index,
+                                           const pgn_move_visitor& visitor) {
+        pgn_game_replayer replayer {worker_index, visitor};
+        std::size_t position {0};
+
+        const auto skip_past {[&pgn_text, &position](char letter) {
+            position = pgn_text.find(letter, position);
+            position = (position == std::string_view::npos) ? pgn_text.size() : position + 1;
+        }};
+
+        while (position < pgn_text.size()) {
+            const char letter {pgn_text [position]};
+            const bool at_line_start {position == 0 || pgn_text [position - 1] == '\n'};
+
+            if (is_pgn_whitespace(letter)) {
+                position++;
+            }
+
+            else if (letter == '[' && at_line_start) {
+                if (replayer.in_movetext) {
+                    replayer.finish_game();
+                }
+
+                const std::size_t line_start {position};
+                skip_past('\n');
+                replayer.read_tag(pgn_text.substr(line_start, position - line_start));
+            }
+
+            else if (letter == '{') {
+                skip_past('}');
+            }
+
+            else if (letter == ';' || (letter == '%' && at_line_start)) {
+                skip_past('\n');
+            }
+
+            else if (letter == '(') { // Variations are skipped with their nested comments
+                int depth {0};
+
+                for (; position < pgn_text.size(); position++) {
+                    if (pgn_text [position] == '{') {
+                        skip_past('}');
+                        position--;
+                    }
+
+                    else if (pgn_text [position] == '(') {
+                        depth++;
+                    }
+
+                    else if (pgn_text [position] == ')' && --depth == 0) {
+                        position++;
+                        break;
+                    }
+                }
+            }
+
+            else if (is_token_delimiter(letter)) {
+                position++;
+            }
+
+            else {
+                const std::size_t token_start {position};
+
+                while (position < pgn_text.size() && !is_token_delimiter(pgn_text [position])) {
+                    position++;
+                }
+
+                std::string_view token {pgn_text.substr(token_start, position - token_start)};
+
+                if (token == "1-0" || token == "0-1" || token == "1/2-1/2" || token == "*") {
+                    replayer.finish_game();
+                    continue;
+                }
+
+                if (token.front() == '$') { // Numeric annotation glyph
+                    continue;
+                }
+
+                if (token.front() >= '1' && token.front() <= '9') { // Move number, as in `12.`
+                    token.remove_prefix(std::min(token.find('.'), token.size()));
+                }
+
+                token.remove_prefix(std::min(token.find_first_not_of('.'), token.size()));
+
+                if (!token.empty()) {
+                    replayer.play_san(token);
+                }
+            }
+        }
+
+        replayer.finish_game();
+
+        return replayer.statistics;
+    }
+
+    pgn_reader::pgn_reader(mapped_file&& file) : _file {std::move(file)} {
+    }
+
+    std::expected<pgn_reader, std::error_code> pgn_reader::open(const std::string& path) {
+        std::expected<mapped_file, std::error_code> file {mapped_file::open(path)};
+
+        if (!file.has_value()) {
+            return std::unexpected {file.error()};
+        }
+
+        return pgn_reader {std::move(*file)};
+    }
+
+    pgn_ingest_statistics pgn_reader::replay(std::size_t thread_count,
+                                             const pgn_move_visitor& visitor) const {
+        static constexpr std::size_t chunks_per_thread {16};
+
+        const std::string_view pgn_text {reinterpret_cast<const char*>(_file.bytes().data()),
+                                         _file.size()};
+        const std::size_t worker_count {std::max<std::size_t>(thread_count, 1)};
+        const std::size_t chunk_count {worker_count * chunks_per_thread};
+
+        std::vector<std::size_t> chunk_boundaries {0};
+
+        for (std::size_t chunk {1}; chunk < chunk_count; chunk++) {
+            const std::size_t boundary {
+                next_game_start(pgn_text, std::max(pgn_text.size() / chunk_count * chunk,
+                                                   chunk_boundaries.back()))};
+
+            if (boundary > chunk_boundaries.back() && boundary < pgn_text.size()) {
+                chunk_boundaries.push_back(boundary);
+            }
+        }
+
+        chunk_boundaries.push_back(pgn_text.size());
+
+        std::atomic<std::size_t> next_chunk {0};
+        std::vector<pgn_ingest_statistics> worker_statistics(worker_count);
+
+        {
+            std::vector<std::jthread> workers;
+
+            for (std::size_t worker_index {}; worker_index < worker_count; worker_index++) {
+                workers.emplace_back([&, worker_index]() {
+                    for (std::size_t chunk {next_chunk++}; chunk + 1 < chunk_boundaries.size();
+                         chunk = next_chunk++) {
+                        worker_statistics.at(worker_index) += replay_pgn_games(
+                            pgn_text.substr(chunk_boundaries.at(chunk),
+                                            chunk_boundaries.at(chunk + 1) -
+                                                chunk_boundaries.at(chunk)),
+                            worker_index, visitor);
+                    }
+                });
+            }
+        }
+
+        pgn_ingest_statistics statistics {};
+
+        for (const pgn_ingest_statistics& single_worker_statistics: worker_statistics) {
+            statistics += single_worker_statistics;
+        }
+
+        return statistics;
+    }
+} // namespace esochess
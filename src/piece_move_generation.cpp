@@ -1,13 +1,17 @@
 #include <array>
-#include <numeric>
+#include <bit>
 #include <utility>
 #include <vector>
 
+#include "headers/attacks.hpp"
 #include "headers/bitboard.hpp"
 #include "headers/move_generation.hpp"
+#include "headers/profiler.hpp"
 
 namespace esochess {
     void add_king_moves(bitboard& board, bitboard::moves_listing& moves_listing_ext) {
+        ESOCHESS_PROFILE_SCOPE(AddKingMoves);
+
         const bitboard::Turn turn {board.turn()};
         const bitboard::bit_representation king_bitboard {board.bitboards().at(
             turn == bitboard::Turn::White ? bitboard::pieces::white_king.bitboard_index
@@ -19,22 +23,27 @@ namespace esochess {
 
         const bitboard::cordinate king_cordinate {
             bitboard::cordinate_from_bit_representation(king_bitboard).at(0)};
-        const bitboard::bit_representation opponent_controlled_squares_bits {
-            (turn == bitboard::Turn::White ? board.cached_moves_listing().black_controlled_squares
-                                           : board.cached_moves_listing().white_controlled_squares)
-                .value_or(0)};
+        const bitboard::Turn opponents_turn {bitboard::opposite_turn(turn)};
+        // The king does not block attacks along the line it is moving away on
+        const bitboard::bit_representation occupancy_without_king {
+            board.bitboard_bitor_accumulation(bitboard::Turn::All) & ~king_bitboard};
 
         for (const bitboard::Direction king_direction: bitboard::pieces::all_directions) {
             const bitboard::cordinate cordinate_in_direction {
                 king_cordinate.in_direction(king_direction)};
+
+            if (!bitboard::in_bounds(cordinate_in_direction)) {
+                continue;
+            }
+
             const bitboard::bit_representation cordinate_in_direction_bits {
                 cordinate_in_direction.to_bit_representation()};
 
             add_controlled_squares_to_bitboard(board, cordinate_in_direction_bits, turn);
 
-            if (bitboard::in_bounds(cordinate_in_direction) &&
-                (board.bitboard_bitor_accumulation(turn) & cordinate_in_direction_bits) == 0 &&
-                (cordinate_in_direction_bits & opponent_controlled_squares_bits) == 0) {
+            if ((board.bitboard_bitor_accumulation(turn) & cordinate_in_direction_bits) == 0 &&
+                board.attackers_of(cordinate_in_direction_bits, opponents_turn,
+                                   occupancy_without_king) == 0) {
                 moves_listing_ext.normal_moves.emplace_back(king_cordinate.to_bit_representation(),
                                                             cordinate_in_direction_bits);
             }
@@ -44,111 +53,68 @@ namespace esochess {
     }
 
     void add_king_castle_moves(bitboard& board, bitboard::moves_listing& moves_listing_ext) {
-        const static std::array<bitboard::cordinate, 2> white_kingside_castle_cordinates {
-            {bitboard::cordinate {5, 0}, bitboard::cordinate {6, 0}}
-        };
-
-        const static std::array<bitboard::cordinate, 2> white_queenside_castle_cordinates {
-            {bitboard::cordinate {2, 0}, bitboard::cordinate {3, 0}}
-        };
+        ESOCHESS_PROFILE_SCOPE(AddKingCastleMoves);
 
-        const static std::array<bitboard::cordinate, 2> black_kingside_castle_cordinates {
-            {bitboard::cordinate {5, 7}, bitboard::cordinate {6, 7}}
+        struct castle_requirements {
+            bitboard::Turn turn;
+            bitboard::CastleType castle_type;
+            bitboard::bit_representation empty_squares;  // Between the king and the rook
+            bitboard::bit_representation passed_squares; // The king may not pass through check
         };
 
-        const static std::array<bitboard::cordinate, 2> black_queenside_castle_cordinates {
-            {bitboard::cordinate {2, 7}, bitboard::cordinate {3, 7}}
+        const static std::array<castle_requirements, 4> all_castle_requirements {
+            {{bitboard::Turn::White, bitboard::CastleType::KingSide,
+              square_bits(5) | square_bits(6), square_bits(4) | square_bits(5) | square_bits(6)},
+             {bitboard::Turn::White, bitboard::CastleType::QueenSide,
+              square_bits(1) | square_bits(2) | square_bits(3),
+              square_bits(2) | square_bits(3) | square_bits(4)},
+             {bitboard::Turn::Black, bitboard::CastleType::KingSide,
+              square_bits(61) | square_bits(62),
+              square_bits(60) | square_bits(61) | square_bits(62)},
+             {bitboard::Turn::Black, bitboard::CastleType::QueenSide,
+              square_bits(57) | square_bits(58) | square_bits(59),
+              square_bits(58) | square_bits(59) | square_bits(60)}}
         };
 
-        const static bitboard::bit_representation white_kingside_castle_mask {std::accumulate(
-            white_kingside_castle_cordinates.begin(), white_kingside_castle_cordinates.end(),
-            bitboard::bit_representation {0},
-            [](bitboard::bit_representation acc, const bitboard::cordinate& cordinate) {
-                return acc | cordinate.to_bit_representation();
-            })};
-
-        const static bitboard::bit_representation white_queenside_castle_mask {std::accumulate(
-            white_queenside_castle_cordinates.begin(), white_queenside_castle_cordinates.end(),
-            bitboard::bit_representation {0},
-            [](bitboard::bit_representation acc, const bitboard::cordinate& cordinate) {
-                return acc | cordinate.to_bit_representation();
-            })};
-
-        const static bitboard::bit_representation black_kingside_castle_mask {std::accumulate(
-            black_kingside_castle_cordinates.begin(), black_kingside_castle_cordinates.end(),
-            bitboard::bit_representation {0},
-            [](bitboard::bit_representation acc, const bitboard::cordinate& cordinate) {
-                return acc | cordinate.to_bit_representation();
-            })};
-
-        const static bitboard::bit_representation black_queenside_castle_mask {std::accumulate(
-            black_queenside_castle_cordinates.begin(), black_queenside_castle_cordinates.end(),
-            bitboard::bit_representation {0},
-            [](bitboard::bit_representation acc, const bitboard::cordinate& cordinate) {
-                return acc | cordinate.to_bit_representation();
-            })};
-
         const bitboard::Turn turn {board.turn()};
-        const bitboard::cached_moves_listing_t& cached_moves_listing {board.cached_moves_listing()};
-
-        if (turn == bitboard::Turn::White &&
-            (board.castle_rights().white_king_side) && // white king side can castle
-            ((cached_moves_listing.black_controlled_squares.value_or(
-                  bitboard::bit_representation {0}) &
-              white_kingside_castle_mask) == white_kingside_castle_mask) &&
-            // None of the kingside castle spaces are controlled by black pieces
-            ((board.bitboard_bitor_accumulation(bitboard::Turn::All) &
-              white_kingside_castle_mask) == 0)
-            // No pieces can occupy kingside castle squares
-        ) {
-            moves_listing_ext.castle_moves.emplace_back(bitboard::Turn::White,
-                                                        bitboard::CastleType::KingSide);
-        }
+        const bitboard::castle_rights_collection castle_rights {board.castle_rights()};
+        const bitboard::bit_representation occupancy {
+            board.bitboard_bitor_accumulation(bitboard::Turn::All)};
+
+        for (const castle_requirements& requirements: all_castle_requirements) {
+            const bool has_castle_right {
+                requirements.turn == bitboard::Turn::White
+                    ? (requirements.castle_type == bitboard::CastleType::KingSide
+                           ? castle_rights.white_king_side
+                           : castle_rights.white_queen_side)
+                    : (requirements.castle_type == bitboard::CastleType::KingSide
+                           ? castle_rights.black_king_side
+                           : castle_rights.black_queen_side)};
+
+            if (requirements.turn != turn || !has_castle_right ||
+                (occupancy & requirements.empty_squares) != 0) {
+                continue;
+            }
 
-        if (turn == bitboard::Turn::White &&
-            (board.castle_rights().white_queen_side) && // white queen side can castle
-            ((cached_moves_listing.black_controlled_squares.value_or(
-                  bitboard::bit_representation {0}) &
-              white_queenside_castle_mask) == white_queenside_castle_mask) &&
-            // None of the queenside castle spaces are controlled by black pieces
-            ((board.bitboard_bitor_accumulation(bitboard::Turn::All) &
-              white_queenside_castle_mask) == 0)
-            // No pieces can occupy queenside castle squares
-        ) {
-            moves_listing_ext.castle_moves.emplace_back(bitboard::Turn::White,
-                                                        bitboard::CastleType::QueenSide);
-        }
+            bool passes_through_check {false};
 
-        if (turn == bitboard::Turn::Black &&
-            (board.castle_rights().black_king_side) && // black king side can castle
-            ((cached_moves_listing.white_controlled_squares.value_or(
-                  bitboard::bit_representation {0}) &
-              black_kingside_castle_mask) == black_kingside_castle_mask) &&
-            // None of the kingside castle spaces are controlled by white pieces
-            ((board.bitboard_bitor_accumulation(bitboard::Turn::All) &
-              black_kingside_castle_mask) == 0)
-            // No pieces can occupy kingside castle squares
-        ) {
-            moves_listing_ext.castle_moves.emplace_back(bitboard::Turn::Black,
-                                                        bitboard::CastleType::KingSide);
-        }
+            for (bitboard::bit_representation passed_squares {requirements.passed_squares};
+                 passed_squares != 0; passed_squares = without_lowest_square(passed_squares)) {
+                passes_through_check = passes_through_check ||
+                                       board.is_square_attacked(std::bit_floor(passed_squares),
+                                                                bitboard::opposite_turn(turn));
+            }
 
-        if (turn == bitboard::Turn::Black &&
-            (board.castle_rights().black_queen_side) && // black queen side can castle
-            ((cached_moves_listing.white_controlled_squares.value_or(
-                  bitboard::bit_representation {0}) &
-              black_queenside_castle_mask) == black_queenside_castle_mask) &&
-            // None of the queenside castle spaces are controlled by white pieces
-            ((board.bitboard_bitor_accumulation(bitboard::Turn::All) &
-              black_queenside_castle_mask) == 0)
-            // No pieces can occupy queenside castle squares
-        ) {
-            moves_listing_ext.castle_moves.emplace_back(bitboard::Turn::Black,
-                                                        bitboard::CastleType::QueenSide);
+            if (!passes_through_check) {
+                moves_listing_ext.castle_moves.emplace_back(requirements.turn,
+                                                            requirements.castle_type);
+            }
         }
     }
 
     void add_rook_bishop_queen_moves(bitboard& board, bitboard::moves_listing& moves_listing_ext) {
+        ESOCHESS_PROFILE_SCOPE(AddRookBishopQueenMoves);
+
         const bitboard::Turn turn {board.turn()};
 
         for (const bitboard::piece& piece:
@@ -184,6 +150,8 @@ namespace esochess {
 
     void add_bishop_moves(bitboard& board, bitboard::moves_listing& moves_listing_ext,
                           const bitboard::cordinate& at_cordinate) {
+        ESOCHESS_PROFILE_SCOPE(AddBishopMoves);
+
         const bitboard::Turn turn {board.turn()};
         const bitboard::Turn opponents_turn {bitboard::opposite_turn(turn)};
         const bitboard::bit_representation bishop_cordinate_bits {
@@ -194,16 +162,20 @@ namespace esochess {
             board.bitboard_bitor_accumulation(opponents_turn)};
 
         for (const bitboard::Direction& direction: bitboard::pieces::bishop_directions) {
-            for (int steps {}; steps < 8; steps++) {
+            for (int steps {1}; steps < 8; steps++) {
                 const bitboard::cordinate cordinate_after_steps {
                     at_cordinate.in_direction(direction, steps)};
+
+                if (!bitboard::in_bounds(cordinate_after_steps)) {
+                    break;
+                }
+
                 const bitboard::bit_representation cordinate_after_steps_bits {
                     cordinate_after_steps.to_bit_representation()};
 
                 add_controlled_squares_to_bitboard(board, cordinate_after_steps_bits, turn);
 
-                if (!bitboard::in_bounds(cordinate_after_steps) ||
-                    (current_turns_pieces_positions_bits & cordinate_after_steps_bits) != 0) {
+                if ((current_turns_pieces_positions_bits & cordinate_after_steps_bits) != 0) {
                     break; // Do not continue searching for moves in this direction
                 }
 
@@ -221,6 +193,8 @@ namespace esochess {
 
     void add_rook_moves(bitboard& board, bitboard::moves_listing& moves_listing_ext,
                         const bitboard::cordinate& at_cordinate) {
+        ESOCHESS_PROFILE_SCOPE(AddRookMoves);
+
         const bitboard::Turn turn {board.turn()};
         const bitboard::Turn opponents_turn {bitboard::opposite_turn(turn)};
         const bitboard::bit_representation rook_cordinate_bits {
@@ -231,16 +205,20 @@ namespace esochess {
             board.bitboard_bitor_accumulation(opponents_turn)};
 
         for (const bitboard::Direction& direction: bitboard::pieces::rook_directions) {
-            for (int steps {}; steps < 8; steps++) {
+            for (int steps {1}; steps < 8; steps++) {
                 const bitboard::cordinate cordinate_after_steps {
                     at_cordinate.in_direction(direction, steps)};
+
+                if (!bitboard::in_bounds(cordinate_after_steps)) {
+                    break;
+                }
+
                 const bitboard::bit_representation cordinate_after_steps_bits {
                     cordinate_after_steps.to_bit_representation()};
 
                 add_controlled_squares_to_bitboard(board, cordinate_after_steps_bits, turn);
 
-                if (!bitboard::in_bounds(cordinate_after_steps) ||
-                    (current_turns_pieces_positions_bits & cordinate_after_steps_bits) != 0) {
+                if ((current_turns_pieces_positions_bits & cordinate_after_steps_bits) != 0) {
                     break; // Do not continue searching for moves in this direction
                 }
 
@@ -259,6 +237,8 @@ namespace esochess {
 
     void add_queen_moves(bitboard& board, bitboard::moves_listing& moves_listing_ext,
                          const bitboard::cordinate& at_cordinate) {
+        ESOCHESS_PROFILE_SCOPE(AddQueenMoves);
+
         const bitboard::Turn turn {board.turn()};
         const bitboard::Turn opponents_turn {bitboard::opposite_turn(turn)};
         const bitboard::bit_representation queen_cordinate_bits {
@@ -269,16 +249,20 @@ namespace esochess {
             board.bitboard_bitor_accumulation(opponents_turn)};
 
         for (const bitboard::Direction& direction: bitboard::pieces::all_directions) {
-            for (int steps {}; steps < 8; steps++) {
+            for (int steps {1}; steps < 8; steps++) {
                 const bitboard::cordinate cordinate_after_steps {
                     at_cordinate.in_direction(direction, steps)};
+
+                if (!bitboard::in_bounds(cordinate_after_steps)) {
+                    break;
+                }
+
                 const bitboard::bit_representation cordinate_after_steps_bits {
                     cordinate_after_steps.to_bit_representation()};
 
                 add_controlled_squares_to_bitboard(board, cordinate_after_steps_bits, turn);
 
-                if (!bitboard::in_bounds(cordinate_after_steps) ||
-                    (current_turns_pieces_positions_bits & cordinate_after_steps_bits) != 0) {
+                if ((current_turns_pieces_positions_bits & cordinate_after_steps_bits) != 0) {
                     break; // Do not continue searching for moves in this direction
                 }
 
@@ -296,6 +280,8 @@ namespace esochess {
     }
 
     void add_knight_moves(bitboard& board, bitboard::moves_listing& moves_listing_ext) {
+        ESOCHESS_PROFILE_SCOPE(AddKnightMoves);
+
         using Direction = bitboard::Direction;
 
         static constexpr std::array<std::pair<int, int>, 8> knight_move_differences {
@@ -315,9 +301,6 @@ namespace esochess {
                     knight_cordinate.in_direction(Direction::North, x_difference)
                         .in_direction(Direction::East, y_difference)};
 
-                add_controlled_squares_to_bitboard(
-                    board, cordinate_after_move.to_bit_representation(), turn);
-
                 if (!bitboard::in_bounds(cordinate_after_move)) {
                     continue;
                 }
@@ -325,6 +308,8 @@ namespace esochess {
                 const bitboard::bit_representation cordinate_after_move_bits {
                     cordinate_after_move.to_bit_representation()};
 
+                add_controlled_squares_to_bitboard(board, cordinate_after_move_bits, turn);
+
                 if (board.color_at_square(cordinate_after_move_bits) !=
                     turn) { // The square moved to only
                             // needs to hold a different color piece
@@ -342,8 +327,7 @@ namespace esochess {
             controlled_squares_bits = bitboard::bit_representation {};
         }
 
-        controlled_squares_bits.transform(
-            [&bit_mask](bitboard::bit_representation bits) { return bits | bit_mask; });
+        *controlled_squares_bits |= bit_mask;
     }
 
     void add_controlled_squares_to_bitboard(bitboard& bitboard_ext,
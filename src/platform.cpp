@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <span>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+
+#include "headers/platform.hpp"
+
+namespace esochess {
+    huge_page_memory::huge_page_memory(void* mapping, std::size_t mapping_size, std::byte* data,
+                                       std::size_t size, bool advised_huge_pages) :
+        _mapping {mapping}, _mapping_size {mapping_size}, _data {data}, _size {size},
+        _advised_huge_pages {advised_huge_pages} {
+    }
+
+    huge_page_memory::huge_page_memory(huge_page_memory&& other) noexcept :
+        _mapping {std::exchange(other._mapping, nullptr)},
+        _mapping_size {std::exchange(other._mapping_size, 0)},
+        _data {std::exchange(other._data, nullptr)}, _size {std::exchange(other._size, 0)},
+        _advised_huge_pages {std::exchange(other._advised_huge_pages, false)} {
+    }
+
+    huge_page_memory::~huge_page_memory() {
+        if (_mapping != nullptr) {
+            munmap(_mapping, _mapping_size);
+        }
+    }
+
+    huge_page_memory& huge_page_memory::operator=(huge_page_memory&& other) noexcept {
+        if (this != &other) {
+            if (_mapping != nullptr) {
+                munmap(_mapping, _mapping_size);
+            }
+
+            _mapping = std::exchange(other._mapping, nullptr);
+            _mapping_size = std::exchange(other._mapping_size, 0);
+            _data = std::exchange(other._data, nullptr);
+            _size = std::exchange(other._size, 0);
+            _advised_huge_pages = std::exchange(other._advised_huge_pages, false);
+        }
+
+        return *this;
+    }
+
+    std::expected<huge_page_memory, std::error_code>
+        huge_page_memory::allocate(std::size_t size, PageSize page_size) {
+        if (size == 0) {
+            return huge_page_memory {};
+        }
+
+        // Huge pages only back whole aligned 2 MB ranges, so the mapping leaves room to align
+        const bool use_huge_pages {page_size == PageSize::Huge && size >= huge_page_size};
+        const std::size_t mapping_size {use_huge_pages ? size + huge_page_size : size};
+        void* const mapping {mmap(nullptr, mapping_size, PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)};
+
+        if (mapping == MAP_FAILED) {
+            return std::unexpected {std::error_code {errno, std::system_category()}};
+        }
+
+        auto* data {static_cast<std::byte*>(mapping)};
+        bool advised_huge_pages {false};
+
+        if (use_huge_pages) {
+            const auto address {reinterpret_cast<std::uintptr_t>(mapping)};
+            const std::uintptr_t misalignment {address % huge_page_size};
+
+            data += misalignment == 0 ? 0 : huge_page_size - misalignment;
+#if defined(MADV_HUGEPAGE)
+            advised_huge_pages = madvise(data, size, MADV_HUGEPAGE) == 0;
+#endif
+        }
+
+        return huge_page_memory {mapping, mapping_size, data, size, advised_huge_pages};
+    }
+
+    std::span<std::byte> huge_page_memory::bytes() const noexcept {
+        return {_data, _size};
+    }
+
+    bool huge_page_memory::advised_huge_pages() const noexcept {
+        return _advised_huge_pages;
+    }
+
+    void for_each_range_in_parallel(std::size_t count, std::size_t minimum_per_thread,
+                                    const std::function<void(std::size_t, std::size_t)>& work) {
+        const std::size_t thread_count {
+            std::clamp<std::size_t>(count / std::max<std::size_t>(minimum_per_thread, 1), 1,
+                                    std::max(1U, std::thread::hardware_concurrency()))};
+
+        if (thread_count == 1) {
+            work(0, count);
+            return;
+        }
+
+        std::vector<std::jthread> threads {};
+
+        for (std::size_t thread {}; thread < thread_count; thread++) {
+            threads.emplace_back(work, count * thread / thread_count,
+                                 count * (thread + 1) / thread_count);
+        }
+    }
+
+    bool pin_current_thread(std::size_t core_index) {
+        cpu_set_t allowed_cores {};
+
+        if (sched_getaffinity(0, sizeof(allowed_cores), &allowed_cores) != 0) {
+            return false;
+        }
+
+        const auto allowed_count {static_cast<std::size_t>(CPU_COUNT(&allowed_cores))};
+        std::size_t remaining {core_index % std::max<std::size_t>(allowed_count, 1)};
+
+        for (int core {}; core < CPU_SETSIZE; core++) {
+            if (!CPU_ISSET(core, &allowed_cores)) {
+                continue;
+            }
+
+            if (remaining-- == 0) {
+                cpu_set_t pinned_core {};
+
+                CPU_ZERO(&pinned_core);
+                CPU_SET(core, &pinned_core);
+
+                return pthread_setaffinity_np(pthread_self(), sizeof(pinned_core), &pinned_core) ==
+                       0;
+            }
+        }
+
+        return false;
+    }
+} // namespace esochess
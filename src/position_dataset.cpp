@@ -0,0 +1,140 @@
+#include <cstddef>
+#include <expected>
+#include <fstream>
+#include <optional>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "headers/bitboard.hpp"
+#include "headers/mapped_file.hpp"
+#include "headers/packed_position.hpp"
+
+namespace esochess {
+    position_dataset_writer::position_dataset_writer(std::ofstream&& stream) :
+        _stream {std::move(stream)} {
+    }
+
+    position_dataset_writer::~position_dataset_writer() {
+        close();
+    }
+
+    position_dataset_writer&
+        position_dataset_writer::operator=(position_dataset_writer&& other) noexcept {
+        if (this != &other) {
+            close();
+            _stream = std::move(other._stream);
+            _position_count = std::exchange(other._position_count, 0);
+        }
+
+        return *this;
+    }
+
+    std::expected<position_dataset_writer, std::error_code>
+        position_dataset_writer::create(const std::string& path) {
+        std::ofstream stream {path, std::ios::binary | std::ios::trunc};
+
+        if (!stream.is_open()) {
+            return std::unexpected {std::make_error_code(std::errc::io_error)};
+        }
+
+        const position_dataset_header header {position_dataset_header::expected_magic, 0, {}};
+        stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        if (!stream.good()) {
+            return std::unexpected {std::make_error_code(std::errc::io_error)};
+        }
+
+        return position_dataset_writer {std::move(stream)};
+    }
+
+    bool position_dataset_writer::write(const packed_position& position) {
+        _stream.write(reinterpret_cast<const char*>(&position), sizeof(position));
+
+        if (!_stream.good()) {
+            return false;
+        }
+
+        _position_count++;
+        return true;
+    }
+
+    bool position_dataset_writer::write(const bitboard& board) {
+        const std::optional<packed_position> position {packed_position::from_bitboard(board)};
+
+        return position.has_value() && write(*position);
+    }
+
+    std::error_code position_dataset_writer::close() {
+        if (!_stream.is_open()) {
+            return {};
+        }
+
+        const position_dataset_header header {position_dataset_header::expected_magic,
+                                              _position_count, {}};
+
+        _stream.seekp(0);
+        _stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        _stream.close();
+
+        return _stream.fail() ? std::make_error_code(std::errc::io_error) : std::error_code {};
+    }
+
+    std::uint64_t position_dataset_writer::position_count() const noexcept {
+        return _position_count;
+    }
+
+    position_dataset_reader::position_dataset_reader(mapped_file&& file,
+                                                     std::span<const packed_position> positions) :
+        _file {std::move(file)},
+        _positions {positions} {
+    }
+
+    std::expected<position_dataset_reader, std::error_code>
+        position_dataset_reader::open(const std::string& path) {
+        std::expected<mapped_file, std::error_code> file {mapped_file::open(path)};
+
+        if (!file.has_value()) {
+            return std::unexpected {file.error()};
+        }
+
+        const std::span<const std::byte> bytes {file->bytes()};
+
+        if (bytes.size() < sizeof(position_dataset_header)) {
+            return std::unexpected {std::make_error_code(std::errc::invalid_argument)};
+        }
+
+        const auto* const header {reinterpret_cast<const position_dataset_header*>(bytes.data())};
+        const std::size_t stored_positions {(bytes.size() - sizeof(position_dataset_header)) /
+                                            sizeof(packed_position)};
+
+        if (header->magic != position_dataset_header::expected_magic ||
+            header->position_count > stored_positions) {
+            return std::unexpected {std::make_error_code(std::errc::invalid_argument)};
+        }
+
+        const auto* const first_position {reinterpret_cast<const packed_position*>(
+            bytes.data() + sizeof(position_dataset_header))};
+        const std::span<const packed_position> positions {
+            first_position, static_cast<std::size_t>(header->position_count)};
+
+        return position_dataset_reader {std::move(*file), positions};
+    }
+
+    std::span<const packed_position> position_dataset_reader::positions() const noexcept {
+        return _positions;
+    }
+
+    std::size_t position_dataset_reader::size() const noexcept {
+        return _positions.size();
+    }
+
+    const packed_position* position_dataset_reader::begin() const noexcept {
+        return _positions.data();
+    }
+
+    const packed_position* position_dataset_reader::end() const noexcept {
+        return _positions.data() + _positions.size();
+    }
+} // namespace esochess
@@ -0,0 +1,379 @@
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <span>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include "headers/mapped_file.hpp"
+#include "headers/position_index.hpp"
+
+namespace esochess {
+    bool position_key_set::insert(std::uint64_t key) {
+        if (key == 0) {
+            return !std::exchange(_contains_zero, true);
+        }
+
+        if (_slots.empty() || at_capacity()) {
+            grow();
+        }
+
+        const std::size_t mask {_slots.size() - 1};
+
+        for (std::size_t slot {slot_of(key)};; slot = (slot + 1) & mask) {
+            if (_slots [slot] == key) {
+                return false;
+            }
+
+            if (_slots [slot] == 0) {
+                _slots [slot] = key;
+                _size++;
+                return true;
+            }
+        }
+    }
+
+    bool position_key_set::contains(std::uint64_t key) const noexcept {
+        if (key == 0) {
+            return _contains_zero;
+        }
+
+        if (_slots.empty()) {
+            return false;
+        }
+
+        const std::size_t mask {_slots.size() - 1};
+
+        for (std::size_t slot {slot_of(key)}; _slots [slot] != 0; slot = (slot + 1) & mask) {
+            if (_slots [slot] == key) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    void position_key_set::clear() noexcept {
+        std::ranges::fill(_slots, 0);
+        _size = 0;
+        _contains_zero = false;
+    }
+
+    bool position_key_set::at_capacity() const noexcept {
+        return 4 * (_size + 1) > 3 * _slots.size();
+    }
+
+    std::size_t position_key_set::size() const noexcept {
+        return _size + (_contains_zero ? 1 : 0);
+    }
+
+    std::size_t position_key_set::memory_bytes() const noexcept {
+        return _slots.size() * sizeof(std::uint64_t);
+    }
+
+    std::vector<std::uint64_t> position_key_set::sorted_keys() const {
+        std::vector<std::uint64_t> keys {};
+        keys.reserve(size());
+
+        if (_contains_zero) {
+            keys.push_back(0);
+        }
+
+        std::ranges::copy_if(_slots, std::back_inserter(keys),
+                             [](std::uint64_t key) { return key != 0; });
+        std::ranges::sort(keys);
+
+        return keys;
+    }
+
+    // Keys of one shard share their high bits, so they are mixed before picking a slot
+    std::size_t position_key_set::slot_of(std::uint64_t key) const noexcept {
+        const int slot_bits {std::countr_zero(_slots.size())};
+
+        return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ULL) >> (64 - slot_bits));
+    }
+
+    void position_key_set::grow() {
+        std::vector<std::uint64_t> old_slots {
+            std::exchange(_slots, std::vector<std::uint64_t>(
+                                      std::max(initial_slots, 2 * _slots.size()), 0))};
+        const std::size_t mask {_slots.size() - 1};
+
+        for (const std::uint64_t key: old_slots) {
+            if (key == 0) {
+                continue;
+            }
+
+            std::size_t slot {slot_of(key)};
+
+            while (_slots [slot] != 0) {
+                slot = (slot + 1) & mask;
+            }
+
+            _slots [slot] = key;
+        }
+    }
+
+    position_index::position_index(std::filesystem::path spill_directory,
+                                   std::size_t shard_count, std::size_t shard_memory_bytes) :
+        _spill_directory {std::move(spill_directory)},
+        _shard_shift {64U - static_cast<unsigned>(std::countr_zero(shard_count))},
+        _shard_memory_bytes {shard_memory_bytes} {
+        for (std::size_t shard_index {}; shard_index < shard_count; shard_index++) {
+            _shards.push_back(std::make_unique<shard>());
+        }
+    }
+
+    position_index::~position_index() {
+        if (_shards.empty()) {
+            return;
+        }
+
+        _shards.clear(); // Unmaps the runs before they are removed
+        std::error_code ignored {};
+        std::filesystem::remove_all(_spill_directory, ignored);
+    }
+
+    std::expected<position_index, std::error_code>
+        position_index::create(const position_index_options& options) {
+        std::random_device random_device {};
+        std::error_code error {};
+
+        // A directory of its own, so that indexes sharing `spill_directory` never collide
+        for (int attempt {}; attempt < 16; attempt++) {
+            const std::filesystem::path directory {
+                options.spill_directory /
+                ("esochess_position_index_" + std::to_string(random_device()))};
+
+            if (std::filesystem::create_directories(directory, error)) {
+                const std::size_t shard_count {std::bit_ceil(std::max<std::size_t>(
+                    options.shard_count, 1))};
+
+                return position_index {directory, shard_count,
+                                       options.memory_limit_bytes / shard_count};
+            }
+
+            if (error) {
+                return std::unexpected {error};
+            }
+        }
+
+        return std::unexpected {std::make_error_code(std::errc::file_exists)};
+    }
+
+    std::expected<bool, std::error_code> position_index::insert(std::uint64_t key) {
+        const std::size_t shard_index {shard_of(key)};
+        shard& keys_shard {*_shards [shard_index]};
+        const std::lock_guard<std::mutex> lock {keys_shard.mutex};
+
+        if (keys_shard.keys.contains(key) || in_runs(keys_shard, key)) {
+            return false;
+        }
+
+        if (keys_shard.keys.at_capacity() && keys_shard.keys.size() > 0 &&
+            2 * keys_shard.keys.memory_bytes() > _shard_memory_bytes) {
+            if (const std::error_code error {spill(keys_shard, shard_index)}) {
+                return std::unexpected {error};
+            }
+        }
+
+        keys_shard.keys.insert(key);
+
+        return true;
+    }
+
+    bool position_index::contains(std::uint64_t key) const {
+        const shard& keys_shard {*_shards [shard_of(key)]};
+        const std::lock_guard<std::mutex> lock {keys_shard.mutex};
+
+        return keys_shard.keys.contains(key) || in_runs(keys_shard, key);
+    }
+
+    std::size_t position_index::shard_of(std::uint64_t key) const noexcept {
+        return _shard_shift == 64 ? 0 : static_cast<std::size_t>(key >> _shard_shift);
+    }
+
+    std::size_t position_index::shard_count() const noexcept {
+        return _shards.size();
+    }
+
+    position_index_statistics position_index::statistics() const {
+        position_index_statistics statistics {0, 0, 0, 0, 0};
+
+        for (const std::unique_ptr<shard>& keys_shard: _shards) {
+            const std::lock_guard<std::mutex> lock {keys_shard->mutex};
+
+            statistics.keys += keys_shard->keys.size();
+            statistics.memory_bytes += keys_shard->keys.memory_bytes();
+            statistics.spill_runs += keys_shard->runs.size();
+
+            for (const spilled_run& run: keys_shard->runs) {
+                statistics.spilled_keys += run.keys.size();
+            }
+        }
+
+        statistics.keys += statistics.spilled_keys;
+        statistics.spill_bytes = statistics.spilled_keys * sizeof(std::uint64_t);
+
+        return statistics;
+    }
+
+    bool position_index::in_runs(const shard& keys_shard, std::uint64_t key) {
+        return std::ranges::any_of(keys_shard.runs, [key](const spilled_run& run) {
+            return std::ranges::binary_search(run.keys, key);
+        });
+    }
+
+    std::error_code position_index::spill(shard& full_shard, std::size_t shard_index) {
+        const std::vector<std::uint64_t> keys {full_shard.keys.sorted_keys()};
+        std::expected<spilled_run, std::error_code> run {
+            write_run(keys, full_shard, shard_index)};
+
+        if (!run.has_value()) {
+            return run.error();
+        }
+
+        full_shard.runs.push_back(std::move(*run));
+        full_shard.keys.clear();
+
+        // Merged runs replace the newest ones, so the tiers never rise towards the back
+        while (full_shard.runs.size() >= runs_per_merge &&
+               full_shard.runs [full_shard.runs.size() - runs_per_merge].tier ==
+                   full_shard.runs.back().tier) {
+            if (const std::error_code error {
+                    merge_runs(full_shard, shard_index, full_shard.runs.size() - runs_per_merge)};
+                error) {
+                return error;
+            }
+        }
+
+        return {};
+    }
+
+    // Runs hold disjoint keys, so merging them is a plain k way merge
+    std::error_code position_index::merge_runs(shard& full_shard, std::size_t shard_index,
+                                               std::size_t first_run) {
+        constexpr std::size_t buffered_keys {1 << 16};
+
+        const std::span<const spilled_run> runs {std::span {full_shard.runs}.subspan(first_run)};
+        std::vector<std::size_t> positions(runs.size(), 0);
+        std::vector<std::uint64_t> buffer {};
+        std::size_t total_keys {0};
+
+        for (const spilled_run& run: runs) {
+            total_keys += run.keys.size();
+        }
+
+        const std::filesystem::path path {next_run_path(full_shard, shard_index)};
+        std::ofstream stream {path, std::ios::binary};
+
+        buffer.reserve(buffered_keys);
+
+        for (std::size_t written {}; written < total_keys; written++) {
+            std::size_t smallest {runs.size()};
+
+            for (std::size_t run_index {}; run_index < runs.size(); run_index++) {
+                const std::span<const std::uint64_t> keys {runs [run_index].keys};
+
+                if (positions [run_index] < keys.size() &&
+                    (smallest == runs.size() ||
+                     keys [positions [run_index]] < runs [smallest].keys [positions [smallest]])) {
+                    smallest = run_index;
+                }
+            }
+
+            buffer.push_back(runs [smallest].keys [positions [smallest]++]);
+
+            if (buffer.size() == buffered_keys || written + 1 == total_keys) {
+                stream.write(reinterpret_cast<const char*>(buffer.data()),
+                             static_cast<std::streamsize>(buffer.size() * sizeof(std::uint64_t)));
+                buffer.clear();
+            }
+        }
+
+        stream.close();
+
+        if (stream.fail()) {
+            return std::make_error_code(std::errc::io_error);
+        }
+
+        std::expected<spilled_run, std::error_code> merged_run {open_run(path, total_keys)};
+
+        if (!merged_run.has_value()) {
+            return merged_run.error();
+        }
+
+        const auto first_old_run {full_shard.runs.begin() + static_cast<std::ptrdiff_t>(first_run)};
+        std::vector<spilled_run> old_runs {std::make_move_iterator(first_old_run),
+                                           std::make_move_iterator(full_shard.runs.end())};
+
+        merged_run->tier = old_runs.front().tier + 1;
+        full_shard.runs.erase(first_old_run, full_shard.runs.end());
+        full_shard.runs.push_back(std::move(*merged_run));
+
+        for (spilled_run& old_run: old_runs) {
+            const std::filesystem::path old_path {std::move(old_run.path)};
+            std::error_code ignored {};
+
+            old_run.file = mapped_file {};
+            std::filesystem::remove(old_path, ignored);
+        }
+
+        return {};
+    }
+
+    std::expected<position_index::spilled_run, std::error_code>
+        position_index::write_run(std::span<const std::uint64_t> keys, shard& full_shard,
+                                  std::size_t shard_index) const {
+        const std::filesystem::path path {next_run_path(full_shard, shard_index)};
+
+        {
+            std::ofstream stream {path, std::ios::binary};
+
+            stream.write(reinterpret_cast<const char*>(keys.data()),
+                         static_cast<std::streamsize>(keys.size_bytes()));
+            stream.close();
+
+            if (stream.fail()) {
+                return std::unexpected {std::make_error_code(std::errc::io_error)};
+            }
+        }
+
+        return open_run(path, keys.size());
+    }
+
+    std::filesystem::path position_index::next_run_path(shard& full_shard,
+                                                        std::size_t shard_index) const {
+        return _spill_directory / ("shard" + std::to_string(shard_index) + "_run" +
+                                   std::to_string(full_shard.runs_written++) + ".keys");
+    }
+
+    std::expected<position_index::spilled_run, std::error_code>
+        position_index::open_run(const std::filesystem::path& path, std::size_t key_count) {
+        std::expected<mapped_file, std::error_code> file {
+            mapped_file::open(path.string(), mapped_file::AccessPattern::Random)};
+
+        if (!file.has_value()) {
+            return std::unexpected {file.error()};
+        }
+
+        if (file->size() != key_count * sizeof(std::uint64_t)) {
+            return std::unexpected {std::make_error_code(std::errc::io_error)};
+        }
+
+        const std::byte* const data {file->bytes().data()};
+
+        return spilled_run {path, std::move(*file),
+                            std::span {reinterpret_cast<const std::uint64_t*>(data), key_count}};
+    }
+} // namespace esochess
@@ -0,0 +1,153 @@
+#include "headers/profiler.hpp"
+
+#ifdef ESOCHESS_PROFILE
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace esochess::profiling {
+    namespace {
+        void add_counters(profile& total, const profile& counters) {
+            for (std::size_t index {}; index < total.size(); index++) {
+                total [index].calls += counters [index].calls;
+                total [index].total_ticks += counters [index].total_ticks;
+                total [index].self_ticks += counters [index].self_ticks;
+            }
+        }
+
+        // Holds the counters of exited threads and writes the profile when the program exits
+        struct profile_registry {
+            profile_registry() = default;
+            profile_registry(const profile_registry& other) = delete;
+
+            ~profile_registry() {
+                write_profile(std::cerr, merged);
+            }
+
+            profile_registry& operator=(const profile_registry& other) = delete;
+
+            std::mutex mutex;
+            profile merged {};
+        };
+
+        profile_registry& registry() {
+            static profile_registry instance {};
+            return instance;
+        }
+
+        struct thread_profile {
+            thread_profile() {
+                static_cast<void>(registry()); // Outlives every thread profile
+            }
+
+            thread_profile(const thread_profile& other) = delete;
+
+            ~thread_profile() {
+                const std::scoped_lock lock {registry().mutex};
+                add_counters(registry().merged, counters);
+            }
+
+            thread_profile& operator=(const thread_profile& other) = delete;
+
+            profile counters {};
+            scoped_timer* innermost_timer {nullptr};
+        };
+
+        thread_local thread_profile this_thread_profile {};
+    } // namespace
+
+    std::uint64_t read_ticks() {
+#if defined(__x86_64__) || defined(__i386__)
+        return __rdtsc();
+#else
+        return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch())
+                .count());
+#endif
+    }
+
+    std::string_view tick_unit() {
+#if defined(__x86_64__) || defined(__i386__)
+        return "cycles";
+#else
+        return "ns";
+#endif
+    }
+
+    profile collect_profile() {
+        const std::scoped_lock lock {registry().mutex};
+        profile total {registry().merged};
+
+        add_counters(total, this_thread_profile.counters);
+
+        return total;
+    }
+
+    void write_profile(std::ostream& output, const profile& counters) {
+        std::uint64_t all_self_ticks {0};
+
+        for (const section_counters& section: counters) {
+            all_self_ticks += section.self_ticks;
+        }
+
+        output << std::left << std::setw(30) << "section" << std::right << std::setw(14)
+               << "calls" << std::setw(18) << "total " + std::string {tick_unit()}
+               << std::setw(18) << "self " + std::string {tick_unit()} << std::setw(12)
+               << "self/call" << std::setw(9) << "self %" << '\n';
+
+        for (std::size_t index {}; index < counters.size(); index++) {
+            const section_counters& section {counters [index]};
+
+            if (section.calls == 0) {
+                continue;
+            }
+
+            output << std::left << std::setw(30) << section_names [index] << std::right
+                   << std::setw(14) << section.calls << std::setw(18) << section.total_ticks
+                   << std::setw(18) << section.self_ticks << std::setw(12)
+                   << section.self_ticks / section.calls << std::setw(8) << std::fixed
+                   << std::setprecision(1)
+                   << (all_self_ticks == 0 ? 0.0
+                                           : 100.0 * static_cast<double>(section.self_ticks) /
+                                                 static_cast<double>(all_self_ticks))
+                   << "%\n";
+        }
+    }
+
+    scoped_timer::scoped_timer(Section section) :
+        _section {section}, _start {read_ticks()}, _child_ticks {0},
+        _parent {this_thread_profile.innermost_timer} {
+        this_thread_profile.innermost_timer = this;
+    }
+
+    scoped_timer::~scoped_timer() {
+        const std::uint64_t elapsed {read_ticks() - _start};
+        section_counters& counters {
+            this_thread_profile.counters [static_cast<std::size_t>(_section)]};
+
+        counters.calls++;
+        counters.total_ticks += elapsed;
+        counters.self_ticks += elapsed - std::min(elapsed, _child_ticks);
+
+        if (_parent != nullptr) {
+            _parent->_child_ticks += elapsed;
+        }
+
+        this_thread_profile.innermost_timer = _parent;
+    }
+} // namespace esochess::profiling
+
+#endif
@@ -0,0 +1,253 @@
+#include <optional>
+#include <string>
+#include <string_view>
+#include <variant>
+
+#include "headers/attacks.hpp"
+#include "headers/bitboard.hpp"
+#include "headers/san.hpp"
+
+namespace esochess {
+    namespace {
+        std::optional<bitboard::PieceType> piece_type_from_san_letter(char letter) {
+            switch (letter) {
+                case 'N': return bitboard::PieceType::Knight;
+                case 'B': return bitboard::PieceType::Bishop;
+                case 'R': return bitboard::PieceType::Rook;
+                case 'Q': return bitboard::PieceType::Queen;
+                case 'K': return bitboard::PieceType::King;
+                default: return std::nullopt;
+            }
+        }
+
+        char san_letter_from_piece_type(bitboard::PieceType piece_type) {
+            switch (piece_type) {
+                case bitboard::PieceType::Knight: return 'N';
+                case bitboard::PieceType::Bishop: return 'B';
+                case bitboard::PieceType::Rook: return 'R';
+                case bitboard::PieceType::Queen: return 'Q';
+                case bitboard::PieceType::King: return 'K';
+                default: return '\0';
+            }
+        }
+
+        bool is_file(char letter) {
+            return letter >= 'a' && letter <= 'h';
+        }
+
+        bool is_rank(char letter) {
+            return letter >= '1' && letter <= '8';
+        }
+
+        struct san_components {
+            bitboard::PieceType piece_type;
+            std::optional<int> start_file;
+            std::optional<int> start_rank;
+            int end_square;
+            std::optional<bitboard::PieceType> promotion_type;
+        };
+
+        std::optional<san_components> parse_san_components(std::string_view san) {
+            san_components components {bitboard::PieceType::Pawn, {}, {}, 0, {}};
+
+            if (san.empty()) {
+                return std::nullopt;
+            }
+
+            if (const std::optional<bitboard::PieceType> piece_type {
+                    piece_type_from_san_letter(san.front())}) {
+                components.piece_type = *piece_type;
+                san.remove_prefix(1);
+            }
+
+            if (san.size() >= 2 && san [san.size() - 2] == '=') {
+                components.promotion_type = piece_type_from_san_letter(san.back());
+
+                if (!components.promotion_type.has_value()) {
+                    return std::nullopt;
+                }
+
+                san.remove_suffix(2);
+            }
+
+            else if (!san.empty() && piece_type_from_san_letter(san.back()).has_value()) {
+                components.promotion_type = piece_type_from_san_letter(san.back()); // `e8Q`
+                san.remove_suffix(1);
+            }
+
+            if (san.size() < 2 || !is_file(san [san.size() - 2]) || !is_rank(san.back())) {
+                return std::nullopt;
+            }
+
+            components.end_square = (san [san.size() - 2] - 'a') + (san.back() - '1') * 8;
+            san.remove_suffix(2);
+
+            for (const char letter: san) {
+                if (is_file(letter)) {
+                    components.start_file = letter - 'a';
+                }
+
+                else if (is_rank(letter)) {
+                    components.start_rank = letter - '1';
+                }
+
+                else if (letter != 'x' && letter != ':' && letter != '-') {
+                    return std::nullopt;
+                }
+            }
+
+            return components;
+        }
+    } // namespace
+
+    std::optional<bitboard::move> move_from_san(bitboard& board, std::string_view san) {
+        while (!san.empty() && (san.back() == '+' || san.back() == '#' || san.back() == '!' ||
+                                san.back() == '?')) {
+            san.remove_suffix(1);
+        }
+
+        const bitboard::moves_listing moves {board.available_moves()};
+
+        if (san == "O-O" || san == "0-0" || san == "O-O-O" || san == "0-0-0") {
+            const bitboard::CastleType castle_type {
+                san.size() == 3 ? bitboard::CastleType::KingSide : bitboard::CastleType::QueenSide};
+
+            for (const bitboard::move_castle& castle_move: moves.castle_moves) {
+                if (castle_move.castle_type == castle_type &&
+                    board.leaves_king_safe(bitboard::move {castle_move})) {
+                    return bitboard::move {castle_move};
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        const std::optional<san_components> components {parse_san_components(san)};
+
+        if (!components.has_value()) {
+            return std::nullopt;
+        }
+
+        const bitboard::bit_representation end_bits {square_bits(components->end_square)};
+        std::optional<bitboard::move> found_move {};
+        int matching_moves {0};
+
+        const auto consider_move {[&](const bitboard::move& candidate_move) {
+            const int start_square {square_index(bitboard::move_start(candidate_move))};
+
+            if (bitboard::move_end(candidate_move) != end_bits ||
+                components->start_file.value_or(start_square % 8) != start_square % 8 ||
+                components->start_rank.value_or(start_square / 8) != start_square / 8 ||
+                !board.leaves_king_safe(candidate_move)) {
+                return;
+            }
+
+            found_move = candidate_move;
+            matching_moves++;
+        }};
+
+        if (components->promotion_type.has_value()) {
+            for (const bitboard::move_promotion& promotion_move: moves.promotion_moves) {
+                if (promotion_move.promotion_type == *components->promotion_type) {
+                    consider_move(bitboard::move {promotion_move});
+                }
+            }
+        }
+
+        else {
+            for (const bitboard::move_normal& normal_move: moves.normal_moves) {
+                if (board.piece_at_square(normal_move.start).piece_type == components->piece_type) {
+                    consider_move(bitboard::move {normal_move});
+                }
+            }
+
+            if (components->piece_type == bitboard::PieceType::Pawn) {
+                for (const bitboard::move_en_passant& en_passant_move: moves.en_passant_moves) {
+                    consider_move(bitboard::move {en_passant_move});
+                }
+            }
+        }
+
+        return matching_moves == 1 ? found_move : std::nullopt;
+    }
+
+    std::string move_to_san(bitboard& board, const bitboard::move& chess_move) {
+        std::string san {};
+
+        if (const auto* castle_move {std::get_if<bitboard::move_castle>(&chess_move)}) {
+            san = castle_move->castle_type == bitboard::CastleType::KingSide ? "O-O" : "O-O-O";
+        }
+
+        else {
+            const bitboard::bit_representation start_bits {bitboard::move_start(chess_move)};
+            const bitboard::bit_representation end_bits {bitboard::move_end(chess_move)};
+            const bitboard::PieceType piece_type {board.piece_at_square(start_bits).piece_type};
+            const bitboard::cordinate start_cordinate {start_bits};
+            const bool is_capture {
+                std::holds_alternative<bitboard::move_en_passant>(chess_move) ||
+                board.color_at_square(end_bits) == bitboard::opposite_turn(board.turn())};
+
+            if (piece_type == bitboard::PieceType::Pawn) {
+                if (is_capture) {
+                    san += static_cast<char>('a' + start_cordinate.pos_x());
+                }
+            }
+
+            else {
+                san += san_letter_from_piece_type(piece_type);
+
+                bool is_ambiguous {false};
+                bool shares_file {false};
+                bool shares_rank {false};
+
+                for (const bitboard::move_normal& other_move: board.legal_moves().normal_moves) {
+                    if (other_move.end != end_bits || other_move.start == start_bits ||
+                        board.piece_at_square(other_move.start).piece_type != piece_type) {
+                        continue;
+                    }
+
+                    const bitboard::cordinate other_start_cordinate {other_move.start};
+
+                    is_ambiguous = true;
+                    shares_file = shares_file ||
+                                  other_start_cordinate.pos_x() == start_cordinate.pos_x();
+                    shares_rank = shares_rank ||
+                                  other_start_cordinate.pos_y() == start_cordinate.pos_y();
+                }
+
+                if (is_ambiguous && (!shares_file || shares_rank)) {
+                    san += static_cast<char>('a' + start_cordinate.pos_x());
+                }
+
+                if (is_ambiguous && shares_file) {
+                    san += static_cast<char>('1' + start_cordinate.pos_y());
+                }
+            }
+
+            if (is_capture) {
+                san += 'x';
+            }
+
+            san += bitboard::cordinate {end_bits}.to_fancy_string();
+
+            if (const auto* promotion_move {std::get_if<bitboard::move_promotion>(&chess_move)}) {
+                san += '=';
+                san += san_letter_from_piece_type(promotion_move->promotion_type);
+            }
+        }
+
+        bitboard board_after_move {board};
+        board_after_move.make_move(chess_move);
+
+        if (board_after_move.is_in_check()) {
+            const bitboard::moves_listing replies {board_after_move.legal_moves()};
+            const bool has_reply {!replies.normal_moves.empty() || !replies.castle_moves.empty() ||
+                                  !replies.en_passant_moves.empty() ||
+                                  !replies.promotion_moves.empty()};
+
+            san += has_reply ? '+' : '#';
+        }
+
+        return san;
+    }
+} // namespace esochess
@@ -0,0 +1,920 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <iomanip>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <optional>
+#include <span>
+#include <sstream>
+#include <stop_token>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "headers/attacks.hpp"
+#include "headers/bitboard.hpp"
+#include "headers/evaluation.hpp"
+#include "headers/move_generation.hpp"
+#include "headers/move_ordering.hpp"
+#include "headers/platform.hpp"
+#include "headers/search.hpp"
+#include "headers/syzygy.hpp"
+
+namespace esochess {
+    static_assert(max_ordering_ply >= max_search_ply);
+
+    namespace {
+        using clock = std::chrono::steady_clock;
+
+        constexpr std::uint64_t time_check_interval {1024}; // Nodes between clock reads
+        constexpr std::chrono::milliseconds move_overhead {30};
+        constexpr std::chrono::milliseconds wait_interval {1}; // Polling while the result is held
+
+        constexpr std::uint64_t generation_bits {6};
+        constexpr std::size_t hashfull_sample_size {1000};
+        constexpr std::size_t parallel_clear_entries {1 << 22}; // 64 MB per clearing thread
+
+        double percentage(std::uint64_t part, std::uint64_t whole) {
+            return whole == 0 ? 0.0
+                              : 100.0 * static_cast<double>(part) / static_cast<double>(whole);
+        }
+
+        bool is_capture(const bitboard& board, const bitboard::move& chess_move) {
+            return std::holds_alternative<bitboard::move_en_passant>(chess_move) ||
+                   board.color_at_square(bitboard::move_end(chess_move)) ==
+                       bitboard::opposite_turn(board.turn());
+        }
+
+        bool is_queen_promotion(const bitboard::move& chess_move) {
+            const auto* const promotion_move {std::get_if<bitboard::move_promotion>(&chess_move)};
+
+            return promotion_move != nullptr &&
+                   promotion_move->promotion_type == bitboard::PieceType::Queen;
+        }
+
+        int piece_value_at(const bitboard& board, bitboard::bit_representation bits) {
+            const std::size_t index {board.piece_at_square(bits).bitboard_index};
+
+            return index == std::string::npos ? 0 : piece_values.at(index % 6);
+        }
+
+        struct ordered_move {
+            bitboard::move chess_move;
+            int score;
+            std::optional<quiet_move> quiet; // Empty for captures and queen promotions
+        };
+
+        // The table move first, then captures by most valuable victim and least valuable
+        // attacker, then queen promotions, then the quiet moves by the ordering tables
+        std::vector<ordered_move> order_moves(const bitboard& board,
+                                              const std::vector<bitboard::move>& moves,
+                                              std::uint16_t table_move,
+                                              const move_ordering_tables& tables,
+                                              const ordering_context& context) {
+            std::vector<ordered_move> ordered_moves {};
+
+            ordered_moves.reserve(moves.size());
+
+            for (const bitboard::move& chess_move: moves) {
+                const std::uint16_t encoded_move {encode_move(chess_move)};
+                const bool capture {is_capture(board, chess_move)};
+                const bool queen_promotion {is_queen_promotion(chess_move)};
+                ordered_move& ordered {
+                    ordered_moves.emplace_back(chess_move, 0, std::nullopt)};
+
+                if (!capture && !queen_promotion) {
+                    ordered.quiet = quiet_move {
+                        encoded_move,
+                        piece_square {
+                            board.piece_at_square(bitboard::move_start(chess_move)).bitboard_index,
+                            square_index(bitboard::move_end(chess_move))}};
+                }
+
+                if (table_move != 0 && encoded_move == table_move) {
+                    ordered.score = 1 << 30;
+                }
+
+                else if (ordered.quiet.has_value()) {
+                    ordered.score = tables.quiet_score(context, *ordered.quiet);
+                }
+
+                else {
+                    const int victim_value {
+                        std::holds_alternative<bitboard::move_en_passant>(chess_move)
+                            ? piece_values.at(0)
+                            : piece_value_at(board, bitboard::move_end(chess_move))};
+
+                    ordered.score = (capture ? (1 << 20) + victim_value * 16 -
+                                                   piece_value_at(board,
+                                                                  bitboard::move_start(chess_move))
+                                             : 0) +
+                                    (queen_promotion ? 1 << 19 : 0);
+                }
+            }
+
+            std::ranges::stable_sort(ordered_moves, std::ranges::greater {}, &ordered_move::score);
+
+            return ordered_moves;
+        }
+
+        // Mate scores are stored relative to the node instead of the root
+        int score_to_table(int score, int ply) {
+            return score > mate_score - max_search_ply    ? score + ply
+                   : score < -mate_score + max_search_ply ? score - ply
+                                                          : score;
+        }
+
+        int score_from_table(int score, int ply) {
+            return score > mate_score - max_search_ply    ? score - ply
+                   : score < -mate_score + max_search_ply ? score + ply
+                                                          : score;
+        }
+
+        int piece_count(const bitboard& board) {
+            return std::popcount(board.bitboard_bitor_accumulation(bitboard::Turn::All));
+        }
+
+        // Mates and tablebase wins, whose bounds pruning must not trade for a static guess
+        bool is_decisive_score(int score) {
+            return std::abs(score) >= tablebase_win_score - max_search_ply;
+        }
+
+        // Null move pruning fails in zugzwang, which is mostly a matter of king and pawn endings
+        bool has_non_pawn_material(const bitboard& board) {
+            const std::size_t first_index {board.turn() == bitboard::Turn::White ? 1U : 7U};
+
+            for (std::size_t index {first_index}; index < first_index + 4; index++) {
+                if (board.bitboards().at(index) != 0) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    } // namespace
+
+    std::uint16_t encode_move(const bitboard::move& chess_move) {
+        const auto* const promotion_move {std::get_if<bitboard::move_promotion>(&chess_move)};
+        const unsigned promotion {
+            promotion_move == nullptr
+                ? 0U
+                : static_cast<unsigned>(promotion_move->promotion_type) -
+                      static_cast<unsigned>(bitboard::PieceType::Pawn)};
+
+        return static_cast<std::uint16_t>(
+            static_cast<unsigned>(square_index(bitboard::move_start(chess_move))) |
+            (static_cast<unsigned>(square_index(bitboard::move_end(chess_move))) << 6U) |
+            (promotion << 12U));
+    }
+
+    search_statistics& search_statistics::operator+=(const search_statistics& other) {
+        nodes += other.nodes;
+        quiescence_nodes += other.quiescence_nodes;
+        table_probes += other.table_probes;
+        table_hits += other.table_hits;
+        table_cutoffs += other.table_cutoffs;
+        beta_cutoffs += other.beta_cutoffs;
+        first_move_cutoffs += other.first_move_cutoffs;
+        generated_moves += other.generated_moves;
+        searched_moves += other.searched_moves;
+        tablebase_hits += other.tablebase_hits;
+        null_move_cutoffs += other.null_move_cutoffs;
+        reverse_futility_cutoffs += other.reverse_futility_cutoffs;
+        futility_pruned_moves += other.futility_pruned_moves;
+        late_move_pruned_moves += other.late_move_pruned_moves;
+        reduced_searches += other.reduced_searches;
+        reduced_re_searches += other.reduced_re_searches;
+
+        return *this;
+    }
+
+    std::string search_statistics::to_string() const {
+        std::ostringstream output {};
+
+        output << std::fixed << std::setprecision(1) << "nodes " << nodes << " quiescence "
+               << quiescence_nodes << " (" << percentage(quiescence_nodes, nodes) << "%)\n"
+               << "table probes " << table_probes << " hits " << table_hits << " ("
+               << percentage(table_hits, table_probes) << "%) cutoffs " << table_cutoffs << '\n'
+               << "beta cutoffs " << beta_cutoffs << " on the first move " << first_move_cutoffs
+               << " (" << percentage(first_move_cutoffs, beta_cutoffs) << "%)\n"
+               << "moves generated " << generated_moves << " searched " << searched_moves << " ("
+               << percentage(searched_moves, generated_moves) << "%)\n"
+               << "tablebase hits " << tablebase_hits << '\n'
+               << "null move cutoffs " << null_move_cutoffs << " reverse futility cutoffs "
+               << reverse_futility_cutoffs << '\n'
+               << "moves pruned by futility " << futility_pruned_moves << " by move count "
+               << late_move_pruned_moves << '\n'
+               << "reduced searches " << reduced_searches << " re-searched " << reduced_re_searches
+               << " (" << percentage(reduced_re_searches, reduced_searches) << "%)";
+
+        return output.str();
+    }
+
+    transposition_table::transposition_table(std::size_t size_in_megabytes, PageSize page_size) :
+        _memory {}, _entries {}, _generation {1} {
+        resize(size_in_megabytes, page_size);
+    }
+
+    std::optional<transposition_table::probe_result>
+        transposition_table::probe(std::uint64_t hash) const {
+        const entry& table_entry {_entries [hash & (_entries.size() - 1)]};
+        const std::uint64_t data {table_entry.data.load(std::memory_order_relaxed)};
+
+        if ((table_entry.checked_key.load(std::memory_order_relaxed) ^ data) != hash) {
+            return std::nullopt;
+        }
+
+        return probe_result {static_cast<std::uint16_t>(data & 0xffffU),
+                             static_cast<int>(static_cast<std::int16_t>((data >> 16U) & 0xffffU)),
+                             static_cast<int>((data >> 32U) & 0xffU),
+                             static_cast<Bound>((data >> 40U) & 0x3U)};
+    }
+
+    void transposition_table::store(std::uint64_t hash, std::uint16_t encoded_move, int score,
+                                    int depth, Bound bound) {
+        entry& table_entry {_entries [hash & (_entries.size() - 1)]};
+        const std::uint64_t data {
+            encoded_move |
+            (static_cast<std::uint64_t>(static_cast<std::uint16_t>(score)) << 16U) |
+            (static_cast<std::uint64_t>(std::clamp(depth, 0, 0xff)) << 32U) |
+            (static_cast<std::uint64_t>(bound) << 40U) | (_generation << 42U)};
+
+        table_entry.checked_key.store(hash ^ data, std::memory_order_relaxed);
+        table_entry.data.store(data, std::memory_order_relaxed);
+    }
+
+    void transposition_table::resize(std::size_t size_in_megabytes, PageSize page_size) {
+        const std::size_t entry_count {std::bit_floor(
+            std::max<std::size_t>(size_in_megabytes * 1024 * 1024 / sizeof(entry), 1))};
+
+        // The old table is kept until the new one is mapped, so a failed resize leaves it usable
+        std::expected<huge_page_memory, std::error_code> memory {
+            huge_page_memory::allocate(entry_count * sizeof(entry), page_size)};
+
+        if (!memory.has_value()) {
+            throw std::bad_alloc {};
+        }
+
+        // Faulting the pages in on every thread also zeroes them on every thread
+        auto* const entries {reinterpret_cast<entry*>(memory->bytes().data())};
+
+        for_each_range_in_parallel(entry_count, parallel_clear_entries,
+                                   [entries](std::size_t begin, std::size_t end) {
+                                       std::uninitialized_value_construct(entries + begin,
+                                                                          entries + end);
+                                   });
+        _entries = std::span {std::launder(entries), entry_count};
+        _memory = std::move(*memory);
+    }
+
+    void transposition_table::clear() {
+        for_each_range_in_parallel(
+            _entries.size(), parallel_clear_entries, [this](std::size_t begin, std::size_t end) {
+                for (entry& table_entry: _entries.subspan(begin, end - begin)) {
+                    table_entry.checked_key.store(0, std::memory_order_relaxed);
+                    table_entry.data.store(0, std::memory_order_relaxed);
+                }
+            });
+    }
+
+    void transposition_table::new_search() {
+        // Skips 0 so that empty entries never count as current
+        _generation = _generation % ((1U << generation_bits) - 1) + 1;
+    }
+
+    std::size_t transposition_table::size() const noexcept {
+        return _entries.size();
+    }
+
+    int transposition_table::hashfull() const {
+        const std::size_t sample_size {std::min(_entries.size(), hashfull_sample_size)};
+        std::size_t current_entries {0};
+
+        for (std::size_t index {}; index < sample_size; index++) {
+            const std::uint64_t data {_entries [index].data.load(std::memory_order_relaxed)};
+
+            current_entries += (data >> 42U) == _generation ? 1 : 0;
+        }
+
+        return static_cast<int>(current_entries * 1000 / sample_size);
+    }
+
+    bool transposition_table::advised_huge_pages() const noexcept {
+        return _memory.advised_huge_pages();
+    }
+
+    struct search_engine::search_state {
+        search_limits limits;
+        std::stop_token stop_token;
+        clock::time_point start;
+        std::optional<clock::time_point> deadline;
+        std::optional<clock::time_point> soft_deadline; // No new iteration is started after it
+        const std::atomic<bool>& ponder_hit;
+        bool pondering;
+
+        search_statistics statistics;
+        int selective_depth;
+        bool stopped;
+
+        std::vector<std::uint64_t> position_hashes; // The game and the current search path
+        std::vector<bitboard::move> root_moves;
+        std::array<std::optional<piece_square>, max_search_ply + 1> moves_made; // By ply
+        std::optional<int> null_move_ply; // Of the innermost null move on the current path
+
+        [[nodiscard]] ordering_context ordering_context_at(int ply, bitboard::Turn turn) const {
+            const auto move_made_at {[this](int previous_ply) {
+                return previous_ply < 0 ? std::nullopt
+                                        : moves_made.at(static_cast<std::size_t>(previous_ply));
+            }};
+
+            return ordering_context {ply, turn, move_made_at(ply - 1), move_made_at(ply - 2)};
+        }
+
+        void start_clock(clock::time_point now) {
+            if (limits.move_time.has_value()) {
+                deadline = now + *limits.move_time;
+            }
+
+            else if (limits.time_left.has_value()) {
+                const std::chrono::milliseconds usable_time {
+                    std::max(*limits.time_left - move_overhead, std::chrono::milliseconds {1})};
+                const std::chrono::milliseconds budget {
+                    std::min(usable_time / std::max(limits.moves_to_go.value_or(30), 1) +
+                                 limits.increment * 3 / 4,
+                             usable_time / 2)};
+
+                deadline = now + budget;
+                soft_deadline = now + budget / 2; // A deeper iteration would rarely finish in time
+            }
+        }
+
+        void check_ponder_hit() {
+            if (pondering && ponder_hit.load(std::memory_order_acquire)) {
+                pondering = false;
+                start_clock(clock::now());
+            }
+        }
+
+        // Counts the node and reports whether the search has to unwind
+        bool visit_node(int ply) {
+            const std::uint64_t nodes {++statistics.nodes};
+            selective_depth = std::max(selective_depth, ply);
+
+            if (nodes % time_check_interval == 0) {
+                check_ponder_hit();
+            }
+
+            if (!stopped && ((limits.nodes.has_value() && nodes >= *limits.nodes) ||
+                             (nodes % time_check_interval == 0 &&
+                              (stop_token.stop_requested() ||
+                               (deadline.has_value() && clock::now() >= *deadline))))) {
+                stopped = true;
+            }
+
+            return stopped;
+        }
+
+        // Positions before a null move are not looked at, as passing is not a legal move
+        [[nodiscard]] bool is_repetition(std::uint64_t hash, int halfmove_clock, int ply) const {
+            const std::size_t size {position_hashes.size()};
+            const int reach {null_move_ply.has_value()
+                                 ? std::min(halfmove_clock, ply - *null_move_ply)
+                                 : halfmove_clock};
+
+            for (std::size_t distance {2};
+                 distance <= std::min(size, static_cast<std::size_t>(reach)); distance += 2) {
+                if (position_hashes.at(size - distance) == hash) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+    };
+
+    search_engine::search_engine(std::size_t hash_megabytes) :
+        _table {hash_megabytes}, _ordering {}, _tablebases {nullptr}, _parameters {},
+        _reductions {}, _ponder_hit {false} {
+        set_parameters(_parameters);
+    }
+
+    void search_engine::set_hash_size(std::size_t size_in_megabytes,
+                                      transposition_table::PageSize page_size) {
+        _table.resize(size_in_megabytes, page_size);
+    }
+
+    void search_engine::set_tablebases(const syzygy_tablebases* tablebases) {
+        _tablebases = tablebases;
+    }
+
+    void search_engine::set_parameters(const search_parameters& parameters) {
+        _parameters = parameters;
+
+        for (std::size_t depth {1}; depth < _reductions.size(); depth++) {
+            for (std::size_t move_number {1}; move_number < _reductions.at(depth).size();
+                 move_number++) {
+                _reductions.at(depth).at(move_number) =
+                    _parameters.reduction_base +
+                    static_cast<int>(10000.0 * std::log(static_cast<double>(depth)) *
+                                     std::log(static_cast<double>(move_number)) /
+                                     std::max(_parameters.reduction_divisor, 1));
+            }
+        }
+    }
+
+    const search_parameters& search_engine::parameters() const noexcept {
+        return _parameters;
+    }
+
+    void search_engine::clear() {
+        _table.clear();
+        _ordering.clear();
+    }
+
+    void search_engine::ponder_hit() {
+        _ponder_hit.store(true, std::memory_order_release);
+    }
+
+    search_result search_engine::search(const bitboard& root,
+                                        std::span<const std::uint64_t> history,
+                                        const search_limits& limits, const report_function& report,
+                                        std::stop_token stop_token) {
+        search_state state {limits,
+                            std::move(stop_token),
+                            clock::now(),
+                            std::nullopt,
+                            std::nullopt,
+                            _ponder_hit,
+                            limits.ponder,
+                            {},
+                            0,
+                            false,
+                            {history.begin(), history.end()},
+                            root.all_legal_moves(),
+                            {},
+                            std::nullopt};
+
+        _table.new_search();
+        _ordering.clear_killers();
+
+        if (!state.pondering) {
+            state.start_clock(state.start);
+        }
+
+        if (_tablebases != nullptr && piece_count(root) <= _tablebases->max_pieces()) {
+            if (std::optional<std::vector<bitboard::move>> tablebase_moves {
+                    _tablebases->root_moves(root)};
+                tablebase_moves.has_value() && !tablebase_moves->empty()) {
+                state.root_moves = std::move(*tablebase_moves);
+            }
+        }
+
+        search_result result {state.root_moves.empty()
+                                  ? std::nullopt
+                                  : std::optional<bitboard::move> {state.root_moves.front()},
+                              std::nullopt, 0, 0, {}, {}};
+
+        if (state.root_moves.empty()) {
+            return result;
+        }
+
+        const int max_depth {std::clamp(limits.depth.value_or(max_search_ply - 1), 1,
+                                        max_search_ply - 1)};
+
+        const std::vector<bitboard::move> all_root_moves {state.root_moves};
+        const std::size_t line_count {
+            std::clamp<std::size_t>(limits.multi_pv, 1, all_root_moves.size())};
+
+        for (int depth {1}; depth <= max_depth; depth++) {
+            std::vector<search_line> lines {};
+
+            // Every further line leaves out the first moves of the lines found before it, while
+            // the transposition table carries what they learnt
+            for (std::size_t line_index {}; line_index < line_count; line_index++) {
+                search_line line {};
+
+                state.root_moves.clear();
+                std::ranges::copy_if(all_root_moves, std::back_inserter(state.root_moves),
+                                     [&lines](const bitboard::move& chess_move) {
+                                         return std::ranges::none_of(
+                                             lines, [&chess_move](const search_line& found) {
+                                                 return encode_move(
+                                                            found.principal_variation.front()) ==
+                                                        encode_move(chess_move);
+                                             });
+                                     });
+
+                line.score = negamax(state, root, -infinite_score, infinite_score, depth, 0,
+                                     line.principal_variation);
+
+                // An interrupted line is only trusted for the moves it finished searching
+                if (line.principal_variation.empty()) {
+                    break;
+                }
+
+                lines.push_back(std::move(line));
+
+                if (state.stopped) {
+                    break;
+                }
+            }
+
+            if (lines.empty()) {
+                break;
+            }
+
+            std::ranges::stable_sort(lines, std::ranges::greater {}, &search_line::score);
+
+            const std::vector<bitboard::move>& principal_variation {
+                lines.front().principal_variation};
+
+            result.best_move = principal_variation.front();
+            result.ponder_move = principal_variation.size() > 1
+                                     ? std::optional<bitboard::move> {principal_variation.at(1)}
+                                     : std::nullopt;
+            result.score = lines.front().score;
+            result.depth = depth;
+
+            if (state.stopped) {
+                break;
+            }
+
+            result.lines = lines;
+
+            const clock::duration elapsed {clock::now() - state.start};
+
+            for (std::size_t line_index {}; report && line_index < lines.size(); line_index++) {
+                report(search_iteration {
+                    depth, line_index + 1, state.selective_depth, lines.at(line_index).score,
+                    _table.hashfull(),
+                    std::chrono::duration_cast<std::chrono::milliseconds>(elapsed),
+                    state.statistics, lines.at(line_index).principal_variation});
+            }
+
+            state.check_ponder_hit();
+
+            if (state.soft_deadline.has_value() && clock::now() >= *state.soft_deadline) {
+                break;
+            }
+        }
+
+        // The GUI expects no result from an infinite or ponder search before it says so
+        while ((limits.infinite || state.pondering) && !state.stop_token.stop_requested()) {
+            std::this_thread::sleep_for(wait_interval);
+            state.check_ponder_hit();
+        }
+
+        _ponder_hit.store(false, std::memory_order_relaxed);
+        result.statistics = state.statistics;
+
+        return result;
+    }
+
+    int search_engine::negamax(search_state& state, const bitboard& board, int alpha, int beta,
+                               int depth, int ply,
+                               std::vector<bitboard::move>& principal_variation) {
+        principal_variation.clear();
+
+        const bool in_check {board.is_in_check()};
+
+        if (depth <= 0 && !in_check) {
+            return quiescence(state, board, alpha, beta, ply, true);
+        }
+
+        if (state.visit_node(ply)) {
+            return 0;
+        }
+
+        const std::uint64_t hash {board.hash()};
+
+        if (ply > 0) {
+            if (board.halfmove_clock() >= 100 ||
+                state.is_repetition(hash, board.halfmove_clock(), ply)) {
+                return 0;
+            }
+
+            if (ply >= max_search_ply - 1) {
+                return evaluate(board);
+            }
+        }
+
+        const std::optional<transposition_table::probe_result> table_entry {_table.probe(hash)};
+
+        state.statistics.table_probes++;
+        state.statistics.table_hits += table_entry.has_value() ? 1 : 0;
+
+        if (ply > 0 && table_entry.has_value() && table_entry->depth >= depth) {
+            const int table_score {score_from_table(table_entry->score, ply)};
+
+            if (table_entry->bound == transposition_table::Bound::Exact ||
+                (table_entry->bound == transposition_table::Bound::Lower && table_score >= beta) ||
+                (table_entry->bound == transposition_table::Bound::Upper &&
+                 table_score <= alpha)) {
+                state.statistics.table_cutoffs++;
+                return table_score;
+            }
+        }
+
+        if (ply > 0) {
+            if (const std::optional<int> tablebase_score {probe_tablebases(board, ply)}) {
+                state.statistics.tablebase_hits++;
+                _table.store(hash, 0, score_to_table(*tablebase_score, ply), max_search_ply - 1,
+                             transposition_table::Bound::Exact);
+                return *tablebase_score;
+            }
+        }
+
+        const bool is_pv_node {beta - alpha > 1};
+        const bool can_prune {ply > 0 && !is_pv_node && !in_check};
+        const int static_score {can_prune ? evaluate(board) : 0};
+
+        if (can_prune && depth <= _parameters.reverse_futility_max_depth &&
+            !is_decisive_score(beta) &&
+            static_score - _parameters.reverse_futility_margin * depth >= beta) {
+            state.statistics.reverse_futility_cutoffs++;
+            return static_score;
+        }
+
+        if (can_prune && depth >= _parameters.null_move_min_depth && static_score >= beta &&
+            !is_decisive_score(beta) && state.null_move_ply != ply - 1 &&
+            has_non_pawn_material(board)) {
+            const int reduced_depth {depth - 1 - _parameters.null_move_base_reduction -
+                                     depth / std::max(_parameters.null_move_depth_divisor, 1)};
+            const std::optional<int> outer_null_move_ply {state.null_move_ply};
+            bitboard child {board.position_copy()};
+            std::vector<bitboard::move> child_variation {};
+
+            static_cast<void>(child.make_null_move());
+            state.moves_made.at(static_cast<std::size_t>(ply)) = std::nullopt;
+            state.null_move_ply = ply;
+            state.position_hashes.push_back(hash);
+
+            const int score {
+                -negamax(state, child, -beta, -beta + 1, reduced_depth, ply + 1, child_variation)};
+
+            state.position_hashes.pop_back();
+            state.null_move_ply = outer_null_move_ply;
+
+            if (state.stopped) {
+                return 0;
+            }
+
+            if (score >= beta) {
+                state.statistics.null_move_cutoffs++;
+                return is_decisive_score(score) ? beta : score;
+            }
+        }
+
+        std::vector<bitboard::move> moves {ply == 0 ? state.root_moves : board.all_legal_moves()};
+
+        state.statistics.generated_moves += moves.size();
+
+        if (moves.empty()) {
+            return in_check ? -mate_score + ply : 0;
+        }
+
+        const ordering_context context {state.ordering_context_at(ply, board.turn())};
+        const std::vector<ordered_move> ordered_moves {
+            order_moves(board, moves, table_entry.has_value() ? table_entry->encoded_move : 0,
+                        _ordering, context)};
+
+        const int extended_depth {in_check ? std::max(depth, 0) + 1 : depth};
+        const int original_alpha {alpha};
+        int best_score {-infinite_score};
+        std::uint16_t best_move {0};
+        std::vector<bitboard::move> child_variation {};
+        std::vector<quiet_move> failed_quiet_moves {};
+
+        state.position_hashes.push_back(hash);
+
+        for (std::size_t index {}; index < ordered_moves.size(); index++) {
+            const bitboard::move& chess_move {ordered_moves.at(index).chess_move};
+            const std::optional<quiet_move>& quiet {ordered_moves.at(index).quiet};
+            const bitboard child {board.after_move(chess_move)};
+            const bool late_quiet_move {quiet.has_value() && index > 0 &&
+                                        !is_decisive_score(best_score)};
+            const bool gives_check {late_quiet_move && child.is_in_check()};
+            int score {};
+
+            if (can_prune && late_quiet_move && !gives_check) {
+                if (depth <= _parameters.late_move_pruning_max_depth &&
+                    index >= static_cast<std::size_t>(
+                                 std::max(_parameters.late_move_pruning_base + depth * depth, 1))) {
+                    state.statistics.late_move_pruned_moves++;
+                    continue;
+                }
+
+                if (depth <= _parameters.futility_max_depth &&
+                    static_score + _parameters.futility_base_margin +
+                            _parameters.futility_depth_margin * depth <=
+                        alpha) {
+                    state.statistics.futility_pruned_moves++;
+                    continue;
+                }
+            }
+
+            state.statistics.searched_moves++;
+            state.moves_made.at(static_cast<std::size_t>(ply)) =
+                quiet.has_value() ? quiet->moved
+                                  : piece_square {board.piece_at_square(
+                                                                 bitboard::move_start(chess_move))
+                                                      .bitboard_index,
+                                                  square_index(bitboard::move_end(chess_move))};
+
+            if (index == 0) {
+                score = -negamax(state, child, -beta, -alpha, extended_depth - 1, ply + 1,
+                                 child_variation);
+            }
+
+            else {
+                const int reduced_by {
+                    late_quiet_move && !in_check && !gives_check &&
+                            depth >= _parameters.reduction_min_depth &&
+                            index >= static_cast<std::size_t>(_parameters.reduction_min_moves)
+                        ? reduction(depth, index + 1, is_pv_node)
+                        : 0};
+
+                if (reduced_by > 0) {
+                    state.statistics.reduced_searches++;
+                    score = -negamax(state, child, -alpha - 1, -alpha,
+                                     extended_depth - 1 - reduced_by, ply + 1, child_variation);
+                }
+
+                if (reduced_by == 0 || score > alpha) {
+                    state.statistics.reduced_re_searches += reduced_by > 0 ? 1 : 0;
+                    score = -negamax(state, child, -alpha - 1, -alpha, extended_depth - 1,
+                                     ply + 1, child_variation);
+                }
+
+                if (score > alpha && score < beta) {
+                    score = -negamax(state, child, -beta, -alpha, extended_depth - 1, ply + 1,
+                                     child_variation);
+                }
+            }
+
+            if (state.stopped) {
+                break;
+            }
+
+            if (score > best_score) {
+                best_score = score;
+                best_move = encode_move(chess_move);
+
+                if (score > alpha) {
+                    alpha = score;
+
+                    principal_variation.clear();
+                    principal_variation.push_back(chess_move);
+                    principal_variation.insert(principal_variation.end(), child_variation.begin(),
+                                               child_variation.end());
+                }
+
+                if (alpha >= beta) {
+                    state.statistics.beta_cutoffs++;
+                    state.statistics.first_move_cutoffs += index == 0 ? 1 : 0;
+
+                    if (quiet.has_value()) {
+                        _ordering.update(context, *quiet, failed_quiet_moves, extended_depth);
+                    }
+
+                    break;
+                }
+            }
+
+            if (quiet.has_value()) {
+                failed_quiet_moves.push_back(*quiet);
+            }
+        }
+
+        state.position_hashes.pop_back();
+
+        if (state.stopped) {
+            return best_score == -infinite_score ? 0 : best_score;
+        }
+
+        using Bound = transposition_table::Bound;
+
+        const Bound bound {best_score >= beta             ? Bound::Lower
+                           : best_score > original_alpha ? Bound::Exact
+                                                         : Bound::Upper};
+
+        _table.store(hash, best_move, score_to_table(best_score, ply), extended_depth, bound);
+
+        return best_score;
+    }
+
+    int search_engine::reduction(int depth, std::size_t move_number, bool is_pv_node) const {
+        const std::size_t last_index {_reductions.size() - 1};
+        const int hundredths {
+            _reductions.at(std::min(static_cast<std::size_t>(depth), last_index))
+                .at(std::min(move_number, last_index))};
+
+        return std::max(hundredths / 100 - (is_pv_node ? 1 : 0), 0);
+    }
+
+    int search_engine::quiescence(search_state& state, const bitboard& board, int alpha, int beta,
+                                  int ply, bool include_checks) {
+        if (state.visit_node(ply)) {
+            return 0;
+        }
+
+        state.statistics.quiescence_nodes++;
+
+        // The side in check may not stand pat and answers with every evasion
+        const bool in_check {board.is_in_check()};
+        const int static_score {in_check ? -mate_score + ply : evaluate(board)};
+
+        if (static_score >= beta || ply >= max_search_ply - 1) {
+            return in_check ? evaluate(board) : static_score;
+        }
+
+        alpha = std::max(alpha, static_score);
+
+        std::vector<bitboard::move> moves {board.all_legal_moves()};
+
+        state.statistics.generated_moves += moves.size();
+
+        if (!in_check) {
+            std::erase_if(moves, [&board](const bitboard::move& chess_move) {
+                return !is_capture(board, chess_move) && !is_queen_promotion(chess_move);
+            });
+        }
+
+        if (!in_check && include_checks) {
+            bitboard::moves_listing checks {};
+
+            add_quiet_check_moves(board, checks);
+            state.statistics.generated_moves += checks.normal_moves.size();
+
+            for (const bitboard::move_normal& check: checks.normal_moves) {
+                if (board.is_legal(check)) {
+                    moves.emplace_back(check);
+                }
+            }
+        }
+
+        int best_score {static_score};
+
+        const std::vector<ordered_move> ordered_moves {
+            order_moves(board, moves, 0, _ordering, state.ordering_context_at(ply, board.turn()))};
+
+        for (const ordered_move& ordered: ordered_moves) {
+            state.statistics.searched_moves++;
+
+            const int score {-quiescence(state, board.after_move(ordered.chess_move), -beta,
+                                         -alpha, ply + 1, false)};
+
+            if (state.stopped) {
+                return 0;
+            }
+
+            if (score > best_score) {
+                best_score = score;
+                alpha = std::max(alpha, score);
+
+                if (alpha >= beta) {
+                    break;
+                }
+            }
+        }
+
+        return best_score;
+    }
+
+    std::optional<int> search_engine::probe_tablebases(const bitboard& board, int ply) const {
+        const bitboard::castle_rights_collection castle_rights {board.castle_rights()};
+
+        // The WDL tables only agree with the fifty move rule straight after a zeroing move
+        if (_tablebases == nullptr || board.halfmove_clock() != 0 ||
+            piece_count(board) > _tablebases->max_pieces() || castle_rights.white_king_side ||
+            castle_rights.white_queen_side || castle_rights.black_king_side ||
+            castle_rights.black_queen_side) {
+            return std::nullopt;
+        }
+
+        const std::optional<WdlScore> wdl {_tablebases->probe_wdl(board)};
+
+        if (!wdl.has_value()) {
+            return std::nullopt;
+        }
+
+        switch (*wdl) {
+            case WdlScore::Win: return tablebase_win_score - ply;
+            case WdlScore::Loss: return -tablebase_win_score + ply;
+            case WdlScore::CursedWin: return 1;
+            case WdlScore::BlessedLoss: return -1;
+            default: return 0;
+        }
+    }
+} // namespace esochess
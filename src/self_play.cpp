@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <limits>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <stop_token>
+#include <thread>
+#include <variant>
+#include <vector>
+
+#include "headers/bitboard.hpp"
+#include "headers/packed_position.hpp"
+#include "headers/pgn.hpp"
+#include "headers/search.hpp"
+#include "headers/self_play.hpp"
+
+namespace esochess {
+    namespace {
+        struct played_game {
+            std::vector<packed_position> positions;
+            GameResult result;
+            bool finished; // False when stopped halfway
+            bool adjudicated;
+            std::uint64_t nodes;
+        };
+
+        // Bare kings, or a single knight or bishop against a bare king
+        bool is_insufficient_material(const bitboard& board) {
+            const std::array<bitboard::bit_representation, 12> bitboards {board.bitboards()};
+            const auto bits_of {[&bitboards](const bitboard::piece& white_piece) {
+                return bitboards.at(white_piece.bitboard_index) |
+                       bitboards.at(white_piece.bitboard_index + 6);
+            }};
+
+            return (bits_of(bitboard::pieces::white_pawn) | bits_of(bitboard::pieces::white_rook) |
+                    bits_of(bitboard::pieces::white_queen)) == 0 &&
+                   std::popcount(bits_of(bitboard::pieces::white_knight) |
+                                 bits_of(bitboard::pieces::white_bishop)) <= 1;
+        }
+
+        bool is_quiet(const bitboard& board, const bitboard::move& chess_move) {
+            return !std::holds_alternative<bitboard::move_en_passant>(chess_move) &&
+                   !std::holds_alternative<bitboard::move_promotion>(chess_move) &&
+                   board.color_at_square(bitboard::move_end(chess_move)) ==
+                       bitboard::Turn::None;
+        }
+
+        played_game play_game(search_engine& engine, const self_play_options& options,
+                              std::uint64_t game_number, const std::stop_token& stop_token) {
+            std::mt19937_64 random_engine {options.seed + game_number};
+            bitboard board {bitboard::from_fen(bitboard::starting_position_fen).value()};
+            std::vector<std::uint64_t> history {};
+            played_game game {{}, GameResult::Unknown, false, false, 0};
+            search_limits limits {};
+
+            int white_ahead_plies {0};
+            int black_ahead_plies {0};
+            int drawn_plies {0};
+
+            limits.nodes = options.nodes;
+            engine.clear();
+
+            for (int ply {}; !stop_token.stop_requested(); ply++) {
+                const std::vector<bitboard::move> moves {board.all_legal_moves()};
+                const bool white_to_move {board.turn() == bitboard::Turn::White};
+
+                if (moves.empty()) {
+                    game.result = !board.is_in_check() ? GameResult::Draw
+                                  : white_to_move      ? GameResult::BlackWin
+                                                       : GameResult::WhiteWin;
+                    game.finished = true;
+                    break;
+                }
+
+                if (ply >= options.max_plies || board.halfmove_clock() >= 100 ||
+                    std::ranges::count(history, board.hash()) >= 2 ||
+                    is_insufficient_material(board)) {
+                    game.result = GameResult::Draw;
+                    game.finished = true;
+                    break;
+                }
+
+                bitboard::move chess_move {moves.front()};
+
+                if (ply < options.random_plies) {
+                    chess_move = moves.at(random_engine() % moves.size());
+                }
+
+                else {
+                    const search_result result {engine.search(board, history, limits)};
+                    const int white_score {white_to_move ? result.score : -result.score};
+
+                    game.nodes += result.statistics.nodes;
+                    chess_move = result.best_move.value_or(chess_move);
+
+                    if (!board.is_in_check() && is_quiet(board, chess_move)) {
+                        if (std::optional<packed_position> position {
+                                packed_position::from_bitboard(board)}) {
+                            position->score = static_cast<std::int16_t>(std::clamp<int>(
+                                result.score, std::numeric_limits<std::int16_t>::min(),
+                                std::numeric_limits<std::int16_t>::max()));
+                            game.positions.push_back(*position);
+                        }
+                    }
+
+                    white_ahead_plies = white_score >= options.resign_score ? white_ahead_plies + 1
+                                                                            : 0;
+                    black_ahead_plies = -white_score >= options.resign_score ? black_ahead_plies + 1
+                                                                             : 0;
+                    drawn_plies = ply >= options.draw_min_ply &&
+                                          std::abs(result.score) <= options.draw_score
+                                      ? drawn_plies + 1
+                                      : 0;
+
+                    if (options.resign_plies > 0 && (white_ahead_plies >= options.resign_plies ||
+                                                     black_ahead_plies >= options.resign_plies)) {
+                        game.result = white_ahead_plies >= options.resign_plies
+                                          ? GameResult::WhiteWin
+                                          : GameResult::BlackWin;
+                        game.finished = true;
+                        game.adjudicated = true;
+                        break;
+                    }
+
+                    if (options.draw_plies > 0 && drawn_plies >= options.draw_plies) {
+                        game.result = GameResult::Draw;
+                        game.finished = true;
+                        game.adjudicated = true;
+                        break;
+                    }
+                }
+
+                history.push_back(board.hash());
+                board = board.position_copy();
+                board.make_move(chess_move);
+            }
+
+            for (packed_position& position: game.positions) {
+                position.set_result(game.result);
+            }
+
+            return game;
+        }
+    } // namespace
+
+    self_play_statistics run_self_play(const self_play_options& options,
+                                       position_dataset_writer& writer,
+                                       const self_play_progress& progress,
+                                       std::stop_token stop_token) {
+        const std::size_t worker_count {std::max<std::size_t>(options.thread_count, 1)};
+
+        std::mutex mutex {};
+        std::atomic<std::uint64_t> next_game {0};
+        self_play_statistics statistics {0, 0, 0, 0, 0, 0, 0};
+
+        {
+            std::vector<std::jthread> workers;
+
+            for (std::size_t worker {}; worker < worker_count; worker++) {
+                workers.emplace_back([&]() {
+                    search_engine engine {options.hash_megabytes};
+
+                    // Every game draws its own random opening from the seed and its number, so
+                    // the games do not depend on which thread plays them
+                    for (std::uint64_t game_number {next_game++};
+                         game_number < options.games && !stop_token.stop_requested();
+                         game_number = next_game++) {
+                        const played_game game {
+                            play_game(engine, options, game_number, stop_token)};
+
+                        if (!game.finished) {
+                            break;
+                        }
+
+                        const std::lock_guard<std::mutex> lock {mutex};
+
+                        for (const packed_position& position: game.positions) {
+                            statistics.positions += writer.write(position) ? 1 : 0;
+                        }
+
+                        statistics.games++;
+                        statistics.white_wins += game.result == GameResult::WhiteWin ? 1 : 0;
+                        statistics.black_wins += game.result == GameResult::BlackWin ? 1 : 0;
+                        statistics.draws += game.result == GameResult::Draw ? 1 : 0;
+                        statistics.adjudicated += game.adjudicated ? 1 : 0;
+                        statistics.nodes += game.nodes;
+
+                        if (progress) {
+                            progress(statistics);
+                        }
+                    }
+                });
+            }
+        }
+
+        return statistics;
+    }
+} // namespace esochess
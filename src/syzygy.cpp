@@ -0,0 +1,1307 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "headers/attacks.hpp"
+#include "headers/bitboard.hpp"
+#include "headers/mapped_file.hpp"
+#include "headers/syzygy.hpp"
+
+// The table layout and index encoding follow the reference probing code by Ronald de Man. Squares
+// and pieces use the same numbering as the tables: a1 is 0, white pieces are 1 to 6 from pawn to
+// king and black pieces are the same plus 8.
+
+namespace esochess {
+    namespace {
+        constexpr int max_table_pieces {7};
+
+        constexpr std::array<std::uint8_t, 4> wdl_magic {0x71, 0xe8, 0x23, 0x5d};
+        constexpr std::array<std::uint8_t, 4> dtz_magic {0xd7, 0x66, 0x0c, 0xa5};
+
+        enum TableFlag : std::uint8_t {
+            SideToMove = 1,
+            Mapped = 2,
+            WinPlies = 4,
+            LossPlies = 8,
+            Wide = 16,
+            SingleValue = 128
+        };
+
+        // Rank minus file, zero on the a1-h8 diagonal and negative below it
+        constexpr int off_diagonal(int square) {
+            return square / 8 - square % 8;
+        }
+
+        constexpr int flip_file(int square) {
+            return square ^ 7;
+        }
+
+        struct encoding_tables {
+            std::array<int, 64> map_pawns;
+            std::array<int, 64> map_b1h1h7;
+            std::array<int, 64> map_a1d1d4;
+            std::array<std::array<int, 64>, 10> map_kk;
+            std::array<std::array<std::uint64_t, 64>, 6> binomial;
+            std::array<std::array<std::uint64_t, 64>, 6> lead_pawn_index;
+            std::array<std::array<std::uint64_t, 4>, 6> lead_pawns_size;
+        };
+
+        constexpr encoding_tables encoding {[]() {
+            encoding_tables tables {};
+
+            int code {0};
+
+            for (int square {}; square < 64; square++) { // b1-h1-h7 triangle to 0..27
+                if (off_diagonal(square) < 0) {
+                    tables.map_b1h1h7.at(static_cast<std::size_t>(square)) = code++;
+                }
+            }
+
+            code = 0;
+
+            for (int square {}; square <= 27; square++) { // a1-d1-d4 triangle to 0..9
+                if (off_diagonal(square) < 0 && square % 8 <= 3) {
+                    tables.map_a1d1d4.at(static_cast<std::size_t>(square)) = code++;
+                }
+            }
+
+            for (int square {}; square <= 27; square++) { // The diagonal is encoded last
+                if (off_diagonal(square) == 0 && square % 8 <= 3) {
+                    tables.map_a1d1d4.at(static_cast<std::size_t>(square)) = code++;
+                }
+            }
+
+            // The 462 placements of two kings with the first one in the a1-d1-d4 triangle, where
+            // placements with both kings on the diagonal come last
+            std::array<std::pair<int, int>, 64> both_on_diagonal {};
+            std::size_t both_on_diagonal_count {0};
+            code = 0;
+
+            for (int index {}; index < 10; index++) {
+                for (int first {}; first <= 27; first++) {
+                    if (tables.map_a1d1d4.at(static_cast<std::size_t>(first)) != index ||
+                        (index == 0 && first != 1)) { // b1 is mapped to 0
+                        continue;
+                    }
+
+                    for (int second {}; second < 64; second++) {
+                        if (((king_attacks(first) | square_bits(first)) & square_bits(second)) !=
+                                0 ||
+                            (off_diagonal(first) == 0 && off_diagonal(second) > 0)) {
+                            continue;
+                        }
+
+                        if (off_diagonal(first) == 0 && off_diagonal(second) == 0) {
+                            both_on_diagonal.at(both_on_diagonal_count++) = {index, second};
+                        }
+
+                        else {
+                            tables.map_kk.at(static_cast<std::size_t>(index))
+                                .at(static_cast<std::size_t>(second)) = code++;
+                        }
+                    }
+                }
+            }
+
+            for (std::size_t index {}; index < both_on_diagonal_count; index++) {
+                const auto& [first_index, second] {both_on_diagonal.at(index)};
+                tables.map_kk.at(static_cast<std::size_t>(first_index))
+                    .at(static_cast<std::size_t>(second)) = code++;
+            }
+
+            tables.binomial.at(0).at(0) = 1;
+
+            for (std::size_t squares {1}; squares < 64; squares++) {
+                for (std::size_t pieces {}; pieces < 6 && pieces <= squares; pieces++) {
+                    tables.binomial.at(pieces).at(squares) =
+                        (pieces > 0 ? tables.binomial.at(pieces - 1).at(squares - 1) : 0) +
+                        (pieces < squares ? tables.binomial.at(pieces).at(squares - 1) : 0);
+                }
+            }
+
+            // Pawns toward the a file and the second rank map highest, so the leading pawn is
+            // the one with the largest value
+            int available_squares {47};
+
+            for (std::size_t lead_pawn_count {1}; lead_pawn_count <= 5; lead_pawn_count++) {
+                for (int file {}; file <= 3; file++) {
+                    std::uint64_t index {0};
+
+                    for (int rank {1}; rank <= 6; rank++) {
+                        const auto square {static_cast<std::size_t>(file + rank * 8)};
+
+                        if (lead_pawn_count == 1) {
+                            tables.map_pawns.at(square) = available_squares--;
+                            tables.map_pawns.at(static_cast<std::size_t>(flip_file(
+                                static_cast<int>(square)))) = available_squares--;
+                        }
+
+                        tables.lead_pawn_index.at(lead_pawn_count).at(square) = index;
+                        index += tables.binomial.at(lead_pawn_count - 1)
+                                     .at(static_cast<std::size_t>(tables.map_pawns.at(square)));
+                    }
+
+                    tables.lead_pawns_size.at(lead_pawn_count).at(static_cast<std::size_t>(file)) =
+                        index;
+                }
+            }
+
+            return tables;
+        }()};
+
+        template <typename T>
+        T read_little_endian(const std::uint8_t* bytes) {
+            T value {0};
+
+            for (std::size_t index {sizeof(T)}; index > 0; index--) {
+                value = static_cast<T>((value << 8U) | bytes [index - 1]);
+            }
+
+            return value;
+        }
+
+        template <typename T>
+        T read_big_endian(const std::uint8_t* bytes) {
+            T value {0};
+
+            for (std::size_t index {}; index < sizeof(T); index++) {
+                value = static_cast<T>((value << 8U) | bytes [index]);
+            }
+
+            return value;
+        }
+
+        // Material as a count per bitboard index, four bits each
+        std::uint64_t material_key(const std::array<bitboard::bit_representation, 12>& bitboards) {
+            std::uint64_t key {0};
+
+            for (std::size_t index {}; index < bitboards.size(); index++) {
+                key |= static_cast<std::uint64_t>(std::popcount(bitboards.at(index)))
+                       << (4 * index);
+            }
+
+            return key;
+        }
+
+        std::uint64_t with_colors_swapped(std::uint64_t key) {
+            return ((key & 0xff'ffffU) << 24U) | (key >> 24U);
+        }
+
+        std::optional<std::size_t> bitboard_index_from_letter(char letter) {
+            static constexpr std::string_view piece_letters {"PNBRQK"};
+            const std::size_t index {piece_letters.find(letter)};
+
+            return index == std::string_view::npos ? std::nullopt : std::optional {index};
+        }
+
+        // The piece code used by the tables for a bitboard index
+        std::uint8_t table_piece_code(std::size_t bitboard_index) {
+            return static_cast<std::uint8_t>(bitboard_index % 6 + 1 + (bitboard_index / 6) * 8);
+        }
+
+        int sign_of(int value) {
+            return (0 < value) - (value < 0);
+        }
+
+        // Zeroing moves reset the DTZ count, so their DTZ only depends on the result
+        int dtz_before_zeroing(WdlScore wdl) {
+            switch (wdl) {
+                case WdlScore::Win: return 1;
+                case WdlScore::CursedWin: return 101;
+                case WdlScore::BlessedLoss: return -101;
+                case WdlScore::Loss: return -1;
+                default: return 0;
+            }
+        }
+
+        WdlScore negated(WdlScore wdl) {
+            return static_cast<WdlScore>(-static_cast<int>(wdl));
+        }
+
+        bool is_capture(const bitboard& board, const bitboard::move& chess_move) {
+            if (std::holds_alternative<bitboard::move_en_passant>(chess_move)) {
+                return true;
+            }
+
+            if (std::holds_alternative<bitboard::move_castle>(chess_move)) {
+                return false;
+            }
+
+            return board.color_at_square(bitboard::move_end(chess_move)) ==
+                   bitboard::opposite_turn(board.turn());
+        }
+
+        bool is_zeroing(const bitboard& board, const bitboard::move& chess_move) {
+            return is_capture(board, chess_move) ||
+                   (!std::holds_alternative<bitboard::move_castle>(chess_move) &&
+                    board.piece_at_square(bitboard::move_start(chess_move)).piece_type ==
+                        bitboard::PieceType::Pawn);
+        }
+
+        bool is_checkmate(const bitboard& board) {
+            return board.is_in_check() && !board.has_legal_move();
+        }
+
+        std::uint16_t left_symbol(const std::uint8_t* symbol_pair) {
+            return static_cast<std::uint16_t>(((symbol_pair [1] & 0xfU) << 8U) | symbol_pair [0]);
+        }
+
+        std::uint16_t right_symbol(const std::uint8_t* symbol_pair) {
+            return static_cast<std::uint16_t>((symbol_pair [2] << 4U) | (symbol_pair [1] >> 4U));
+        }
+
+        // Number of values a symbol expands to, minus one
+        std::uint8_t symbol_length(std::vector<std::uint8_t>& symbol_lengths,
+                                   std::vector<bool>& visited, const std::uint8_t* symbol_pairs,
+                                   std::uint16_t symbol) {
+            visited.at(symbol) = true;
+
+            const std::uint8_t* const symbol_pair {symbol_pairs + std::size_t {symbol} * 3};
+            const std::uint16_t right {right_symbol(symbol_pair)};
+
+            if (right == 0xfff) { // A leaf holding a value
+                return 0;
+            }
+
+            const std::uint16_t left {left_symbol(symbol_pair)};
+
+            for (const std::uint16_t child: {left, right}) {
+                if (child >= symbol_lengths.size()) {
+                    return 0;
+                }
+
+                if (!visited.at(child)) {
+                    symbol_lengths.at(child) =
+                        symbol_length(symbol_lengths, visited, symbol_pairs, child);
+                }
+            }
+
+            return static_cast<std::uint8_t>(symbol_lengths.at(left) +
+                                             symbol_lengths.at(right) + 1);
+        }
+
+        // Bytes needed to align `data` to `alignment`, counted from the start of the file
+        std::size_t alignment_padding(const std::uint8_t* file_start, const std::uint8_t* data,
+                                      std::size_t alignment) {
+            const auto offset {static_cast<std::size_t>(data - file_start)};
+
+            return (alignment - offset % alignment) % alignment;
+        }
+
+        std::optional<std::string> find_file(const std::vector<std::filesystem::path>& directories,
+                                             const std::string& file_name) {
+            for (const std::filesystem::path& directory: directories) {
+                std::error_code error {};
+
+                if (std::filesystem::is_regular_file(directory / file_name, error)) {
+                    return (directory / file_name).string();
+                }
+            }
+
+            return std::nullopt;
+        }
+    } // namespace
+
+    struct syzygy_tablebases::pairs_data {
+        void set_groups(const table& entry, std::array<int, 2> order, int pawn_file);
+        // Reads the Huffman code description, returning nullptr when it runs past `end`
+        [[nodiscard]] const std::uint8_t* read_sizes(const std::uint8_t* data,
+                                                     const std::uint8_t* end);
+
+        // Returns the value stored at `index`, expanding the Huffman coded symbols of its block
+        [[nodiscard]] int decompress(std::uint64_t index) const;
+
+        std::uint8_t flags;
+        std::uint8_t max_symbol_length;
+        std::uint8_t min_symbol_length; // Holds the value itself for single value tables
+        std::uint32_t block_count;
+        std::size_t block_size;
+        std::size_t span; // Distance in values between two sparse index entries
+        const std::uint8_t* lowest_symbols;
+        const std::uint8_t* symbol_pairs; // Three bytes holding two 12 bit child symbols each
+        const std::uint8_t* block_lengths;
+        std::uint32_t block_lengths_size;
+        const std::uint8_t* sparse_index; // Six bytes each: a block and an offset into it
+        std::size_t sparse_index_size;
+        const std::uint8_t* data;
+        std::vector<std::uint64_t> base64; // Lowest symbol of each length padded to 64 bits
+        std::vector<std::uint8_t> symbol_lengths;
+        std::array<std::uint8_t, max_table_pieces> pieces; // Defines the encoding groups
+        std::array<std::uint64_t, max_table_pieces + 1> group_index;
+        std::array<int, max_table_pieces + 1> group_length; // Zero terminated
+        std::array<std::uint16_t, 4> map_index; // DTZ value maps per WDL result
+    };
+
+    struct syzygy_tablebases::table_file {
+        mapped_file file;
+        const std::uint8_t* dtz_map;
+        std::size_t sides; // DTZ tables store only one side to move
+        std::array<std::array<pairs_data, 4>, 2> items; // [side to move][leading pawn file]
+    };
+
+    struct syzygy_tablebases::table {
+        [[nodiscard]] bool load(mapped_file&& file, bool is_dtz);
+
+        [[nodiscard]] const pairs_data& get(const table_file& file, int side_to_move,
+                                            int pawn_file) const {
+            return file.items.at(static_cast<std::size_t>(side_to_move) % file.sides)
+                .at(static_cast<std::size_t>(has_pawns ? pawn_file : 0));
+        }
+
+        std::uint64_t key;  // White holds the first side of the file name
+        std::uint64_t key2; // Black holds the first side of the file name
+        int piece_count;
+        bool has_pawns;
+        bool has_unique_pieces;
+        std::array<int, 2> pawn_count; // Leading colour first
+        std::optional<table_file> wdl;
+        std::optional<table_file> dtz;
+    };
+
+    // Pieces are split into groups that are encoded together, such as KRvKN into KRK and N
+    void syzygy_tablebases::pairs_data::set_groups(const table& entry, std::array<int, 2> order,
+                                                   int pawn_file) {
+        std::size_t group_count {0};
+        int first_length {entry.has_pawns ? 0 : entry.has_unique_pieces ? 3 : 2};
+
+        group_length.at(0) = 1;
+
+        for (std::size_t index {1}; index < static_cast<std::size_t>(entry.piece_count); index++) {
+            if (--first_length > 0 || pieces.at(index) == pieces.at(index - 1)) {
+                group_length.at(group_count)++;
+            }
+
+            else {
+                group_length.at(++group_count) = 1;
+            }
+        }
+
+        group_length.at(++group_count) = 0;
+
+        // Groups are encoded in a per table order, with the leading group at `order [0]` and the
+        // remaining pawns at `order [1]`
+        const bool pawns_on_both_sides {entry.has_pawns && entry.pawn_count.at(1) != 0};
+        std::size_t next_group {pawns_on_both_sides ? 2U : 1U};
+        int free_squares {64 - group_length.at(0) - (pawns_on_both_sides ? group_length.at(1) : 0)};
+        std::uint64_t index {1};
+
+        for (int group {};
+             next_group < group_count || group == order.at(0) || group == order.at(1); group++) {
+            if (group == order.at(0)) {
+                group_index.at(0) = index;
+                index *= entry.has_pawns
+                             ? encoding.lead_pawns_size
+                                   .at(static_cast<std::size_t>(group_length.at(0)))
+                                   .at(static_cast<std::size_t>(pawn_file))
+                         : entry.has_unique_pieces ? 31332
+                                                   : 462;
+            }
+
+            else if (group == order.at(1)) {
+                group_index.at(1) = index;
+                index *= encoding.binomial.at(static_cast<std::size_t>(group_length.at(1)))
+                             .at(static_cast<std::size_t>(48 - group_length.at(0)));
+            }
+
+            else {
+                group_index.at(next_group) = index;
+                index *= encoding.binomial.at(static_cast<std::size_t>(group_length.at(next_group)))
+                             .at(static_cast<std::size_t>(free_squares));
+                free_squares -= group_length.at(next_group++);
+            }
+        }
+
+        group_index.at(group_count) = index;
+    }
+
+    const std::uint8_t* syzygy_tablebases::pairs_data::read_sizes(const std::uint8_t* data,
+                                                                  const std::uint8_t* end) {
+        if (data + 2 > end) {
+            return nullptr;
+        }
+
+        flags = *data++;
+
+        if ((flags & TableFlag::SingleValue) != 0) {
+            block_count = 0;
+            block_lengths_size = 0;
+            span = 0;
+            sparse_index_size = 0;
+            min_symbol_length = *data++;
+            return data;
+        }
+
+        if (data + 10 > end) {
+            return nullptr;
+        }
+
+        const std::uint64_t table_size {group_index.at(static_cast<std::size_t>(
+            std::ranges::find(group_length, 0) - group_length.begin()))};
+
+        block_size = std::size_t {1} << *data++;
+        span = std::size_t {1} << *data++;
+        sparse_index_size = (table_size + span - 1) / span;
+
+        const std::uint8_t padding {*data++};
+
+        block_count = read_little_endian<std::uint32_t>(data);
+        data += 4;
+        block_lengths_size = block_count + padding; // Keeps the sparse index within the table
+        max_symbol_length = *data++;
+        min_symbol_length = *data++;
+        lowest_symbols = data;
+
+        if (max_symbol_length < min_symbol_length || max_symbol_length > 64) {
+            return nullptr;
+        }
+
+        base64.assign(std::size_t {max_symbol_length} - min_symbol_length + 1, 0);
+
+        if (data + base64.size() * 2 + 2 > end) {
+            return nullptr;
+        }
+
+        // Longer codes have lower values, so the base of each length follows from the next
+        // longer one
+        for (std::size_t length {base64.size() - 1}; length > 0; length--) {
+            base64.at(length - 1) =
+                (base64.at(length) +
+                 read_little_endian<std::uint16_t>(lowest_symbols + (length - 1) * 2) -
+                 read_little_endian<std::uint16_t>(lowest_symbols + length * 2)) /
+                2;
+        }
+
+        for (std::size_t length {}; length < base64.size(); length++) {
+            base64.at(length) <<= 64 - length - min_symbol_length;
+        }
+
+        data += base64.size() * 2;
+
+        const std::uint16_t symbol_count {read_little_endian<std::uint16_t>(data)};
+        data += 2;
+
+        if (data + std::size_t {symbol_count} * 3 > end) {
+            return nullptr;
+        }
+
+        symbol_pairs = data;
+        symbol_lengths.assign(symbol_count, 0);
+
+        std::vector<bool> visited(symbol_count);
+
+        for (std::uint16_t symbol {}; symbol < symbol_count; symbol++) {
+            if (!visited.at(symbol)) {
+                symbol_lengths.at(symbol) =
+                    symbol_length(symbol_lengths, visited, symbol_pairs, symbol);
+            }
+        }
+
+        return data + std::size_t {symbol_count} * 3 + (symbol_count & 1U);
+    }
+
+    int syzygy_tablebases::pairs_data::decompress(std::uint64_t index) const {
+        if ((flags & TableFlag::SingleValue) != 0) {
+            return min_symbol_length;
+        }
+
+        // Sparse index entry k points at the value k * span + span / 2, from which the block
+        // lengths are walked to the block holding `index`
+        const std::uint8_t* const sparse_entry {sparse_index + index / span * 6};
+        std::uint32_t block {read_little_endian<std::uint32_t>(sparse_entry)};
+        std::int64_t offset {read_little_endian<std::uint16_t>(sparse_entry + 4) +
+                             static_cast<std::int64_t>(index % span) -
+                             static_cast<std::int64_t>(span / 2)};
+
+        const auto block_length {[this](std::uint32_t block_number) -> std::int64_t {
+            return read_little_endian<std::uint16_t>(block_lengths +
+                                                     std::size_t {block_number} * 2);
+        }};
+
+        while (offset < 0) {
+            offset += block_length(--block) + 1;
+        }
+
+        while (offset > block_length(block)) {
+            offset -= block_length(block++) + 1;
+        }
+
+        const std::uint8_t* bytes {data + std::uint64_t {block} * block_size};
+        std::uint64_t buffer {read_big_endian<std::uint64_t>(bytes)};
+        int buffer_size {64};
+        std::uint16_t symbol {};
+
+        bytes += 8;
+
+        while (true) {
+            std::size_t length {0}; // Above the minimum symbol length
+
+            while (buffer < base64 [length]) {
+                length++;
+            }
+
+            symbol = static_cast<std::uint16_t>((buffer - base64 [length]) >>
+                                                (64 - length - min_symbol_length));
+            symbol += read_little_endian<std::uint16_t>(lowest_symbols + length * 2);
+
+            if (offset < symbol_lengths [symbol] + 1) {
+                break;
+            }
+
+            offset -= symbol_lengths [symbol] + 1;
+            length += min_symbol_length;
+            buffer <<= length;
+            buffer_size -= static_cast<int>(length);
+
+            if (buffer_size <= 32) {
+                buffer_size += 32;
+                buffer |= std::uint64_t {read_big_endian<std::uint32_t>(bytes)}
+                          << (64 - buffer_size);
+                bytes += 4;
+            }
+        }
+
+        // Symbols stand for pairs of adjacent symbols, so walk down to the leaf holding `index`
+        while (symbol_lengths [symbol] != 0) {
+            const std::uint8_t* const symbol_pair {symbol_pairs + std::size_t {symbol} * 3};
+            const std::uint16_t left {left_symbol(symbol_pair)};
+
+            if (offset < symbol_lengths [left] + 1) {
+                symbol = left;
+            }
+
+            else {
+                offset -= symbol_lengths [left] + 1;
+                symbol = right_symbol(symbol_pair);
+            }
+        }
+
+        return left_symbol(symbol_pairs + std::size_t {symbol} * 3);
+    }
+
+    bool syzygy_tablebases::table::load(mapped_file&& file, bool is_dtz) {
+        enum HeaderFlag : std::uint8_t { Split = 1, HasPawns = 2 };
+
+        const auto* const start {reinterpret_cast<const std::uint8_t*>(file.bytes().data())};
+        const std::uint8_t* const end {start + file.size()};
+        const std::array<std::uint8_t, 4>& magic {is_dtz ? dtz_magic : wdl_magic};
+
+        if (file.size() < magic.size() + 1 || !std::equal(magic.begin(), magic.end(), start) ||
+            ((start [4] & HeaderFlag::HasPawns) != 0) != has_pawns ||
+            ((start [4] & HeaderFlag::Split) != 0) != (key != key2)) {
+            return false;
+        }
+
+        table_file loaded_file {};
+        const std::uint8_t* data {start + 5};
+
+        const std::size_t sides {!is_dtz && key != key2 ? 2U : 1U};
+        loaded_file.sides = sides;
+        const int max_pawn_file {has_pawns ? 3 : 0};
+        const bool pawns_on_both_sides {has_pawns && pawn_count.at(1) != 0};
+
+        const auto for_each_item {[&](const auto& visit) {
+            for (int pawn_file {}; pawn_file <= max_pawn_file; pawn_file++) {
+                for (std::size_t side {}; side < sides; side++) {
+                    visit(loaded_file.items.at(side).at(static_cast<std::size_t>(pawn_file)),
+                          pawn_file);
+                }
+            }
+        }};
+
+        for (int pawn_file {}; pawn_file <= max_pawn_file; pawn_file++) {
+            if (data + 1 + (pawns_on_both_sides ? 1 : 0) + piece_count > end) {
+                return false;
+            }
+
+            const std::array<std::array<int, 2>, 2> order {
+                {{data [0] & 0xf, pawns_on_both_sides ? data [1] & 0xf : 0xf},
+                 {data [0] >> 4U, pawns_on_both_sides ? data [1] >> 4U : 0xf}}
+            };
+
+            data += pawns_on_both_sides ? 2 : 1;
+
+            for (std::size_t piece_index {}; piece_index < static_cast<std::size_t>(piece_count);
+                 piece_index++, data++) {
+                for (std::size_t side {}; side < sides; side++) {
+                    loaded_file.items.at(side).at(static_cast<std::size_t>(pawn_file))
+                        .pieces.at(piece_index) =
+                        static_cast<std::uint8_t>(side == 0 ? *data & 0xfU : *data >> 4U);
+                }
+            }
+
+            for (std::size_t side {}; side < sides; side++) {
+                loaded_file.items.at(side)
+                    .at(static_cast<std::size_t>(pawn_file))
+                    .set_groups(*this, order.at(side), pawn_file);
+            }
+        }
+
+        data += alignment_padding(start, data, 2);
+
+        for_each_item([&](pairs_data& pairs, int) {
+            data = data == nullptr ? nullptr : pairs.read_sizes(data, end);
+        });
+
+        if (data == nullptr) {
+            return false;
+        }
+
+        if (is_dtz) { // Maps from the stored DTZ values back to distances, per WDL result
+            loaded_file.dtz_map = data;
+
+            for (int pawn_file {}; pawn_file <= max_pawn_file; pawn_file++) {
+                pairs_data& pairs {loaded_file.items.at(0).at(static_cast<std::size_t>(pawn_file))};
+
+                if ((pairs.flags & TableFlag::Mapped) == 0) {
+                    continue;
+                }
+
+                if ((pairs.flags & TableFlag::Wide) != 0) {
+                    data += alignment_padding(start, data, 2);
+                }
+
+                for (std::uint16_t& map_index: pairs.map_index) {
+                    if (data + 2 > end) {
+                        return false;
+                    }
+
+                    if ((pairs.flags & TableFlag::Wide) != 0) {
+                        map_index =
+                            static_cast<std::uint16_t>((data - loaded_file.dtz_map) / 2 + 1);
+                        data += 2 * read_little_endian<std::uint16_t>(data) + 2;
+                    }
+
+                    else {
+                        map_index = static_cast<std::uint16_t>(data - loaded_file.dtz_map + 1);
+                        data += *data + 1;
+                    }
+                }
+            }
+
+            data += alignment_padding(start, data, 2);
+        }
+
+        for_each_item([&](pairs_data& pairs, int) {
+            pairs.sparse_index = data;
+            data += pairs.sparse_index_size * 6;
+        });
+
+        for_each_item([&](pairs_data& pairs, int) {
+            pairs.block_lengths = data;
+            data += std::size_t {pairs.block_lengths_size} * 2;
+        });
+
+        bool fits {data <= end};
+
+        for_each_item([&](pairs_data& pairs, int) {
+            data += alignment_padding(start, data, 64); // Blocks start on cache lines
+            pairs.data = data;
+            data += std::size_t {pairs.block_count} * pairs.block_size;
+            fits = fits && (pairs.block_count == 0 || data <= end);
+        });
+
+        if (!fits) {
+            return false;
+        }
+
+        loaded_file.file = std::move(file);
+        (is_dtz ? dtz : wdl) = std::move(loaded_file);
+
+        return true;
+    }
+
+    syzygy_tablebases::syzygy_tablebases() : _max_pieces {0} {
+    }
+
+    syzygy_tablebases::syzygy_tablebases(syzygy_tablebases&& other) noexcept = default;
+    syzygy_tablebases::~syzygy_tablebases() = default;
+    syzygy_tablebases&
+        syzygy_tablebases::operator=(syzygy_tablebases&& other) noexcept = default;
+
+    syzygy_tablebases syzygy_tablebases::open(std::string_view paths) {
+        syzygy_tablebases tablebases {};
+        std::vector<std::filesystem::path> directories {};
+
+        for (std::size_t start {}; start <= paths.size();) {
+            const std::size_t separator {std::min(paths.find(':', start), paths.size())};
+
+            if (separator > start && paths.substr(start, separator - start) != "<empty>") {
+                directories.emplace_back(paths.substr(start, separator - start));
+            }
+
+            start = separator + 1;
+        }
+
+        std::vector<std::string> table_names {};
+
+        for (const std::filesystem::path& directory: directories) {
+            std::error_code error {};
+
+            for (std::filesystem::directory_iterator entry {directory, error};
+                 !error && entry != std::filesystem::directory_iterator {};
+                 entry.increment(error)) {
+                if (entry->path().extension() == ".rtbw") {
+                    table_names.push_back(entry->path().stem().string());
+                }
+            }
+        }
+
+        std::ranges::sort(table_names);
+        table_names.erase(std::ranges::unique(table_names).begin(), table_names.end());
+
+        for (const std::string& table_name: table_names) {
+            std::array<std::array<int, 6>, 2> piece_counts {};
+            std::size_t side {0};
+            bool valid_name {std::ranges::count(table_name, 'v') == 1};
+
+            for (const char letter: table_name) { // Such as `KRPvKR`
+                if (letter == 'v') {
+                    side = 1;
+                }
+
+                else if (const std::optional<std::size_t> index {
+                             bitboard_index_from_letter(letter)}) {
+                    piece_counts.at(side).at(*index)++;
+                }
+
+                else {
+                    valid_name = false;
+                }
+            }
+
+            if (!valid_name || piece_counts.at(0).at(5) != 1 || piece_counts.at(1).at(5) != 1) {
+                continue;
+            }
+
+            table entry {};
+
+            for (std::size_t index {}; index < 6; index++) {
+                entry.key |= static_cast<std::uint64_t>(piece_counts.at(0).at(index))
+                             << (4 * index);
+                entry.key |= static_cast<std::uint64_t>(piece_counts.at(1).at(index))
+                             << (4 * (index + 6));
+                entry.piece_count += piece_counts.at(0).at(index) + piece_counts.at(1).at(index);
+                entry.has_unique_pieces = entry.has_unique_pieces ||
+                                          (index < 5 && (piece_counts.at(0).at(index) == 1 ||
+                                                         piece_counts.at(1).at(index) == 1));
+            }
+
+            if (entry.piece_count > max_table_pieces) {
+                continue;
+            }
+
+            entry.key2 = with_colors_swapped(entry.key);
+
+            // The side with fewer pawns leads, since that compresses better
+            const int white_pawns {piece_counts.at(0).at(0)};
+            const int black_pawns {piece_counts.at(1).at(0)};
+            const bool white_leads {black_pawns == 0 ||
+                                    (white_pawns != 0 && black_pawns >= white_pawns)};
+
+            entry.has_pawns = white_pawns + black_pawns > 0;
+            entry.pawn_count = {white_leads ? white_pawns : black_pawns,
+                                white_leads ? black_pawns : white_pawns};
+
+            for (const bool is_dtz: {false, true}) {
+                const std::optional<std::string> path {
+                    find_file(directories, table_name + (is_dtz ? ".rtbz" : ".rtbw"))};
+
+                if (!path.has_value()) {
+                    continue;
+                }
+
+                std::expected<mapped_file, std::error_code> file {
+                    mapped_file::open(*path, mapped_file::AccessPattern::Random)};
+
+                if (file.has_value()) {
+                    static_cast<void>(entry.load(std::move(*file), is_dtz));
+                }
+            }
+
+            if (!entry.wdl.has_value()) {
+                continue;
+            }
+
+            tablebases._max_pieces = std::max(tablebases._max_pieces, entry.piece_count);
+            tablebases._table_indices.emplace(entry.key, tablebases._tables.size());
+            tablebases._table_indices.emplace(entry.key2, tablebases._tables.size());
+            tablebases._tables.push_back(std::move(entry));
+        }
+
+        return tablebases;
+    }
+
+    const syzygy_tablebases::table*
+        syzygy_tablebases::find_table(std::uint64_t material_key) const {
+        const auto found {_table_indices.find(material_key)};
+
+        return found == _table_indices.end() ? nullptr : &_tables.at(found->second);
+    }
+
+    // Maps the position onto the canonical placement of the table and decodes its value, which
+    // is a WDL score or a DTZ in plies
+    int syzygy_tablebases::probe_table(const bitboard& board, bool probe_dtz_table, WdlScore wdl,
+                                       ProbeState& state) const {
+        const std::array<bitboard::bit_representation, 12> bitboards {board.bitboards()};
+        const std::uint64_t key {material_key(bitboards)};
+
+        if (key == ((std::uint64_t {1} << 20U) | (std::uint64_t {1} << 44U))) {
+            return 0; // Bare kings
+        }
+
+        const table* const entry {find_table(key)};
+
+        if (entry == nullptr || !(probe_dtz_table ? entry->dtz : entry->wdl).has_value()) {
+            state = ProbeState::Failed;
+            return 0;
+        }
+
+        const table_file& file {probe_dtz_table ? *entry->dtz : *entry->wdl};
+
+        // Tables hold the first side of their name as white, with only white to move stored
+        // for symmetric material, so other positions are mirrored vertically with colours swapped
+        const int black_to_move {board.turn() == bitboard::Turn::Black ? 1 : 0};
+        const bool flip {(entry->key == entry->key2 && black_to_move != 0) || key != entry->key};
+        const std::uint8_t flip_color {flip ? std::uint8_t {8} : std::uint8_t {0}};
+        const int flip_squares {flip ? 56 : 0};
+        const int side_to_move {(flip ? 1 : 0) ^ black_to_move};
+
+        std::array<int, max_table_pieces> squares {};
+        std::array<std::uint8_t, max_table_pieces> pieces {};
+        std::size_t size {0};
+        std::size_t lead_pawn_count {0};
+        bitboard::bit_representation lead_pawns {0};
+        int pawn_file {0};
+
+        const auto by_pawn_map {[](int first, int second) {
+            return encoding.map_pawns.at(static_cast<std::size_t>(first)) <
+                   encoding.map_pawns.at(static_cast<std::size_t>(second));
+        }};
+
+        if (entry->has_pawns) { // Pawns of the leading colour come first
+            const std::uint8_t lead_pawn {
+                static_cast<std::uint8_t>(entry->get(file, 0, 0).pieces.at(0) ^ flip_color)};
+            const std::size_t lead_pawn_index {lead_pawn < 8 ? 0U : 6U};
+
+            lead_pawns = bitboards.at(lead_pawn_index);
+
+            for (bitboard::bit_representation pawn_bits {lead_pawns}; pawn_bits != 0;
+                 pawn_bits = without_lowest_square(pawn_bits)) {
+                squares.at(size++) = square_index(pawn_bits) ^ flip_squares;
+            }
+
+            lead_pawn_count = size;
+
+            std::swap(squares.at(0), *std::max_element(squares.begin(),
+                                                       squares.begin() +
+                                                           static_cast<std::ptrdiff_t>(size),
+                                                       by_pawn_map));
+
+            pawn_file = std::min(squares.at(0) % 8, 7 - squares.at(0) % 8);
+        }
+
+        if (probe_dtz_table) { // DTZ tables only store one side to move
+            const std::uint8_t flags {entry->get(file, side_to_move, pawn_file).flags};
+
+            if ((flags & TableFlag::SideToMove) != side_to_move &&
+                (entry->key != entry->key2 || entry->has_pawns)) {
+                state = ProbeState::ChangeSideToMove;
+                return 0;
+            }
+        }
+
+        for (std::size_t index {}; index < bitboards.size(); index++) {
+            for (bitboard::bit_representation piece_bits {bitboards.at(index) & ~lead_pawns};
+                 piece_bits != 0; piece_bits = without_lowest_square(piece_bits)) {
+                squares.at(size) = square_index(piece_bits) ^ flip_squares;
+                pieces.at(size++) = static_cast<std::uint8_t>(table_piece_code(index) ^ flip_color);
+            }
+        }
+
+        const pairs_data& pairs {entry->get(file, side_to_move, pawn_file)};
+
+        // Put the pieces in the order of the table
+        for (std::size_t index {lead_pawn_count}; index + 1 < size; index++) {
+            for (std::size_t other {index + 1}; other < size; other++) {
+                if (pairs.pieces.at(index) == pieces.at(other)) {
+                    std::swap(pieces.at(index), pieces.at(other));
+                    std::swap(squares.at(index), squares.at(other));
+                    break;
+                }
+            }
+        }
+
+        // Mirror the leading piece onto the a to d files
+        if (squares.at(0) % 8 > 3) {
+            for (std::size_t index {}; index < size; index++) {
+                squares.at(index) = flip_file(squares.at(index));
+            }
+        }
+
+        std::uint64_t index {0};
+
+        if (entry->has_pawns) {
+            index = encoding.lead_pawn_index.at(lead_pawn_count)
+                        .at(static_cast<std::size_t>(squares.at(0)));
+
+            std::stable_sort(squares.begin() + 1,
+                             squares.begin() + static_cast<std::ptrdiff_t>(lead_pawn_count),
+                             by_pawn_map);
+
+            for (std::size_t pawn {1}; pawn < lead_pawn_count; pawn++) {
+                index += encoding.binomial.at(pawn).at(static_cast<std::size_t>(
+                    encoding.map_pawns.at(static_cast<std::size_t>(squares.at(pawn)))));
+            }
+        }
+
+        else {
+            if (squares.at(0) / 8 > 3) { // Mirror the leading piece onto the first four ranks
+                for (std::size_t square {}; square < size; square++) {
+                    squares.at(square) ^= 56;
+                }
+            }
+
+            // Mirror along the a1-h8 diagonal so the first piece of the leading group that is
+            // off the diagonal lies below it
+            for (std::size_t square {};
+                 square < static_cast<std::size_t>(pairs.group_length.at(0)); square++) {
+                if (off_diagonal(squares.at(square)) == 0) {
+                    continue;
+                }
+
+                if (off_diagonal(squares.at(square)) > 0) {
+                    for (std::size_t other {square}; other < size; other++) {
+                        squares.at(other) =
+                            ((squares.at(other) >> 3) | (squares.at(other) << 3)) & 63;
+                    }
+                }
+
+                break;
+            }
+
+            const auto rank_of {[&squares](std::size_t piece) { return squares.at(piece) / 8; }};
+            const auto below_diagonal {
+                [&squares](std::size_t piece) { return off_diagonal(squares.at(piece)) != 0; }};
+
+            if (entry->has_unique_pieces) { // The three leading pieces are encoded together
+                const int adjust1 {squares.at(1) > squares.at(0) ? 1 : 0};
+                const int adjust2 {(squares.at(2) > squares.at(0) ? 1 : 0) +
+                                   (squares.at(2) > squares.at(1) ? 1 : 0)};
+                const auto map_b1h1h7 {[&squares](std::size_t piece) {
+                    return encoding.map_b1h1h7.at(static_cast<std::size_t>(squares.at(piece)));
+                }};
+
+                if (below_diagonal(0)) {
+                    index = static_cast<std::uint64_t>(
+                        (encoding.map_a1d1d4.at(static_cast<std::size_t>(squares.at(0))) * 63 +
+                         (squares.at(1) - adjust1)) *
+                            62 +
+                        squares.at(2) - adjust2);
+                }
+
+                else if (below_diagonal(1)) {
+                    index = static_cast<std::uint64_t>(
+                        (6 * 63 + rank_of(0) * 28 + map_b1h1h7(1)) * 62 + squares.at(2) -
+                        adjust2);
+                }
+
+                else if (below_diagonal(2)) {
+                    index = static_cast<std::uint64_t>(6 * 63 * 62 + 4 * 28 * 62 +
+                                                       rank_of(0) * 7 * 28 +
+                                                       (rank_of(1) - adjust1) * 28 +
+                                                       map_b1h1h7(2));
+                }
+
+                else {
+                    index = static_cast<std::uint64_t>(6 * 63 * 62 + 4 * 28 * 62 + 4 * 7 * 28 +
+                                                       rank_of(0) * 7 * 6 +
+                                                       (rank_of(1) - adjust1) * 6 +
+                                                       (rank_of(2) - adjust2));
+                }
+            }
+
+            else { // Only the kings lead
+                index = static_cast<std::uint64_t>(
+                    encoding.map_kk
+                        .at(static_cast<std::size_t>(
+                            encoding.map_a1d1d4.at(static_cast<std::size_t>(squares.at(0)))))
+                        .at(static_cast<std::size_t>(squares.at(1))));
+            }
+        }
+
+        // The remaining groups are each encoded as a combination of their free squares
+        index *= pairs.group_index.at(0);
+
+        std::size_t group_start {static_cast<std::size_t>(pairs.group_length.at(0))};
+        bool remaining_pawns {entry->has_pawns && entry->pawn_count.at(1) != 0};
+
+        for (std::size_t group {1}; pairs.group_length.at(group) != 0; group++) {
+            const auto group_end {group_start +
+                                  static_cast<std::size_t>(pairs.group_length.at(group))};
+            std::uint64_t group_index {0};
+
+            std::sort(squares.begin() + static_cast<std::ptrdiff_t>(group_start),
+                      squares.begin() + static_cast<std::ptrdiff_t>(group_end));
+
+            for (std::size_t piece {group_start}; piece < group_end; piece++) {
+                const auto squares_before {std::count_if(
+                    squares.begin(), squares.begin() + static_cast<std::ptrdiff_t>(group_start),
+                    [&squares, piece](int square) { return squares.at(piece) > square; })};
+
+                group_index += encoding.binomial.at(piece - group_start + 1)
+                                   .at(static_cast<std::size_t>(squares.at(piece) - squares_before -
+                                                                (remaining_pawns ? 8 : 0)));
+            }
+
+            remaining_pawns = false;
+            index += group_index * pairs.group_index.at(group);
+            group_start = group_end;
+        }
+
+        const int value {pairs.decompress(index)};
+
+        if (!probe_dtz_table) {
+            return value - 2;
+        }
+
+        // DTZ values are stored by frequency per result and in moves unless flagged as plies
+        static constexpr std::array<std::size_t, 5> wdl_map_slots {1, 3, 0, 2, 0};
+
+        const pairs_data& map_pairs {entry->get(file, 0, pawn_file)};
+        int distance {value};
+
+        if ((map_pairs.flags & TableFlag::Mapped) != 0) {
+            const std::size_t map_offset {
+                map_pairs.map_index.at(wdl_map_slots.at(static_cast<std::size_t>(wdl) + 2)) +
+                static_cast<std::size_t>(value)};
+
+            distance = (map_pairs.flags & TableFlag::Wide) != 0
+                           ? read_little_endian<std::uint16_t>(file.dtz_map + map_offset * 2)
+                           : file.dtz_map [map_offset];
+        }
+
+        if ((wdl == WdlScore::Win && (map_pairs.flags & TableFlag::WinPlies) == 0) ||
+            (wdl == WdlScore::Loss && (map_pairs.flags & TableFlag::LossPlies) == 0) ||
+            wdl == WdlScore::CursedWin || wdl == WdlScore::BlessedLoss) {
+            distance *= 2;
+        }
+
+        return distance + 1;
+    }
+
+    // Tables store "don't care" values where a capture decides the result, and DTZ tables are
+    // wrong where a zeroing move is best, so captures (and pawn moves for DTZ) are searched too
+    WdlScore syzygy_tablebases::search(const bitboard& board, bool check_zeroing_moves,
+                                       ProbeState& state) const {
+        const std::vector<bitboard::move> moves {board.all_legal_moves()};
+        WdlScore best_value {WdlScore::Loss};
+        std::size_t searched_moves {0};
+
+        for (const bitboard::move& chess_move: moves) {
+            if (!is_capture(board, chess_move) &&
+                (!check_zeroing_moves || !is_zeroing(board, chess_move))) {
+                continue;
+            }
+
+            searched_moves++;
+
+            const WdlScore value {negated(search(board.after_move(chess_move), false, state))};
+
+            if (state == ProbeState::Failed) {
+                return WdlScore::Draw;
+            }
+
+            if (value > best_value) {
+                best_value = value;
+
+                if (value >= WdlScore::Win) {
+                    state = ProbeState::ZeroingBestMove;
+                    return value;
+                }
+            }
+        }
+
+        const bool no_more_moves {searched_moves != 0 && searched_moves == moves.size()};
+        WdlScore value {best_value};
+
+        if (!no_more_moves) {
+            value = static_cast<WdlScore>(probe_table(board, false, WdlScore::Draw, state));
+
+            if (state == ProbeState::Failed) {
+                return WdlScore::Draw;
+            }
+        }
+
+        if (best_value >= value) {
+            state = best_value > WdlScore::Draw || no_more_moves ? ProbeState::ZeroingBestMove
+                                                                 : ProbeState::Ok;
+            return best_value;
+        }
+
+        state = ProbeState::Ok;
+
+        return value;
+    }
+
+    int syzygy_tablebases::probe_dtz(const bitboard& board, ProbeState& state) const {
+        state = ProbeState::Ok;
+
+        const WdlScore wdl {search(board, true, state)};
+
+        if (state == ProbeState::Failed || wdl == WdlScore::Draw) {
+            return 0;
+        }
+
+        if (state == ProbeState::ZeroingBestMove) {
+            return dtz_before_zeroing(wdl);
+        }
+
+        int dtz {probe_table(board, true, wdl, state)};
+
+        if (state == ProbeState::Failed) {
+            return 0;
+        }
+
+        if (state != ProbeState::ChangeSideToMove) {
+            const bool fifty_move_draw {wdl == WdlScore::BlessedLoss ||
+                                        wdl == WdlScore::CursedWin};
+
+            return (dtz + (fifty_move_draw ? 100 : 0)) * sign_of(static_cast<int>(wdl));
+        }
+
+        // The table holds the other side to move, so take the best DTZ one ply deeper
+        int min_dtz {0xffff};
+
+        for (const bitboard::move& chess_move: board.all_legal_moves()) {
+            const bool zeroing {is_zeroing(board, chess_move)};
+            const bitboard board_after_move {board.after_move(chess_move)};
+
+            dtz = zeroing ? -dtz_before_zeroing(search(board_after_move, false, state))
+                          : -probe_dtz(board_after_move, state);
+
+            if (state == ProbeState::Failed) {
+                return 0;
+            }
+
+            if (dtz == 1 && is_checkmate(board_after_move)) {
+                min_dtz = 1;
+            }
+
+            if (!zeroing) {
+                dtz += sign_of(dtz);
+            }
+
+            if (dtz < min_dtz && sign_of(dtz) == sign_of(static_cast<int>(wdl))) {
+                min_dtz = dtz;
+            }
+        }
+
+        return min_dtz == 0xffff ? -1 : min_dtz;
+    }
+
+    std::optional<WdlScore> syzygy_tablebases::probe_wdl(const bitboard& board) const {
+        const bitboard::castle_rights_collection castle_rights {board.castle_rights()};
+
+        if (castle_rights != bitboard::castle_rights_collection {false, false, false, false}) {
+            return std::nullopt;
+        }
+
+        ProbeState state {ProbeState::Ok};
+        const WdlScore wdl {search(board, false, state)};
+
+        return state == ProbeState::Failed ? std::nullopt : std::optional {wdl};
+    }
+
+    std::optional<int> syzygy_tablebases::probe_dtz(const bitboard& board) const {
+        const bitboard::castle_rights_collection castle_rights {board.castle_rights()};
+
+        if (castle_rights != bitboard::castle_rights_collection {false, false, false, false}) {
+            return std::nullopt;
+        }
+
+        ProbeState state {ProbeState::Ok};
+        const int dtz {probe_dtz(board, state)};
+
+        return state == ProbeState::Failed ? std::nullopt : std::optional {dtz};
+    }
+
+    std::optional<std::vector<bitboard::move>>
+        syzygy_tablebases::root_moves(const bitboard& board) const {
+        const std::vector<bitboard::move> moves {board.all_legal_moves()};
+        std::vector<int> ranks {};
+
+        // Certain wins rank equally and ahead of wins the fifty move rule may spoil, and losses
+        // rank the other way around
+        const auto dtz_rank {[&board](int dtz) {
+            const int halfmove_clock {board.halfmove_clock()};
+
+            if (dtz > 0) {
+                return dtz + halfmove_clock <= 99 ? 1000 : 1000 - (dtz + halfmove_clock);
+            }
+
+            if (dtz < 0) {
+                return -dtz * 2 + halfmove_clock < 100 ? -1000 : -1000 + (-dtz + halfmove_clock);
+            }
+
+            return 0;
+        }};
+
+        for (const bitboard::move& chess_move: moves) {
+            const bitboard board_after_move {board.after_move(chess_move)};
+            std::optional<int> rank {};
+
+            if (board_after_move.halfmove_clock() == 0) {
+                if (const std::optional<WdlScore> wdl {probe_wdl(board_after_move)}) {
+                    rank = dtz_rank(dtz_before_zeroing(negated(*wdl)));
+                }
+            }
+
+            else if (const std::optional<int> dtz {probe_dtz(board_after_move)}) {
+                const int root_dtz {-*dtz + sign_of(-*dtz)};
+                rank = dtz_rank(root_dtz == 2 && is_checkmate(board_after_move) ? 1 : root_dtz);
+            }
+
+            if (!rank.has_value()) { // Without DTZ tables, fall back to the WDL result alone
+                const std::optional<WdlScore> wdl {probe_wdl(board_after_move)};
+
+                if (!wdl.has_value()) {
+                    return std::nullopt;
+                }
+
+                rank = dtz_rank(dtz_before_zeroing(negated(*wdl)));
+            }
+
+            ranks.push_back(*rank);
+        }
+
+        const int best_rank {ranks.empty() ? 0 : std::ranges::max(ranks)};
+        std::vector<bitboard::move> best_moves {};
+
+        for (std::size_t index {}; index < moves.size(); index++) {
+            if (ranks.at(index) == best_rank) {
+                best_moves.push_back(moves.at(index));
+            }
+        }
+
+        return best_moves;
+    }
+
+    int syzygy_tablebases::max_pieces() const noexcept {
+        return _max_pieces;
+    }
+
+    std::size_t syzygy_tablebases::size() const noexcept {
+        return _tables.size();
+    }
+} // namespace esochess
@@ -0,0 +1,243 @@
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <headers/analysis_server.hpp>
+#include <headers/bench.hpp>
+#include <headers/bitboard.hpp>
+#include <headers/search.hpp>
+#include <headers/uci.hpp>
+
+namespace {
+    using esochess::bitboard;
+
+    struct captured_lines {
+        std::mutex mutex;
+        std::vector<std::string> lines;
+
+        esochess::analysis_session::line_writer writer() {
+            return [this](std::string_view line) {
+                const std::lock_guard<std::mutex> lock {mutex};
+                lines.emplace_back(line);
+            };
+        }
+
+        std::vector<std::string> snapshot() {
+            const std::lock_guard<std::mutex> lock {mutex};
+            return lines;
+        }
+    };
+
+    // The lines answering `id`, requests and errors alike
+    std::vector<std::string> answers_to(const std::vector<std::string>& lines,
+                                        std::string_view id) {
+        const std::string tag {"{\"id\":\"" + std::string {id} + '"'};
+        std::vector<std::string> answers {};
+
+        for (const std::string& line: lines) {
+            if (line.starts_with(tag)) {
+                answers.push_back(line);
+            }
+        }
+
+        return answers;
+    }
+
+    // The text of a string or number field, without its quotes
+    std::optional<std::string> field_of(std::string_view line, std::string_view key) {
+        const std::string tag {'"' + std::string {key} + "\":"};
+        const std::size_t start {line.find(tag)};
+
+        if (start == std::string_view::npos) {
+            return std::nullopt;
+        }
+
+        std::string_view value {line.substr(start + tag.size())};
+
+        if (value.starts_with('"')) {
+            return std::string {value.substr(1, value.find('"', 1) - 1)};
+        }
+
+        return std::string {value.substr(0, value.find_first_of(",}"))};
+    }
+
+    // Exactly one answer to `id`, a response rather than an error
+    std::optional<std::string> single_response(const std::vector<std::string>& lines,
+                                               std::string_view id, int& failures) {
+        const std::vector<std::string> answers {answers_to(lines, id)};
+
+        if (answers.size() != 1 || answers.front().find("\"error\"") != std::string::npos) {
+            std::cout << "Expected one response to " << id << ", got " << answers.size() << '\n';
+
+            for (const std::string& answer: answers) {
+                std::cout << "  " << answer << '\n';
+            }
+
+            failures++;
+            return std::nullopt;
+        }
+
+        return answers.front();
+    }
+
+    void expect_error(const std::vector<std::string>& lines, std::string_view id,
+                      int& failures) {
+        const std::vector<std::string> answers {answers_to(lines, id)};
+
+        if (answers.empty() || answers.back().find("\"error\"") == std::string::npos) {
+            std::cout << "Expected an error for " << id << '\n';
+            failures++;
+        }
+    }
+} // namespace
+
+int main() {
+    int failures {0};
+
+    esochess::search_limits default_limits {};
+    default_limits.depth = 3;
+
+    esochess::analysis_server server {esochess::analysis_server_options {
+        2, 1, default_limits, 0, std::chrono::milliseconds {0}, true}};
+    captured_lines output {};
+
+    {
+        esochess::analysis_session session {server, output.writer()};
+
+        // The long request is cancelled, on a worker or still in the queue
+        session.handle_line(
+            R"({"id": "long", "fen": ")" + std::string {esochess::bench_positions.at(1)} +
+            R"(", "depth": 60})");
+        session.handle_line(R"({"id": "long", "fen": "8/8/8/8/8/8/8/K6k w - - 0 1"})");
+
+        for (std::size_t index {}; index < esochess::bench_positions.size(); index++) {
+            session.handle_line(R"({"id":"bench)" + std::to_string(index) + R"(","fen":")" +
+                                std::string {esochess::bench_positions.at(index)} + "\"}");
+        }
+
+        session.handle_line(
+            R"({"id": "mate", "fen": "6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1", "depth": 4})");
+        session.handle_line(R"({"id": "nodes", "fen": ")" +
+                            std::string {esochess::bench_positions.at(2)} +
+                            R"(", "nodes": 3000, "depth": 40})");
+        session.handle_line(R"({"id": "bad fen", "fen": "8/8/8 w - - 0 1"})");
+        session.handle_line(R"({"id": "bad depth", "fen": "8/8/8/8/8/8/8/K6k w - - 0 1",)"
+                            R"( "depth": -2})");
+        session.handle_line(R"({"fen": "8/8/8/8/8/8/8/K6k w - - 0 1"})");
+        session.handle_line(R"({"id": "broken", )");
+        session.handle_line("");
+        session.handle_line(R"({"id": "unknown", "cancel": true})");
+        session.handle_line(R"({"id": "long", "cancel": true})");
+        session.wait();
+        session.handle_line(R"({"stats": true})");
+    }
+
+    const std::vector<std::string> lines {output.snapshot()};
+
+    // The repeated id is refused while the first request is open
+    const std::vector<std::string> long_answers {answers_to(lines, "long")};
+
+    if (long_answers.size() != 2 ||
+        long_answers.front().find("\"error\"") == std::string::npos ||
+        long_answers.back().find("\"cancelled\":true") == std::string::npos) {
+        std::cout << "Expected an error for the repeated id and a cancelled response\n";
+        failures++;
+    }
+
+    for (std::size_t index {}; index < esochess::bench_positions.size(); index++) {
+        const std::optional<std::string> response {
+            single_response(lines, "bench" + std::to_string(index), failures)};
+
+        if (!response.has_value()) {
+            continue;
+        }
+
+        const bitboard board {*bitboard::from_fen(esochess::bench_positions.at(index))};
+        const std::optional<std::string> best_move {field_of(*response, "bestmove")};
+
+        if (!best_move.has_value() || !esochess::move_from_uci(board, *best_move).has_value() ||
+            field_of(*response, "depth") != "3" ||
+            response->find("\"cancelled\":false") == std::string::npos) {
+            std::cout << "Unexpected response to a bench position: " << *response << '\n';
+            failures++;
+        }
+    }
+
+    const std::optional<std::string> mate_response {single_response(lines, "mate", failures)};
+
+    if (mate_response.has_value() && (field_of(*mate_response, "bestmove") != "a1a8" ||
+                                      mate_response->find("{\"mate\":1}") == std::string::npos)) {
+        std::cout << "Back rank mate not found: " << *mate_response << '\n';
+        failures++;
+    }
+
+    const std::optional<std::string> nodes_response {single_response(lines, "nodes", failures)};
+
+    // Node limits are checked between batches of nodes, so allow some overshoot
+    if (nodes_response.has_value() &&
+        std::stoull(field_of(*nodes_response, "nodes").value_or("0")) > 3000 + 4096) {
+        std::cout << "Node limit ignored: " << *nodes_response << '\n';
+        failures++;
+    }
+
+    for (const std::string_view id: {"bad fen", "bad depth", "unknown"}) {
+        expect_error(lines, id, failures);
+    }
+
+    std::size_t anonymous_errors {0};
+
+    for (const std::string& line: lines) {
+        anonymous_errors += line.starts_with("{\"id\":null,\"error\":") ? 1 : 0;
+    }
+
+    if (anonymous_errors != 2) {
+        std::cout << "Expected errors for the request without id and the broken line, got "
+                  << anonymous_errors << '\n';
+        failures++;
+    }
+
+    const esochess::latency_percentiles latencies {server.latencies()};
+
+    // Every search is timed, the cancelled one unless it was still queued
+    if (latencies.responses < esochess::bench_positions.size() + 2 ||
+        latencies.responses > esochess::bench_positions.size() + 3 ||
+        latencies.p50 > latencies.p90 || latencies.p90 > latencies.p99 ||
+        latencies.p99 > latencies.max || lines.empty() ||
+        !lines.back().starts_with("{\"stats\":{\"responses\":")) {
+        std::cout << "Unexpected latency statistics over " << latencies.responses
+                  << " responses\n";
+        failures++;
+    }
+
+    // A session closed with requests open cancels and answers them
+    {
+        captured_lines abandoned_output {};
+
+        {
+            esochess::analysis_session session {server, abandoned_output.writer()};
+
+            for (int request {}; request < 4; request++) {
+                session.handle_line(R"({"id": "deep)" + std::to_string(request) +
+                                    R"(", "fen": ")" +
+                                    std::string {esochess::bench_positions.at(3)} +
+                                    R"(", "depth": 60})");
+            }
+        }
+
+        if (abandoned_output.snapshot().size() != 4 || server.pending() != 0) {
+            std::cout << "Closing a session left requests unanswered\n";
+            failures++;
+        }
+    }
+
+    if (failures == 0) {
+        std::cout << "All analysis server tests passed\n";
+    }
+
+    return failures;
+}
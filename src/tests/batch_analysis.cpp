@@ -0,0 +1,105 @@
+#include <cstddef>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <headers/batch_analysis.hpp>
+#include <headers/bench.hpp>
+#include <headers/search.hpp>
+
+namespace {
+    std::vector<std::string> lines_of(const std::string& text) {
+        std::istringstream stream {text};
+        std::vector<std::string> lines {};
+
+        for (std::string line {}; std::getline(stream, line);) {
+            lines.push_back(line);
+        }
+
+        return lines;
+    }
+
+    std::string analyse(const std::string& input, std::size_t thread_count, std::size_t window,
+                        esochess::batch_analysis_statistics& statistics) {
+        esochess::search_limits limits {};
+        limits.depth = 3;
+
+        std::istringstream input_stream {input};
+        std::ostringstream output_stream {};
+
+        statistics = esochess::analyse_positions(
+            input_stream, output_stream,
+            esochess::batch_analysis_options {thread_count, 1, limits, window});
+
+        return output_stream.str();
+    }
+} // namespace
+
+int main() {
+    int failures {0};
+    std::string input {};
+
+    // Every position twice, with an EPD line, a blank line and an invalid line mixed in
+    for (int round {}; round < 2; round++) {
+        for (const std::string_view fen: esochess::bench_positions) {
+            input += std::string {fen} + '\n';
+        }
+    }
+
+    input += "6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - bm Ra8#; id \"back rank\";\n\nnot a position\n";
+
+    esochess::batch_analysis_statistics single_thread_statistics {};
+    esochess::batch_analysis_statistics pool_statistics {};
+    const std::string single_thread_output {analyse(input, 1, 1, single_thread_statistics)};
+    const std::string pool_output {analyse(input, 4, 4, pool_statistics)};
+    const std::vector<std::string> lines {lines_of(single_thread_output)};
+    const std::size_t position_count {2 * esochess::bench_positions.size() + 1};
+
+    if (pool_output != single_thread_output) {
+        std::cout << "The worker pool wrote different output than a single thread\n";
+        failures++;
+    }
+
+    if (single_thread_statistics.positions != position_count ||
+        single_thread_statistics.invalid_lines != 1 ||
+        pool_statistics.nodes != single_thread_statistics.nodes ||
+        lines.size() != position_count + 1) {
+        std::cout << "Expected " << position_count << " positions and an invalid line, got "
+                  << single_thread_statistics.positions << " positions, "
+                  << single_thread_statistics.invalid_lines << " invalid lines and "
+                  << lines.size() << " output lines\n";
+        failures++;
+    }
+
+    for (std::size_t index {}; index < lines.size() && index < position_count; index++) {
+        const std::string_view fen {
+            index + 1 == position_count
+                ? "6k1/5ppp/8/8/8/8/5PPP/R5K1 w -"
+                : esochess::bench_positions.at(index % esochess::bench_positions.size())};
+        const std::string_view position_fields {fen.substr(0, fen.find(" - ") + 2)};
+
+        if (!lines.at(index).starts_with(position_fields) ||
+            lines.at(index).find(" bm ") == std::string::npos ||
+            lines.at(index).find(" acd 3;") == std::string::npos) {
+            std::cout << "Line " << index + 1 << " is out of order or incomplete: "
+                      << lines.at(index) << '\n';
+            failures++;
+        }
+    }
+
+    if (lines.size() > position_count &&
+        (!lines.back().starts_with("not a position c0 ") ||
+         lines.at(position_count - 1).find(" bm Ra8#; ce 32766; dm 1;") == std::string::npos)) {
+        std::cout << "Unexpected last lines: " << lines.at(position_count - 1) << " / "
+                  << lines.back() << '\n';
+        failures++;
+    }
+
+    if (failures == 0) {
+        std::cout << "All batch analysis tests passed\n";
+    }
+
+    return failures;
+}
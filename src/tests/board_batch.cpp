@@ -0,0 +1,117 @@
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <headers/bitboard.hpp>
+#include <headers/board_batch.hpp>
+
+#include <tests/move_test_helpers.hpp>
+
+namespace {
+    using esochess::bitboard;
+    using esochess::move_test_helpers::candidate_moves;
+    using esochess::move_test_helpers::keys_of;
+
+    // The perft positions, plus castling against attacked squares and en passant for black
+    const std::vector<std::string_view> starting_positions {
+        esochess::move_test_helpers::perft_positions_and({
+            "r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1",
+            "r3k2r/8/8/8/8/8/6b1/R3K2R w KQkq - 0 1",
+            "4k3/8/8/8/3pP3/8/8/4K3 b - e3 0 1",
+        })};
+
+    constexpr int playout_length {40};
+    constexpr int playouts_per_position {6};
+
+    // The pseudo legal moves found by trying every move of the side to move
+    std::vector<bitboard::move> pseudo_legal_moves(const bitboard& board) {
+        std::vector<bitboard::move> candidates {candidate_moves(board)};
+
+        std::erase_if(candidates, [&board](const bitboard::move& candidate) {
+            return !board.is_pseudo_legal(candidate);
+        });
+
+        return candidates;
+    }
+
+    int check_batch(std::span<const bitboard> boards) {
+        int failures {0};
+        const esochess::board_batch batch {boards};
+        const std::array<std::size_t, esochess::board_batch::width> counts {batch.count_moves()};
+        std::array<std::vector<bitboard::move>, esochess::board_batch::width> moves {};
+
+        moves.back().emplace_back(bitboard::move_normal {1, 2}); // Stale moves are replaced
+        batch.generate_moves(moves);
+
+        for (std::size_t lane {}; lane < esochess::board_batch::width; lane++) {
+            if (lane >= boards.size()) {
+                if (counts.at(lane) != 0 || !moves.at(lane).empty()) {
+                    std::cout << "Lane " << lane << " of a batch of " << boards.size()
+                              << " has moves\n";
+                    failures++;
+                }
+
+                continue;
+            }
+
+            bitboard board {boards [lane].position_copy()};
+            const std::vector<std::uint32_t> keys {keys_of(moves.at(lane))};
+            std::vector<bitboard::move> legal_moves {moves.at(lane)};
+
+            std::erase_if(legal_moves, [&board](const bitboard::move& chess_move) {
+                return !board.leaves_king_safe(chess_move);
+            });
+
+            if (keys != keys_of(pseudo_legal_moves(board))) {
+                std::cout << board.to_fen() << ": the batch generates " << keys.size()
+                          << " moves, not the pseudo legal moves\n";
+                failures++;
+            }
+
+            if (counts.at(lane) != keys.size()) {
+                std::cout << board.to_fen() << ": the batch counts " << counts.at(lane)
+                          << " moves but generates " << keys.size() << '\n';
+                failures++;
+            }
+
+            if (keys_of(legal_moves) != keys_of(board.legal_moves().flatten())) {
+                std::cout << board.to_fen() << ": the safe batch moves are not the legal moves\n";
+                failures++;
+            }
+        }
+
+        return failures;
+    }
+} // namespace
+
+int main() {
+    int failures {0};
+    std::vector<bitboard> positions {};
+
+    esochess::move_test_helpers::for_each_playout_position(
+        starting_positions, playouts_per_position, playout_length, 20240625,
+        [&positions](const bitboard& board) { positions.push_back(board.position_copy()); });
+
+    // Whole batches mix both colours, the partial batches leave lanes empty
+    for (std::size_t first {}; first < positions.size(); first += esochess::board_batch::width) {
+        const std::size_t batch_size {
+            std::min(esochess::board_batch::width, positions.size() - first)};
+
+        failures += check_batch(std::span {positions}.subspan(first, batch_size));
+    }
+
+    for (std::size_t batch_size {}; batch_size < esochess::board_batch::width; batch_size++) {
+        failures += check_batch(std::span {positions}.subspan(batch_size, batch_size));
+    }
+
+    if (failures == 0) {
+        std::cout << "All board batch tests passed (" << positions.size() << " positions)\n";
+    }
+
+    return failures;
+}
@@ -0,0 +1,92 @@
+#include <array>
+#include <iostream>
+#include <optional>
+#include <string_view>
+
+#include <headers/bitboard.hpp>
+
+int main() {
+    static constexpr std::array<std::string_view, 7> valid_positions {
+        esochess::bitboard::starting_position_fen,
+        "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e6 0 2",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "rnbqkb1r/ppp1pppp/5n2/3pP3/8/8/PPPP1PPP/RNBQKBNR w Kq d6 0 3",
+        "rnbqkbnr/p1p1p1p1/1p1p1p1p/1N1N1n1n/n1n1N1N1/P1P1P1P1/1P1P1P1P/RNBQKBNR "
+        "w KQkq - 65535 65535",
+        "4k3/8/8/8/8/8/8/4K2R b K - 17 42"};
+
+    static constexpr std::array<std::string_view, 7> invalid_positions {
+        "", "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP w KQkq - 0 1",
+        "rnbqkbnr/pppppppp/9/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "rnbqkbnr/ppppxppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkx - 0 1",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq e4 0 1",
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 65536 1"};
+
+    int failures {0};
+
+    for (const std::string_view fen_position: valid_positions) {
+        const auto board {esochess::bitboard::from_fen(fen_position)};
+
+        if (!board.has_value()) {
+            std::cout << "Failed to parse " << fen_position << ": " << board.error().to_string()
+                      << '\n';
+            failures++;
+            continue;
+        }
+
+        if (board->to_fen() != fen_position) {
+            std::cout << "Round trip mismatch:\n  " << fen_position << "\n  " << board->to_fen()
+                      << '\n';
+            failures++;
+        }
+    }
+
+    for (const std::string_view fen_position: invalid_positions) {
+        if (esochess::bitboard::from_fen(fen_position).has_value()) {
+            std::cout << "Accepted invalid position " << fen_position << '\n';
+            failures++;
+        }
+    }
+
+    const auto epd_board {esochess::bitboard::from_fen(
+        "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3")};
+
+    if (!epd_board.has_value() || epd_board->halfmove_clock() != 0 ||
+        epd_board->fullmove_number() != 1) {
+        std::cout << "Failed to parse a position without move counters\n";
+        failures++;
+    }
+
+    // Counters the FEN fields cannot hold are clamped to the largest one they can
+    const esochess::bitboard start_board {
+        esochess::bitboard::from_fen(esochess::bitboard::starting_position_fen).value()};
+    const esochess::bitboard long_game {start_board.bitboards(),
+                                        esochess::bitboard::Turn::White,
+                                        start_board.castle_rights(),
+                                        std::nullopt,
+                                        70000,
+                                        -1};
+
+    if (long_game.halfmove_clock() != 65535 || long_game.fullmove_number() != 0) {
+        std::cout << "Failed to clamp the move counters of a constructed position\n";
+        failures++;
+    }
+
+    // EPD operations stand where the move counters would, and only `from_epd` accepts them
+    constexpr std::string_view epd_line {
+        "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 bm e5; id \"open\";"};
+    const auto operations_board {esochess::bitboard::from_epd(epd_line)};
+
+    if (esochess::bitboard::from_fen(epd_line).has_value() || !operations_board.has_value() ||
+        operations_board->to_epd() != "rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3" ||
+        esochess::bitboard::from_epd(valid_positions.back())->to_fen() != valid_positions.back()) {
+        std::cout << "Failed to parse an EPD line with operations\n";
+        failures++;
+    }
+
+    std::cout << (failures == 0 ? "All FEN round trips passed\n" : "FEN round trips failed\n");
+
+    return failures == 0 ? 0 : 1;
+}
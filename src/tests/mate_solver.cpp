@@ -0,0 +1,91 @@
+#include <array>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <headers/bitboard.hpp>
+#include <headers/mate_solver.hpp>
+#include <headers/uci.hpp>
+
+namespace {
+    struct mate_case {
+        std::string_view fen;
+        int moves_limit;
+        std::optional<int> mate_in; // Empty when there is no mate within the limit
+        std::string_view first_move;
+    };
+
+    // A back rank mate, a queen and a rook ending, a combination and two positions without a
+    // forced mate
+    constexpr std::array<mate_case, 6> mate_cases {
+        {{"6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1", 3, 1, "a1a8"},
+         {"7k/8/6K1/8/8/8/8/6Q1 w - - 0 1", 3, 2, ""},
+         {"2k5/8/8/2K5/8/8/8/7R w - - 0 1", 4, 3, ""},
+         {"r2qkb1r/pp2nppp/3p4/2pNN1B1/2BnP3/3P4/PPP2PPP/R2bK2R w KQkq - 1 1", 3, 2, "d5f6"},
+         {"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 2, std::nullopt, ""},
+         {"7k/8/6K1/8/8/8/8/8 w - - 0 1", 3, std::nullopt, ""}}
+    };
+} // namespace
+
+int main() {
+    int failures {0};
+    esochess::mate_solver solver {16};
+
+    for (const mate_case& test_case: mate_cases) {
+        const esochess::bitboard board {esochess::bitboard::from_fen(test_case.fen).value()};
+        const esochess::mate_solution solution {
+            solver.solve(board, esochess::mate_solver_limits {test_case.moves_limit, {}, {}})};
+        const std::string first_move {solution.principal_variation.empty()
+                                          ? "0000"
+                                          : esochess::move_to_uci(
+                                                solution.principal_variation.front())};
+
+        if (solution.mate_in != test_case.mate_in ||
+            solution.disproven == test_case.mate_in.has_value() ||
+            (solution.mate_in.has_value() &&
+             solution.principal_variation.size() !=
+                 static_cast<std::size_t>(2 * *solution.mate_in - 1)) ||
+            (!test_case.first_move.empty() && first_move != test_case.first_move)) {
+            std::cout << test_case.fen << ": expected "
+                      << (test_case.mate_in.has_value() ? "mate in " +
+                                                              std::to_string(*test_case.mate_in)
+                                                        : std::string {"no mate"})
+                      << ", got "
+                      << (solution.mate_in.has_value() ? "mate in " +
+                                                             std::to_string(*solution.mate_in)
+                                                       : std::string {"no mate"})
+                      << " starting " << first_move << '\n';
+            failures++;
+        }
+    }
+
+    // A table filled from other roots gives the answers of an empty one. Disproofs through a
+    // repetition of one path must not be reused where the path differs.
+    for (const std::string_view fen:
+         {"2k5/8/8/2K5/8/8/8/7R w - - 0 1", "7k/8/6K1/8/8/8/8/6Q1 w - - 0 1"}) {
+        const esochess::bitboard root {esochess::bitboard::from_fen(fen).value()};
+
+        for (const esochess::bitboard::move& attacker_move: root.all_legal_moves()) {
+            const esochess::bitboard after_attacker {root.after_move(attacker_move)};
+
+            for (const esochess::bitboard::move& defender_move: after_attacker.all_legal_moves()) {
+                const esochess::bitboard position {after_attacker.after_move(defender_move)};
+                const esochess::mate_solver_limits limits {3, {}, {}};
+                esochess::mate_solver fresh_solver {1};
+
+                if (solver.solve(position, limits).mate_in !=
+                    fresh_solver.solve(position, limits).mate_in) {
+                    std::cout << position.to_fen() << ": the shared table changed the answer\n";
+                    failures++;
+                }
+            }
+        }
+    }
+
+    if (failures == 0) {
+        std::cout << "All mate solver tests passed\n";
+    }
+
+    return failures;
+}
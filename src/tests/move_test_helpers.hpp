@@ -0,0 +1,123 @@
+#ifndef ESOCHESS_MOVE_TEST_HELPERS_HPP
+#define ESOCHESS_MOVE_TEST_HELPERS_HPP
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <random>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include <headers/attacks.hpp>
+#include <headers/bitboard.hpp>
+#include <headers/search.hpp>
+
+// Shared by the tests that compare move generators over random playouts
+namespace esochess::move_test_helpers {
+    constexpr std::array<std::string_view, 5> perft_positions {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8"};
+
+    // The perft positions followed by the positions a test adds
+    inline std::vector<std::string_view>
+        perft_positions_and(std::initializer_list<std::string_view> extra_positions) {
+        std::vector<std::string_view> positions {perft_positions.begin(), perft_positions.end()};
+
+        positions.insert(positions.end(), extra_positions.begin(), extra_positions.end());
+
+        return positions;
+    }
+
+    // Tells the move types apart, since castling and a king's step share their squares
+    inline std::uint32_t move_key(const bitboard::move& chess_move) {
+        return encode_move(chess_move) | (static_cast<std::uint32_t>(chess_move.index()) << 16U);
+    }
+
+    inline std::vector<std::uint32_t> keys_of(const std::vector<bitboard::move>& moves) {
+        std::vector<std::uint32_t> keys {};
+
+        for (const bitboard::move& chess_move: moves) {
+            keys.push_back(move_key(chess_move));
+        }
+
+        std::ranges::sort(keys);
+
+        return keys;
+    }
+
+    // Every move of the side to move from one of its pieces, most of them nonsense
+    inline std::vector<bitboard::move> candidate_moves(const bitboard& board) {
+        std::vector<bitboard::move> candidates {};
+
+        for (int start_square {}; start_square < 64; start_square++) {
+            const bitboard::bit_representation start {square_bits(start_square)};
+
+            if (board.color_at_square(start) != board.turn()) {
+                continue;
+            }
+
+            for (int end_square {}; end_square < 64; end_square++) {
+                candidates.emplace_back(bitboard::move_normal {start, square_bits(end_square)});
+            }
+
+            for (const bitboard::Direction direction: bitboard::pieces::all_directions) {
+                for (const bitboard::piece& promotion_piece:
+                     bitboard::pieces::white_pawn_promotion_pieces) {
+                    candidates.emplace_back(
+                        bitboard::move_promotion {start, promotion_piece.piece_type, direction});
+                }
+            }
+        }
+
+        if (board.en_passant().has_value()) {
+            for (const bitboard::Direction direction: bitboard::pieces::all_directions) {
+                candidates.emplace_back(bitboard::move_en_passant {*board.en_passant(), direction});
+            }
+        }
+
+        for (const bitboard::Turn turn: {bitboard::Turn::White, bitboard::Turn::Black}) {
+            for (const bitboard::CastleType castle_type:
+                 {bitboard::CastleType::KingSide, bitboard::CastleType::QueenSide}) {
+                candidates.emplace_back(bitboard::move_castle {turn, castle_type});
+            }
+        }
+
+        return candidates;
+    }
+
+    // Calls `visit` on every position of `playouts_per_position` random games of up to
+    // `playout_length` plies from each of `fens`, the same games for the same seed
+    template <typename Visitor>
+    void for_each_playout_position(std::span<const std::string_view> fens,
+                                   int playouts_per_position, int playout_length,
+                                   std::uint64_t seed, Visitor visit) {
+        std::mt19937_64 random_engine {seed};
+
+        for (const std::string_view fen: fens) {
+            for (int playout {}; playout < playouts_per_position; playout++) {
+                bitboard board {bitboard::from_fen(fen).value()};
+
+                for (int ply {}; ply < playout_length; ply++) {
+                    visit(board);
+
+                    const std::vector<bitboard::move> moves {board.legal_moves().flatten()};
+
+                    if (moves.empty()) {
+                        break;
+                    }
+
+                    board = board.position_copy();
+                    board.make_move(moves.at(random_engine() % moves.size()));
+                }
+            }
+        }
+    }
+} // namespace esochess::move_test_helpers
+
+#endif
@@ -0,0 +1,129 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include <headers/bitboard.hpp>
+#include <headers/polyglot_book.hpp>
+#include <headers/uci.hpp>
+
+#include <tests/move_test_helpers.hpp>
+
+namespace {
+    using esochess::bitboard;
+    using esochess::move_test_helpers::candidate_moves;
+    using esochess::move_test_helpers::keys_of;
+    using esochess::move_test_helpers::move_key;
+
+    // The perft positions, plus pins, a double check and an en passant capture along a rank
+    const std::vector<std::string_view> starting_positions {
+        esochess::move_test_helpers::perft_positions_and({
+            "4k3/8/8/8/1b6/2N5/3K4/8 w - - 0 1",
+            "4k3/8/8/8/4r3/5n2/8/4K3 w - - 0 1",
+            "8/8/8/K2pP2r/8/8/8/7k w - d6 0 1",
+            "r3k2r/8/8/8/8/8/8/R3K2R b KQkq - 0 1",
+        })};
+
+    constexpr int playout_length {40};
+    constexpr int playouts_per_position {10};
+
+    int check_position(bitboard& board) {
+        int failures {0};
+        const std::vector<bitboard::move> legal_moves {board.legal_moves().flatten()};
+        const std::vector<std::uint32_t> legal_keys {keys_of(legal_moves)};
+
+        const auto fail {[&board, &failures](const bitboard::move& chess_move,
+                                             std::string_view reason) {
+            std::cout << board.to_fen() << ": " << esochess::move_to_uci(chess_move) << ' '
+                      << reason << '\n';
+            failures++;
+        }};
+
+        for (const bitboard::move& chess_move: legal_moves) {
+            bitboard board_after_move {board.position_copy()};
+
+            board_after_move.make_move(chess_move);
+
+            if (board.gives_check(chess_move) != board_after_move.is_in_check()) {
+                fail(chess_move, "gives_check differs from playing the move");
+            }
+
+            const std::optional<bitboard::move> parsed_move {
+                esochess::move_from_uci(board, esochess::move_to_uci(chess_move))};
+            const std::optional<bitboard::move> book_move {
+                esochess::move_from_polyglot_move(board, esochess::polyglot_move(chess_move))};
+
+            if (!parsed_move.has_value() || move_key(*parsed_move) != move_key(chess_move)) {
+                fail(chess_move, "does not survive move_from_uci");
+            }
+
+            if (!book_move.has_value() || move_key(*book_move) != move_key(chess_move)) {
+                fail(chess_move, "does not survive move_from_polyglot_move");
+            }
+        }
+
+        std::size_t legal_candidates {0};
+
+        for (const bitboard::move& candidate: candidate_moves(board)) {
+            const bool is_legal {board.is_legal(candidate)};
+            const bool is_pseudo_legal {board.is_pseudo_legal(candidate)};
+
+            legal_candidates += is_legal ? 1 : 0;
+
+            if (is_legal && !std::ranges::binary_search(legal_keys, move_key(candidate))) {
+                fail(candidate, "is_legal accepts a move that is not generated");
+            }
+
+            if (is_pseudo_legal && is_legal != board.leaves_king_safe(candidate)) {
+                fail(candidate, "is_legal differs from playing the move");
+            }
+
+            if (is_legal && !is_pseudo_legal) {
+                fail(candidate, "is legal but not pseudo legal");
+            }
+        }
+
+        // Every legal move is among the candidates, so the counts agree when none is missed
+        if (legal_candidates != legal_moves.size()) {
+            std::cout << board.to_fen() << ": is_legal accepts " << legal_candidates << " of "
+                      << legal_moves.size() << " legal moves\n";
+            failures++;
+        }
+
+        if (board.has_legal_move() == legal_moves.empty()) {
+            std::cout << board.to_fen() << ": has_legal_move differs from the generated moves\n";
+            failures++;
+        }
+
+        return failures;
+    }
+} // namespace
+
+int main() {
+    int failures {0};
+    std::size_t positions {0};
+
+    esochess::move_test_helpers::for_each_playout_position(
+        starting_positions, playouts_per_position, playout_length, 20240615,
+        [&failures, &positions](bitboard& board) {
+            positions++;
+            failures += check_position(board);
+        });
+
+    const bitboard start_position {bitboard::from_fen(bitboard::starting_position_fen).value()};
+
+    for (const std::string_view invalid_move: {"e2e5", "e7e5", "e2e4q", "e1g1", "a1a2", "z9e4"}) {
+        if (esochess::move_from_uci(start_position, invalid_move).has_value()) {
+            std::cout << invalid_move << " is accepted in the starting position\n";
+            failures++;
+        }
+    }
+
+    if (failures == 0) {
+        std::cout << "All move validation tests passed (" << positions << " positions)\n";
+    }
+
+    return failures;
+}
@@ -0,0 +1,98 @@
+#include <array>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include <headers/bitboard.hpp>
+#include <headers/packed_position.hpp>
+
+int main() {
+    static constexpr std::array<std::string_view, 5> positions {
+        esochess::bitboard::starting_position_fen,
+        "rnbqkbnr/pppp1ppp/8/4p3/4P3/8/PPPP1PPP/RNBQKBNR w KQkq e6 0 2",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b Qk e3 0 3",
+        "4k3/8/8/8/8/8/8/4K2R b K - 17 42"};
+
+    const std::string dataset_path {"/tmp/esochess_packed_position_round_trip.bin"};
+    int failures {0};
+
+    {
+        auto writer {esochess::position_dataset_writer::create(dataset_path).value()};
+
+        for (const std::string_view fen_position: positions) {
+            const esochess::bitboard board {esochess::bitboard::from_fen(fen_position).value()};
+            const auto packed {esochess::packed_position::from_bitboard(board)};
+
+            if (!packed.has_value() || !packed->to_bitboard().has_value() ||
+                packed->to_bitboard()->to_fen() != fen_position) {
+                std::cout << "Pack round trip mismatch for " << fen_position << '\n';
+                failures++;
+            }
+
+            writer.write(board);
+        }
+    }
+
+    const auto reader {esochess::position_dataset_reader::open(dataset_path)};
+
+    if (!reader.has_value() || reader->size() != positions.size()) {
+        std::cout << "Failed to read back the dataset\n";
+        failures++;
+    }
+
+    else {
+        for (std::size_t index {}; index < positions.size(); index++) {
+            const auto board {reader->positions() [index].to_bitboard()};
+
+            if (!board.has_value() || board->to_fen() != positions.at(index)) {
+                std::cout << "Dataset mismatch for " << positions.at(index) << '\n';
+                failures++;
+            }
+        }
+    }
+
+    // Corrupt piece codes, piece counts and en passant files are refused rather than unpacked
+    const esochess::packed_position start_position {
+        esochess::packed_position::from_bitboard(
+            esochess::bitboard::from_fen(esochess::bitboard::starting_position_fen).value())
+            .value()};
+    std::array<esochess::packed_position, 3> corrupt_positions {start_position, start_position,
+                                                                start_position};
+
+    corrupt_positions [0].piece_codes [3] = 0xfc;
+    corrupt_positions [1].occupancy = ~esochess::bitboard::bit_representation {0};
+    corrupt_positions [2].en_passant_file = 9;
+
+    for (const esochess::packed_position& corrupt_position: corrupt_positions) {
+        if (corrupt_position.to_bitboard().has_value()) {
+            std::cout << "A corrupt packed position was unpacked\n";
+            failures++;
+        }
+    }
+
+    // Assigning over a writer finishes the dataset it was writing
+    {
+        auto writer {esochess::position_dataset_writer::create(dataset_path).value()};
+
+        writer.write(start_position);
+        writer.write(start_position);
+        writer = esochess::position_dataset_writer::create(dataset_path + ".next").value();
+
+        const auto finished {esochess::position_dataset_reader::open(dataset_path)};
+
+        if (!finished.has_value() || finished->size() != 2) {
+            std::cout << "Assigning over a writer left its dataset unfinished\n";
+            failures++;
+        }
+    }
+
+    std::remove((dataset_path + ".next").c_str());
+    std::remove(dataset_path.c_str());
+
+    std::cout << (failures == 0 ? "All packed position round trips passed\n"
+                                : "Packed position round trips failed\n");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,60 @@
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include <headers/bitboard.hpp>
+#include <headers/perft.hpp>
+
+namespace {
+    struct perft_case {
+        std::string_view fen;
+        int depth;
+        std::uint64_t nodes;
+    };
+
+    // Positions from the Chess Programming Wiki perft results page
+    constexpr std::array<perft_case, 5> perft_cases {
+        {{"rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1", 3, 8902},
+         {"r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 2, 2039},
+         {"8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 4, 43238},
+         {"r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 3, 9467},
+         {"rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 2, 1486}}
+    };
+} // namespace
+
+int main() {
+    int failures {0};
+    esochess::perft_table table {1};
+
+    for (const perft_case& test_case: perft_cases) {
+        const esochess::bitboard board {esochess::bitboard::from_fen(test_case.fen).value()};
+
+        const std::uint64_t serial_nodes {esochess::perft(board, test_case.depth)};
+        const std::uint64_t hashed_nodes {esochess::perft(board, test_case.depth, &table)};
+        const std::uint64_t rehashed_nodes {esochess::perft(board, test_case.depth, &table)};
+
+        std::uint64_t divided_nodes {0};
+
+        for (const esochess::perft_divide_entry& entry:
+             esochess::perft_divide(board, test_case.depth, 3, &table)) {
+            divided_nodes += entry.nodes;
+        }
+
+        if (serial_nodes != test_case.nodes || hashed_nodes != test_case.nodes ||
+            rehashed_nodes != test_case.nodes || divided_nodes != test_case.nodes) {
+            std::cout << test_case.fen << " at depth " << test_case.depth << ": expected "
+                      << test_case.nodes << ", got " << serial_nodes << " serial, " << hashed_nodes
+                      << " hashed, " << rehashed_nodes << " from the table and " << divided_nodes
+                      << " divided\n";
+            failures++;
+        }
+    }
+
+    if (failures == 0) {
+        std::cout << "All perft tests passed\n";
+    }
+
+    return failures;
+}
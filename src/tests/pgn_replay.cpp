@@ -0,0 +1,65 @@
+#include <array>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <headers/bitboard.hpp>
+#include <headers/pgn.hpp>
+
+int main() {
+    static constexpr std::string_view pgn_text {
+        "[Event \"Opera game\"]\n"
+        "[Result \"1-0\"]\n"
+        "\n"
+        "1. e4 e5 2. Nf3 d6 3. d4 Bg4 {A dubious pin} 4. dxe5 Bxf3 5. Qxf3 dxe5 6. Bc4 Nf6\n"
+        "7. Qb3 Qe7 8. Nc3 c6 9. Bg5 b5 (9... Qb4 10. Qxb4) 10. Nxb5 cxb5 11. Bxb5+ Nbd7\n"
+        "12. O-O-O Rd8 13. Rxd7 Rxd7 14. Rd1 Qe6 15. Bxd7+ Nxd7 16. Qb8+ $1 Nxb8 17. Rd8# 1-0\n"
+        "\n"
+        "[Event \"En passant and promotion\"]\n"
+        "[SetUp \"1\"]\n"
+        "[FEN \"4k3/1P6/8/8/5p2/8/4P3/4K3 w - - 0 1\"]\n"
+        "[Result \"*\"]\n"
+        "\n"
+        "1. e4 fxe3 2. b8=Q+ Kd7 3. Qb5+ *\n"};
+
+    static constexpr std::array<std::pair<std::string_view, std::string_view>, 2> expected_games {
+        {{"Opera game", "1n1Rkb1r/p4ppp/4q3/4p1B1/4P3/8/PPP2PPP/2K5 b k - 1 17"},
+         {"En passant and promotion", "8/3k4/8/1Q6/8/4p3/8/4K3 b - - 2 3"}}
+    };
+
+    std::array<std::string, 2> final_positions {};
+    std::size_t game_index {0};
+
+    const esochess::pgn_ingest_statistics statistics {esochess::replay_pgn_games(
+        pgn_text, 0, [&](const esochess::pgn_move_visit& visit) {
+            if (visit.position_before.fullmove_number() == 1 &&
+                visit.position_before.turn() == esochess::bitboard::Turn::White &&
+                !final_positions.at(game_index).empty()) {
+                game_index++;
+            }
+
+            final_positions.at(game_index) = visit.position_after.to_fen();
+        })};
+
+    int failures {0};
+
+    if (statistics.games != 2 || statistics.moves != 38 || statistics.unresolved_games != 0) {
+        std::cout << "Unexpected statistics: " << statistics.games << " games, "
+                  << statistics.moves << " moves, " << statistics.unresolved_games
+                  << " unresolved games\n";
+        failures++;
+    }
+
+    for (std::size_t index {}; index < expected_games.size(); index++) {
+        if (final_positions.at(index) != expected_games.at(index).second) {
+            std::cout << expected_games.at(index).first << " ended in " << final_positions.at(index)
+                      << ", expected " << expected_games.at(index).second << '\n';
+            failures++;
+        }
+    }
+
+    std::cout << (failures == 0 ? "All PGN replays passed\n" : "PGN replays failed\n");
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,141 @@
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <headers/bitboard.hpp>
+#include <headers/polyglot_book.hpp>
+#include <headers/san.hpp>
+
+int main() {
+    static constexpr std::string_view pgn_text {
+        "[Result \"1-0\"]\n\n1. e4 e5 2. Nf3 Nc6 3. Bb5 a6 1-0\n\n"
+        "[Result \"1/2-1/2\"]\n\n1. e4 c5 2. Nf3 d6 1/2-1/2\n\n"
+        "[Result \"0-1\"]\n\n1. d4 d5 2. c4 e6 0-1\n\n"
+        "[Result \"1-0\"]\n\n1. e4 e5 2. Nf3 Nf6 3. O-O-O 1-0\n\n"
+        "[FEN \"r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1\"]\n[Result \"1-0\"]\n\n1. O-O O-O-O 1-0\n"};
+    static const std::string book_path {"/tmp/esochess_polyglot_test.bin"};
+
+    int failures {0};
+
+    esochess::polyglot_book_builder builder {{4, 1}};
+    const esochess::pgn_ingest_statistics statistics {builder.add_games(pgn_text)};
+
+    if (statistics.games != 5 || statistics.unresolved_games != 1) {
+        std::cout << "Unexpected statistics: " << statistics.games << " games, "
+                  << statistics.unresolved_games << " unresolved\n";
+        failures++;
+    }
+
+    if (const std::error_code error {builder.write(book_path)}) {
+        std::cout << "Could not write the book: " << error.message() << '\n';
+        return 1;
+    }
+
+    const auto book {esochess::polyglot_book::open(book_path)};
+
+    if (!book.has_value()) {
+        std::cout << "Could not open the book: " << book.error().message() << '\n';
+        return 1;
+    }
+
+    esochess::bitboard board {
+        esochess::bitboard::from_fen(esochess::bitboard::starting_position_fen).value()};
+    const std::vector<esochess::polyglot_entry> entries {book->probe(board)};
+    std::vector<std::string> moves {};
+
+    for (const esochess::polyglot_entry& entry: entries) {
+        const std::optional<esochess::bitboard::move> book_move {
+            esochess::move_from_polyglot_move(board, entry.move)};
+        moves.push_back(book_move.has_value() ? esochess::move_to_san(board, *book_move) : "?");
+    }
+
+    // e4 scores 5 points over 3 games, d4 none over 1
+    if (moves != std::vector<std::string> {"e4", "d4"} || entries.at(0).weight != 5 ||
+        entries.at(1).weight != 0) {
+        std::cout << "Unexpected start position entries:";
+
+        for (const std::string& book_move: moves) {
+            std::cout << ' ' << book_move;
+        }
+
+        std::cout << '\n';
+        failures++;
+    }
+
+    std::mt19937_64 random_engine {1};
+    const std::optional<esochess::bitboard::move> picked_move {
+        book->pick_move(board, random_engine)};
+
+    if (!picked_move.has_value() || esochess::move_to_san(board, *picked_move) != "e4") {
+        std::cout << "Weighted pick did not choose e4\n";
+        failures++;
+    }
+
+    esochess::bitboard castle_board {
+        esochess::bitboard::from_fen("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1").value()};
+    const std::vector<esochess::polyglot_entry> castle_entries {book->probe(castle_board)};
+
+    // Castling is stored as the king moving onto its rook, e1h1
+    if (castle_entries.size() != 1 || castle_entries.at(0).move != ((4U << 6U) | 7U)) {
+        std::cout << "Unexpected castling entry\n";
+        failures++;
+    }
+
+    // Plies past the limit and positions missing the side to move's en passant capture
+    const esochess::bitboard after_e4 {
+        esochess::bitboard::from_fen("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1")
+            .value()};
+    const esochess::bitboard after_e4_without_en_passant {
+        esochess::bitboard::from_fen("rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1")
+            .value()};
+
+    if (esochess::polyglot_key(after_e4) != esochess::polyglot_key(after_e4_without_en_passant)) {
+        std::cout << "Uncapturable en passant squares changed the key\n";
+        failures++;
+    }
+
+    // Keys from the Polyglot book format description, covering castle rights and en passant
+    const std::vector<std::pair<std::string_view, std::uint64_t>> published_keys {
+        {esochess::bitboard::starting_position_fen, 0x463b96181691fc9c},
+        {"rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 1", 0x823c9b50fd114196},
+        {"rnbqkbnr/ppp1pppp/8/3p4/4P3/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 2", 0x0756b94461c50fb0},
+        {"rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 2", 0x662fafb965db29d4},
+        {"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3", 0x22a48b5a8e47ff78},
+        {"rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR b kq - 0 3", 0x652a607ca3f242c1},
+        {"rnbq1bnr/ppp1pkpp/8/3pPp2/8/8/PPPPKPPP/RNBQ1BNR w - - 0 4", 0x00fdd303c946bdd9},
+        {"rnbqkbnr/p1pppppp/8/8/PpP4P/8/1P1PPPP1/RNBQKBNR b KQkq c3 0 3", 0x3c8123ea7b067637},
+        {"rnbqkbnr/p1pppppp/8/8/P6P/R1p5/1P1PPPP1/1NBQKBNR b Kkq - 0 4", 0x5c3f9b829b279560}};
+
+    for (const auto& [fen, expected_key]: published_keys) {
+        const std::uint64_t key {
+            esochess::polyglot_key(esochess::bitboard::from_fen(fen).value())};
+
+        if (key != expected_key) {
+            std::cout << "Unexpected key " << std::hex << key << std::dec << " for " << fen
+                      << '\n';
+            failures++;
+        }
+    }
+
+    esochess::bitboard ply_board {
+        esochess::bitboard::from_fen(
+            "r1bqkbnr/pppp1ppp/2n5/4p3/4P3/5N2/PPPP1PPP/RNBQKB1R w KQkq - 2 3")
+            .value()};
+
+    if (!book->probe(ply_board).empty()) {
+        std::cout << "Moves past the ply limit were recorded\n";
+        failures++;
+    }
+
+    if (failures == 0) {
+        std::cout << "All polyglot book tests passed\n";
+    }
+
+    return failures;
+}
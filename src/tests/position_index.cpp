@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <iostream>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#include <headers/bitboard.hpp>
+#include <headers/position_index.hpp>
+
+namespace {
+    constexpr std::size_t key_count {200000};
+    constexpr std::size_t thread_count {4};
+
+    // Half of the keys repeat an earlier one, and 0 is among them
+    std::vector<std::uint64_t> random_keys() {
+        std::mt19937_64 random_engine {20240801};
+        std::vector<std::uint64_t> keys {0};
+
+        while (keys.size() < key_count) {
+            keys.push_back(random_engine() % 2 == 0 ? random_engine()
+                                                    : keys.at(random_engine() % keys.size()));
+        }
+
+        return keys;
+    }
+} // namespace
+
+int main() {
+    int failures {0};
+    const std::vector<std::uint64_t> keys {random_keys()};
+    const std::unordered_set<std::uint64_t> distinct_keys {keys.begin(), keys.end()};
+
+    {
+        esochess::position_key_set key_set {};
+        std::unordered_set<std::uint64_t> seen {};
+
+        for (const std::uint64_t key: keys) {
+            if (key_set.insert(key) != seen.insert(key).second) {
+                std::cout << "position_key_set::insert disagrees for key " << key << '\n';
+                failures++;
+                break;
+            }
+        }
+
+        const std::vector<std::uint64_t> sorted {key_set.sorted_keys()};
+
+        if (key_set.size() != distinct_keys.size() || sorted.size() != distinct_keys.size() ||
+            !std::ranges::is_sorted(sorted) || !key_set.contains(0) ||
+            key_set.contains(sorted.back() + 1) ||
+            key_set.memory_bytes() > 4 * distinct_keys.size() * sizeof(std::uint64_t)) {
+            std::cout << "position_key_set holds " << key_set.size() << " keys in "
+                      << key_set.memory_bytes() << " bytes, expected " << distinct_keys.size()
+                      << " keys\n";
+            failures++;
+        }
+    }
+
+    // Positions differing only in their move counters share a key
+    if (esochess::bitboard::from_fen("4k3/8/8/8/8/8/8/4K2R w K - 0 1")->hash() !=
+        esochess::bitboard::from_fen("4k3/8/8/8/8/8/8/4K2R w K - 12 40")->hash()) {
+        std::cout << "Move counters change the position key\n";
+        failures++;
+    }
+
+    const std::filesystem::path spill_directory {std::filesystem::temp_directory_path() /
+                                                 "esochess_position_index_test"};
+
+    std::filesystem::remove_all(spill_directory);
+    std::filesystem::create_directories(spill_directory);
+
+    {
+        // Little enough memory that every shard spills and merges its runs
+        auto index {esochess::position_index::create(esochess::position_index_options {
+            8, 64 * 1024, spill_directory})};
+
+        if (!index.has_value()) {
+            std::cout << "Could not create a position index: " << index.error().message() << '\n';
+            return failures + 1;
+        }
+
+        std::atomic<std::uint64_t> first_insertions {0};
+        std::atomic<int> insertion_errors {0};
+
+        {
+            std::vector<std::jthread> workers {};
+
+            for (std::size_t worker {}; worker < thread_count; worker++) {
+                workers.emplace_back([&, worker]() {
+                    for (std::size_t item {worker}; item < keys.size(); item += thread_count) {
+                        const auto inserted {index->insert(keys.at(item))};
+
+                        insertion_errors += inserted.has_value() ? 0 : 1;
+                        first_insertions += inserted.value_or(false) ? 1 : 0;
+                    }
+                });
+            }
+        }
+
+        const esochess::position_index_statistics statistics {index->statistics()};
+
+        if (insertion_errors != 0 || first_insertions != distinct_keys.size() ||
+            statistics.keys != distinct_keys.size() || statistics.spilled_keys == 0 ||
+            statistics.spill_runs >
+                index->shard_count() * esochess::position_index::runs_per_merge) {
+            std::cout << "Sharded index counted " << first_insertions << " first insertions and "
+                      << statistics.keys << " keys, " << statistics.spilled_keys
+                      << " spilled in " << statistics.spill_runs << " runs, expected "
+                      << distinct_keys.size() << " keys\n";
+            failures++;
+        }
+
+        const std::size_t missing {static_cast<std::size_t>(std::ranges::count_if(
+            distinct_keys, [&index](std::uint64_t key) { return !index->contains(key); }))};
+
+        if (missing != 0 || index->contains(0x0123456789ABCDEFULL)) {
+            std::cout << missing << " keys missing from the sharded index\n";
+            failures++;
+        }
+
+        for (const std::uint64_t key: keys) {
+            if (index->insert(key).value_or(true)) {
+                std::cout << "Key " << key << " inserted twice\n";
+                failures++;
+                break;
+            }
+        }
+
+        if (std::filesystem::is_empty(spill_directory)) {
+            std::cout << "Nothing was spilled to " << spill_directory << '\n';
+            failures++;
+        }
+    }
+
+    {
+        // One small shard spills over a hundred runs, which merge through three tiers
+        auto index {esochess::position_index::create(
+            esochess::position_index_options {1, 16 * 1024, spill_directory})};
+
+        if (!index.has_value()) {
+            std::cout << "Could not create a position index: " << index.error().message() << '\n';
+            return failures + 1;
+        }
+
+        for (const std::uint64_t key: keys) {
+            if (!index->insert(key).has_value()) {
+                std::cout << "Could not insert into the single shard index\n";
+                failures++;
+                break;
+            }
+        }
+
+        const esochess::position_index_statistics statistics {index->statistics()};
+        const std::size_t spills {static_cast<std::size_t>(statistics.spilled_keys) /
+                                  (esochess::position_key_set::initial_slots * 3 / 4)};
+
+        if (statistics.keys != distinct_keys.size() ||
+            spills < esochess::position_index::runs_per_merge *
+                         esochess::position_index::runs_per_merge ||
+            statistics.spill_runs >= 3 * (esochess::position_index::runs_per_merge - 1) ||
+            !std::ranges::all_of(distinct_keys,
+                                 [&index](std::uint64_t key) { return index->contains(key); })) {
+            std::cout << "Single shard index kept " << statistics.keys << " keys in "
+                      << statistics.spill_runs << " runs after about " << spills << " spills\n";
+            failures++;
+        }
+    }
+
+    if (!std::filesystem::is_empty(spill_directory)) {
+        std::cout << "Spilled runs were not cleaned up\n";
+        failures++;
+    }
+
+    std::filesystem::remove_all(spill_directory);
+
+    if (failures == 0) {
+        std::cout << "All position index tests passed (" << distinct_keys.size()
+                  << " distinct keys)\n";
+    }
+
+    return failures;
+}
@@ -0,0 +1,82 @@
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include <headers/bitboard.hpp>
+#include <headers/move_generation.hpp>
+#include <headers/search.hpp>
+
+#include <tests/move_test_helpers.hpp>
+
+namespace {
+    // The perft positions, plus discovered checks by a pawn, a knight and the king
+    const std::vector<std::string_view> starting_positions {
+        esochess::move_test_helpers::perft_positions_and({
+            "7k/8/8/8/8/8/1P6/B6K w - - 0 1",
+            "7k/8/8/4N3/8/8/1B6/K7 w - - 0 1",
+            "k7/8/8/8/K7/8/8/R7 w - - 0 1",
+        })};
+
+    constexpr int playout_length {40};
+    constexpr int playouts_per_position {25};
+
+    // Every legal move to an empty square that checks, except promotions and castling
+    std::vector<std::uint16_t> checks_by_filtering(esochess::bitboard& board) {
+        std::vector<std::uint16_t> checks {};
+
+        for (const esochess::bitboard::move_normal& chess_move: board.legal_moves().normal_moves) {
+            esochess::bitboard board_after_move {board.position_copy()};
+
+            if (board.color_at_square(chess_move.end) == esochess::bitboard::Turn::None &&
+                board_after_move.make_move(chess_move).is_in_check()) {
+                checks.push_back(esochess::encode_move(chess_move));
+            }
+        }
+
+        std::ranges::sort(checks);
+
+        return checks;
+    }
+
+    std::vector<std::uint16_t> checks_by_generation(const esochess::bitboard& board) {
+        esochess::bitboard::moves_listing moves {};
+        std::vector<std::uint16_t> checks {};
+
+        esochess::add_quiet_check_moves(board, moves);
+
+        for (const esochess::bitboard::move_normal& chess_move: moves.normal_moves) {
+            if (board.leaves_king_safe(chess_move)) {
+                checks.push_back(esochess::encode_move(chess_move));
+            }
+        }
+
+        std::ranges::sort(checks);
+
+        return checks;
+    }
+} // namespace
+
+int main() {
+    int failures {0};
+    std::size_t positions {0};
+
+    esochess::move_test_helpers::for_each_playout_position(
+        starting_positions, playouts_per_position, playout_length, 20240601,
+        [&failures, &positions](esochess::bitboard& board) {
+            positions++;
+
+            if (checks_by_filtering(board) != checks_by_generation(board)) {
+                std::cout << board.to_fen() << ": the generated quiet checks differ\n";
+                failures++;
+            }
+        });
+
+    if (failures == 0) {
+        std::cout << "All quiet check tests passed (" << positions << " positions)\n";
+    }
+
+    return failures;
+}
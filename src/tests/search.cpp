@@ -0,0 +1,130 @@
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <sstream>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <headers/bench.hpp>
+#include <headers/bitboard.hpp>
+#include <headers/search.hpp>
+#include <headers/uci.hpp>
+
+namespace {
+    struct best_move_case {
+        std::string_view fen;
+        int depth;
+        std::string_view best_move;
+    };
+
+    // A back rank mate, the scholar's mate, the only legal move and a promotion
+    constexpr std::array<best_move_case, 4> best_move_cases {
+        {{"6k1/5ppp/8/8/8/8/5PPP/R5K1 w - - 0 1", 3, "a1a8"},
+         {"r1bqkb1r/pppp1ppp/2n2n2/4p2Q/2B1P3/8/PPPP1PPP/RNB1K1NR w KQkq - 4 4", 3, "h5f7"},
+         {"4k3/8/8/8/8/8/4q3/4K3 w - - 0 1", 2, "e1e2"},
+         {"7k/P7/8/8/8/8/8/K7 w - - 0 1", 3, "a7a8q"}}
+    };
+} // namespace
+
+int main() {
+    int failures {0};
+    esochess::search_engine engine {1};
+
+    for (const best_move_case& test_case: best_move_cases) {
+        esochess::bitboard board {esochess::bitboard::from_fen(test_case.fen).value()};
+        esochess::search_limits limits {};
+
+        limits.depth = test_case.depth;
+        engine.clear();
+
+        const esochess::search_result result {engine.search(board, {}, limits)};
+        const std::string_view expected_move {test_case.best_move};
+
+        if (!result.best_move.has_value() ||
+            esochess::move_to_uci(*result.best_move) != expected_move ||
+            esochess::move_from_uci(board, expected_move) == std::nullopt) {
+            std::cout << test_case.fen << ": expected " << expected_move << ", got "
+                      << (result.best_move.has_value() ? esochess::move_to_uci(*result.best_move)
+                                                       : "0000")
+                      << '\n';
+            failures++;
+        }
+    }
+
+    // Further lines start with different moves and come out best first
+    esochess::search_limits multi_pv_limits {};
+
+    multi_pv_limits.depth = 3;
+    multi_pv_limits.multi_pv = 3;
+    engine.clear();
+
+    const esochess::search_result multi_pv_result {engine.search(
+        esochess::bitboard::from_fen(best_move_cases.front().fen).value(), {}, multi_pv_limits)};
+    const std::vector<esochess::search_line>& lines {multi_pv_result.lines};
+
+    if (lines.size() != 3 ||
+        esochess::move_to_uci(lines.at(0).principal_variation.front()) != "a1a8" ||
+        lines.at(0).score < lines.at(1).score || lines.at(1).score < lines.at(2).score ||
+        esochess::encode_move(lines.at(1).principal_variation.front()) ==
+            esochess::encode_move(lines.at(2).principal_variation.front())) {
+        std::cout << "MultiPV lines are wrong\n";
+        failures++;
+    }
+
+    // Passing clears the en passant square and unmaking restores the position exactly
+    const std::string_view null_move_fen {
+        "rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR b KQkq e3 0 3"};
+    esochess::bitboard null_move_board {esochess::bitboard::from_fen(null_move_fen).value()};
+    const std::uint64_t hash_before_null_move {null_move_board.hash()};
+    const auto previous_en_passant {null_move_board.make_null_move()};
+
+    if (null_move_board.to_fen() != "rnbqkbnr/ppp1pppp/8/8/3pP3/8/PPPP1PPP/RNBQKBNR w KQkq - 1 4" ||
+        null_move_board.hash() == hash_before_null_move ||
+        null_move_board.unmake_null_move(previous_en_passant).to_fen() != null_move_fen ||
+        null_move_board.hash() != hash_before_null_move) {
+        std::cout << "Null move round trip failed: " << null_move_board.to_fen() << '\n';
+        failures++;
+    }
+
+    // A ponder search holds its result back until the ponder hit, even once the depth is reached
+    std::atomic<bool> ponder_search_finished {false};
+    esochess::search_limits ponder_limits {};
+
+    ponder_limits.depth = 1;
+    ponder_limits.ponder = true;
+
+    std::jthread ponder_thread {[&]() {
+        static_cast<void>(engine.search(esochess::bitboard::from_fen(null_move_fen).value(), {},
+                                        ponder_limits));
+        ponder_search_finished = true;
+    }};
+
+    std::this_thread::sleep_for(std::chrono::milliseconds {50});
+
+    const bool finished_before_ponder_hit {ponder_search_finished};
+
+    engine.ponder_hit();
+    ponder_thread.join();
+
+    if (finished_before_ponder_hit || !ponder_search_finished) {
+        std::cout << "Ponder search did not wait for the ponder hit\n";
+        failures++;
+    }
+
+    std::ostringstream first_report {};
+    std::ostringstream second_report {};
+
+    if (esochess::run_bench(2, first_report).nodes != esochess::run_bench(2, second_report).nodes) {
+        std::cout << "Bench node counts differ between runs\n";
+        failures++;
+    }
+
+    if (failures == 0) {
+        std::cout << "All search tests passed\n";
+    }
+
+    return failures;
+}
@@ -0,0 +1,76 @@
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+#include <headers/bitboard.hpp>
+#include <headers/packed_position.hpp>
+#include <headers/pgn.hpp>
+#include <headers/self_play.hpp>
+
+int main() {
+    const std::string dataset_path {"/tmp/esochess_self_play.bin"};
+    const esochess::self_play_options options {2, 6, 300, 1, 20240620, 6, 60, 600, 4, 5, 6, 30};
+    int failures {0};
+    esochess::self_play_statistics statistics {};
+
+    {
+        auto writer {esochess::position_dataset_writer::create(dataset_path).value()};
+        statistics = esochess::run_self_play(options, writer);
+    }
+
+    const auto reader {esochess::position_dataset_reader::open(dataset_path)};
+
+    if (statistics.games != options.games ||
+        statistics.white_wins + statistics.black_wins + statistics.draws != statistics.games ||
+        statistics.positions == 0) {
+        std::cout << "Expected " << options.games << " finished games with positions, got "
+                  << statistics.games << " games and " << statistics.positions << " positions\n";
+        failures++;
+    }
+
+    if (!reader.has_value() || reader->size() != statistics.positions) {
+        std::cout << "The dataset does not hold the " << statistics.positions
+                  << " positions written\n";
+        failures++;
+    }
+
+    else {
+        for (const esochess::packed_position& position: *reader) {
+            const auto board {position.to_bitboard()};
+
+            if (!board.has_value()) {
+                std::cout << "A written position could not be unpacked\n";
+                failures++;
+            }
+
+            else if (position.result() == esochess::GameResult::Unknown || board->is_in_check() ||
+                     !esochess::bitboard::from_fen(board->to_fen()).has_value()) {
+                std::cout << board->to_fen() << " is unlabelled, in check or invalid\n";
+                failures++;
+            }
+        }
+    }
+
+    // Labels do not change the position
+    esochess::packed_position labelled {
+        esochess::packed_position::from_bitboard(
+            esochess::bitboard::from_fen(esochess::bitboard::starting_position_fen).value())
+            .value()};
+
+    labelled.score = -25;
+    labelled.set_result(esochess::GameResult::BlackWin);
+
+    if (labelled.result() != esochess::GameResult::BlackWin ||
+        labelled.to_bitboard().value().to_fen() != esochess::bitboard::starting_position_fen) {
+        std::cout << "Labelling a packed position changed it\n";
+        failures++;
+    }
+
+    std::remove(dataset_path.c_str());
+
+    if (failures == 0) {
+        std::cout << "All self play tests passed (" << statistics.positions << " positions)\n";
+    }
+
+    return failures;
+}
@@ -0,0 +1,88 @@
+#include <array>
+#include <cstddef>
+#include <iostream>
+#include <random>
+
+#include <headers/attacks.hpp>
+#include <headers/bitboard.hpp>
+
+namespace {
+    using esochess::bitboard;
+
+    constexpr int random_boards {20000};
+
+    // The same attacks looked up square by square
+    bitboard::bit_representation attacks_by_square(bitboard::bit_representation diagonal_sliders,
+                                                   bitboard::bit_representation straight_sliders,
+                                                   bitboard::bit_representation occupancy) {
+        bitboard::bit_representation attacks {0};
+
+        for (; diagonal_sliders != 0;
+             diagonal_sliders = esochess::without_lowest_square(diagonal_sliders)) {
+            attacks |=
+                esochess::bishop_attacks(esochess::square_index(diagonal_sliders), occupancy);
+        }
+
+        for (; straight_sliders != 0;
+             straight_sliders = esochess::without_lowest_square(straight_sliders)) {
+            attacks |= esochess::rook_attacks(esochess::square_index(straight_sliders), occupancy);
+        }
+
+        return attacks;
+    }
+} // namespace
+
+int main() {
+    int failures {0};
+    std::mt19937_64 random_engine {20240701};
+
+    // Fills are constant expressions, like the lookups
+    static_assert(esochess::fill_attacks(bitboard::Direction::North, esochess::square_bits(0),
+                                         esochess::square_bits(0)) ==
+                  esochess::ray_attacks(bitboard::Direction::North, 0, esochess::square_bits(0)));
+
+    for (int board {}; board < random_boards; board++) {
+        // Sparse and dense boards alike, every slider also occupies its square
+        const int density {board % 4};
+        bitboard::bit_representation occupancy {random_engine()};
+
+        for (int thinning {}; thinning < density; thinning++) {
+            occupancy &= random_engine();
+        }
+
+        const bitboard::bit_representation diagonal_sliders {occupancy & random_engine() &
+                                                             random_engine()};
+        const bitboard::bit_representation straight_sliders {occupancy & random_engine() &
+                                                             random_engine()};
+        const bitboard::bit_representation expected {
+            attacks_by_square(diagonal_sliders, straight_sliders, occupancy)};
+
+        if (esochess::slider_attacks(diagonal_sliders, straight_sliders, occupancy) != expected) {
+            std::cout << "slider_attacks differs for occupancy " << occupancy << '\n';
+            failures++;
+        }
+
+        for (const bitboard::Direction direction: bitboard::pieces::all_directions) {
+            bitboard::bit_representation expected_fill {0};
+
+            for (bitboard::bit_representation sliders {diagonal_sliders | straight_sliders};
+                 sliders != 0; sliders = esochess::without_lowest_square(sliders)) {
+                expected_fill |=
+                    esochess::ray_attacks(direction, esochess::square_index(sliders), occupancy);
+            }
+
+            if (esochess::fill_attacks(direction, diagonal_sliders | straight_sliders,
+                                       occupancy) != expected_fill) {
+                std::cout << "fill_attacks differs in direction " << static_cast<int>(direction)
+                          << " for occupancy " << occupancy << '\n';
+                failures++;
+            }
+        }
+    }
+
+    if (failures == 0) {
+        std::cout << "All slider attack tests passed (" << random_boards << " boards)\n";
+    }
+
+    return failures;
+}
@@ -0,0 +1,628 @@
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <initializer_list>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <headers/attacks.hpp>
+#include <headers/bitboard.hpp>
+#include <headers/san.hpp>
+#include <headers/syzygy.hpp>
+
+namespace {
+    using esochess::bitboard;
+
+    void write_bytes(const std::filesystem::path& path, const std::vector<std::uint8_t>& bytes) {
+        std::ofstream file {path, std::ios::binary | std::ios::trunc};
+
+        for (const std::uint8_t byte: bytes) {
+            file.put(static_cast<char>(byte));
+        }
+    }
+
+    void append_little_endian(std::vector<std::uint8_t>& bytes, std::uint32_t value,
+                              std::size_t size) {
+        for (std::size_t byte {}; byte < size; byte++) {
+            bytes.push_back(static_cast<std::uint8_t>(value >> (8 * byte)));
+        }
+    }
+
+    // Twelve bits for the left symbol and twelve for the right one, 0xfff marking a leaf
+    void append_symbol_pair(std::vector<std::uint8_t>& bytes, std::uint16_t left,
+                            std::uint16_t right) {
+        bytes.push_back(static_cast<std::uint8_t>(left & 0xffU));
+        bytes.push_back(static_cast<std::uint8_t>((left >> 8U) | ((right & 0xfU) << 4U)));
+        bytes.push_back(static_cast<std::uint8_t>(right >> 4U));
+    }
+
+    // Codes are written from the most significant bit down, as the decoder reads them
+    void append_codes(std::vector<std::uint8_t>& bytes, std::size_t& bit_count,
+                      std::string_view code, std::size_t repeats) {
+        for (std::size_t repeat {}; repeat < repeats; repeat++) {
+            for (const char bit: code) {
+                if (bit_count % 8 == 0) {
+                    bytes.push_back(0);
+                }
+
+                bytes.back() |= static_cast<std::uint8_t>((bit == '1' ? 1U : 0U)
+                                                          << (7 - bit_count % 8));
+                bit_count++;
+            }
+        }
+    }
+
+    // A KQvK table whose white to move side is Huffman coded in one block: 40000 wins and then
+    // draws, through symbols standing for one, two and four values. The 31332 positions of the
+    // table are all wins, so a misread code or offset shows up as a draw.
+    std::vector<std::uint8_t> huffman_coded_kqvk() {
+        std::vector<std::uint8_t> bytes {0x71, 0xe8, 0x23, 0x5d, 0x01, 0x00, 0x66, 0x55, 0xee,
+                                         0x00};
+
+        // Blocks of 4096 bytes, one sparse index entry every 65536 values and one block
+        bytes.insert(bytes.end(), {0x00, 12, 16, 0});
+        append_little_endian(bytes, 1, 4);
+
+        // Code lengths of 1 to 4 bits, where symbols 0 to 3 take 4 bits, 4 takes 2 and 5 takes 1
+        bytes.insert(bytes.end(), {4, 1});
+
+        for (const std::uint32_t lowest_symbol: {5, 4, 4, 0}) {
+            append_little_endian(bytes, lowest_symbol, 2);
+        }
+
+        append_little_endian(bytes, 6, 2);
+        append_symbol_pair(bytes, 4, 0xfff); // A win
+        append_symbol_pair(bytes, 2, 0xfff); // A draw
+        append_symbol_pair(bytes, 0, 0);     // Two wins
+        append_symbol_pair(bytes, 1, 1);     // Two draws
+        append_symbol_pair(bytes, 3, 3);     // Four draws
+        append_symbol_pair(bytes, 2, 2);     // Four wins
+
+        bytes.insert(bytes.end(), {0x80, 0x00}); // Black to move always loses
+
+        // The sparse index entry points at the middle of its span, then the block length
+        append_little_endian(bytes, 0, 4);
+        append_little_endian(bytes, 32768, 2);
+        append_little_endian(bytes, 65535, 2);
+        bytes.resize(64, 0); // Blocks start on cache lines
+
+        std::vector<std::uint8_t> block {};
+        std::size_t bit_count {0};
+
+        append_codes(block, bit_count, "0010", 1);
+        append_codes(block, bit_count, "0000", 1);
+        append_codes(block, bit_count, "1", 9999);
+        append_codes(block, bit_count, "0000", 1);
+        append_codes(block, bit_count, "0011", 1);
+        append_codes(block, bit_count, "0001", 2);
+        append_codes(block, bit_count, "01", 6383);
+        block.resize(4096, 0);
+        bytes.insert(bytes.end(), block.begin(), block.end());
+
+        return bytes;
+    }
+
+    // Zero or one for every index of a table, mixed so that a misplaced index reads the wrong
+    // bit half of the time
+    std::size_t index_bit(std::uint64_t index, std::uint64_t salt) {
+        return static_cast<std::size_t>(((index + salt) * 0x9e37'79b9'7f4a'7c15U) >> 63U);
+    }
+
+    // One side to move of one leading pawn file, storing
+    // `values [index_bit(index / stride, salt)]`
+    struct bit_coded_item {
+        std::array<std::uint8_t, 2> values; // WDL results plus 2
+        std::uint64_t size;
+        std::uint64_t stride; // Indices sharing a value, to leave the least significant group out
+        std::uint64_t salt;
+    };
+
+    // Completes `header`, the magic, flags, orders and pieces of a WDL table, with items coded
+    // in one bit per value: 512 values to a 64 byte block and a sparse index entry per 1024
+    std::vector<std::uint8_t> bit_coded_table(std::vector<std::uint8_t> bytes,
+                                              const std::vector<bit_coded_item>& items) {
+        constexpr std::uint64_t values_per_block {512};
+        constexpr std::uint64_t span {1024};
+        const auto block_count {[](const bit_coded_item& item) {
+            return (item.size + values_per_block - 1) / values_per_block;
+        }};
+        const auto sparse_entries {[](const bit_coded_item& item) {
+            return (item.size + span - 1) / span;
+        }};
+
+        // The last sparse entry may point past the table, into full blocks kept as padding
+        const auto padding_blocks {[&sparse_entries](const bit_coded_item& item) {
+            const std::uint64_t last_middle {sparse_entries(item) * span - span / 2};
+
+            return last_middle < item.size ? 0 : (last_middle - item.size) / values_per_block + 1;
+        }};
+
+        bytes.resize(bytes.size() + bytes.size() % 2, 0);
+
+        for (const bit_coded_item& item: items) {
+            bytes.insert(bytes.end(),
+                         {0x00, 6, 10, static_cast<std::uint8_t>(padding_blocks(item))});
+            append_little_endian(bytes, static_cast<std::uint32_t>(block_count(item)), 4);
+            bytes.insert(bytes.end(), {1, 1}); // Two symbols of one bit
+            append_little_endian(bytes, 0, 2);
+            append_little_endian(bytes, 2, 2);
+            append_symbol_pair(bytes, item.values.at(0), 0xfff);
+            append_symbol_pair(bytes, item.values.at(1), 0xfff);
+        }
+
+        // Entry k stands for the value in the middle of its span, k * 1024 + 512
+        for (const bit_coded_item& item: items) {
+            for (std::uint64_t entry {}; entry < sparse_entries(item); entry++) {
+                const std::uint64_t middle {entry * span + span / 2};
+                const std::uint64_t block {
+                    middle < item.size ? middle / values_per_block
+                                       : block_count(item) +
+                                             (middle - item.size) / values_per_block};
+                const std::uint64_t offset {middle < item.size
+                                                ? middle % values_per_block
+                                                : (middle - item.size) % values_per_block};
+
+                append_little_endian(bytes, static_cast<std::uint32_t>(block), 4);
+                append_little_endian(bytes, static_cast<std::uint32_t>(offset), 2);
+            }
+        }
+
+        for (const bit_coded_item& item: items) {
+            for (std::uint64_t block {}; block < block_count(item) + padding_blocks(item);
+                 block++) {
+                const std::uint64_t values {
+                    block * values_per_block < item.size
+                        ? std::min(values_per_block, item.size - block * values_per_block)
+                        : values_per_block};
+
+                append_little_endian(bytes, static_cast<std::uint32_t>(values - 1), 2);
+            }
+        }
+
+        for (const bit_coded_item& item: items) {
+            bytes.resize((bytes.size() + 63) / 64 * 64, 0);
+
+            const std::size_t data_start {bytes.size()};
+
+            bytes.resize(data_start + block_count(item) * values_per_block / 8, 0);
+
+            for (std::uint64_t index {}; index < item.size; index++) {
+                if (index_bit(index / item.stride, item.salt) != 0) {
+                    bytes.at(data_start + index / 8) |=
+                        static_cast<std::uint8_t>(0x80U >> (index % 8));
+                }
+            }
+        }
+
+        return bytes;
+    }
+
+    // Pieces given as a bitboard index and a square each
+    esochess::bitboard placed_board(std::initializer_list<std::pair<std::size_t, int>> pieces,
+                                    esochess::bitboard::Turn turn) {
+        std::array<esochess::bitboard::bit_representation, 12> bitboards {};
+
+        for (const auto& [bitboard_index, square]: pieces) {
+            bitboards.at(bitboard_index) |= esochess::square_bits(square);
+        }
+
+        return esochess::bitboard {bitboards, turn, {false, false, false, false}, std::nullopt,
+                                   0, 1};
+    }
+
+    // Whether the side that is not to move could be captured, or kings share or touch squares
+    bool is_illegal(const esochess::bitboard& board, std::initializer_list<int> squares) {
+        return std::ranges::any_of(squares,
+                                   [&squares](int square) {
+                                       return std::ranges::count(squares, square) > 1;
+                                   }) ||
+               board.is_in_check(esochess::bitboard::opposite_turn(board.turn()));
+    }
+
+    esochess::bitboard board_from_fen(std::string_view fen) {
+        return esochess::bitboard::from_fen(fen).value();
+    }
+
+    // Checks the three piece tables downloaded from a Syzygy mirror, given as the first argument.
+    // The tables written by the test itself cover the same layouts on every run.
+    int probe_real_tables(std::string_view paths) {
+        const esochess::syzygy_tablebases tablebases {esochess::syzygy_tablebases::open(paths)};
+        int failures {0};
+
+        if (tablebases.size() < 5 || tablebases.max_pieces() < 3) {
+            std::cout << "Expected the three piece tables in " << paths << '\n';
+            return 1;
+        }
+
+        for (const auto& [fen, expected]:
+             std::vector<std::pair<std::string_view, esochess::WdlScore>> {
+                 {"8/8/4k3/8/8/8/8/QK6 w - - 0 1", esochess::WdlScore::Win},
+                 {"8/8/4k3/8/8/8/8/QK6 b - - 0 1", esochess::WdlScore::Loss},
+                 {"8/8/8/8/8/8/1k6/Q2K4 b - - 0 1", esochess::WdlScore::Draw},
+                 {"8/8/4k3/8/8/8/8/RK6 w - - 0 1", esochess::WdlScore::Win},
+                 {"8/8/4k3/8/8/8/8/BK6 w - - 0 1", esochess::WdlScore::Draw},
+                 {"8/8/4k3/8/8/8/8/NK6 b - - 0 1", esochess::WdlScore::Draw},
+                 {"4k3/8/4K3/4P3/8/8/8/8 b - - 0 1", esochess::WdlScore::Loss},
+                 {"4k3/4P3/4K3/8/8/8/8/8 b - - 0 1", esochess::WdlScore::Draw}}) {
+            if (tablebases.probe_wdl(board_from_fen(fen)) != expected) {
+                std::cout << "Unexpected WDL from the real tables for " << fen << '\n';
+                failures++;
+            }
+        }
+
+        // Without pawns, every kept root move brings the win closer
+        for (const std::string_view fen:
+             {"8/8/4k3/8/8/8/8/QK6 w - - 0 1", "8/8/4k3/8/8/8/8/RK6 w - - 0 1",
+              "k7/8/8/8/8/8/5R2/6K1 w - - 0 1", "8/8/4K3/8/8/8/8/qk6 b - - 0 1"}) {
+            const esochess::bitboard board {board_from_fen(fen)};
+            const std::optional<int> dtz {tablebases.probe_dtz(board)};
+            const std::optional<std::vector<esochess::bitboard::move>> moves {
+                tablebases.root_moves(board)};
+            bool closer {dtz.has_value() && *dtz > 0 && moves.has_value() && !moves->empty()};
+
+            for (const esochess::bitboard::move& chess_move:
+                 moves.value_or(std::vector<esochess::bitboard::move> {})) {
+                const esochess::bitboard child {board.after_move(chess_move)};
+                const std::optional<int> child_dtz {tablebases.probe_dtz(child)};
+                closer = closer && child_dtz.has_value() && *child_dtz < 0 && -*child_dtz < *dtz;
+            }
+
+            if (!closer) {
+                std::cout << "Unexpected DTZ from the real tables for " << fen << ": "
+                          << dtz.value_or(-9999) << '\n';
+                failures++;
+            }
+        }
+
+        return failures;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::filesystem::path directory {std::filesystem::temp_directory_path() /
+                                           "esochess_syzygy_test"};
+
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+
+    // Tables where every position holds one value: KQvK is won with white to move and lost with
+    // black to move, with a distance to zeroing of 5 moves. The header lists the piece order
+    // (white king, white queen, black king) for both sides to move.
+    write_bytes(directory / "KQvK.rtbw", {0x71, 0xe8, 0x23, 0x5d, 0x01, 0x00, 0x66, 0x55, 0xee,
+                                          0x00, 0x80, 0x04, 0x80, 0x00});
+    write_bytes(directory / "KQvK.rtbz",
+                {0xd7, 0x66, 0x0c, 0xa5, 0x01, 0x00, 0x66, 0x55, 0xee, 0x00, 0x80, 0x05});
+    write_bytes(directory / "KRvK.rtbw", {0x00, 0x01, 0x02, 0x03, 0x04}); // Corrupted
+
+    const esochess::syzygy_tablebases tablebases {
+        esochess::syzygy_tablebases::open("/nonexistent:" + directory.string())};
+
+    int failures {0};
+
+    if (tablebases.size() != 1 || tablebases.max_pieces() != 3) {
+        std::cout << "Expected only KQvK to load, found " << tablebases.size() << " tables\n";
+        failures++;
+    }
+
+    const auto expect_wdl {[&](std::string_view fen, std::optional<esochess::WdlScore> expected) {
+        if (tablebases.probe_wdl(board_from_fen(fen)) != expected) {
+            std::cout << "Unexpected WDL for " << fen << '\n';
+            failures++;
+        }
+    }};
+
+    const auto expect_dtz {[&](std::string_view fen, std::optional<int> expected) {
+        const std::optional<int> dtz {tablebases.probe_dtz(board_from_fen(fen))};
+
+        if (dtz != expected) {
+            std::cout << "Unexpected DTZ for " << fen << ": " << dtz.value_or(-9999) << '\n';
+            failures++;
+        }
+    }};
+
+    expect_wdl("8/8/4k3/8/8/8/8/QK6 w - - 0 1", esochess::WdlScore::Win);
+    expect_wdl("8/8/4k3/8/8/8/8/QK6 b - - 0 1", esochess::WdlScore::Loss);
+    expect_wdl("8/8/4K3/8/8/8/8/qk6 b - - 0 1", esochess::WdlScore::Win); // Colours swapped
+    expect_wdl("8/8/8/8/8/8/1k6/Q2K4 b - - 0 1", esochess::WdlScore::Draw); // Kxa1 is a draw
+    expect_wdl("4k3/8/8/8/8/8/8/4K3 w - - 0 1", esochess::WdlScore::Draw);
+    expect_wdl("8/8/4k3/8/8/8/8/RK6 w - - 0 1", std::nullopt);
+    expect_wdl("4k3/8/8/8/8/8/8/Q3K2R w K - 0 1", std::nullopt);
+
+    expect_dtz("8/8/4k3/8/8/8/8/QK6 w - - 0 1", 11);
+    expect_dtz("8/8/4k3/8/8/8/8/QK6 b - - 0 1", -12); // One ply further from the stored side
+
+    // Queen moves next to the king lose the queen, so they are filtered from the root
+    esochess::bitboard root_board {board_from_fen("8/8/8/8/Q7/2k5/8/1K6 w - - 0 1")};
+    const std::optional<std::vector<esochess::bitboard::move>> root_moves {
+        tablebases.root_moves(root_board)};
+    std::vector<std::string> root_sans {};
+
+    for (const esochess::bitboard::move& root_move: root_moves.value_or(
+             std::vector<esochess::bitboard::move> {})) {
+        root_sans.push_back(esochess::move_to_san(root_board, root_move));
+    }
+
+    if (root_sans.empty() || std::ranges::find(root_sans, "Qa3+") == root_sans.end() ||
+        std::ranges::find(root_sans, "Qb4+") != root_sans.end() ||
+        std::ranges::find(root_sans, "Qc4+") != root_sans.end()) {
+        std::cout << "Unexpected root moves:";
+
+        for (const std::string& san: root_sans) {
+            std::cout << ' ' << san;
+        }
+
+        std::cout << '\n';
+        failures++;
+    }
+
+    // DTZ tables store a single side to move, here black, which both sides must probe
+    const std::filesystem::path huffman_directory {directory / "huffman"};
+
+    std::filesystem::create_directories(huffman_directory);
+    write_bytes(huffman_directory / "KQvK.rtbw", huffman_coded_kqvk());
+    write_bytes(huffman_directory / "KQvK.rtbz",
+                {0xd7, 0x66, 0x0c, 0xa5, 0x01, 0x00, 0x66, 0x55, 0xee, 0x00, 0x81, 0x05});
+
+    const esochess::syzygy_tablebases huffman_tablebases {
+        esochess::syzygy_tablebases::open(huffman_directory.string())};
+
+    for (const std::string_view fen:
+         {"8/8/4k3/8/8/8/8/QK6 w - - 0 1", "7K/8/8/8/8/8/7Q/k7 w - - 0 1",
+          "8/3k4/8/8/4Q3/8/8/6K1 w - - 0 1", "K7/8/1k6/8/8/8/8/7Q w - - 0 1",
+          "8/8/8/3K4/8/8/2Q5/k7 w - - 0 1", "8/8/4K3/8/8/8/8/qk6 b - - 0 1"}) {
+        if (huffman_tablebases.probe_wdl(board_from_fen(fen)) != esochess::WdlScore::Win) {
+            std::cout << "Unexpected WDL from the Huffman coded table for " << fen << '\n';
+            failures++;
+        }
+    }
+
+    if (huffman_tablebases.probe_wdl(board_from_fen("8/8/4k3/8/8/8/8/QK6 b - - 0 1")) !=
+        esochess::WdlScore::Loss) {
+        std::cout << "Unexpected WDL from the Huffman coded table with black to move\n";
+        failures++;
+    }
+
+    for (const auto& [fen, expected]: std::vector<std::pair<std::string_view, int>> {
+             {"8/8/4k3/8/8/8/8/QK6 b - - 0 1", -11},
+             {"8/8/4K3/8/8/8/8/qk6 w - - 0 1", -11},
+             {"8/8/4k3/8/8/8/8/QK6 w - - 0 1", 12}}) {
+        const std::optional<int> dtz {huffman_tablebases.probe_dtz(board_from_fen(fen))};
+
+        if (dtz != expected) {
+            std::cout << "Unexpected DTZ from the black to move table for " << fen << ": "
+                      << dtz.value_or(-9999) << '\n';
+            failures++;
+        }
+    }
+
+    // Pawn tables hold an item per file of the leading pawn, a to d, with files e to h mirrored
+    // onto them. Each item here stores a bit per index, so a misread order, file or pawn index
+    // shows up in half of the positions. The order bytes make the leading pawn the most
+    // significant group for one side to move and the least significant for the other.
+    const std::filesystem::path pawn_directory {directory / "pawns"};
+    std::vector<std::uint8_t> kpvk_header {0x71, 0xe8, 0x23, 0x5d, 0x03};
+    std::vector<bit_coded_item> kpvk_items {};
+
+    for (std::uint8_t file {}; file < 4; file++) {
+        kpvk_header.insert(kpvk_header.end(),
+                           {file % 2 == 0 ? std::uint8_t {0x02} : std::uint8_t {0x20}, 0x11, 0x66,
+                            0xee});
+        kpvk_items.push_back({{4, 2}, 6 * 63 * 62, 1, file * 2U});     // The pawn's side to move
+        kpvk_items.push_back({{2, 0}, 6 * 63 * 62, 1, file * 2U + 1}); // The other side to move
+    }
+
+    std::filesystem::create_directories(pawn_directory);
+    write_bytes(pawn_directory / "KPvK.rtbw", bit_coded_table(kpvk_header, kpvk_items));
+
+    // Squares as the table sees them, with the pawn's side as white
+    const auto kpvk_value {[&kpvk_items](int pawn, int king, int other_king, int side) {
+        if (pawn % 8 > 3) {
+            pawn ^= 7;
+            king ^= 7;
+            other_king ^= 7;
+        }
+
+        const int file {pawn % 8};
+        const auto lead {static_cast<std::uint64_t>(pawn / 8 - 1)};
+        const auto king_index {static_cast<std::uint64_t>(king - (pawn < king ? 1 : 0))};
+        const auto other_king_index {static_cast<std::uint64_t>(
+            other_king - (pawn < other_king ? 1 : 0) - (king < other_king ? 1 : 0))};
+        const std::uint64_t index {(file % 2 == 0) == (side == 0)
+                                       ? lead * 63 * 62 + king_index + 63 * other_king_index
+                                       : lead + 6 * king_index + 6 * 63 * other_king_index};
+        const bit_coded_item& item {kpvk_items.at(static_cast<std::size_t>(file * 2 + side))};
+
+        return static_cast<esochess::WdlScore>(item.values.at(index_bit(index, item.salt)) - 2);
+    }};
+
+    const esochess::syzygy_tablebases pawn_tablebases {
+        esochess::syzygy_tablebases::open(pawn_directory.string())};
+    std::mt19937_64 random_engine {20240611};
+    int pawn_failures {0};
+
+    // Every pawn square of both colours, with random kings
+    for (const bitboard::Turn pawn_side: {bitboard::Turn::White, bitboard::Turn::Black}) {
+        const bool white_pawn {pawn_side == bitboard::Turn::White};
+        const int flip {white_pawn ? 0 : 56};
+
+        for (int pawn {8}; pawn < 56; pawn++) {
+            for (int sample {}; sample < 1000; sample++) {
+                const auto king {static_cast<int>(random_engine() % 64)};
+                const auto other_king {static_cast<int>(random_engine() % 64)};
+                const bitboard::Turn turn {sample % 2 == 0 ? bitboard::Turn::White
+                                                           : bitboard::Turn::Black};
+                const esochess::bitboard board {placed_board({{white_pawn ? 0U : 6U, pawn},
+                                                              {white_pawn ? 5U : 11U, king},
+                                                              {white_pawn ? 11U : 5U, other_king}},
+                                                             turn)};
+
+                // Taking the pawn leaves bare kings instead of reading the table
+                if (is_illegal(board, {pawn, king, other_king}) ||
+                    (turn != pawn_side &&
+                     (esochess::king_attacks(other_king) & esochess::square_bits(pawn)) != 0)) {
+                    continue;
+                }
+
+                const esochess::WdlScore expected {kpvk_value(
+                    pawn ^ flip, king ^ flip, other_king ^ flip, turn == pawn_side ? 0 : 1)};
+
+                if (pawn_tablebases.probe_wdl(board) != expected && pawn_failures++ < 5) {
+                    std::cout << "Unexpected WDL from the pawn table for " << board.to_fen()
+                              << '\n';
+                }
+            }
+        }
+    }
+
+    failures += pawn_failures;
+
+    // Two rooks form one group, a combination of two of the squares the kings leave free. With
+    // the rooks as the most significant group, the bit only depends on where they stand once
+    // the white king is mirrored into the a1-d1-d4 triangle.
+    const std::filesystem::path paired_directory {directory / "paired"};
+    const std::vector<bit_coded_item> krrvk_items {{{4, 2}, 462 * 1891, 462, 0},
+                                                   {{2, 0}, 462 * 1891, 462, 1}};
+
+    std::filesystem::create_directories(paired_directory);
+    write_bytes(paired_directory / "KRRvK.rtbw",
+                bit_coded_table({0x71, 0xe8, 0x23, 0x5d, 0x01, 0x00, 0x66, 0xee, 0x44, 0x44},
+                                krrvk_items));
+
+    const esochess::syzygy_tablebases paired_tablebases {
+        esochess::syzygy_tablebases::open(paired_directory.string())};
+    int paired_failures {0};
+
+    if (paired_tablebases.max_pieces() != 4 || pawn_tablebases.max_pieces() != 3) {
+        std::cout << "Expected the bit coded KPvK and KRRvK tables to load\n";
+        failures++;
+    }
+
+    for (int sample {}; sample < 100000; sample++) {
+        std::array<int, 4> squares {}; // White king, black king and the rooks
+
+        for (int& square: squares) {
+            square = static_cast<int>(random_engine() % 64);
+        }
+
+        const bitboard::Turn turn {sample % 2 == 0 ? bitboard::Turn::White
+                                                   : bitboard::Turn::Black};
+        const esochess::bitboard board {placed_board(
+            {{5, squares.at(0)}, {11, squares.at(1)}, {3, squares.at(2)}, {3, squares.at(3)}},
+            turn)};
+
+        // Taking a rook leads to KRvK, which is missing
+        if (is_illegal(board, {squares.at(0), squares.at(1), squares.at(2), squares.at(3)}) ||
+            (turn == bitboard::Turn::Black &&
+             (esochess::king_attacks(squares.at(1)) &
+              (esochess::square_bits(squares.at(2)) | esochess::square_bits(squares.at(3)))) !=
+                 0)) {
+            continue;
+        }
+
+        const auto mirror_all {[&squares](const auto& mirror) {
+            std::ranges::for_each(squares, [&mirror](int& square) { square = mirror(square); });
+        }};
+
+        if (squares.at(0) % 8 > 3) {
+            mirror_all([](int square) { return square ^ 7; });
+        }
+
+        if (squares.at(0) / 8 > 3) {
+            mirror_all([](int square) { return square ^ 56; });
+        }
+
+        // The first king off the a1-h8 diagonal decides whether to mirror along it
+        for (const int king: {squares.at(0), squares.at(1)}) {
+            if (king / 8 != king % 8) {
+                if (king / 8 > king % 8) {
+                    mirror_all([](int square) { return (square >> 3) | ((square & 7) << 3); });
+                }
+
+                break;
+            }
+        }
+
+        const auto free_square {[&squares](int square) {
+            return static_cast<std::uint64_t>(square - (squares.at(0) < square ? 1 : 0) -
+                                              (squares.at(1) < square ? 1 : 0));
+        }};
+        const std::uint64_t low_rook {free_square(std::min(squares.at(2), squares.at(3)))};
+        const std::uint64_t high_rook {free_square(std::max(squares.at(2), squares.at(3)))};
+        const bit_coded_item& item {krrvk_items.at(turn == bitboard::Turn::White ? 0 : 1)};
+        const std::uint64_t rooks_index {low_rook + high_rook * (high_rook - 1) / 2};
+        const auto expected {static_cast<esochess::WdlScore>(
+            item.values.at(index_bit(rooks_index, item.salt)) - 2)};
+
+        if (paired_tablebases.probe_wdl(board) != expected && paired_failures++ < 5) {
+            std::cout << "Unexpected WDL from the paired piece table for " << board.to_fen()
+                      << '\n';
+        }
+    }
+
+    failures += paired_failures;
+
+    // Pawn DTZ tables also hold an item per file, here a single distance each. The king in
+    // front of the pawn leaves no zeroing move, so the distance comes from the table.
+    const std::filesystem::path pawn_dtz_directory {directory / "pawn_dtz"};
+    std::vector<std::uint8_t> pawn_dtz {0xd7, 0x66, 0x0c, 0xa5, 0x03};
+
+    for (int file {}; file < 4; file++) {
+        pawn_dtz.insert(pawn_dtz.end(), {0x00, 0x11, 0x66, 0xee});
+    }
+
+    pawn_dtz.push_back(0x00);
+
+    for (const std::uint8_t moves: {3, 5, 7, 9}) { // Files a to d, white to move
+        pawn_dtz.insert(pawn_dtz.end(), {0x80, moves});
+    }
+
+    std::filesystem::create_directories(pawn_dtz_directory);
+    write_bytes(pawn_dtz_directory / "KPvK.rtbz", pawn_dtz);
+    write_bytes(pawn_dtz_directory / "KPvK.rtbw",
+                {0x71, 0xe8, 0x23, 0x5d, 0x03, 0x00, 0x11, 0x66, 0xee, 0x00, 0x11, 0x66, 0xee,
+                 0x00, 0x11, 0x66, 0xee, 0x00, 0x11, 0x66, 0xee, 0x00, 0x80, 0x04, 0x80, 0x00,
+                 0x80, 0x04, 0x80, 0x00, 0x80, 0x04, 0x80, 0x00, 0x80, 0x04, 0x80, 0x00});
+
+    const esochess::syzygy_tablebases pawn_dtz_tablebases {
+        esochess::syzygy_tablebases::open(pawn_dtz_directory.string())};
+
+    for (const auto& [fen, expected]: std::vector<std::pair<std::string_view, int>> {
+             {"k7/8/8/8/K7/P7/8/8 w - - 0 1", 7},
+             {"k7/8/8/8/6K1/6P1/8/8 w - - 0 1", 11},
+             {"7k/8/8/8/2K5/2P5/8/8 w - - 0 1", 15},
+             {"k7/8/8/4K3/4P3/8/8/8 w - - 0 1", 19},
+             {"8/8/4p3/4k3/8/8/8/K7 b - - 0 1", 19}}) { // Colours swapped
+        const std::optional<int> dtz {pawn_dtz_tablebases.probe_dtz(board_from_fen(fen))};
+
+        if (dtz != expected) {
+            std::cout << "Unexpected DTZ from the pawn table for " << fen << ": "
+                      << dtz.value_or(-9999) << '\n';
+            failures++;
+        }
+    }
+
+    std::filesystem::remove_all(directory);
+
+    if (argc > 1) {
+        failures += probe_real_tables(argv [1]);
+    }
+
+    else {
+        std::cout << "Skipping the real table checks, pass a Syzygy directory to run them\n";
+    }
+
+    if (failures == 0) {
+        std::cout << "All syzygy probe tests passed\n";
+    }
+
+    return failures;
+}
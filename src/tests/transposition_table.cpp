@@ -0,0 +1,122 @@
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <vector>
+
+#include <headers/platform.hpp>
+#include <headers/search.hpp>
+
+int main() {
+    using Bound = esochess::transposition_table::Bound;
+    using PageSize = esochess::transposition_table::PageSize;
+
+    int failures {0};
+
+    for (const PageSize page_size: {PageSize::Default, PageSize::Huge}) {
+        const auto memory {esochess::huge_page_memory::allocate(
+            3 * esochess::huge_page_memory::huge_page_size + 64, page_size)};
+
+        if (!memory.has_value() ||
+            memory->bytes().size() != 3 * esochess::huge_page_memory::huge_page_size + 64) {
+            std::cout << "Could not allocate table memory\n";
+            failures++;
+            continue;
+        }
+
+        bool zeroed {true};
+
+        for (const std::byte byte: memory->bytes()) {
+            zeroed = zeroed && byte == std::byte {0};
+        }
+
+        const auto address {reinterpret_cast<std::uintptr_t>(memory->bytes().data())};
+
+        if (!zeroed || (page_size == PageSize::Huge &&
+                        address % esochess::huge_page_memory::huge_page_size != 0)) {
+            std::cout << "Table memory is not zeroed and aligned\n";
+            failures++;
+        }
+    }
+
+    // Every index once, on however many threads
+    for (const std::size_t count: {std::size_t {0}, std::size_t {5}, std::size_t {100003}}) {
+        std::vector<int> visits(count, 0);
+        std::mutex mutex {};
+        std::size_t ranges {0};
+
+        esochess::for_each_range_in_parallel(count, 1000, [&](std::size_t begin, std::size_t end) {
+            for (std::size_t index {begin}; index < end; index++) {
+                visits.at(index)++;
+            }
+
+            const std::lock_guard<std::mutex> lock {mutex};
+            ranges++;
+        });
+
+        for (const int visit_count: visits) {
+            if (visit_count != 1) {
+                std::cout << "A range of " << count << " was not covered exactly once\n";
+                failures++;
+                break;
+            }
+        }
+
+        if (ranges == 0) {
+            std::cout << "No work was run for a range of " << count << '\n';
+            failures++;
+        }
+    }
+
+    for (const PageSize page_size: {PageSize::Default, PageSize::Huge}) {
+        esochess::transposition_table table {1, page_size};
+
+        table.resize(8, page_size);
+        table.store(0x0123456789ABCDEFULL, 0x0abc, -123, 7, Bound::Lower);
+
+        const auto stored {table.probe(0x0123456789ABCDEFULL)};
+
+        if (table.size() != 8 * 1024 * 1024 / 16 || !stored.has_value() ||
+            stored->encoded_move != 0x0abc || stored->score != -123 || stored->depth != 7 ||
+            stored->bound != Bound::Lower || table.probe(0x0123456789ABCDEEULL).has_value()) {
+            std::cout << "Table store and probe failed after resizing\n";
+            failures++;
+        }
+
+        // A table too large to map leaves the old one in place
+        bool allocated {true};
+
+        try {
+            table.resize(std::size_t {1} << 30U, page_size);
+        }
+
+        catch (const std::bad_alloc&) {
+            allocated = false;
+        }
+
+        if (allocated || table.size() != 8 * 1024 * 1024 / 16 ||
+            !table.probe(0x0123456789ABCDEFULL).has_value()) {
+            std::cout << "A failed resize did not keep the previous table\n";
+            failures++;
+        }
+
+        table.clear();
+
+        if (table.probe(0x0123456789ABCDEFULL).has_value() || table.hashfull() != 0) {
+            std::cout << "Table not empty after clearing\n";
+            failures++;
+        }
+    }
+
+    if (!esochess::pin_current_thread(0)) {
+        std::cout << "Could not pin the thread to a core\n";
+        failures++;
+    }
+
+    if (failures == 0) {
+        std::cout << "All transposition table tests passed\n";
+    }
+
+    return failures;
+}
@@ -0,0 +1,109 @@
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <headers/uci.hpp>
+
+namespace {
+    // Runs `commands` through a fresh engine and returns every line it answered
+    std::vector<std::string> run_commands(std::string_view commands) {
+        std::ostringstream output {};
+
+        {
+            esochess::uci_engine engine {output};
+            std::istringstream input {std::string {commands}};
+
+            engine.run(input);
+        }
+
+        std::istringstream lines {output.str()};
+        std::vector<std::string> answered {};
+
+        for (std::string line {}; std::getline(lines, line);) {
+            answered.push_back(line);
+        }
+
+        return answered;
+    }
+
+    bool contains_line(const std::vector<std::string>& lines, std::string_view prefix) {
+        for (const std::string& line: lines) {
+            if (line.starts_with(prefix)) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+} // namespace
+
+int main() {
+    int failures {0};
+
+    const std::vector<std::pair<std::string_view, std::optional<std::int64_t>>> numbers {
+        {"42", 42},
+        {"-7", -7},
+        {"", std::nullopt},
+        {"abc", std::nullopt},
+        {"12abc", std::nullopt},
+        {"99999999999999999999", std::nullopt}};
+
+    for (const auto& [text, expected]: numbers) {
+        if (esochess::parse_integer(text) != expected) {
+            std::cout << "Unexpected parse of \"" << text << "\"\n";
+            failures++;
+        }
+    }
+
+    // Command line options, where a thread count of -1 or 0 is as malformed as "abc"
+    if (esochess::parse_integer("4", 1, 1024) != 4 ||
+        esochess::parse_integer("-1", 1, 1024).has_value() ||
+        esochess::parse_integer("0", 1, 1024).has_value() ||
+        esochess::parse_integer("abc", 1, 1024).has_value()) {
+        std::cout << "Unexpected parse of a ranged integer\n";
+        failures++;
+    }
+
+    // Malformed numbers and tables too large to allocate are reported and skipped, and the
+    // engine keeps answering
+    const std::vector<std::string> lines {
+        run_commands("setoption name Hash value abc\n"
+                     "setoption name Hash value 1000000000\n"
+                     "setoption name MultiPV value 2x\n"
+                     "setoption name NullMoveMinDepth value deep\n"
+                     "position startpos moves e2e4\n"
+                     "go depth x nodes 2000\n"
+                     "isready\n"
+                     "go depth 2 movetime soon\n"
+                     "go depth 1 nodes -5 movetime -1\n"
+                     "isready\n"
+                     "position startpos moves e2e4 e7e5 e2e5\n"
+                     "d\n"
+                     "quit\n")};
+
+    for (const std::string_view expected_line:
+         {"info string Invalid value for Hash: abc", "info string Could not allocate 1000000000 MB",
+          "info string Invalid value for MultiPV: 2x",
+          "info string Invalid value for NullMoveMinDepth: deep",
+          "info string Invalid value for depth: x", "info string Invalid value for movetime: soon",
+          "info string Invalid value for nodes: -5", "info string Invalid value for movetime: -1",
+          "info string Illegal move: e2e5",
+          // The position before the rejected moves stays
+          "Fen: rnbqkbnr/pppppppp/8/8/4P3/8/PPPP1PPP/RNBQKBNR b KQkq", "readyok", "bestmove "}) {
+        if (!contains_line(lines, expected_line)) {
+            std::cout << "Missing \"" << expected_line << "\" in the engine output\n";
+            failures++;
+        }
+    }
+
+    if (failures == 0) {
+        std::cout << "All UCI command tests passed\n";
+    }
+
+    return failures;
+}
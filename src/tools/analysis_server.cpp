@@ -0,0 +1,361 @@
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <headers/analysis_server.hpp>
+#include <headers/search.hpp>
+#include <headers/uci.hpp>
+
+namespace {
+    constexpr std::size_t max_request_length {64 * 1024};
+    constexpr std::size_t max_unread_bytes {1024 * 1024}; // Of responses the client has not read
+
+    // Responses from the workers, waiting for the connection's own thread to send them, so a
+    // client that stops reading holds up nobody else. Each line wakes that thread through a pipe.
+    struct connection_outbox {
+        struct contents {
+            std::string lines;
+            bool overflowed; // The client fell too far behind, and lost responses
+            bool finished;   // Every request is answered and no more will come
+        };
+
+        explicit connection_outbox(int wake_descriptor) : _wake_descriptor {wake_descriptor} {
+        }
+
+        void push(std::string_view line) {
+            {
+                const std::lock_guard<std::mutex> lock {_mutex};
+
+                if (_contents.lines.size() + line.size() + 1 > max_unread_bytes) {
+                    _contents.overflowed = true;
+                }
+
+                else {
+                    _contents.lines += line;
+                    _contents.lines += '\n';
+                }
+            }
+
+            wake();
+        }
+
+        void finish() {
+            {
+                const std::lock_guard<std::mutex> lock {_mutex};
+                _contents.finished = true;
+            }
+
+            wake();
+        }
+
+        [[nodiscard]] contents take() {
+            const std::lock_guard<std::mutex> lock {_mutex};
+
+            contents taken {std::move(_contents.lines), _contents.overflowed, _contents.finished};
+
+            _contents.lines.clear();
+            return taken;
+        }
+
+        private:
+
+        void wake() const {
+            const char signal {};
+
+            // Never blocks, a full pipe has woken the connection already
+            static_cast<void>(write(_wake_descriptor, &signal, 1));
+        }
+
+        int _wake_descriptor;
+        std::mutex _mutex;
+        contents _contents {};
+    };
+
+    // Answers one connection until the client closes it, or has half closed it and every
+    // request it sent is answered
+    void serve_connection(esochess::analysis_server& server, int connection) {
+        std::array<int, 2> wake_pipe {};
+
+        if (pipe2(wake_pipe.data(), O_NONBLOCK | O_CLOEXEC) != 0) {
+            close(connection);
+            return;
+        }
+
+        connection_outbox outbox {wake_pipe.at(1)};
+
+        {
+            esochess::analysis_session session {
+                server, [&outbox](std::string_view line) { outbox.push(line); }};
+            std::jthread waiting {}; // For the open requests, once the client stops sending
+            std::array<char, 4096> buffer {};
+            std::string pending {};
+            std::string unsent {};
+            bool reading {true};
+            bool finished {false};
+
+            const auto stop_reading {[&session, &outbox, &waiting, &reading]() {
+                reading = false;
+                waiting = std::jthread {[&session, &outbox]() {
+                    session.wait();
+                    outbox.finish();
+                }};
+            }};
+
+            while (true) {
+                if (unsent.empty()) {
+                    connection_outbox::contents taken {outbox.take()};
+
+                    if (taken.overflowed) {
+                        break;
+                    }
+
+                    unsent = std::move(taken.lines);
+                    finished = taken.finished;
+                }
+
+                if (finished && unsent.empty()) {
+                    break;
+                }
+
+                const auto socket_events {static_cast<short>((reading ? POLLIN : 0) |
+                                                             (unsent.empty() ? 0 : POLLOUT))};
+                std::array<pollfd, 2> descriptors {
+                    {{connection, socket_events, 0}, {wake_pipe.at(0), POLLIN, 0}}};
+
+                if (poll(descriptors.data(), descriptors.size(), -1) < 0) {
+                    if (errno == EINTR) {
+                        continue;
+                    }
+
+                    break;
+                }
+
+                while (read(wake_pipe.at(0), buffer.data(), buffer.size()) > 0) {
+                }
+
+                const short socket_state {descriptors.at(0).revents};
+
+                if ((socket_state & (POLLHUP | POLLERR)) != 0) {
+                    break; // Closed both ways, nobody is left to answer
+                }
+
+                if ((socket_state & POLLIN) != 0) {
+                    const ssize_t received {read(connection, buffer.data(), buffer.size())};
+
+                    if (received < 0 && errno != EINTR) {
+                        break;
+                    }
+
+                    if (received == 0) {
+                        session.handle_line(pending); // The client only sends no more
+                        stop_reading();
+                    }
+
+                    else if (received > 0) {
+                        pending.append(buffer.data(), static_cast<std::size_t>(received));
+
+                        for (std::size_t end {pending.find('\n')}; end != std::string::npos;
+                             end = pending.find('\n')) {
+                            session.handle_line(std::string_view {pending}.substr(0, end));
+                            pending.erase(0, end + 1);
+                        }
+
+                        // Where the line ends is lost, and with it the requests after it
+                        if (pending.size() > max_request_length) {
+                            outbox.push(R"({"error":"request longer than )" +
+                                        std::to_string(max_request_length) + " bytes\"}");
+                            stop_reading();
+                        }
+                    }
+                }
+
+                if ((socket_state & POLLOUT) != 0) {
+                    const ssize_t written {send(connection, unsent.data(), unsent.size(),
+                                                MSG_NOSIGNAL | MSG_DONTWAIT)};
+
+                    if (written < 0 && errno != EAGAIN && errno != EINTR) {
+                        break; // The client has gone
+                    }
+
+                    if (written > 0) {
+                        unsent.erase(0, static_cast<std::size_t>(written));
+                    }
+                }
+            }
+
+            // Only a client that is gone or too far behind leaves requests open here
+            session.cancel();
+        } // Waits for the open requests to be answered before the connection closes
+
+        close(wake_pipe.at(0));
+        close(wake_pipe.at(1));
+        close(connection);
+    }
+
+    int serve_socket(esochess::analysis_server& server, const std::string& path) {
+        sockaddr_un address {};
+
+        if (path.size() >= sizeof(address.sun_path)) {
+            std::cerr << "Socket path " << path << " is too long\n";
+            return 1;
+        }
+
+        address.sun_family = AF_UNIX;
+        std::ranges::copy(path, static_cast<char*>(address.sun_path));
+
+        const int listener {socket(AF_UNIX, SOCK_STREAM, 0)};
+
+        unlink(path.c_str());
+
+        if (listener < 0 ||
+            bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(listener, SOMAXCONN) != 0) {
+            std::cerr << "Could not listen on " << path << ": " << std::strerror(errno) << '\n';
+            return 1;
+        }
+
+        std::cerr << "Listening on " << path << '\n';
+
+        struct connection_thread {
+            std::unique_ptr<std::atomic<bool>> finished;
+            std::jthread thread; // Joined before `finished` is freed
+        };
+
+        std::vector<connection_thread> connections {};
+
+        while (true) {
+            const int connection {accept(listener, nullptr, nullptr)};
+
+            if (connection < 0 && (errno == EINTR || errno == ECONNABORTED)) {
+                continue; // Interrupted, or the client left before it was accepted
+            }
+
+            if (connection < 0) {
+                break;
+            }
+
+            // Joins the sessions whose clients have gone, so closed connections do not pile up
+            std::erase_if(connections, [](const connection_thread& session) {
+                return session.finished->load();
+            });
+
+            auto finished {std::make_unique<std::atomic<bool>>(false)};
+            std::atomic<bool>* const finished_flag {finished.get()};
+
+            connections.push_back(
+                {std::move(finished), std::jthread {[&server, connection, finished_flag]() {
+                     serve_connection(server, connection);
+                     finished_flag->store(true);
+                 }}});
+        }
+
+        std::cerr << "Stopped accepting connections: " << std::strerror(errno) << '\n';
+        close(listener);
+
+        return 1;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string_view> arguments {argv + 1, argv + argc};
+    esochess::analysis_server_options options {std::max(1U, std::thread::hardware_concurrency()),
+                                               16, esochess::search_limits {}, 0,
+                                               std::chrono::milliseconds {0}, false};
+    std::optional<std::string> socket_path {};
+    bool valid_arguments {true};
+
+    options.default_limits.depth = 10;
+
+    for (std::size_t index {}; index < arguments.size(); index++) {
+        const bool has_value {index + 1 < arguments.size()};
+        // The next argument, or `minimum` with the arguments marked invalid
+        const auto number {[&](std::int64_t minimum, std::int64_t maximum) {
+            const std::optional<std::int64_t> value {
+                esochess::parse_integer(arguments.at(++index), minimum, maximum)};
+
+            valid_arguments = valid_arguments && value.has_value();
+            return value.value_or(minimum);
+        }};
+
+        if (arguments.at(index) == "--socket" && has_value) {
+            socket_path = std::string {arguments.at(++index)};
+        }
+
+        else if (arguments.at(index) == "--threads" && has_value) {
+            options.thread_count = static_cast<std::size_t>(number(1, 1024));
+        }
+
+        else if (arguments.at(index) == "--hash" && has_value) {
+            options.hash_megabytes = static_cast<std::size_t>(number(1, 1 << 20));
+        }
+
+        else if (arguments.at(index) == "--depth" && has_value) {
+            options.default_limits.depth = static_cast<int>(number(1, esochess::max_search_ply));
+        }
+
+        else if (arguments.at(index) == "--max-nodes" && has_value) {
+            options.max_nodes =
+                static_cast<std::uint64_t>(number(0, std::numeric_limits<std::int64_t>::max()));
+        }
+
+        else if (arguments.at(index) == "--max-time" && has_value) {
+            options.max_move_time =
+                std::chrono::milliseconds {number(0, std::numeric_limits<std::int32_t>::max())};
+        }
+
+        else if (arguments.at(index) == "--pin") {
+            options.pin_workers = true;
+        }
+
+        else {
+            valid_arguments = false;
+        }
+    }
+
+    if (!valid_arguments) {
+        std::cerr << "Usage: " << argv [0]
+                  << " [--socket PATH] [--threads N] [--hash MB] [--depth N]"
+                     " [--max-nodes N] [--max-time MS] [--pin]\n"
+                     "Reads line delimited JSON requests from stdin unless given a socket\n"
+                     "Requests without limits search to --depth, 10 by default\n";
+        return 1;
+    }
+
+    esochess::analysis_server server {options};
+
+    if (socket_path.has_value()) {
+        return serve_socket(server, *socket_path);
+    }
+
+    esochess::analysis_session session {
+        server, [](std::string_view line) { std::cout << line << std::endl; }};
+
+    for (std::string line {}; std::getline(std::cin, line);) {
+        session.handle_line(line);
+    }
+
+    session.wait();
+
+    return 0;
+}
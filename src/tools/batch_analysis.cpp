@@ -0,0 +1,122 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <headers/batch_analysis.hpp>
+#include <headers/search.hpp>
+#include <headers/uci.hpp>
+
+int main(int argc, char** argv) {
+    using clock = std::chrono::steady_clock;
+
+    std::vector<std::string_view> arguments {argv + 1, argv + argc};
+    esochess::batch_analysis_options options {std::max(1U, std::thread::hardware_concurrency()),
+                                              16, esochess::search_limits {}, 0};
+    std::optional<std::string_view> input_path {};
+    std::optional<std::string_view> output_path {};
+    bool valid_arguments {true};
+
+    for (std::size_t index {}; index < arguments.size(); index++) {
+        const bool has_value {index + 1 < arguments.size()};
+        // The next argument, or `minimum` with the arguments marked invalid
+        const auto number {[&](std::int64_t minimum, std::int64_t maximum) {
+            const std::optional<std::int64_t> value {
+                esochess::parse_integer(arguments.at(++index), minimum, maximum)};
+
+            valid_arguments = valid_arguments && value.has_value();
+            return value.value_or(minimum);
+        }};
+
+        if (arguments.at(index) == "--threads" && has_value) {
+            options.thread_count = static_cast<std::size_t>(number(1, 1024));
+        }
+
+        else if (arguments.at(index) == "--hash" && has_value) {
+            options.hash_megabytes = static_cast<std::size_t>(number(1, 1 << 20));
+        }
+
+        else if (arguments.at(index) == "--depth" && has_value) {
+            options.limits.depth = static_cast<int>(number(1, esochess::max_search_ply));
+        }
+
+        else if (arguments.at(index) == "--nodes" && has_value) {
+            options.limits.nodes =
+                static_cast<std::uint64_t>(number(1, std::numeric_limits<std::int64_t>::max()));
+        }
+
+        else if (arguments.at(index) == "--window" && has_value) {
+            options.window = static_cast<std::size_t>(number(1, 1 << 20));
+        }
+
+        else if (!input_path.has_value()) {
+            input_path = arguments.at(index);
+        }
+
+        else {
+            output_path = arguments.at(index);
+        }
+    }
+
+    if (!input_path.has_value() || !valid_arguments) {
+        std::cerr << "Usage: " << argv [0]
+                  << " <input.epd|-> [output.epd] [--threads N] [--hash MB] [--depth N]"
+                     " [--nodes N] [--window N]\n"
+                     "Searches to depth 8 unless a depth or node limit is given\n";
+        return 1;
+    }
+
+    if (!options.limits.depth.has_value() && !options.limits.nodes.has_value()) {
+        options.limits.depth = 8;
+    }
+
+    if (options.window == 0) {
+        options.window = 4 * options.thread_count;
+    }
+
+    std::ifstream input_file {};
+    std::ofstream output_file {};
+
+    if (*input_path != "-") {
+        input_file.open(std::string {*input_path});
+
+        if (!input_file.is_open()) {
+            std::cerr << "Could not open " << *input_path << '\n';
+            return 1;
+        }
+    }
+
+    if (output_path.has_value()) {
+        output_file.open(std::string {*output_path});
+
+        if (!output_file.is_open()) {
+            std::cerr << "Could not create " << *output_path << '\n';
+            return 1;
+        }
+    }
+
+    std::istream& input {*input_path == "-" ? std::cin : input_file};
+    std::ostream& output {output_path.has_value() ? output_file : std::cout};
+
+    const clock::time_point start {clock::now()};
+    const esochess::batch_analysis_statistics statistics {
+        esochess::analyse_positions(input, output, options)};
+    const std::chrono::duration<double> duration {clock::now() - start};
+
+    std::cerr << "Analysed " << statistics.positions << " positions ("
+              << statistics.invalid_lines << " invalid lines) with " << options.thread_count
+              << " threads in " << duration.count() << "s ("
+              << static_cast<double>(statistics.positions) / duration.count()
+              << " positions/sec, "
+              << static_cast<double>(statistics.nodes) / duration.count() << " nodes/sec)\n";
+
+    return statistics.invalid_lines == 0 ? 0 : 1;
+}
@@ -0,0 +1,293 @@
+#include <sys/resource.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <headers/bitboard.hpp>
+#include <headers/packed_position.hpp>
+#include <headers/position_index.hpp>
+#include <headers/uci.hpp>
+
+namespace {
+    constexpr std::size_t block_size {1 << 16};
+
+    struct dedup_counts {
+        std::uint64_t positions;
+        std::uint64_t unique;
+        std::uint64_t invalid;
+    };
+
+    std::optional<std::uint64_t> key_of_line(std::string_view line) {
+        const auto board {esochess::bitboard::from_epd(line)};
+
+        return board.has_value() ? std::optional {board->hash()} : std::nullopt;
+    }
+
+    void run_workers(std::size_t worker_count, const std::function<void(std::size_t)>& work) {
+        std::vector<std::jthread> workers {};
+
+        for (std::size_t worker {}; worker < worker_count; worker++) {
+            workers.emplace_back(work, worker);
+        }
+    }
+
+    // Marks the first occurrence of every key not seen in earlier blocks. Each worker inserts the
+    // keys of its own shards in order, so the result does not depend on the thread count.
+    std::error_code mark_unique(esochess::position_index& index,
+                                std::span<const std::optional<std::uint64_t>> keys,
+                                std::vector<char>& unique, std::size_t worker_count) {
+        std::vector<std::error_code> errors(worker_count);
+
+        unique.assign(keys.size(), 0);
+        run_workers(worker_count, [&](std::size_t worker) {
+            for (std::size_t item {}; item < keys.size(); item++) {
+                if (!keys [item].has_value() ||
+                    index.shard_of(*keys [item]) % worker_count != worker) {
+                    continue;
+                }
+
+                const std::expected<bool, std::error_code> inserted {index.insert(*keys [item])};
+
+                if (!inserted.has_value()) {
+                    errors.at(worker) = inserted.error();
+                    return;
+                }
+
+                unique [item] = *inserted ? 1 : 0;
+            }
+        });
+
+        const auto error {std::ranges::find_if(errors, [](std::error_code code) {
+            return static_cast<bool>(code);
+        })};
+
+        return error == errors.end() ? std::error_code {} : *error;
+    }
+
+    std::expected<dedup_counts, std::error_code>
+        dedup_dataset(const esochess::position_dataset_reader& reader,
+                      const std::string& output_path, esochess::position_index& index,
+                      std::size_t worker_count) {
+        auto writer {esochess::position_dataset_writer::create(output_path)};
+
+        if (!writer.has_value()) {
+            return std::unexpected {writer.error()};
+        }
+
+        dedup_counts counts {0, 0, 0};
+        std::vector<std::optional<std::uint64_t>> keys {};
+        std::vector<char> unique {};
+
+        for (std::size_t start {}; start < reader.size(); start += block_size) {
+            const std::span<const esochess::packed_position> block {
+                reader.positions().subspan(start, std::min(block_size, reader.size() - start))};
+
+            keys.resize(block.size());
+            run_workers(worker_count, [&](std::size_t worker) {
+                for (std::size_t item {worker}; item < block.size(); item += worker_count) {
+                    const auto board {block [item].to_bitboard()};
+
+                    keys [item] = board.has_value() ? std::optional {board->hash()} : std::nullopt;
+                }
+            });
+
+            if (const std::error_code error {mark_unique(index, keys, unique, worker_count)}) {
+                return std::unexpected {error};
+            }
+
+            for (std::size_t item {}; item < block.size(); item++) {
+                if (!keys [item].has_value()) {
+                    counts.invalid++;
+                }
+
+                else if (unique [item] != 0) {
+                    writer->write(block [item]);
+                    counts.unique++;
+                }
+            }
+
+            counts.positions += block.size();
+        }
+
+        if (const std::error_code error {writer->close()}) {
+            return std::unexpected {error};
+        }
+
+        return counts;
+    }
+
+    std::expected<dedup_counts, std::error_code> dedup_lines(const std::string& input_path,
+                                                             const std::string& output_path,
+                                                             esochess::position_index& index,
+                                                             std::size_t worker_count) {
+        std::ifstream input {input_path};
+        std::ofstream output {output_path};
+
+        if (!input.is_open() || !output.is_open()) {
+            return std::unexpected {std::error_code {errno, std::generic_category()}};
+        }
+
+        dedup_counts counts {0, 0, 0};
+        std::vector<std::string> lines {};
+        std::vector<std::optional<std::uint64_t>> keys {};
+        std::vector<char> unique {};
+
+        for (bool input_left {true}; input_left;) {
+            lines.clear();
+
+            for (std::string line {}; lines.size() < block_size;) {
+                if (!std::getline(input, line)) {
+                    input_left = false;
+                    break;
+                }
+
+                if (line.find_first_not_of(" \t\r") != std::string::npos) {
+                    lines.push_back(std::move(line));
+                }
+            }
+
+            keys.resize(lines.size());
+            run_workers(worker_count, [&](std::size_t worker) {
+                for (std::size_t item {worker}; item < lines.size(); item += worker_count) {
+                    keys [item] = key_of_line(lines [item]);
+                }
+            });
+
+            if (const std::error_code error {mark_unique(index, keys, unique, worker_count)}) {
+                return std::unexpected {error};
+            }
+
+            for (std::size_t item {}; item < lines.size(); item++) {
+                if (!keys [item].has_value()) {
+                    counts.invalid++;
+                }
+
+                else if (unique [item] != 0) {
+                    output << lines [item] << '\n';
+                    counts.unique++;
+                }
+            }
+
+            counts.positions += lines.size();
+        }
+
+        output.close();
+
+        if (output.fail()) {
+            return std::unexpected {std::make_error_code(std::errc::io_error)};
+        }
+
+        return counts;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    using clock = std::chrono::steady_clock;
+
+    std::vector<std::string_view> arguments {argv + 1, argv + argc};
+    std::size_t worker_count {std::max(1U, std::thread::hardware_concurrency())};
+    esochess::position_index_options options {64, std::size_t {1024} << 20U,
+                                              std::filesystem::temp_directory_path()};
+    std::vector<std::string_view> paths {};
+    bool valid_arguments {true};
+
+    for (std::size_t index {}; index < arguments.size(); index++) {
+        const bool has_value {index + 1 < arguments.size()};
+        // The next argument, or `minimum` with the arguments marked invalid
+        const auto number {[&](std::int64_t minimum, std::int64_t maximum) {
+            const std::optional<std::int64_t> value {
+                esochess::parse_integer(arguments.at(++index), minimum, maximum)};
+
+            valid_arguments = valid_arguments && value.has_value();
+            return value.value_or(minimum);
+        }};
+
+        if (arguments.at(index) == "--threads" && has_value) {
+            worker_count = static_cast<std::size_t>(number(1, 1024));
+        }
+
+        else if (arguments.at(index) == "--memory" && has_value) {
+            options.memory_limit_bytes = static_cast<std::size_t>(number(1, 1 << 24)) << 20U;
+        }
+
+        else if (arguments.at(index) == "--shards" && has_value) {
+            options.shard_count = static_cast<std::size_t>(number(1, 1 << 16));
+        }
+
+        else if (arguments.at(index) == "--spill-dir" && has_value) {
+            options.spill_directory = std::string {arguments.at(++index)};
+        }
+
+        else {
+            paths.push_back(arguments.at(index));
+        }
+    }
+
+    if (paths.size() != 2 || !valid_arguments) {
+        std::cerr << "Usage: " << argv [0]
+                  << " <input.fen|input.epd|input.bin> <output> [--threads N] [--memory MB]"
+                     " [--shards N] [--spill-dir DIR]\n"
+                     "Keeps the first line or packed position of every distinct position, by"
+                     " Zobrist key,\nspilling keys to DIR beyond MB megabytes (1024 by default)\n";
+        return 1;
+    }
+
+    const std::string input_path {paths.at(0)};
+    const std::string output_path {paths.at(1)};
+    auto index {esochess::position_index::create(options)};
+
+    if (!index.has_value()) {
+        std::cerr << "Could not create the spill directory in " << options.spill_directory
+                  << ": " << index.error().message() << '\n';
+        return 1;
+    }
+
+    const clock::time_point start {clock::now()};
+    const auto reader {esochess::position_dataset_reader::open(input_path)};
+    const std::expected<dedup_counts, std::error_code> counts {
+        reader.has_value() ? dedup_dataset(*reader, output_path, *index, worker_count)
+                           : dedup_lines(input_path, output_path, *index, worker_count)};
+
+    if (!counts.has_value()) {
+        std::cerr << "Could not deduplicate " << input_path << " into " << output_path << ": "
+                  << counts.error().message() << '\n';
+        return 1;
+    }
+
+    const std::chrono::duration<double> duration {clock::now() - start};
+    const esochess::position_index_statistics statistics {index->statistics()};
+    rusage usage {};
+
+    getrusage(RUSAGE_SELF, &usage);
+
+    std::cout << "Kept " << counts->unique << " of " << counts->positions << " positions ("
+              << counts->positions - counts->unique - counts->invalid << " duplicates, "
+              << counts->invalid << " invalid entries) with " << worker_count << " threads in "
+              << duration.count() << "s ("
+              << static_cast<double>(counts->positions) / duration.count()
+              << " positions/sec)\n";
+    std::cout << "Index: " << statistics.keys << " keys, "
+              << static_cast<double>(statistics.memory_bytes) / (1 << 20)
+              << " MB in memory, " << statistics.spilled_keys << " keys in "
+              << statistics.spill_runs << " spilled runs ("
+              << static_cast<double>(statistics.spill_bytes) / (1 << 20) << " MB), peak RSS "
+              << static_cast<double>(usage.ru_maxrss) / 1024 << " MB\n";
+
+    return counts->invalid == 0 ? 0 : 1;
+}
@@ -0,0 +1,60 @@
+#include <cstddef>
+#include <expected>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <headers/bitboard.hpp>
+#include <headers/packed_position.hpp>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv [0] << " <input.fen|input.epd> <output.bin>\n";
+        return 1;
+    }
+
+    std::ifstream input {argv [1]};
+
+    if (!input.is_open()) {
+        std::cerr << "Could not open " << argv [1] << '\n';
+        return 1;
+    }
+
+    auto writer {esochess::position_dataset_writer::create(argv [2])};
+
+    if (!writer.has_value()) {
+        std::cerr << "Could not create " << argv [2] << ": " << writer.error().message() << '\n';
+        return 1;
+    }
+
+    std::string line;
+    std::size_t line_number {0};
+    std::size_t skipped_lines {0};
+
+    while (std::getline(input, line)) {
+        line_number++;
+
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+
+        const auto board {esochess::bitboard::from_epd(line)};
+
+        if (!board.has_value() || !writer->write(*board)) {
+            std::cerr << "Skipping line " << line_number << ": "
+                      << (board.has_value() ? "too many pieces" : board.error().to_string())
+                      << '\n';
+            skipped_lines++;
+        }
+    }
+
+    const std::uint64_t position_count {writer->position_count()};
+
+    if (const std::error_code error {writer->close()}) {
+        std::cerr << "Could not write " << argv [2] << ": " << error.message() << '\n';
+        return 1;
+    }
+
+    std::cout << "Wrote " << position_count << " positions, skipped " << skipped_lines
+              << " lines\n";
+}
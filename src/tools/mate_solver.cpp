@@ -0,0 +1,167 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <headers/bitboard.hpp>
+#include <headers/mate_solver.hpp>
+#include <headers/uci.hpp>
+
+namespace {
+    // The `dm` (direct mate) operation of an EPD line, such as `dm 3;`, nothing when it is
+    // absent or not a move count
+    std::optional<int> direct_mate_of(std::string_view line) {
+        const std::size_t operation {line.find(" dm ")};
+
+        if (operation == std::string_view::npos) {
+            return std::nullopt;
+        }
+
+        const std::string_view operand {line.substr(operation + 4)};
+
+        return esochess::parse_integer(operand.substr(0, operand.find_first_of("; \t\r")), 1,
+                                       esochess::max_search_ply / 2)
+            .transform([](std::int64_t moves) { return static_cast<int>(moves); });
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    std::vector<std::string_view> arguments {argv + 1, argv + argc};
+    std::size_t hash_megabytes {esochess::mate_solver::default_table_megabytes};
+    esochess::mate_solver_limits limits {5, std::nullopt, std::nullopt};
+    std::optional<std::string_view> input_path {};
+    bool valid_arguments {true};
+
+    for (std::size_t index {}; index < arguments.size(); index++) {
+        const bool has_value {index + 1 < arguments.size()};
+        // The next argument, or `minimum` with the arguments marked invalid
+        const auto number {[&](std::int64_t minimum, std::int64_t maximum) {
+            const std::optional<std::int64_t> value {
+                esochess::parse_integer(arguments.at(++index), minimum, maximum)};
+
+            valid_arguments = valid_arguments && value.has_value();
+            return value.value_or(minimum);
+        }};
+
+        if (arguments.at(index) == "--moves" && has_value) {
+            limits.moves = static_cast<int>(number(1, esochess::max_search_ply / 2));
+        }
+
+        else if (arguments.at(index) == "--hash" && has_value) {
+            hash_megabytes = static_cast<std::size_t>(number(1, 1 << 20));
+        }
+
+        else if (arguments.at(index) == "--nodes" && has_value) {
+            limits.nodes =
+                static_cast<std::uint64_t>(number(1, std::numeric_limits<std::int64_t>::max()));
+        }
+
+        else if (arguments.at(index) == "--time" && has_value) {
+            limits.time =
+                std::chrono::milliseconds {number(1, std::numeric_limits<std::int32_t>::max())};
+        }
+
+        else {
+            input_path = arguments.at(index);
+        }
+    }
+
+    if (!input_path.has_value() || !valid_arguments) {
+        std::cerr << "Usage: " << argv [0]
+                  << " <input.fen|input.epd|-> [--moves N] [--hash MB] [--nodes N] [--time MS]\n"
+                     "EPD lines with a `dm N` operation are solved up to N moves and checked\n";
+        return 1;
+    }
+
+    std::ifstream input_file {};
+
+    if (*input_path != "-") {
+        input_file.open(std::string {*input_path});
+
+        if (!input_file.is_open()) {
+            std::cerr << "Could not open " << *input_path << '\n';
+            return 1;
+        }
+    }
+
+    std::istream& input {*input_path == "-" ? std::cin : input_file};
+    esochess::mate_solver solver {hash_megabytes};
+
+    std::size_t positions {0};
+    std::size_t mates {0};
+    std::size_t wrong_mates {0};
+    std::size_t unsolved {0};
+    std::uint64_t total_nodes {0};
+    std::chrono::milliseconds total_time {0};
+    std::string line;
+
+    while (std::getline(input, line)) {
+        if (line.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+
+        const auto board {esochess::bitboard::from_epd(line)};
+
+        if (!board.has_value()) {
+            std::cerr << "Skipping " << line << ": " << board.error().to_string() << '\n';
+            continue;
+        }
+
+        const std::optional<int> expected_mate {direct_mate_of(line)};
+        esochess::mate_solver_limits position_limits {limits};
+
+        position_limits.moves = expected_mate.value_or(limits.moves);
+        solver.clear();
+
+        const esochess::mate_solution solution {solver.solve(*board, position_limits)};
+        const std::uint64_t milliseconds {
+            static_cast<std::uint64_t>(std::max<std::int64_t>(solution.time.count(), 1))};
+
+        positions++;
+        total_nodes += solution.nodes;
+        total_time += solution.time;
+
+        std::cout << board->to_epd() << ": ";
+
+        if (solution.mate_in.has_value()) {
+            mates++;
+            std::cout << "mate in " << *solution.mate_in << " pv";
+
+            for (const esochess::bitboard::move& chess_move: solution.principal_variation) {
+                std::cout << ' ' << esochess::move_to_uci(chess_move);
+            }
+        }
+
+        else {
+            unsolved += solution.disproven ? 0 : 1;
+            std::cout << (solution.disproven ? "no mate" : "unknown") << " in "
+                      << position_limits.moves;
+        }
+
+        if (expected_mate.has_value() && solution.mate_in != expected_mate) {
+            wrong_mates++;
+            std::cout << " (expected mate in " << *expected_mate << ')';
+        }
+
+        std::cout << " nodes " << solution.nodes << " time " << solution.time.count()
+                  << "ms nps " << solution.nodes * 1000 / milliseconds << '\n';
+    }
+
+    const std::uint64_t milliseconds {
+        static_cast<std::uint64_t>(std::max<std::int64_t>(total_time.count(), 1))};
+
+    std::cout << "\nPositions       : " << positions << "\nMates found     : " << mates
+              << "\nUnknown         : " << unsolved << "\nWrong mates     : " << wrong_mates
+              << "\nNodes           : " << total_nodes
+              << "\nTotal time (ms) : " << total_time.count()
+              << "\nNodes/second    : " << total_nodes * 1000 / milliseconds << '\n';
+
+    return wrong_mates == 0 ? 0 : 1;
+}
@@ -0,0 +1,113 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <headers/bitboard.hpp>
+#include <headers/perft.hpp>
+#include <headers/san.hpp>
+#include <headers/search.hpp>
+#include <headers/uci.hpp>
+
+int main(int argc, char** argv) {
+    using clock = std::chrono::steady_clock;
+
+    std::vector<std::string_view> arguments {argv + 1, argv + argc};
+    std::size_t thread_count {std::max(1U, std::thread::hardware_concurrency())};
+    std::size_t hash_megabytes {64};
+    bool divide {false};
+    std::optional<std::string> fen {};
+    std::optional<int> max_depth {};
+    bool valid_arguments {true};
+
+    for (std::size_t index {}; index < arguments.size(); index++) {
+        const bool has_value {index + 1 < arguments.size()};
+        // The next argument, or `minimum` with the arguments marked invalid
+        const auto number {[&](std::int64_t minimum, std::int64_t maximum) {
+            const std::optional<std::int64_t> value {
+                esochess::parse_integer(arguments.at(++index), minimum, maximum)};
+
+            valid_arguments = valid_arguments && value.has_value();
+            return value.value_or(minimum);
+        }};
+
+        if (arguments.at(index) == "--threads" && has_value) {
+            thread_count = static_cast<std::size_t>(number(1, 1024));
+        }
+
+        else if (arguments.at(index) == "--hash" && has_value) {
+            hash_megabytes = static_cast<std::size_t>(number(1, 1 << 20));
+        }
+
+        else if (arguments.at(index) == "--divide") {
+            divide = true;
+        }
+
+        else if (!max_depth.has_value() && esochess::parse_integer(arguments.at(index))) {
+            const std::optional<std::int64_t> depth {
+                esochess::parse_integer(arguments.at(index), 0, esochess::max_search_ply)};
+
+            valid_arguments = valid_arguments && depth.has_value();
+            max_depth = static_cast<int>(depth.value_or(0));
+        }
+
+        else {
+            fen = arguments.at(index) == "startpos" ? std::string {
+                                                          esochess::bitboard::starting_position_fen}
+                                                    : std::string {arguments.at(index)};
+        }
+    }
+
+    if (!max_depth.has_value() || !valid_arguments) {
+        std::cerr << "Usage: " << argv [0]
+                  << " [fen|startpos] <depth> [--threads N] [--hash MB] [--divide]\n";
+        return 1;
+    }
+
+    auto board {
+        esochess::bitboard::from_fen(fen.value_or(esochess::bitboard::starting_position_fen))};
+
+    if (!board.has_value()) {
+        std::cerr << "Invalid FEN: " << board.error().to_string() << '\n';
+        return 1;
+    }
+
+    std::optional<esochess::perft_table> table {};
+
+    if (hash_megabytes > 0) {
+        table.emplace(hash_megabytes);
+    }
+
+    esochess::perft_table* const table_pointer {table.has_value() ? &*table : nullptr};
+
+    for (int depth {1}; depth <= *max_depth; depth++) {
+        const clock::time_point start {clock::now()};
+        const std::vector<esochess::perft_divide_entry> entries {
+            esochess::perft_divide(*board, depth, thread_count, table_pointer)};
+        const std::chrono::duration<double> duration {clock::now() - start};
+
+        std::uint64_t nodes {0};
+
+        for (const esochess::perft_divide_entry& entry: entries) {
+            nodes += entry.nodes;
+        }
+
+        std::cout << "depth " << depth << " nodes " << nodes << " time " << duration.count()
+                  << "s nps " << static_cast<std::uint64_t>(static_cast<double>(nodes) /
+                                                            std::max(duration.count(), 1e-9))
+                  << '\n';
+
+        if (divide && depth == *max_depth) {
+            for (const esochess::perft_divide_entry& entry: entries) {
+                std::cout << esochess::move_to_san(*board, entry.root_move) << ": " << entry.nodes
+                          << '\n';
+            }
+        }
+    }
+}
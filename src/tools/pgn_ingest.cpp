@@ -0,0 +1,130 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <headers/packed_position.hpp>
+#include <headers/pgn.hpp>
+#include <headers/uci.hpp>
+
+int main(int argc, char** argv) {
+    using clock = std::chrono::steady_clock;
+
+    std::vector<std::string_view> arguments {argv + 1, argv + argc};
+    std::size_t thread_count {std::max(1U, std::thread::hardware_concurrency())};
+    std::optional<std::string> input_path {};
+    std::optional<std::string> output_path {};
+    bool valid_arguments {true};
+
+    for (std::size_t index {}; index < arguments.size(); index++) {
+        if (arguments.at(index) == "--threads" && index + 1 < arguments.size()) {
+            const std::optional<std::int64_t> threads {
+                esochess::parse_integer(arguments.at(++index), 1, 1024)};
+
+            // The per worker vectors below are sized from this, so it must match `replay`
+            valid_arguments = valid_arguments && threads.has_value();
+            thread_count = static_cast<std::size_t>(threads.value_or(1));
+        }
+
+        else if (!input_path.has_value()) {
+            input_path = arguments.at(index);
+        }
+
+        else {
+            output_path = arguments.at(index);
+        }
+    }
+
+    if (!input_path.has_value() || !valid_arguments) {
+        std::cerr << "Usage: " << argv [0] << " <games.pgn> [positions.bin] [--threads N]\n";
+        return 1;
+    }
+
+    const auto reader {esochess::pgn_reader::open(*input_path)};
+
+    if (!reader.has_value()) {
+        std::cerr << "Could not open " << *input_path << ": " << reader.error().message() << '\n';
+        return 1;
+    }
+
+    std::optional<esochess::position_dataset_writer> writer {};
+
+    if (output_path.has_value()) {
+        auto created_writer {esochess::position_dataset_writer::create(*output_path)};
+
+        if (!created_writer.has_value()) {
+            std::cerr << "Could not create " << *output_path << ": "
+                      << created_writer.error().message() << '\n';
+            return 1;
+        }
+
+        writer.emplace(std::move(*created_writer));
+    }
+
+    static constexpr std::size_t flush_threshold {4096};
+
+    std::mutex writer_mutex {};
+    std::vector<std::vector<esochess::packed_position>> pending_positions(thread_count);
+    std::vector<std::uint64_t> worker_checksums(thread_count);
+
+    const auto flush_positions {[&](std::vector<esochess::packed_position>& positions) {
+        const std::lock_guard<std::mutex> lock {writer_mutex};
+
+        for (const esochess::packed_position& position: positions) {
+            writer->write(position);
+        }
+
+        positions.clear();
+    }};
+
+    const clock::time_point start {clock::now()};
+
+    const esochess::pgn_ingest_statistics statistics {
+        reader->replay(thread_count, [&](const esochess::pgn_move_visit& visit) {
+            worker_checksums [visit.worker_index] ^= visit.position_after.hash();
+
+            if (!writer.has_value()) {
+                return;
+            }
+
+            std::vector<esochess::packed_position>& positions {
+                pending_positions [visit.worker_index]};
+
+            if (const auto position {
+                    esochess::packed_position::from_bitboard(visit.position_after)}) {
+                positions.push_back(*position);
+            }
+
+            if (positions.size() >= flush_threshold) {
+                flush_positions(positions);
+            }
+        })};
+
+    if (writer.has_value()) {
+        for (std::vector<esochess::packed_position>& positions: pending_positions) {
+            flush_positions(positions);
+        }
+
+        writer->close();
+    }
+
+    const std::chrono::duration<double> duration {clock::now() - start};
+    std::uint64_t checksum {0};
+
+    for (const std::uint64_t worker_checksum: worker_checksums) {
+        checksum ^= worker_checksum;
+    }
+
+    std::cout << "Replayed " << statistics.games << " games and " << statistics.moves
+              << " moves in " << duration.count() << "s ("
+              << static_cast<double>(statistics.moves) / duration.count() << " moves/sec)\n";
+    std::cout << "Unresolved games: " << statistics.unresolved_games << '\n';
+    std::cout << "Position hash checksum: " << std::hex << checksum << '\n';
+}
@@ -0,0 +1,93 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+#include <headers/pgn.hpp>
+#include <headers/polyglot_book.hpp>
+#include <headers/uci.hpp>
+
+int main(int argc, char** argv) {
+    using clock = std::chrono::steady_clock;
+
+    std::vector<std::string_view> arguments {argv + 1, argv + argc};
+    std::size_t thread_count {std::max(1U, std::thread::hardware_concurrency())};
+    esochess::polyglot_book_builder::options builder_options {24, 1};
+    std::optional<std::string> output_path {};
+    std::vector<std::string> input_paths {};
+    bool valid_arguments {true};
+
+    for (std::size_t index {}; index < arguments.size(); index++) {
+        const bool has_value {index + 1 < arguments.size()};
+        // The next argument, or `minimum` with the arguments marked invalid
+        const auto number {[&](std::int64_t minimum, std::int64_t maximum) {
+            const std::optional<std::int64_t> value {
+                esochess::parse_integer(arguments.at(++index), minimum, maximum)};
+
+            valid_arguments = valid_arguments && value.has_value();
+            return value.value_or(minimum);
+        }};
+
+        if (arguments.at(index) == "--threads" && has_value) {
+            thread_count = static_cast<std::size_t>(number(1, 1024));
+        }
+
+        else if (arguments.at(index) == "--max-ply" && has_value) {
+            builder_options.max_ply = static_cast<int>(number(1, 10000));
+        }
+
+        else if (arguments.at(index) == "--min-games" && has_value) {
+            builder_options.minimum_games = static_cast<std::uint32_t>(
+                number(1, std::numeric_limits<std::uint32_t>::max()));
+        }
+
+        else if (!output_path.has_value()) {
+            output_path = arguments.at(index);
+        }
+
+        else {
+            input_paths.emplace_back(arguments.at(index));
+        }
+    }
+
+    if (!output_path.has_value() || input_paths.empty() || !valid_arguments) {
+        std::cerr << "Usage: " << argv [0]
+                  << " <book.bin> <games.pgn>... [--threads N] [--max-ply N] [--min-games N]\n";
+        return 1;
+    }
+
+    esochess::polyglot_book_builder builder {builder_options};
+    esochess::pgn_ingest_statistics statistics {};
+    const clock::time_point start {clock::now()};
+
+    for (const std::string& input_path: input_paths) {
+        const auto reader {esochess::pgn_reader::open(input_path)};
+
+        if (!reader.has_value()) {
+            std::cerr << "Could not open " << input_path << ": " << reader.error().message()
+                      << '\n';
+            return 1;
+        }
+
+        statistics += builder.add_games(*reader, thread_count);
+    }
+
+    if (const std::error_code error {builder.write(*output_path)}) {
+        std::cerr << "Could not write " << *output_path << ": " << error.message() << '\n';
+        return 1;
+    }
+
+    const std::chrono::duration<double> duration {clock::now() - start};
+
+    std::cout << "Built a book of " << builder.size() << " moves from " << statistics.games
+              << " games (" << statistics.unresolved_games << " unresolved) in "
+              << duration.count() << "s\n";
+}
@@ -0,0 +1,63 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include <headers/bitboard.hpp>
+#include <headers/polyglot_book.hpp>
+#include <headers/san.hpp>
+
+int main(int argc, char** argv) {
+    using clock = std::chrono::steady_clock;
+
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv [0] << " <book.bin> [fen]\n";
+        return 1;
+    }
+
+    const auto book {esochess::polyglot_book::open(argv [1])};
+
+    if (!book.has_value()) {
+        std::cerr << "Could not open " << argv [1] << ": " << book.error().message() << '\n';
+        return 1;
+    }
+
+    auto board {esochess::bitboard::from_fen(
+        argc > 2 ? argv [2] : esochess::bitboard::starting_position_fen)};
+
+    if (!board.has_value()) {
+        std::cerr << "Invalid FEN: " << board.error().to_string() << '\n';
+        return 1;
+    }
+
+    const std::uint64_t key {esochess::polyglot_key(*board)};
+    const std::vector<esochess::polyglot_entry> entries {book->probe(key)};
+
+    std::cout << "Key " << std::hex << key << std::dec << ", " << entries.size() << " of "
+              << book->size() << " entries\n";
+
+    for (const esochess::polyglot_entry& entry: entries) {
+        const std::optional<esochess::bitboard::move> book_move {
+            esochess::move_from_polyglot_move(*board, entry.move)};
+
+        std::cout << (book_move.has_value() ? esochess::move_to_san(*board, *book_move) : "?")
+                  << " weight " << entry.weight << '\n';
+    }
+
+    static constexpr std::size_t probe_count {100000};
+
+    std::size_t entries_found {0};
+    const clock::time_point start {clock::now()};
+
+    for (std::size_t probe {}; probe < probe_count; probe++) {
+        entries_found += book->probe(key ^ (probe & 1U)).size();
+    }
+
+    const std::chrono::duration<double, std::micro> duration {clock::now() - start};
+
+    std::cout << "Average probe: " << duration.count() / probe_count << "us (" << entries_found
+              << " entries found)\n";
+}
@@ -0,0 +1,158 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <optional>
+#include <random>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <headers/packed_position.hpp>
+#include <headers/search.hpp>
+#include <headers/self_play.hpp>
+#include <headers/uci.hpp>
+
+int main(int argc, char** argv) {
+    using clock = std::chrono::steady_clock;
+
+    std::vector<std::string_view> arguments {argv + 1, argv + argc};
+    esochess::self_play_options options {std::max(1U, std::thread::hardware_concurrency()),
+                                         100,
+                                         5000,
+                                         16,
+                                         std::random_device {}(),
+                                         8,
+                                         400,
+                                         1000,
+                                         8,
+                                         10,
+                                         12,
+                                         80};
+    std::optional<std::string> output_path {};
+    bool valid_arguments {true};
+    constexpr std::int64_t unbounded {std::numeric_limits<std::int64_t>::max()};
+    constexpr std::int64_t max_plies {10000};
+
+    for (std::size_t index {}; index < arguments.size(); index++) {
+        const bool has_value {index + 1 < arguments.size()};
+        // The next argument, or `minimum` with the arguments marked invalid
+        const auto number {[&](std::int64_t minimum, std::int64_t maximum) {
+            const std::optional<std::int64_t> value {
+                esochess::parse_integer(arguments.at(++index), minimum, maximum)};
+
+            valid_arguments = valid_arguments && value.has_value();
+            return value.value_or(minimum);
+        }};
+
+        if (arguments.at(index) == "--threads" && has_value) {
+            options.thread_count = static_cast<std::size_t>(number(1, 1024));
+        }
+
+        else if (arguments.at(index) == "--games" && has_value) {
+            options.games = static_cast<std::uint64_t>(number(1, unbounded));
+        }
+
+        else if (arguments.at(index) == "--nodes" && has_value) {
+            options.nodes = static_cast<std::uint64_t>(number(1, unbounded));
+        }
+
+        else if (arguments.at(index) == "--hash" && has_value) {
+            options.hash_megabytes = static_cast<std::size_t>(number(1, 1 << 20));
+        }
+
+        else if (arguments.at(index) == "--seed" && has_value) {
+            options.seed = static_cast<std::uint64_t>(number(0, unbounded));
+        }
+
+        else if (arguments.at(index) == "--random-plies" && has_value) {
+            options.random_plies = static_cast<int>(number(0, max_plies));
+        }
+
+        else if (arguments.at(index) == "--max-plies" && has_value) {
+            options.max_plies = static_cast<int>(number(1, max_plies));
+        }
+
+        else if (arguments.at(index) == "--resign-score" && has_value) {
+            options.resign_score = static_cast<int>(number(0, esochess::mate_score));
+        }
+
+        else if (arguments.at(index) == "--resign-plies" && has_value) {
+            options.resign_plies = static_cast<int>(number(1, max_plies));
+        }
+
+        else if (arguments.at(index) == "--draw-score" && has_value) {
+            options.draw_score = static_cast<int>(number(0, esochess::mate_score));
+        }
+
+        else if (arguments.at(index) == "--draw-plies" && has_value) {
+            options.draw_plies = static_cast<int>(number(1, max_plies));
+        }
+
+        else if (arguments.at(index) == "--draw-min-ply" && has_value) {
+            options.draw_min_ply = static_cast<int>(number(0, max_plies));
+        }
+
+        else {
+            output_path = arguments.at(index);
+        }
+    }
+
+    if (!output_path.has_value() || !valid_arguments) {
+        std::cerr << "Usage: " << argv [0]
+                  << " <positions.bin> [--threads N] [--games N] [--nodes N] [--hash MB]"
+                     " [--seed N]\n"
+                     "    [--random-plies N] [--max-plies N] [--resign-score CP]"
+                     " [--resign-plies N]\n"
+                     "    [--draw-score CP] [--draw-plies N] [--draw-min-ply N]\n";
+        return 1;
+    }
+
+    auto writer {esochess::position_dataset_writer::create(*output_path)};
+
+    if (!writer.has_value()) {
+        std::cerr << "Could not create " << *output_path << ": " << writer.error().message()
+                  << '\n';
+        return 1;
+    }
+
+    const clock::time_point start {clock::now()};
+    clock::time_point last_report {start};
+
+    const auto report {[&](const esochess::self_play_statistics& statistics) {
+        const clock::time_point now {clock::now()};
+
+        if (now - last_report < std::chrono::seconds {1} && statistics.games < options.games) {
+            return;
+        }
+
+        const std::chrono::duration<double> elapsed {now - start};
+
+        last_report = now;
+        std::cout << "Games " << statistics.games << '/' << options.games << " positions "
+                  << statistics.positions << " (+" << statistics.white_wins << " ="
+                  << statistics.draws << " -" << statistics.black_wins << ") "
+                  << static_cast<double>(statistics.positions) / elapsed.count()
+                  << " positions/sec " << static_cast<double>(statistics.nodes) / elapsed.count()
+                  << " nodes/sec\n";
+    }};
+
+    const esochess::self_play_statistics statistics {
+        esochess::run_self_play(options, *writer, report)};
+
+    if (writer->close()) {
+        std::cerr << "Could not finish " << *output_path << '\n';
+        return 1;
+    }
+
+    const std::chrono::duration<double> duration {clock::now() - start};
+
+    std::cout << "Played " << statistics.games << " games (" << statistics.adjudicated
+              << " adjudicated) and wrote " << statistics.positions << " positions in "
+              << duration.count() << "s ("
+              << static_cast<double>(statistics.positions) / duration.count()
+              << " positions/sec)\n";
+}
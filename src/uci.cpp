@@ -0,0 +1,639 @@
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <limits>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "headers/bench.hpp"
+#include "headers/bitboard.hpp"
+#include "headers/mate_solver.hpp"
+#include "headers/platform.hpp"
+#include "headers/polyglot_book.hpp"
+#include "headers/search.hpp"
+#include "headers/syzygy.hpp"
+#include "headers/uci.hpp"
+
+namespace esochess {
+    namespace {
+        struct parameter_option {
+            std::string_view name;
+            int search_parameters::*parameter;
+            int min;
+            int max;
+        };
+
+        // The selective search parameters, exposed for tuning
+        constexpr std::array<parameter_option, 14> parameter_options {
+            {{"NullMoveMinDepth", &search_parameters::null_move_min_depth, 1, 128},
+             {"NullMoveBaseReduction", &search_parameters::null_move_base_reduction, 0, 16},
+             {"NullMoveDepthDivisor", &search_parameters::null_move_depth_divisor, 1, 64},
+             {"ReductionBase", &search_parameters::reduction_base, -200, 500},
+             {"ReductionDivisor", &search_parameters::reduction_divisor, 50, 1000},
+             {"ReductionMinDepth", &search_parameters::reduction_min_depth, 1, 128},
+             {"ReductionMinMoves", &search_parameters::reduction_min_moves, 1, 256},
+             {"ReverseFutilityMaxDepth", &search_parameters::reverse_futility_max_depth, 0, 16},
+             {"ReverseFutilityMargin", &search_parameters::reverse_futility_margin, 0, 1000},
+             {"FutilityMaxDepth", &search_parameters::futility_max_depth, 0, 16},
+             {"FutilityBaseMargin", &search_parameters::futility_base_margin, 0, 1000},
+             {"FutilityDepthMargin", &search_parameters::futility_depth_margin, 0, 1000},
+             {"LateMovePruningMaxDepth", &search_parameters::late_move_pruning_max_depth, 0, 16},
+             {"LateMovePruningBase", &search_parameters::late_move_pruning_base, 1, 256}}};
+
+        std::vector<std::string_view> split_words(std::string_view text) {
+            std::vector<std::string_view> words {};
+
+            while (!text.empty()) {
+                const std::size_t word_start {text.find_first_not_of(" \t\r")};
+
+                if (word_start == std::string_view::npos) {
+                    break;
+                }
+
+                text.remove_prefix(word_start);
+
+                const std::size_t word_end {std::min(text.find_first_of(" \t\r"), text.size())};
+
+                words.push_back(text.substr(0, word_end));
+                text.remove_prefix(word_end);
+            }
+
+            return words;
+        }
+
+        // Everything after `command` in `command_line`, without the separating space
+        std::string_view arguments_of(std::string_view command_line, std::string_view command) {
+            const std::size_t start {command_line.find(command) + command.size()};
+            const std::size_t arguments_start {command_line.find_first_not_of(" \t", start)};
+
+            return arguments_start == std::string_view::npos
+                       ? std::string_view {}
+                       : command_line.substr(arguments_start);
+        }
+
+        int saturated_int(std::int64_t value) {
+            return static_cast<int>(std::clamp<std::int64_t>(
+                value, std::numeric_limits<int>::min(), std::numeric_limits<int>::max()));
+        }
+
+        std::string score_to_uci(int score) {
+            if (!is_mate_score(score)) {
+                return "cp " + std::to_string(score);
+            }
+
+            const int plies_to_mate {score > 0 ? mate_score - score : -mate_score - score};
+
+            return "mate " + std::to_string(score > 0 ? (plies_to_mate + 1) / 2
+                                                      : plies_to_mate / 2);
+        }
+
+        std::string mate_solution_to_uci(const mate_solution& solution) {
+            const std::uint64_t milliseconds {
+                static_cast<std::uint64_t>(std::max<std::int64_t>(solution.time.count(), 1))};
+
+            std::string line {"info depth " + std::to_string(solution.principal_variation.size()) +
+                              " score mate " + std::to_string(solution.mate_in.value_or(0)) +
+                              " nodes " + std::to_string(solution.nodes) + " nps " +
+                              std::to_string(solution.nodes * 1000 / milliseconds) + " time " +
+                              std::to_string(solution.time.count()) + " pv"};
+
+            for (const bitboard::move& chess_move: solution.principal_variation) {
+                line += ' ' + move_to_uci(chess_move);
+            }
+
+            return line;
+        }
+
+        std::string iteration_to_uci(const search_iteration& iteration) {
+            const std::uint64_t nodes {iteration.statistics.nodes};
+            const std::uint64_t milliseconds {
+                static_cast<std::uint64_t>(std::max<std::int64_t>(iteration.time.count(), 1))};
+
+            std::string line {
+                "info depth " + std::to_string(iteration.depth) + " seldepth " +
+                std::to_string(iteration.selective_depth) + " multipv " +
+                std::to_string(iteration.line) + " score " +
+                score_to_uci(iteration.score) + " nodes " + std::to_string(nodes) + " nps " +
+                std::to_string(nodes * 1000 / milliseconds) + " hashfull " +
+                std::to_string(iteration.hashfull) + " tbhits " +
+                std::to_string(iteration.statistics.tablebase_hits) + " time " +
+                std::to_string(iteration.time.count()) + " pv"};
+
+            for (const bitboard::move& chess_move: iteration.principal_variation) {
+                line += ' ' + move_to_uci(chess_move);
+            }
+
+            return line;
+        }
+    } // namespace
+
+    std::string move_to_uci(const bitboard::move& chess_move) {
+        std::string uci_move {bitboard::cordinate {bitboard::move_start(chess_move)}
+                                  .to_fancy_string() +
+                              bitboard::cordinate {bitboard::move_end(chess_move)}
+                                  .to_fancy_string()};
+
+        if (const auto* promotion_move {std::get_if<bitboard::move_promotion>(&chess_move)}) {
+            uci_move += static_cast<char>(bitboard::pieces::from_type_and_turn(
+                                              promotion_move->promotion_type, bitboard::Turn::Black)
+                                              .symbol);
+        }
+
+        return uci_move;
+    }
+
+    std::optional<bitboard::move> move_from_uci(const bitboard& board, std::string_view uci_move) {
+        if (uci_move.size() != 4 && uci_move.size() != 5) {
+            return std::nullopt;
+        }
+
+        const auto square_at {[uci_move](std::size_t offset) {
+            const char file {uci_move.at(offset)};
+            const char rank {uci_move.at(offset + 1)};
+
+            return file >= 'a' && file <= 'h' && rank >= '1' && rank <= '8'
+                       ? std::optional {bitboard::cordinate {file - 'a', rank - '1'}
+                                            .to_bit_representation()}
+                       : std::nullopt;
+        }};
+
+        const std::optional<bitboard::bit_representation> start {square_at(0)};
+        const std::optional<bitboard::bit_representation> end {square_at(2)};
+        bitboard::PieceType promotion_type {bitboard::PieceType::Any};
+
+        if (uci_move.size() == 5) {
+            switch (uci_move.at(4)) {
+                case 'n': promotion_type = bitboard::PieceType::Knight; break;
+                case 'b': promotion_type = bitboard::PieceType::Bishop; break;
+                case 'r': promotion_type = bitboard::PieceType::Rook; break;
+                case 'q': promotion_type = bitboard::PieceType::Queen; break;
+                default: return std::nullopt;
+            }
+        }
+
+        if (!start.has_value() || !end.has_value()) {
+            return std::nullopt;
+        }
+
+        return board.legal_move_between(*start, *end, promotion_type);
+    }
+
+    std::optional<std::int64_t> parse_integer(std::string_view text) {
+        std::int64_t value {};
+        const char* const end {text.data() + text.size()};
+        const auto [parse_end, error] {std::from_chars(text.data(), end, value)};
+
+        if (error != std::errc {} || parse_end != end) {
+            return std::nullopt;
+        }
+
+        return value;
+    }
+
+    std::optional<std::int64_t> parse_integer(std::string_view text, std::int64_t minimum,
+                                              std::int64_t maximum) {
+        return parse_integer(text).and_then([minimum, maximum](std::int64_t value) {
+            return value >= minimum && value <= maximum ? std::optional {value} : std::nullopt;
+        });
+    }
+
+    uci_engine::uci_engine(std::ostream& output) :
+        _output {output}, _statistics {}, _engine {default_hash_megabytes},
+        _mate_solver {mate_solver::default_table_megabytes},
+        _position {bitboard::from_fen(bitboard::starting_position_fen).value()}, _multi_pv {1},
+        _own_book {false}, _pin_search_thread {false}, _next_search_core {0},
+        _random_engine {std::random_device {}()} {
+    }
+
+    uci_engine::~uci_engine() {
+        stop_search();
+    }
+
+    void uci_engine::run(std::istream& input) {
+        std::string command_line {};
+
+        while (std::getline(input, command_line) && handle_command(command_line)) {
+        }
+
+        stop_search();
+    }
+
+    bool uci_engine::handle_command(std::string_view command_line) {
+        const std::vector<std::string_view> words {split_words(command_line)};
+
+        if (words.empty()) {
+            return true;
+        }
+
+        const std::string_view command {words.front()};
+
+        if (command == "uci") {
+            send("id name esochess");
+            send("id author the esochess authors");
+            send("option name Hash type spin default " + std::to_string(default_hash_megabytes) +
+                 " min 1 max 65536");
+            send("option name Clear Hash type button");
+            send("option name Ponder type check default false");
+            send("option name MultiPV type spin default 1 min 1 max " +
+                 std::to_string(max_multi_pv));
+            send("option name MateSolverHash type spin default " +
+                 std::to_string(mate_solver::default_table_megabytes) + " min 1 max 65536");
+            send("option name SyzygyPath type string default <empty>");
+            send("option name OwnBook type check default false");
+            send("option name BookFile type string default <empty>");
+            send("option name ThreadAffinity type check default false");
+
+            for (const parameter_option& option: parameter_options) {
+                send("option name " + std::string {option.name} + " type spin default " +
+                     std::to_string(search_parameters {}.*option.parameter) + " min " +
+                     std::to_string(option.min) + " max " + std::to_string(option.max));
+            }
+
+            send("uciok");
+        }
+
+        else if (command == "isready") {
+            send("readyok");
+        }
+
+        else if (command == "ucinewgame") {
+            stop_search();
+            _engine.clear();
+            _mate_solver.clear();
+        }
+
+        else if (command == "setoption") {
+            set_option(arguments_of(command_line, command));
+        }
+
+        else if (command == "position") {
+            set_position(arguments_of(command_line, command));
+        }
+
+        else if (command == "go") {
+            go(arguments_of(command_line, command));
+        }
+
+        else if (command == "stop") {
+            stop_search();
+        }
+
+        else if (command == "ponderhit") { // The search goes on, now on the engine's own clock
+            _engine.ponder_hit();
+        }
+
+        else if (command == "quit") {
+            stop_search();
+            return false;
+        }
+
+        else if (command == "bench") {
+            stop_search();
+
+            const std::optional<std::int64_t> requested_depth {
+                words.size() > 1 ? parse_integer(words.at(1)) : std::nullopt};
+            std::ostringstream report {};
+
+            if (words.size() > 1 && !requested_depth.has_value()) {
+                send("info string Invalid bench depth: " + std::string {words.at(1)});
+            }
+
+            const int depth {requested_depth.has_value() ? saturated_int(*requested_depth)
+                                                         : default_bench_depth};
+
+            static_cast<void>(run_bench(depth, report, _engine.parameters()));
+            send(report.str());
+        }
+
+        else if (command == "stats") { // Counters of the last completed iteration
+            std::istringstream statistics {[this]() {
+                const std::scoped_lock lock {_output_mutex};
+                return _statistics.to_string();
+            }()};
+
+            for (std::string line {}; std::getline(statistics, line);) {
+                send("info string " + line);
+            }
+        }
+
+        else if (command == "d") {
+            send(_position.to_fancy_string() + "\nFen: " + _position.to_fen());
+        }
+
+        else {
+            send("info string Unknown command: " + std::string {command_line});
+        }
+
+        return true;
+    }
+
+    void uci_engine::send(std::string_view line, const search_statistics* statistics) {
+        const std::scoped_lock lock {_output_mutex};
+
+        if (statistics != nullptr) {
+            _statistics = *statistics;
+        }
+
+        _output << line << std::endl;
+    }
+
+    void uci_engine::set_option(std::string_view arguments) {
+        const std::size_t value_position {arguments.find(" value ")};
+        const std::string_view name {arguments_of(arguments.substr(0, value_position), "name")};
+        const std::string_view value {value_position == std::string_view::npos
+                                          ? std::string_view {}
+                                          : arguments_of(arguments.substr(value_position),
+                                                         "value")};
+
+        stop_search();
+
+        static constexpr std::array<std::string_view, 3> numeric_options {"Hash", "MateSolverHash",
+                                                                          "MultiPV"};
+        const bool numeric {std::ranges::find(numeric_options, name) != numeric_options.end() ||
+                            std::ranges::find(parameter_options, name,
+                                              &parameter_option::name) != parameter_options.end()};
+        const std::optional<std::int64_t> number {parse_integer(value)};
+
+        if (numeric && !number.has_value()) {
+            send("info string Invalid value for " + std::string {name} + ": " +
+                 std::string {value});
+            return;
+        }
+
+        if (name == "Hash") {
+            try {
+                _engine.set_hash_size(
+                    static_cast<std::size_t>(std::max<std::int64_t>(*number, 1)));
+            }
+
+            catch (const std::bad_alloc&) {
+                send("info string Could not allocate " + std::string {value} +
+                     " MB for Hash, keeping the previous table");
+            }
+        }
+
+        else if (name == "Clear Hash") {
+            _engine.clear();
+            _mate_solver.clear();
+        }
+
+        else if (name == "MateSolverHash") {
+            try {
+                _mate_solver.set_table_size(
+                    static_cast<std::size_t>(std::max<std::int64_t>(*number, 1)));
+            }
+
+            catch (const std::bad_alloc&) {
+                send("info string Could not allocate " + std::string {value} +
+                     " MB for MateSolverHash, keeping the previous table");
+            }
+        }
+
+        else if (name == "MultiPV") {
+            _multi_pv = static_cast<std::size_t>(
+                std::clamp<std::int64_t>(*number, 1, static_cast<std::int64_t>(max_multi_pv)));
+        }
+
+        else if (name == "Ponder") {
+            // Only tells the engine that the GUI may send `go ponder`, which needs no preparation
+        }
+
+        else if (name == "SyzygyPath") {
+            _engine.set_tablebases(nullptr);
+            _tablebases.reset();
+
+            if (!value.empty() && value != "<empty>") {
+                _tablebases = syzygy_tablebases::open(value);
+                _engine.set_tablebases(&*_tablebases);
+                send("info string Found " + std::to_string(_tablebases->size()) +
+                     " tablebases with up to " + std::to_string(_tablebases->max_pieces()) +
+                     " pieces");
+            }
+        }
+
+        else if (name == "OwnBook") {
+            _own_book = value == "true";
+        }
+
+        else if (name == "BookFile") {
+            _book.reset();
+
+            if (!value.empty() && value != "<empty>") {
+                if (auto book {polyglot_book::open(std::string {value})}) {
+                    _book.emplace(std::move(*book));
+                }
+
+                else {
+                    send("info string Could not open book: " + book.error().message());
+                }
+            }
+        }
+
+        else if (name == "ThreadAffinity") {
+            _pin_search_thread = value == "true";
+        }
+
+        else if (const auto* const option {
+                     std::ranges::find(parameter_options, name, &parameter_option::name)};
+                 option != parameter_options.end()) {
+            search_parameters parameters {_engine.parameters()};
+
+            parameters.*option->parameter =
+                static_cast<int>(std::clamp<std::int64_t>(*number, option->min, option->max));
+            _engine.set_parameters(parameters);
+        }
+
+        else {
+            send("info string Unknown option: " + std::string {name});
+        }
+    }
+
+    void uci_engine::set_position(std::string_view arguments) {
+        stop_search();
+
+        const std::vector<std::string_view> words {split_words(arguments)};
+        const auto moves_word {std::ranges::find(words, "moves")};
+
+        std::optional<bitboard> position {};
+
+        if (!words.empty() && words.front() == "startpos") {
+            position = bitboard::from_fen(bitboard::starting_position_fen).value();
+        }
+
+        else if (!words.empty() && words.front() == "fen") {
+            std::string fen {};
+
+            for (auto word {words.begin() + 1}; word != moves_word; word++) {
+                fen += (fen.empty() ? "" : " ") + std::string {*word};
+            }
+
+            if (auto parsed_position {bitboard::from_fen(fen)}) {
+                position = *parsed_position;
+            }
+
+            else {
+                send("info string Invalid FEN: " + parsed_position.error().to_string());
+            }
+        }
+
+        if (!position.has_value()) {
+            return;
+        }
+
+        // The current position stays as it was unless every move applies
+        std::vector<std::uint64_t> history {};
+
+        for (auto word {moves_word}; word != words.end() && ++word != words.end();) {
+            const std::optional<bitboard::move> chess_move {move_from_uci(*position, *word)};
+
+            if (!chess_move.has_value()) {
+                send("info string Illegal move: " + std::string {*word});
+                return;
+            }
+
+            history.push_back(position->hash());
+            position->make_move(*chess_move);
+        }
+
+        _position = *position;
+        _history = std::move(history);
+    }
+
+    void uci_engine::go(std::string_view arguments) {
+        stop_search();
+
+        const std::vector<std::string_view> words {split_words(arguments)};
+        const bool white_to_move {_position.turn() == bitboard::Turn::White};
+        search_limits limits {};
+        std::optional<int> mate_moves {};
+
+        limits.infinite = std::ranges::find(words, "infinite") != words.end();
+        limits.ponder = std::ranges::find(words, "ponder") != words.end();
+        limits.multi_pv = _multi_pv;
+
+        static constexpr std::array<std::string_view, 9> numeric_arguments {
+            "depth", "nodes", "movetime", "wtime", "btime", "winc", "binc", "movestogo", "mate"};
+
+        for (std::size_t index {}; index + 1 < words.size(); index++) {
+            const std::string_view word {words.at(index)};
+
+            if (std::ranges::find(numeric_arguments, word) == numeric_arguments.end()) {
+                continue;
+            }
+
+            // Only the clocks may run negative, a node count or move time below zero is malformed
+            const bool is_limit {word == "nodes" || word == "movetime"};
+            const std::optional<std::int64_t> number {
+                is_limit ? parse_integer(words.at(index + 1), 0,
+                                         std::numeric_limits<std::int64_t>::max())
+                         : parse_integer(words.at(index + 1))};
+
+            if (!number.has_value()) {
+                send("info string Invalid value for " + std::string {word} + ": " +
+                     std::string {words.at(index + 1)});
+                continue;
+            }
+
+            if (word == "depth") {
+                limits.depth = saturated_int(*number);
+            }
+
+            else if (word == "nodes") {
+                limits.nodes = static_cast<std::uint64_t>(*number);
+            }
+
+            else if (word == "movetime") {
+                limits.move_time = std::chrono::milliseconds {*number};
+            }
+
+            else if (word == (white_to_move ? "wtime" : "btime")) {
+                limits.time_left = std::chrono::milliseconds {*number};
+            }
+
+            else if (word == (white_to_move ? "winc" : "binc")) {
+                limits.increment = std::chrono::milliseconds {*number};
+            }
+
+            else if (word == "movestogo") {
+                limits.moves_to_go = saturated_int(*number);
+            }
+
+            else if (word == "mate") {
+                mate_moves = saturated_int(*number);
+            }
+        }
+
+        if (_own_book && _book.has_value() && !limits.infinite && !limits.ponder &&
+            !mate_moves.has_value()) {
+            bitboard position {_position};
+
+            if (const std::optional<bitboard::move> book_move {
+                    _book->pick_move(position, _random_engine)}) {
+                send("bestmove " + move_to_uci(*book_move));
+                return;
+            }
+        }
+
+        _search_thread = std::jthread {[this, root {_position}, history {_history}, limits,
+                                        mate_moves, pin_thread {_pin_search_thread},
+                                        core {_next_search_core++}](std::stop_token stop_token) {
+            if (pin_thread) {
+                pin_current_thread(core);
+            }
+
+            // `go mate` runs the mate solver, falling back on the normal search without a mate
+            if (mate_moves.has_value()) {
+                const mate_solution solution {_mate_solver.solve(
+                    root, mate_solver_limits {*mate_moves, limits.nodes, limits.move_time},
+                    stop_token)};
+
+                if (solution.mate_in.has_value()) {
+                    send(mate_solution_to_uci(solution));
+                    send("bestmove " + move_to_uci(solution.principal_variation.front()) +
+                         (solution.principal_variation.size() > 1
+                              ? " ponder " + move_to_uci(solution.principal_variation.at(1))
+                              : ""));
+                    return;
+                }
+
+                send("info string No mate in " + std::to_string(*mate_moves) +
+                     (solution.disproven ? " exists" : " found"));
+            }
+
+            const search_result result {_engine.search(
+                root, history, limits,
+                [this](const search_iteration& iteration) {
+                    send(iteration_to_uci(iteration), &iteration.statistics);
+                },
+                std::move(stop_token))};
+
+            send("bestmove " +
+                     (result.best_move.has_value() ? move_to_uci(*result.best_move) : "0000") +
+                     (result.ponder_move.has_value()
+                          ? " ponder " + move_to_uci(*result.ponder_move)
+                          : ""),
+                 &result.statistics);
+        }};
+    }
+
+    void uci_engine::stop_search() {
+        if (_search_thread.joinable()) {
+            _search_thread.request_stop();
+            _search_thread.join();
+        }
+    }
+} // namespace esochess
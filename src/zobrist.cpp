@@ -0,0 +1,82 @@
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "headers/attacks.hpp"
+#include "headers/bitboard.hpp"
+
+namespace esochess {
+    namespace {
+        struct zobrist_keys {
+            std::array<std::array<std::uint64_t, 64>, 12> piece_squares;
+            std::array<std::uint64_t, 4> castle_rights;
+            std::array<std::uint64_t, 8> en_passant_files;
+            std::uint64_t black_to_move;
+        };
+
+        constexpr zobrist_keys keys {[]() {
+            std::uint64_t state {0x5eed'e50c'4e55'0001};
+
+            const auto next_key {[&state]() { // splitmix64
+                state += 0x9e37'79b9'7f4a'7c15;
+                std::uint64_t key {state};
+                key = (key ^ (key >> 30U)) * 0xbf58'476d'1ce4'e5b9;
+                key = (key ^ (key >> 27U)) * 0x94d0'49bb'1331'11eb;
+                return key ^ (key >> 31U);
+            }};
+
+            zobrist_keys generated_keys {};
+
+            for (auto& square_keys: generated_keys.piece_squares) {
+                for (std::uint64_t& key: square_keys) {
+                    key = next_key();
+                }
+            }
+
+            for (std::uint64_t& key: generated_keys.castle_rights) {
+                key = next_key();
+            }
+
+            for (std::uint64_t& key: generated_keys.en_passant_files) {
+                key = next_key();
+            }
+
+            generated_keys.black_to_move = next_key();
+
+            return generated_keys;
+        }()};
+    } // namespace
+
+    std::uint64_t bitboard::hash() const {
+        std::uint64_t position_hash {0};
+
+        for (std::size_t bitboard_index {}; bitboard_index < pieces::all_pieces.size();
+             bitboard_index++) {
+            for (bit_representation piece_bits {_position.pieces(bitboard_index)}; piece_bits != 0;
+                 piece_bits = without_lowest_square(piece_bits)) {
+                const auto square {static_cast<std::size_t>(square_index(piece_bits))};
+                position_hash ^= keys.piece_squares [bitboard_index][square];
+            }
+        }
+
+        const std::array<bool, 4> castle_rights {
+            _position.castle_rights.white_king_side, _position.castle_rights.white_queen_side,
+            _position.castle_rights.black_king_side, _position.castle_rights.black_queen_side};
+
+        for (std::size_t index {}; index < castle_rights.size(); index++) {
+            if (castle_rights.at(index)) {
+                position_hash ^= keys.castle_rights.at(index);
+            }
+        }
+
+        if (_position.en_passant.has_value()) {
+            position_hash ^= keys.en_passant_files.at(_position.en_passant->column_index);
+        }
+
+        if (_position.turn == Turn::Black) {
+            position_hash ^= keys.black_to_move;
+        }
+
+        return position_hash;
+    }
+} // namespace esochess